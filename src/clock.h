@@ -0,0 +1,24 @@
+/*
+ * clock.h — Zeitstempel für Messungen
+ *
+ * Alle Zeitmessungen in blkout verwenden CLOCK_MONOTONIC in Nanosekunden,
+ * damit sie untereinander und mit den Zeitstempeln des Compositors
+ * (wl_pointer/wl_keyboard verwenden dieselbe Uhr in Millisekunden)
+ * vergleichbar sind.
+ */
+
+#ifndef BLKOUT_CLOCK_H
+#define BLKOUT_CLOCK_H
+
+#include <stdint.h>
+#include <time.h>
+
+/* Aktuelle monotone Zeit in Nanosekunden */
+static inline uint64_t monotonic_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+#endif
@@ -0,0 +1,143 @@
+/*
+ * config.c — Konfigurationsdatei mit Neuladen per inotify
+ *
+ * Siehe config.h. Gelesen wird nur beim Start und nach einer gemeldeten
+ * Änderung; die Beobachtung selbst verursacht keine Wakeups.
+ */
+
+#define _GNU_SOURCE
+
+#include "config.h"
+
+#include <ctype.h>
+#include <errno.h>
+#include <libgen.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/inotify.h>
+
+/* Längste ausgewertete Zeile; längere Zeilen sind ein Fehler */
+#define CONFIG_LINE_MAX 256
+
+char *config_default_path(void)
+{
+    const char *xdg  = getenv("XDG_CONFIG_HOME");
+    const char *home = getenv("HOME");
+    char *path = NULL;
+
+    if (xdg && *xdg) {
+        if (asprintf(&path, "%s/blkout/config", xdg) < 0)
+            return NULL;
+    } else if (home && *home) {
+        if (asprintf(&path, "%s/.config/blkout/config", home) < 0)
+            return NULL;
+    }
+    return path;
+}
+
+/* Leerraum am Anfang und Ende abschneiden */
+static char *trim(char *s)
+{
+    while (isspace((unsigned char)*s))
+        s++;
+    char *end = s + strlen(s);
+    while (end > s && isspace((unsigned char)end[-1]))
+        end--;
+    *end = '\0';
+    return s;
+}
+
+bool config_load(const char *path, ConfigApply apply, void *ctx)
+{
+    FILE *f = fopen(path, "re");
+    if (!f) {
+        if (errno == ENOENT)
+            return true;
+        perror(path);
+        return false;
+    }
+
+    char buf[CONFIG_LINE_MAX];
+    int  lineno = 0;
+    bool ok     = true;
+    while (ok && fgets(buf, sizeof(buf), f)) {
+        lineno++;
+        if (!strchr(buf, '\n') && !feof(f)) {
+            fprintf(stderr, "%s:%d: Zeile zu lang\n", path, lineno);
+            ok = false;
+            break;
+        }
+
+        char *line = trim(buf);
+        if (*line == '\0' || *line == '#')
+            continue;
+
+        char *eq = strchr(line, '=');
+        if (!eq) {
+            fprintf(stderr, "%s:%d: \"schlüssel = wert\" erwartet\n",
+                    path, lineno);
+            ok = false;
+            break;
+        }
+        *eq = '\0';
+        char *key   = trim(line);
+        char *value = trim(eq + 1);
+        if (!apply(ctx, key, value)) {
+            fprintf(stderr, "%s:%d: Ungültiger Eintrag: %s = %s\n",
+                    path, lineno, key, value);
+            ok = false;
+        }
+    }
+    if (ferror(f)) {
+        perror(path);
+        ok = false;
+    }
+    fclose(f);
+    return ok;
+}
+
+int config_watch(const char *path)
+{
+    char *copy = strdup(path);
+    if (!copy)
+        return -1;
+
+    int fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (fd < 0) {
+        perror("inotify_init1");
+        free(copy);
+        return -1;
+    }
+    /* Schreiben, Ersetzen per rename() und Löschen der Datei erkennen */
+    if (inotify_add_watch(fd, dirname(copy),
+                          IN_CLOSE_WRITE | IN_MOVED_TO | IN_MOVED_FROM |
+                          IN_DELETE) < 0) {
+        close(fd);
+        fd = -1;
+    }
+    free(copy);
+    return fd;
+}
+
+bool config_changed(int fd, const char *path)
+{
+    const char *name = strrchr(path, '/');
+    name = name ? name + 1 : path;
+
+    /* Puffer mit der Ausrichtung von struct inotify_event */
+    char buf[4096] __attribute__((aligned(__alignof__(struct inotify_event))));
+    bool hit = false;
+    ssize_t n;
+
+    while ((n = read(fd, buf, sizeof(buf))) > 0) {
+        for (char *p = buf; p < buf + n; ) {
+            const struct inotify_event *ev = (const struct inotify_event *)p;
+            if (ev->len > 0 && strcmp(ev->name, name) == 0)
+                hit = true;
+            p += sizeof(struct inotify_event) + ev->len;
+        }
+    }
+    return hit;
+}
@@ -0,0 +1,53 @@
+/*
+ * config.h — Konfigurationsdatei mit Neuladen per inotify
+ *
+ * Standardpfad ist $XDG_CONFIG_HOME/blkout/config (ersatzweise
+ * ~/.config/blkout/config), abweichend per --config <pfad>. Eine fehlende
+ * Datei ist kein Fehler. Format: eine Einstellung pro Zeile,
+ *
+ *   # Kommentar
+ *   timeout  = 300
+ *   strategy = cached
+ *
+ * Leerzeichen um Schlüssel und Wert werden ignoriert. Welche Schlüssel es
+ * gibt und wie sie wirken, entscheidet der Aufrufer (main.c); hier wird nur
+ * gelesen und beobachtet.
+ *
+ * Beobachtet wird das Verzeichnis der Datei, nicht die Datei selbst: Editoren
+ * und Verteilungswerkzeuge ersetzen Dateien meist per rename(), wodurch eine
+ * Beobachtung der alten Datei ins Leere liefe.
+ */
+
+#ifndef BLKOUT_CONFIG_H
+#define BLKOUT_CONFIG_H
+
+#include <stdbool.h>
+
+/*
+ * Wird für jede Einstellung aufgerufen. Gibt false zurück, wenn Schlüssel
+ * oder Wert ungültig sind; config_load meldet dann Datei und Zeile.
+ */
+typedef bool (*ConfigApply)(void *ctx, const char *key, const char *value);
+
+/* Standardpfad als neu allocierter String, NULL ohne HOME/XDG_CONFIG_HOME */
+char *config_default_path(void);
+
+/*
+ * Datei lesen und jede Einstellung an apply übergeben. Gibt false bei
+ * Lesefehler oder ungültiger Zeile zurück; eine fehlende Datei gilt als leer.
+ */
+bool config_load(const char *path, ConfigApply apply, void *ctx);
+
+/*
+ * inotify-Beobachtung für das Verzeichnis von path anlegen. Gibt den
+ * nicht blockierenden fd zurück, -1 wenn das Verzeichnis fehlt.
+ */
+int config_watch(const char *path);
+
+/*
+ * Anstehende inotify-Ereignisse abholen. Gibt true zurück, wenn eines
+ * davon die Datei path betrifft (geschrieben, ersetzt oder gelöscht).
+ */
+bool config_changed(int fd, const char *path);
+
+#endif
@@ -0,0 +1,139 @@
+/*
+ * content.c — Minimaler Inhalt auf dem Overlay (--content)
+ *
+ * Siehe content.h. Ziffern stammen aus einer 5x7-Pixelschrift und werden
+ * als waagrechte Läufe über fill_rect() gezeichnet, skaliert mit der
+ * Bildschirmhöhe.
+ */
+
+#define _GNU_SOURCE
+
+#include "content.h"
+
+#include <stddef.h>
+
+#include "fill.h"
+
+/* Gedimmtes Grau; auf OLED gerade noch lesbar, kaum Leuchtdichte */
+#define CONTENT_COLOR  0x00282828u
+
+/* Schrift- und Markengröße als Bruchteil der Bildschirmhöhe */
+#define CLOCK_SCALE_DIV   216   /* 1080 Zeilen → Skalierung 5, 35 px hoch */
+#define MARKER_SIZE_DIV   135   /* 1080 Zeilen → 8 px */
+#define CONTENT_MARGIN    16    /* Mindestabstand zum Rand in Pixeln */
+
+#define GLYPH_W  5
+#define GLYPH_H  7
+
+/* 5x7-Pixelschrift für 0-9 und ':'; Bit 4 ist die linke Spalte */
+static const uint8_t glyphs[11][GLYPH_H] = {
+    { 0x0E, 0x11, 0x13, 0x15, 0x19, 0x11, 0x0E },   /* 0 */
+    { 0x04, 0x0C, 0x04, 0x04, 0x04, 0x04, 0x0E },   /* 1 */
+    { 0x0E, 0x11, 0x01, 0x02, 0x04, 0x08, 0x1F },   /* 2 */
+    { 0x1F, 0x02, 0x04, 0x02, 0x01, 0x11, 0x0E },   /* 3 */
+    { 0x02, 0x06, 0x0A, 0x12, 0x1F, 0x02, 0x02 },   /* 4 */
+    { 0x1F, 0x10, 0x1E, 0x01, 0x01, 0x11, 0x0E },   /* 5 */
+    { 0x06, 0x08, 0x10, 0x1E, 0x11, 0x11, 0x0E },   /* 6 */
+    { 0x1F, 0x01, 0x02, 0x04, 0x08, 0x08, 0x08 },   /* 7 */
+    { 0x0E, 0x11, 0x11, 0x0E, 0x11, 0x11, 0x0E },   /* 8 */
+    { 0x0E, 0x11, 0x11, 0x0F, 0x01, 0x02, 0x0C },   /* 9 */
+    { 0x00, 0x0C, 0x0C, 0x00, 0x0C, 0x0C, 0x00 },   /* : */
+};
+#define GLYPH_COLON 10
+
+void content_attach(Content *c, ContentMode mode, void *pixels,
+                    int width, int height, bool fresh)
+{
+    if (fresh || c->pixels != pixels || c->width != width ||
+        c->height != height) {
+        c->drawn  = (ContentRect){ 0 };
+        c->minute = -1;
+    }
+    c->mode   = mode;
+    c->pixels = pixels;
+    c->width  = width;
+    c->height = height;
+}
+
+time_t content_next_update(time_t now)
+{
+    return (now / 60 + 1) * 60;
+}
+
+/* Stelle der Minute: gleichmäßig gestreut, aber reproduzierbar */
+static uint64_t mix(uint64_t x)
+{
+    x += 0x9E3779B97F4A7C15ull;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+    return x ^ (x >> 31);
+}
+
+static void draw_glyph(Content *c, int glyph, int x, int y, int scale)
+{
+    for (int r = 0; r < GLYPH_H; r++) {
+        uint8_t bits = glyphs[glyph][r];
+        for (int col = 0; col < GLYPH_W; ) {
+            if (!(bits & (0x10 >> col))) {
+                col++;
+                continue;
+            }
+            int run = 1;
+            while (col + run < GLYPH_W && (bits & (0x10 >> (col + run))))
+                run++;
+            fill_rect(c->pixels, c->width, x + col * scale, y + r * scale,
+                      run * scale, scale, CONTENT_COLOR);
+            col += run;
+        }
+    }
+}
+
+int content_update(Content *c, time_t now, ContentRect damage[2])
+{
+    long minute = (long)(now / 60);
+    if (c->mode == CONTENT_NONE || !c->pixels || minute == c->minute)
+        return 0;
+    c->minute = minute;
+
+    /* Alte Position löschen */
+    int n = 0;
+    if (c->drawn.w > 0) {
+        fill_rect(c->pixels, c->width, c->drawn.x, c->drawn.y,
+                  c->drawn.w, c->drawn.h, 0);
+        damage[n++] = c->drawn;
+        c->drawn.w = 0;
+    }
+
+    /* Größe des neuen Inhalts */
+    int scale = c->height / CLOCK_SCALE_DIV > 1 ? c->height / CLOCK_SCALE_DIV : 1;
+    int w, h;
+    if (c->mode == CONTENT_CLOCK) {
+        w = (5 * (GLYPH_W + 1) - 1) * scale;   /* "HH:MM" mit Abständen */
+        h = GLYPH_H * scale;
+    } else {
+        w = h = c->height / MARKER_SIZE_DIV > 2 ? c->height / MARKER_SIZE_DIV : 2;
+    }
+    if (w + 2 * CONTENT_MARGIN > c->width || h + 2 * CONTENT_MARGIN > c->height)
+        return n;
+
+    uint64_t r = mix((uint64_t)minute);
+    int x = CONTENT_MARGIN +
+            (int)(r % (uint64_t)(c->width - w - 2 * CONTENT_MARGIN + 1));
+    int y = CONTENT_MARGIN +
+            (int)((r >> 32) % (uint64_t)(c->height - h - 2 * CONTENT_MARGIN + 1));
+
+    if (c->mode == CONTENT_CLOCK) {
+        struct tm tm;
+        localtime_r(&now, &tm);
+        int text[5] = { tm.tm_hour / 10, tm.tm_hour % 10, GLYPH_COLON,
+                        tm.tm_min / 10, tm.tm_min % 10 };
+        for (int i = 0; i < 5; i++)
+            draw_glyph(c, text[i], x + i * (GLYPH_W + 1) * scale, y, scale);
+    } else {
+        fill_rect(c->pixels, c->width, x, y, w, h, CONTENT_COLOR);
+    }
+
+    c->drawn = (ContentRect){ x, y, w, h };
+    damage[n++] = c->drawn;
+    return n;
+}
@@ -0,0 +1,59 @@
+/*
+ * content.h — Minimaler Inhalt auf dem Overlay (--content)
+ *
+ * Für OLED-Anzeigen, auf denen ein rein schwarzes Bild zu wenig ist: eine
+ * gedimmte Uhr (HH:MM) oder eine kleine Marke. Damit sich nichts einbrennt,
+ * springt der Inhalt jede Minute an eine andere Stelle.
+ *
+ * Gezeichnet wird direkt in den schwarzen Puffer des Overlays. Je Minute
+ * ändern sich höchstens zwei kleine Rechtecke: die alte Position wird
+ * schwarz, die neue gezeichnet. Nur diese meldet content_update() als
+ * Schaden zurück; Rechenzeit, Speicherbandbreite und der vom Compositor
+ * neu zu zeichnende Bereich hängen so von wenigen hundert Pixeln ab, nicht
+ * von der Bildschirmgröße.
+ */
+
+#ifndef BLKOUT_CONTENT_H
+#define BLKOUT_CONTENT_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <time.h>
+
+typedef enum {
+    CONTENT_NONE,    /* Nur schwarz (Standard) */
+    CONTENT_CLOCK,   /* Gedimmte Uhrzeit */
+    CONTENT_MARKER,  /* Kleines gedimmtes Quadrat */
+} ContentMode;
+
+typedef struct {
+    int x, y, w, h;
+} ContentRect;
+
+typedef struct {
+    ContentMode mode;
+    uint32_t   *pixels;   /* XRGB8888, Zeilenlänge = width */
+    int         width;
+    int         height;
+    ContentRect drawn;    /* Zuletzt gezeichneter Bereich, w = 0: keiner */
+    long        minute;   /* Gezeichnete Minute seit der Epoche, -1 = keine */
+} Content;
+
+/*
+ * Puffer übernehmen. fresh = frisch schwarz gefüllt; sonst steht darin
+ * noch, was zuletzt gezeichnet wurde (persistent, cached, nach dem
+ * Wiederverbinden).
+ */
+void content_attach(Content *c, ContentMode mode, void *pixels,
+                    int width, int height, bool fresh);
+
+/*
+ * Inhalt für die Zeit now zeichnen, falls sich etwas ändert. Gibt die
+ * Anzahl der geänderten Rechtecke in damage zurück (0 bis 2).
+ */
+int content_update(Content *c, time_t now, ContentRect damage[2]);
+
+/* Nächster Zeitpunkt (Sekunden seit der Epoche), an dem sich etwas ändert */
+time_t content_next_update(time_t now);
+
+#endif
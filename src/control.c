@@ -0,0 +1,152 @@
+/*
+ * control.c — Steuersocket für das Auslösen von außen
+ *
+ * Siehe control.h. Verbindungen werden in der Hauptschleife angenommen;
+ * der Zustand je Verbindung (ControlClient) liegt beim Aufrufer.
+ */
+
+#define _GNU_SOURCE
+
+#include "control.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+
+/* Erster geerbter Dateideskriptor laut sd_listen_fds(3) */
+#define LISTEN_FDS_START 3
+
+int control_listen(const char *path)
+{
+    struct sockaddr_un addr = { .sun_family = AF_UNIX };
+
+    if (strlen(path) >= sizeof(addr.sun_path)) {
+        fprintf(stderr, "Socket-Pfad zu lang: %s\n", path);
+        return -1;
+    }
+    strcpy(addr.sun_path, path);
+
+    /* Verwaisten Socket einer früheren Instanz entfernen, sonst nichts */
+    struct stat st;
+    if (lstat(path, &st) == 0) {
+        if (!S_ISSOCK(st.st_mode)) {
+            fprintf(stderr, "%s existiert und ist kein Socket\n", path);
+            return -1;
+        }
+        unlink(path);
+    }
+
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        perror("socket");
+        return -1;
+    }
+
+    if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0 ||
+        listen(fd, 4) < 0) {
+        perror(path);
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+/* Ist fd ein lauschender AF_UNIX-Stream-Socket? */
+static bool is_unix_listener(int fd)
+{
+    int       domain = 0, type = 0, listening = 0;
+    socklen_t len;
+
+    len = sizeof(domain);
+    if (getsockopt(fd, SOL_SOCKET, SO_DOMAIN, &domain, &len) < 0)
+        return false;
+    len = sizeof(type);
+    if (getsockopt(fd, SOL_SOCKET, SO_TYPE, &type, &len) < 0)
+        return false;
+    len = sizeof(listening);
+    if (getsockopt(fd, SOL_SOCKET, SO_ACCEPTCONN, &listening, &len) < 0)
+        return false;
+    return domain == AF_UNIX && type == SOCK_STREAM && listening;
+}
+
+int control_inherited(void)
+{
+    const char *pid = getenv("LISTEN_PID");
+    const char *fds = getenv("LISTEN_FDS");
+    if (!pid || !fds || strtol(pid, NULL, 10) != (long)getpid())
+        return -1;
+
+    long n = strtol(fds, NULL, 10);
+    unsetenv("LISTEN_PID");
+    unsetenv("LISTEN_FDS");
+    unsetenv("LISTEN_FDNAMES");
+    if (n < 1)
+        return -1;
+    if (n > 1)
+        fprintf(stderr, "%ld Sockets geerbt, verwende nur den ersten\n", n);
+
+    /* Falsch konfigurierte .socket-Unit (Datagram, TCP, ...) ablehnen */
+    int fd = LISTEN_FDS_START;
+    if (!is_unix_listener(fd)) {
+        fprintf(stderr, "LISTEN_FDS: fd %d ist kein lauschender "
+                        "Unix-Stream-Socket\n", fd);
+        return -1;
+    }
+
+    /* Geerbte fds tragen weder O_NONBLOCK noch FD_CLOEXEC */
+    int fl = fcntl(fd, F_GETFL);
+    if (fl < 0 || fcntl(fd, F_SETFL, fl | O_NONBLOCK) < 0 ||
+        fcntl(fd, F_SETFD, FD_CLOEXEC) < 0) {
+        perror("LISTEN_FDS");
+        return -1;
+    }
+    return fd;
+}
+
+int control_accept(int listen_fd)
+{
+    int client = accept4(listen_fd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+    if (client < 0 && errno != EAGAIN && errno != EWOULDBLOCK &&
+        errno != EINTR)
+        perror("accept4");
+    return client;
+}
+
+ControlCommand control_read(ControlClient *c)
+{
+    /* Lesen, bis die Zeile vollständig ist oder nichts mehr ansteht */
+    while (!memchr(c->line, '\n', c->len) && c->len < sizeof(c->line) - 1) {
+        ssize_t n = read(c->fd, c->line + c->len, sizeof(c->line) - 1 - c->len);
+        if (n > 0) {
+            c->len += (size_t)n;
+            continue;
+        }
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+            return CONTROL_PENDING;
+        break;      /* EOF oder Fehler: gelesene Zeile gilt */
+    }
+    c->line[c->len] = '\0';
+    c->line[strcspn(c->line, "\r\n")] = '\0';
+
+    ControlCommand cmd = CONTROL_INVALID;
+    if (strcmp(c->line, "show") == 0)
+        cmd = CONTROL_SHOW;
+    else if (strcmp(c->line, "hide") == 0)
+        cmd = CONTROL_HIDE;
+    else if (strcmp(c->line, "quit") == 0)
+        cmd = CONTROL_QUIT;
+
+    const char *reply = cmd == CONTROL_INVALID ? "unbekannt\n" : "ok\n";
+    if (send(c->fd, reply, strlen(reply), MSG_DONTWAIT | MSG_NOSIGNAL) < 0)
+        perror("send");
+    return cmd;
+}
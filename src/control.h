@@ -0,0 +1,73 @@
+/*
+ * control.h — Steuersocket für das Auslösen von außen
+ *
+ * Über einen Unix-Socket nimmt blkout je Verbindung eine Befehlszeile
+ * entgegen und beantwortet sie mit "ok" oder "unbekannt":
+ *
+ *   show   Overlay anzeigen
+ *   hide   Overlay entfernen
+ *   quit   blkout beenden
+ *
+ * z.B. per "echo show | socat - UNIX-CONNECT:<pfad>". Verbindungen sind
+ * nicht blockierend und hängen als eigene Quellen in der Hauptschleife,
+ * bis ihre Zeile vollständig ist; ein langsamer oder schweigender Client
+ * hält blkout nicht auf. Der Socket wird
+ * entweder mit --control-socket selbst angelegt oder nach der LISTEN_FDS-
+ * Konvention von systemd geerbt (Socket-Aktivierung): Dann startet die
+ * erste Verbindung blkout bei Bedarf, und blkout kann sich nach einer
+ * Ruhezeit wieder beenden (--exit-idle).
+ */
+
+#ifndef BLKOUT_CONTROL_H
+#define BLKOUT_CONTROL_H
+
+#include <stddef.h>
+
+/* Gleichzeitig offene Verbindungen; eine weitere verdrängt die älteste */
+#define CONTROL_MAX_CLIENTS 4
+
+typedef enum {
+    CONTROL_PENDING,    /* Zeile noch unvollständig, weiter warten */
+    CONTROL_INVALID,    /* Unbekannter Befehl oder Lesefehler */
+    CONTROL_SHOW,
+    CONTROL_HIDE,
+    CONTROL_QUIT,
+} ControlCommand;
+
+/* Angenommene Verbindung und ihre bisher gelesene Befehlszeile */
+typedef struct {
+    int    fd;
+    char   line[32];
+    size_t len;
+} ControlClient;
+
+/*
+ * Unix-Socket anlegen und lauschen. Ein vorhandener Socket an path (von
+ * einer früheren Instanz) wird ersetzt, jede andere Datei nicht. Gibt den
+ * fd zurück, -1 bei Fehler.
+ */
+int control_listen(const char *path);
+
+/*
+ * Geerbten lauschenden Socket übernehmen (LISTEN_PID/LISTEN_FDS). Gibt
+ * den nicht blockierenden fd zurück, -1 ohne Socket-Aktivierung oder wenn
+ * fd 3 kein lauschender AF_UNIX-Stream-Socket ist. Die Variablen werden
+ * entfernt, damit Kindprozesse sie nicht übernehmen.
+ */
+int control_inherited(void);
+
+/*
+ * Eine wartende Verbindung nicht blockierend annehmen. Gibt ihren fd
+ * zurück, -1 wenn keine wartet.
+ */
+int control_accept(int listen_fd);
+
+/*
+ * Client lesbar: lesen, was bereits da ist. Solange die Zeile weder mit
+ * '\n' abgeschlossen noch durch EOF beendet ist, CONTROL_PENDING; sonst
+ * wird sie beantwortet und der Befehl geliefert. Schließen muss der
+ * Aufrufer (nach dem Austragen aus der Hauptschleife).
+ */
+ControlCommand control_read(ControlClient *c);
+
+#endif
@@ -0,0 +1,322 @@
+/*
+ * evdev.c — Inaktivitätserkennung über /dev/input (ohne ext-idle-notify)
+ *
+ * Siehe evdev.h. Zustände:
+ *
+ *   aktiv    Frist läuft. Ein Gerät, das sich meldet, setzt nur die letzte
+ *            Aktivität und bleibt bis zum Ablauf der Frist stumm geschaltet
+ *            (EPOLLONESHOT). Bei Ablauf: Puffer aller Geräte leeren, alle
+ *            wieder scharf schalten, jüngsten Zeitstempel bestimmen und
+ *            entweder die Frist neu stellen oder idled melden.
+ *   idle     Kein Timer. Das erste Ereignis eines Geräts meldet resumed und
+ *            startet eine neue Frist.
+ */
+
+#define _GNU_SOURCE
+
+#include "evdev.h"
+
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <linux/input.h>
+#include <sys/epoll.h>
+#include <sys/inotify.h>
+#include <sys/ioctl.h>
+#include <sys/stat.h>
+#include <sys/timerfd.h>
+
+#include "clock.h"
+
+/* Nur Ereignisknoten, nicht mouse0, js0, by-id/ usw. */
+static bool is_event_node(const char *name)
+{
+    return strncmp(name, "event", 5) == 0 && name[5] >= '0' && name[5] <= '9';
+}
+
+static void arm_device(EvdevIdle *ev, const EvdevDevice *d, int op)
+{
+    struct epoll_event e = {
+        .events  = EPOLLIN | EPOLLONESHOT,
+        .data.fd = d->fd,
+    };
+    epoll_ctl(ev->epoll_fd, op, d->fd, &e);
+}
+
+static void add_device(EvdevIdle *ev, const char *name)
+{
+    if (!is_event_node(name) || strlen(name) >= sizeof(ev->devices[0].name))
+        return;
+    for (int i = 0; i < ev->ndevices; i++)
+        if (strcmp(ev->devices[i].name, name) == 0)
+            return;
+    if (ev->ndevices >= EVDEV_MAX_DEVICES) {
+        fprintf(stderr, "Zu viele Eingabegeräte, ignoriere %s\n", name);
+        return;
+    }
+
+    char path[512];
+    snprintf(path, sizeof(path), "%s/%s", ev->dir, name);
+    /* Ohne Leserecht bleibt das Gerät außen vor; udev setzt es ggf. später */
+    int fd = open(path, O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+    if (fd < 0)
+        return;
+
+    EvdevDevice *d = &ev->devices[ev->ndevices++];
+    d->fd = fd;
+    d->npartial = 0;
+    snprintf(d->name, sizeof(d->name), "%s", name);
+
+    /*
+     * Echte Geräte auf CLOCK_MONOTONIC umstellen. FIFOs stammen von
+     * tools/evdev-replay, das seine Zeitstempel bereits so schreibt.
+     */
+    struct stat st;
+    int clk = CLOCK_MONOTONIC;
+    d->monotonic = (fstat(fd, &st) == 0 && S_ISFIFO(st.st_mode)) ||
+                   ioctl(fd, EVIOCSCLOCKID, &clk) == 0;
+    arm_device(ev, d, EPOLL_CTL_ADD);
+}
+
+static void remove_device(EvdevIdle *ev, int i)
+{
+    epoll_ctl(ev->epoll_fd, EPOLL_CTL_DEL, ev->devices[i].fd, NULL);
+    close(ev->devices[i].fd);
+    ev->devices[i] = ev->devices[--ev->ndevices];
+}
+
+static int find_device(const EvdevIdle *ev, int fd)
+{
+    for (int i = 0; i < ev->ndevices; i++)
+        if (ev->devices[i].fd == fd)
+            return i;
+    return -1;
+}
+
+/*
+ * Gepufferte Ereignisse verwerfen, dabei den jüngsten Zeitstempel nach
+ * *latest übernehmen. Gibt false zurück, wenn das Gerät verschwunden ist.
+ */
+static bool drain_device(EvdevDevice *d, uint64_t *latest)
+{
+    struct input_event buf[64];
+    uint8_t *bytes = (uint8_t *)buf;
+    ssize_t n;
+
+    _Static_assert(sizeof(struct input_event) <= EVDEV_PARTIAL_MAX,
+                   "EVDEV_PARTIAL_MAX zu klein");
+
+    /* Rest eines angefangenen Ereignisses vor die neuen Bytes stellen */
+    memcpy(bytes, d->partial, d->npartial);
+    while ((n = read(d->fd, bytes + d->npartial,
+                     sizeof(buf) - d->npartial)) > 0) {
+        size_t total    = d->npartial + (size_t)n;
+        size_t complete = total / sizeof(buf[0]);
+
+        /* Ohne monotone Zeitstempel gilt der Lesezeitpunkt */
+        uint64_t t = monotonic_ns();
+        if (d->monotonic) {
+            /* Nur Bruchstück gelesen: Zeitstempel kommt mit dem Rest */
+            t = 0;
+            if (complete > 0) {
+                const struct input_event *last = &buf[complete - 1];
+                t = (uint64_t)last->input_event_sec * 1000000000ull +
+                    (uint64_t)last->input_event_usec * 1000;
+            }
+        }
+        if (t > *latest)
+            *latest = t;
+
+        d->npartial = total - complete * sizeof(buf[0]);
+        memmove(bytes, bytes + complete * sizeof(buf[0]), d->npartial);
+    }
+    memcpy(d->partial, bytes, d->npartial);
+    /* n == 0: FIFO ohne Schreiber, das ist kein Fehler */
+    return n == 0 || errno == EAGAIN || errno == EINTR;
+}
+
+static void set_deadline(EvdevIdle *ev, uint64_t at_ns)
+{
+    struct itimerspec its = {
+        .it_value = {
+            .tv_sec  = (time_t)(at_ns / 1000000000ull),
+            .tv_nsec = (long)(at_ns % 1000000000ull),
+        },
+    };
+    timerfd_settime(ev->timer_fd, TFD_TIMER_ABSTIME, &its, NULL);
+}
+
+/* Puffer aller Geräte leeren und alle wieder scharf schalten */
+static void rearm_devices(EvdevIdle *ev, uint64_t *latest)
+{
+    for (int i = 0; i < ev->ndevices; ) {
+        if (!drain_device(&ev->devices[i], latest)) {
+            remove_device(ev, i);
+            continue;
+        }
+        arm_device(ev, &ev->devices[i], EPOLL_CTL_MOD);
+        i++;
+    }
+}
+
+/* Frist abgelaufen: tatsächliche letzte Aktivität bestimmen */
+static EvdevIdleEvent check_deadline(EvdevIdle *ev)
+{
+    uint64_t latest = ev->last_ns;
+    rearm_devices(ev, &latest);
+
+    uint64_t now = monotonic_ns();
+    if (latest > now)
+        latest = now;
+    ev->last_ns = latest;
+
+    if (now - latest >= ev->timeout_ns) {
+        ev->idle = true;
+        return EVDEV_IDLE_IDLED;
+    }
+    set_deadline(ev, latest + ev->timeout_ns);
+    return EVDEV_IDLE_NONE;
+}
+
+/* Angesteckte, freigegebene und entfernte Geräte */
+static void handle_hotplug(EvdevIdle *ev)
+{
+    char buf[4096] __attribute__((aligned(__alignof__(struct inotify_event))));
+    ssize_t n;
+
+    while ((n = read(ev->inotify_fd, buf, sizeof(buf))) > 0) {
+        for (char *p = buf; p < buf + n; ) {
+            const struct inotify_event *ie = (const struct inotify_event *)p;
+            p += sizeof(struct inotify_event) + ie->len;
+            if (ie->len == 0)
+                continue;
+            if (ie->mask & IN_DELETE) {
+                for (int i = 0; i < ev->ndevices; i++)
+                    if (strcmp(ev->devices[i].name, ie->name) == 0) {
+                        remove_device(ev, i);
+                        break;
+                    }
+            } else {
+                add_device(ev, ie->name);
+            }
+        }
+    }
+}
+
+bool evdev_idle_open(EvdevIdle *ev, const char *dir, int timeout_ms)
+{
+    memset(ev, 0, sizeof(*ev));
+    ev->dir        = dir;
+    ev->epoll_fd   = epoll_create1(EPOLL_CLOEXEC);
+    ev->timer_fd   = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    ev->inotify_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (ev->epoll_fd < 0 || ev->timer_fd < 0 || ev->inotify_fd < 0) {
+        perror("evdev");
+        evdev_idle_close(ev);
+        return false;
+    }
+
+    struct epoll_event e = { .events = EPOLLIN, .data.fd = ev->timer_fd };
+    epoll_ctl(ev->epoll_fd, EPOLL_CTL_ADD, ev->timer_fd, &e);
+
+    /* IN_ATTRIB: udev legt Knoten an und gibt sie erst danach frei */
+    if (inotify_add_watch(ev->inotify_fd, dir,
+                          IN_CREATE | IN_ATTRIB | IN_DELETE) < 0) {
+        perror(dir);
+        evdev_idle_close(ev);
+        return false;
+    }
+    e = (struct epoll_event){ .events = EPOLLIN, .data.fd = ev->inotify_fd };
+    epoll_ctl(ev->epoll_fd, EPOLL_CTL_ADD, ev->inotify_fd, &e);
+
+    DIR *d = opendir(dir);
+    if (d) {
+        struct dirent *de;
+        while ((de = readdir(d)))
+            add_device(ev, de->d_name);
+        closedir(d);
+    }
+    if (ev->ndevices == 0)
+        fprintf(stderr, "Keine lesbaren Eingabegeräte in %s "
+                        "(Gruppe input?)\n", dir);
+
+    evdev_idle_set_timeout(ev, timeout_ms);
+    return true;
+}
+
+void evdev_idle_close(EvdevIdle *ev)
+{
+    while (ev->ndevices > 0)
+        remove_device(ev, 0);
+    if (ev->inotify_fd >= 0)
+        close(ev->inotify_fd);
+    if (ev->timer_fd >= 0)
+        close(ev->timer_fd);
+    if (ev->epoll_fd >= 0)
+        close(ev->epoll_fd);
+    ev->inotify_fd = ev->timer_fd = ev->epoll_fd = -1;
+}
+
+void evdev_idle_set_timeout(EvdevIdle *ev, int timeout_ms)
+{
+    uint64_t now = monotonic_ns();
+    uint64_t ignored = 0;
+
+    ev->timeout_ns = (uint64_t)timeout_ms * 1000000;
+    ev->last_ns    = now;
+    ev->idle       = false;
+    rearm_devices(ev, &ignored);
+    set_deadline(ev, now + ev->timeout_ns);
+}
+
+EvdevIdleEvent evdev_idle_dispatch(EvdevIdle *ev)
+{
+    struct epoll_event evs[EVDEV_MAX_DEVICES + 2];
+    int n = epoll_wait(ev->epoll_fd, evs, EVDEV_MAX_DEVICES + 2, 0);
+    EvdevIdleEvent result = EVDEV_IDLE_NONE;
+    bool deadline = false;
+
+    /* Erst Eingaben, dann die Frist: Aktivität im selben Durchgang zählt */
+    for (int i = 0; i < n; i++) {
+        int fd = evs[i].data.fd;
+        if (fd == ev->timer_fd) {
+            uint64_t expirations;
+            if (read(fd, &expirations, sizeof(expirations)) > 0)
+                deadline = true;
+            continue;
+        }
+        if (fd == ev->inotify_fd) {
+            handle_hotplug(ev);
+            continue;
+        }
+
+        int idx = find_device(ev, fd);
+        if (idx < 0)
+            continue;
+
+        /* Abgezogen: nur noch gepufferte Ereignisse zählen als Aktivität */
+        if (evs[i].events & (EPOLLHUP | EPOLLERR)) {
+            uint64_t latest = 0;
+            drain_device(&ev->devices[idx], &latest);
+            remove_device(ev, idx);
+            if (latest == 0)
+                continue;
+        }
+
+        uint64_t now = monotonic_ns();
+        ev->last_ns = now;
+        if (ev->idle) {
+            ev->idle = false;
+            set_deadline(ev, now + ev->timeout_ns);
+            result = EVDEV_IDLE_RESUMED;
+        }
+    }
+
+    if (deadline && !ev->idle)
+        result = check_deadline(ev);
+    return result;
+}
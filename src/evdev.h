@@ -0,0 +1,81 @@
+/*
+ * evdev.h — Inaktivitätserkennung über /dev/input (ohne ext-idle-notify)
+ *
+ * Ersatz für ext_idle_notification_v1 auf Compositoren, die das Protokoll
+ * nicht anbieten. Beobachtet alle /dev/input/event*-Geräte und meldet wie
+ * die Notification "idled" nach timeout Millisekunden ohne Eingabe und
+ * "resumed" bei der ersten Eingabe danach. Ausgewertet werden nur die
+ * Zeitstempel der Ereignisse, nie Typ, Code oder Wert.
+ *
+ * Alle Geräte, ein timerfd für die Frist und ein inotify auf das
+ * Verzeichnis (für angesteckte Geräte) liegen in einem epoll-fd, der als
+ * eine einzige Quelle in der Hauptschleife hängt. Geräte sind mit
+ * EPOLLONESHOT eingetragen: Während der Benutzer aktiv ist, weckt jedes
+ * Gerät höchstens einmal pro Frist. Läuft die Frist ab, werden die bis
+ * dahin gepufferten Ereignisse gelesen; ihr jüngster Zeitstempel ergibt die
+ * tatsächliche letzte Aktivität und damit die neue Frist. Der Timer wird
+ * also je Frist einmal gestellt, nicht bei jedem Ereignis.
+ *
+ * Geräte müssen lesbar sein (Gruppe input). Zum Testen ohne Geräte kann
+ * das Verzeichnis FIFOs enthalten, die tools/evdev-replay mit
+ * aufgezeichneten Ereignisströmen füllt.
+ */
+
+#ifndef BLKOUT_EVDEV_H
+#define BLKOUT_EVDEV_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define EVDEV_DEFAULT_DIR  "/dev/input"
+#define EVDEV_MAX_DEVICES  32
+
+/* Platz für ein angefangenes struct input_event (höchstens 24 Byte) */
+#define EVDEV_PARTIAL_MAX 32
+
+typedef struct {
+    int      fd;
+    char     name[16];       /* Dateiname, z.B. "event3" */
+    bool     monotonic;      /* Zeitstempel in CLOCK_MONOTONIC */
+    /*
+     * Angefangenes Ereignis: Ein echtes Gerät liefert nur ganze Ereignisse,
+     * ein FIFO (tools/evdev-replay) auch Bruchstücke. Der Rest wird beim
+     * nächsten Lesen vorangestellt, damit die Ereignisgrenzen stimmen.
+     */
+    uint8_t  partial[EVDEV_PARTIAL_MAX];
+    size_t   npartial;
+} EvdevDevice;
+
+typedef enum {
+    EVDEV_IDLE_NONE,     /* Nichts zu melden */
+    EVDEV_IDLE_IDLED,    /* Frist ohne Eingabe abgelaufen */
+    EVDEV_IDLE_RESUMED,  /* Erste Eingabe nach idled */
+} EvdevIdleEvent;
+
+typedef struct {
+    const char *dir;             /* Beobachtetes Verzeichnis */
+    int         epoll_fd;        /* Quelle für die Hauptschleife, -1 = zu */
+    int         timer_fd;
+    int         inotify_fd;
+    uint64_t    timeout_ns;
+    uint64_t    last_ns;         /* Letzte bekannte Aktivität */
+    bool        idle;            /* idled gemeldet, resumed ausstehend */
+    EvdevDevice devices[EVDEV_MAX_DEVICES];
+    int         ndevices;
+} EvdevIdle;
+
+/*
+ * Verzeichnis öffnen, vorhandene Geräte eintragen und die erste Frist ab
+ * jetzt stellen. Gibt false zurück, wenn nichts beobachtet werden kann.
+ */
+bool evdev_idle_open(EvdevIdle *ev, const char *dir, int timeout_ms);
+void evdev_idle_close(EvdevIdle *ev);
+
+/* Neue Frist setzen; zählt als Aktivität und hebt idled auf */
+void evdev_idle_set_timeout(EvdevIdle *ev, int timeout_ms);
+
+/* epoll_fd lesbar: Geräte, Timer und Hotplug abarbeiten */
+EvdevIdleEvent evdev_idle_dispatch(EvdevIdle *ev);
+
+#endif
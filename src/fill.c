@@ -0,0 +1,345 @@
+/*
+ * fill.c — Rechtecke und ganze Puffer in XRGB8888 füllen
+ *
+ * Siehe fill.h. Je Zeile: einzelne Pixel bis zur 16-Byte-Grenze, dann
+ * ausgerichtete 128-Bit-Speicherbefehle (vier Pixel), der Rest einzeln.
+ * Der Compiler wählt den Befehlssatz über die vordefinierten Makros; auf
+ * x86-64 ist SSE2 immer vorhanden.
+ *
+ * fill_buffer() schreibt Läufe aus zwei abwechselnden Pixeln (bei Vollfarbe
+ * zweimal dieselbe), auf x86-64 mit AVX2 zu acht Pixeln, falls
+ * __builtin_cpu_supports() es meldet. Große Puffer liest blkout danach nie
+ * wieder, nur der Compositor: Sie werden an den Caches vorbei geschrieben
+ * (non-temporal) und zeilenweise auf bis zu FILL_MAX_THREADS Threads
+ * verteilt, die auch die Seitenfehler des frischen memfd parallel abwickeln.
+ *
+ * FillAsync legt den memfd selbst an und füllt ihn in einem eigenen Thread
+ * über fill_buffer(); das Ergebnis übernimmt die Hauptschleife nach dem
+ * eventfd-Signal. Mapping und Thread gehören allein dem Hintergrund.
+ */
+
+#define _GNU_SOURCE
+
+#include "fill.h"
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#include <immintrin.h>
+#define FILL_AVX2 1
+#endif
+
+/* Ab dieser Puffergröße: Threads und Schreiben an den Caches vorbei */
+#define FILL_LARGE_BYTES   (8u << 20)
+/* Mindestanteil je Thread, darunter lohnt das Starten nicht */
+#define FILL_CHUNK_BYTES   (2u << 20)
+#define FILL_MAX_THREADS   8
+
+/* Eine Zeile von n Pixeln ab p füllen */
+static inline void fill_row(uint32_t *p, int n, uint32_t color)
+{
+#if defined(__SSE2__) || defined(__ARM_NEON)
+    while (n > 0 && ((uintptr_t)p & 15)) {
+        *p++ = color;
+        n--;
+    }
+#if defined(__SSE2__)
+    __m128i v = _mm_set1_epi32((int)color);
+    for (; n >= 4; n -= 4, p += 4)
+        _mm_store_si128((__m128i *)p, v);
+#else
+    uint32x4_t v = vdupq_n_u32(color);
+    for (; n >= 4; n -= 4, p += 4)
+        vst1q_u32(p, v);
+#endif
+#endif
+    while (n-- > 0)
+        *p++ = color;
+}
+
+void fill_rect(uint32_t *pixels, int stride, int x, int y, int w, int h,
+               uint32_t color)
+{
+    uint32_t *row = pixels + (size_t)y * (size_t)stride + (size_t)x;
+    for (int r = 0; r < h; r++, row += stride)
+        fill_row(row, w, color);
+}
+
+/* =========================================================================
+ * Läufe aus zwei abwechselnden Pixeln
+ * =========================================================================
+ * Pixel 0, 2, 4, ... erhalten a, die übrigen b. Bis zur Ausrichtung wird
+ * einzeln geschrieben; danach liegt a wieder auf einem geraden Pixel oder
+ * a und b sind vertauscht.
+ */
+typedef void (*SpanFn)(uint32_t *p, size_t n, uint32_t a, uint32_t b,
+                       bool stream);
+
+static void span_generic(uint32_t *p, size_t n, uint32_t a, uint32_t b,
+                         bool stream)
+{
+    (void)stream;
+#if defined(__SSE2__) || defined(__ARM_NEON)
+    while (n > 0 && ((uintptr_t)p & 15)) {
+        uint32_t t = a;
+        *p++ = a;
+        a = b;
+        b = t;
+        n--;
+    }
+#if defined(__SSE2__)
+    __m128i v = _mm_set_epi32((int)b, (int)a, (int)b, (int)a);
+    if (stream) {
+        for (; n >= 4; n -= 4, p += 4)
+            _mm_stream_si128((__m128i *)p, v);
+        _mm_sfence();
+    } else {
+        for (; n >= 4; n -= 4, p += 4)
+            _mm_store_si128((__m128i *)p, v);
+    }
+#else
+    const uint32_t pair[4] = { a, b, a, b };
+    uint32x4_t v = vld1q_u32(pair);
+    for (; n >= 4; n -= 4, p += 4)
+        vst1q_u32(p, v);
+#endif
+#endif
+    for (size_t i = 0; i < n; i++)
+        p[i] = (i & 1) ? b : a;
+}
+
+#ifdef FILL_AVX2
+__attribute__((target("avx2")))
+static void span_avx2(uint32_t *p, size_t n, uint32_t a, uint32_t b,
+                      bool stream)
+{
+    while (n > 0 && ((uintptr_t)p & 31)) {
+        uint32_t t = a;
+        *p++ = a;
+        a = b;
+        b = t;
+        n--;
+    }
+    __m256i v = _mm256_set_epi32((int)b, (int)a, (int)b, (int)a,
+                                 (int)b, (int)a, (int)b, (int)a);
+    if (stream) {
+        for (; n >= 8; n -= 8, p += 8)
+            _mm256_stream_si256((__m256i *)p, v);
+        _mm_sfence();
+    } else {
+        for (; n >= 8; n -= 8, p += 8)
+            _mm256_store_si256((__m256i *)p, v);
+    }
+    for (size_t i = 0; i < n; i++)
+        p[i] = (i & 1) ? b : a;
+}
+#endif
+
+/* Einmal je Prozess: AVX2, wenn die CPU es kann */
+static SpanFn span;
+static pthread_once_t span_once = PTHREAD_ONCE_INIT;
+
+static void select_span(void)
+{
+    span = span_generic;
+#ifdef FILL_AVX2
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+        span = span_avx2;
+#endif
+}
+
+/* =========================================================================
+ * Ganze Puffer, auf Threads verteilt
+ * ========================================================================= */
+
+typedef struct {
+    SpanFn    span;
+    uint32_t *pixels;
+    int       width;
+    int       y0, y1;     /* Zeilen [y0, y1) */
+    uint32_t  color;
+    Pattern   pattern;
+    bool      stream;
+} FillJob;
+
+static void *fill_job(void *data)
+{
+    const FillJob *j = data;
+    uint32_t *row = j->pixels + (size_t)j->y0 * (size_t)j->width;
+
+    /* Vollfarbe: der ganze Bereich ist ein einziger Lauf */
+    if (j->pattern == PATTERN_SOLID) {
+        j->span(row, (size_t)(j->y1 - j->y0) * (size_t)j->width,
+                j->color, j->color, j->stream);
+        return NULL;
+    }
+
+    for (int y = j->y0; y < j->y1; y++, row += j->width) {
+        bool even = (y & 1) == 0;
+        if (j->pattern == PATTERN_LINES)
+            j->span(row, (size_t)j->width, even ? j->color : 0,
+                    even ? j->color : 0, j->stream);
+        else
+            j->span(row, (size_t)j->width, even ? j->color : 0,
+                    even ? 0 : j->color, j->stream);
+    }
+    return NULL;
+}
+
+/* Threads für bytes Bytes: je mindestens FILL_CHUNK_BYTES, höchstens CPUs */
+static int fill_threads(size_t bytes)
+{
+    if (bytes < FILL_LARGE_BYTES)
+        return 1;
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    size_t n = bytes / FILL_CHUNK_BYTES;
+    if (cpus > 0 && n > (size_t)cpus)
+        n = (size_t)cpus;
+    if (n > FILL_MAX_THREADS)
+        n = FILL_MAX_THREADS;
+    return n > 0 ? (int)n : 1;
+}
+
+void fill_buffer(uint32_t *pixels, int width, int height, uint32_t color,
+                 Pattern pattern)
+{
+    /* Auch aus dem Hintergrund-Thread von FillAsync aufgerufen */
+    pthread_once(&span_once, select_span);
+
+    size_t bytes = (size_t)width * (size_t)height * 4;
+    int nthreads = fill_threads(bytes);
+    if (nthreads > height)
+        nthreads = height > 0 ? height : 1;
+
+    FillJob   jobs[FILL_MAX_THREADS];
+    pthread_t threads[FILL_MAX_THREADS];
+    bool      started[FILL_MAX_THREADS] = { false };
+
+    for (int i = 0; i < nthreads; i++)
+        jobs[i] = (FillJob){
+            .span    = span,
+            .pixels  = pixels,
+            .width   = width,
+            .y0      = (int)((long)height * i / nthreads),
+            .y1      = (int)((long)height * (i + 1) / nthreads),
+            .color   = color,
+            .pattern = pattern,
+            .stream  = bytes >= FILL_LARGE_BYTES,
+        };
+
+    /* Anteil 0 übernimmt der aufrufende Thread; scheitert ein Start, auch */
+    for (int i = 1; i < nthreads; i++)
+        started[i] = pthread_create(&threads[i], NULL, fill_job,
+                                    &jobs[i]) == 0;
+    fill_job(&jobs[0]);
+    for (int i = 1; i < nthreads; i++) {
+        if (started[i])
+            pthread_join(threads[i], NULL);
+        else
+            fill_job(&jobs[i]);
+    }
+}
+
+/* =========================================================================
+ * Füllen im Hintergrund
+ * ========================================================================= */
+
+static void *fill_async_job(void *data)
+{
+    FillAsync *a = data;
+    size_t size = (size_t)a->width * (size_t)a->height * 4;
+
+    int fd = memfd_create("blkout-shm", MFD_CLOEXEC);
+    if (fd >= 0 && ftruncate(fd, (off_t)size) == 0) {
+        void *p = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (p != MAP_FAILED) {
+            fill_buffer(p, a->width, a->height, a->color, a->pattern);
+            munmap(p, size);
+            a->fd = fd;
+            fd = -1;
+        }
+    }
+    if (fd >= 0)
+        close(fd);
+
+    uint64_t one = 1;
+    if (write(a->done_fd, &one, sizeof(one)) < 0)
+        perror("eventfd");
+    return NULL;
+}
+
+bool fill_async_init(FillAsync *a)
+{
+    *a = (FillAsync){ .done_fd = -1, .fd = -1 };
+    a->done_fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (a->done_fd < 0) {
+        perror("eventfd");
+        return false;
+    }
+    return true;
+}
+
+bool fill_async_start(FillAsync *a, int width, int height, uint32_t color,
+                      Pattern pattern)
+{
+    if (a->busy || a->done_fd < 0 || width <= 0 || height <= 0)
+        return false;
+    a->fd      = -1;
+    a->width   = width;
+    a->height  = height;
+    a->color   = color;
+    a->pattern = pattern;
+    if (pthread_create(&a->thread, NULL, fill_async_job, a) != 0)
+        return false;
+    a->busy = true;
+    return true;
+}
+
+int fill_async_finish(FillAsync *a)
+{
+    uint64_t n;
+    if (!a->busy || read(a->done_fd, &n, sizeof(n)) < 0)
+        return -1;
+    return fill_async_wait(a);
+}
+
+int fill_async_wait(FillAsync *a)
+{
+    if (!a->busy)
+        return -1;
+    pthread_join(a->thread, NULL);
+    a->busy = false;
+
+    /* Signal verbrauchen, damit die Hauptschleife nicht erneut aufwacht */
+    uint64_t n;
+    if (read(a->done_fd, &n, sizeof(n)) < 0 && errno != EAGAIN)
+        perror("eventfd");
+    int fd = a->fd;
+    a->fd = -1;
+    return fd;
+}
+
+void fill_async_close(FillAsync *a)
+{
+    int fd = fill_async_wait(a);
+    if (fd >= 0)
+        close(fd);
+    if (a->done_fd >= 0) {
+        close(a->done_fd);
+        a->done_fd = -1;
+    }
+}
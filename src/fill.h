@@ -0,0 +1,76 @@
+/*
+ * fill.h — Rechtecke und ganze Puffer in XRGB8888 füllen
+ *
+ * Grundlage des Inhaltsmodus (--content): Ziffern, Marke und das Löschen
+ * der vorigen Position bestehen nur aus einfarbigen Rechtecken. Gefüllt
+ * wird zeilenweise mit 128-Bit-Speicherbefehlen (SSE2 bzw. NEON) statt
+ * Pixel für Pixel; ohne beide bleibt die einfache Schleife.
+ *
+ * Farbige Overlays (--color, --pattern) füllen den ganzen Vollbild-Puffer.
+ * fill_buffer() wählt dafür zur Laufzeit AVX2, sofern die CPU es kann, und
+ * verteilt große Puffer auf mehrere Threads: Bei 8K sind es 130 MB, deren
+ * Seiten beim ersten Schreiben erst angelegt werden. Selbst so dauert das
+ * über 100 ms; FillAsync erledigt es deshalb vorab in einem eigenen Thread,
+ * außerhalb des Anzeigepfads.
+ */
+
+#ifndef BLKOUT_FILL_H
+#define BLKOUT_FILL_H
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Muster des Overlays (--pattern) */
+typedef enum {
+    PATTERN_SOLID,    /* Jedes Pixel in der Farbe */
+    PATTERN_LINES,    /* Jede zweite Zeile, dazwischen Schwarz */
+    PATTERN_CHECKER,  /* Schachbrett aus Einzelpixeln, dazwischen Schwarz */
+} Pattern;
+
+/*
+ * Rechteck x, y, w, h in einem Puffer mit stride Pixeln je Zeile auf color
+ * setzen. Das Rechteck muss vollständig im Puffer liegen.
+ */
+void fill_rect(uint32_t *pixels, int stride, int x, int y, int w, int h,
+               uint32_t color);
+
+/*
+ * Dicht gepackten Puffer aus width x height Pixeln mit color im Muster
+ * pattern füllen. Kehrt erst zurück, wenn alle Threads fertig sind.
+ */
+void fill_buffer(uint32_t *pixels, int width, int height, uint32_t color,
+                 Pattern pattern);
+
+/*
+ * Einen frischen memfd im Hintergrund füllen. done_fd (eventfd) wird
+ * lesbar, sobald der Thread fertig ist; dann liefert fill_async_finish()
+ * den memfd. Es läuft höchstens eine Füllung zugleich.
+ */
+typedef struct {
+    pthread_t thread;
+    bool      busy;       /* Thread gestartet, noch nicht abgeholt */
+    int       done_fd;    /* eventfd, -1 = nicht angelegt */
+    int       fd;         /* Ergebnis: memfd mit Pixeln, -1 = fehlgeschlagen */
+    int       width, height;
+    uint32_t  color;
+    Pattern   pattern;
+} FillAsync;
+
+/* done_fd anlegen; false bei Fehler */
+bool fill_async_init(FillAsync *a);
+
+/* Füllung starten; false, wenn schon eine läuft oder der Start scheitert */
+bool fill_async_start(FillAsync *a, int width, int height, uint32_t color,
+                      Pattern pattern);
+
+/* Nach done_fd: Thread abholen, memfd zurückgeben (-1 = fehlgeschlagen) */
+int fill_async_finish(FillAsync *a);
+
+/* Auf die laufende Füllung warten und ihren memfd zurückgeben */
+int fill_async_wait(FillAsync *a);
+
+/* Laufende Füllung abwarten und verwerfen, done_fd schließen */
+void fill_async_close(FillAsync *a);
+
+#endif
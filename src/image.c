@@ -0,0 +1,132 @@
+/*
+ * image.c — Vorab umgewandeltes Standbild für das Overlay (--image)
+ *
+ * Siehe image.h. Die Datei selbst wird nicht an den Compositor gereicht:
+ * wl_shm bildet Pools beschreibbar ab, was eine schreibbar geöffnete Datei
+ * voraussetzte, und eine später gekürzte Datei ließe den Compositor beim
+ * Lesen auf SIGBUS laufen. Die einmalige Kopie in einen memfd, dessen
+ * Größe versiegelt ist, vermeidet beides.
+ */
+
+#define _GNU_SOURCE
+
+#include "image.h"
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/sendfile.h>
+#include <sys/stat.h>
+
+/* wl_shm-Formate, die jeder Compositor unterstützen muss */
+#define SHM_FORMAT_ARGB8888 0
+#define SHM_FORMAT_XRGB8888 1
+
+/* Kopf prüfen; meldet Fehler mit Dateinamen */
+static bool check_header(const ImageHeader *h, size_t file_size,
+                         const char *path)
+{
+    if (memcmp(h->magic, IMAGE_MAGIC, sizeof(h->magic)) != 0) {
+        fprintf(stderr, "%s: kein blkout-Bild (tools/png2blk)\n", path);
+        return false;
+    }
+    if (h->width == 0 || h->height == 0 ||
+        h->width > IMAGE_MAX_SIDE || h->height > IMAGE_MAX_SIDE ||
+        h->stride < h->width * 4) {
+        fprintf(stderr, "%s: ungültige Abmessungen %ux%u, stride %u\n",
+                path, h->width, h->height, h->stride);
+        return false;
+    }
+    if (h->format != SHM_FORMAT_ARGB8888 && h->format != SHM_FORMAT_XRGB8888) {
+        fprintf(stderr, "%s: Format %u nicht unterstützt "
+                        "(nur ARGB8888, XRGB8888)\n", path, h->format);
+        return false;
+    }
+    if (h->offset < sizeof(*h) ||
+        (uint64_t)h->offset + (uint64_t)h->stride * h->height > file_size) {
+        fprintf(stderr, "%s: Datei zu kurz für %ux%u\n",
+                path, h->width, h->height);
+        return false;
+    }
+    return true;
+}
+
+bool image_load(Image *img, const char *path)
+{
+    img->fd = -1;
+
+    int src = open(path, O_RDONLY | O_CLOEXEC);
+    if (src < 0) {
+        perror(path);
+        return false;
+    }
+
+    struct stat st;
+    ImageHeader h;
+    ssize_t n = fstat(src, &st) < 0 ? -1 : pread(src, &h, sizeof(h), 0);
+    if (n != (ssize_t)sizeof(h)) {
+        if (n < 0)
+            perror(path);
+        else
+            fprintf(stderr, "%s: kein blkout-Bild (tools/png2blk)\n", path);
+        close(src);
+        return false;
+    }
+    if (!check_header(&h, (size_t)st.st_size, path)) {
+        close(src);
+        return false;
+    }
+    size_t size = (size_t)h.offset + (size_t)h.stride * h.height;
+
+    int fd = memfd_create("blkout-image", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+    if (fd < 0 || ftruncate(fd, (off_t)size) < 0) {
+        perror("memfd_create");
+        if (fd >= 0)
+            close(fd);
+        close(src);
+        return false;
+    }
+
+    /* Einmal im Kern kopieren, ohne Umweg über einen Puffer in blkout */
+    off_t  off  = 0;
+    size_t left = size;
+    while (left > 0) {
+        ssize_t n = sendfile(fd, src, &off, left);
+        if (n <= 0) {
+            perror(path);
+            close(fd);
+            close(src);
+            return false;
+        }
+        left -= (size_t)n;
+    }
+    close(src);
+
+    /*
+     * Größe festschreiben: Der Compositor braucht dann keinen SIGBUS-
+     * Schutz für diesen Pool. F_SEAL_WRITE geht nicht, weil wl_shm den
+     * Pool beschreibbar abbildet.
+     */
+    if (fcntl(fd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_SEAL) < 0)
+        perror("F_ADD_SEALS");
+
+    *img = (Image){
+        .fd     = fd,
+        .size   = size,
+        .width  = (int)h.width,
+        .height = (int)h.height,
+        .stride = (int)h.stride,
+        .format = h.format,
+        .offset = h.offset,
+    };
+    return true;
+}
+
+void image_close(Image *img)
+{
+    if (img->fd >= 0)
+        close(img->fd);
+    img->fd = -1;
+}
@@ -0,0 +1,56 @@
+/*
+ * image.h — Vorab umgewandeltes Standbild für das Overlay (--image)
+ *
+ * Statt Schwarz zeigt das Overlay ein festes Bild, etwa ein Firmenlogo auf
+ * Kiosk-Geräten. blkout dekodiert dafür nichts: Die Datei enthält die
+ * Pixel bereits im wl_shm-Format hinter einem kleinen Kopf und wird beim
+ * Start einmal in einen versiegelten memfd kopiert. Jedes Anzeigen legt
+ * nur Pool und wl_buffer auf diesem memfd an — ohne Kopie, ohne Füllen.
+ * Erzeugt wird die Datei offline mit tools/png2blk.
+ *
+ * Dateiformat (Ganzzahlen little-endian):
+ *
+ *   0   magic   "BLKIMG1\n"
+ *   8   width   Breite in Pixeln
+ *   12  height  Höhe in Pixeln
+ *   16  stride  Bytes je Zeile
+ *   20  format  wl_shm-Format (0 = ARGB8888, 1 = XRGB8888)
+ *   24  offset  Beginn der Pixel ab Dateianfang
+ *   28  (reserviert, 0)
+ */
+
+#ifndef BLKOUT_IMAGE_H
+#define BLKOUT_IMAGE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define IMAGE_MAGIC      "BLKIMG1\n"
+#define IMAGE_MAX_SIDE   16384
+
+typedef struct {
+    char     magic[8];
+    uint32_t width;
+    uint32_t height;
+    uint32_t stride;
+    uint32_t format;
+    uint32_t offset;
+    uint32_t reserved;
+} ImageHeader;
+
+typedef struct {
+    int      fd;        /* Versiegelter memfd mit der ganzen Datei, -1 = keins */
+    size_t   size;      /* Größe des memfd (Pool) */
+    int      width;
+    int      height;
+    int      stride;
+    uint32_t format;
+    uint32_t offset;
+} Image;
+
+/* Datei prüfen und in einen versiegelten memfd kopieren */
+bool image_load(Image *img, const char *path);
+void image_close(Image *img);
+
+#endif
@@ -0,0 +1,255 @@
+/*
+ * journal.c — Dauerhaftes Protokoll der Übergänge als Ringdatei
+ *
+ * Siehe journal.h. Ein Eintrag wird erst mit seiner Nummer gültig: Vor dem
+ * Füllen wird seq auf 0 gesetzt, danach per Release-Store auf die neue
+ * Nummer. Bricht blkout dazwischen ab, überspringt journal_dump() den
+ * halben Eintrag. Die Datei wird beim Anlegen vollständig belegt, damit ein
+ * Schreibzugriff später nicht an voller Platte scheitert (SIGBUS). Der Kopf
+ * folgt erst danach; eine belegte Datei mit leerem Kopf (Abbruch dazwischen)
+ * gilt deshalb wie eine leere als neu.
+ */
+
+#define _GNU_SOURCE
+
+#include "journal.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "clock.h"
+
+JournalHeader *journal_header;
+
+static JournalRecord *journal_records;
+static size_t         journal_size;    /* Länge der Einblendung */
+static int            journal_fd = -1;
+
+static const char *const type_names[JOURNAL_TYPE_COUNT] = {
+    [JOURNAL_START]     = "start",
+    [JOURNAL_ARM]       = "arm",
+    [JOURNAL_IDLED]     = "idled",
+    [JOURNAL_SHOW]      = "show",
+    [JOURNAL_PRESENTED] = "presented",
+    [JOURNAL_WAKE]      = "wake",
+    [JOURNAL_HIDE]      = "hide",
+};
+
+static const char *const source_names[JOURNAL_SOURCE_COUNT] = {
+    [JOURNAL_SOURCE_NONE]     = "none",
+    [JOURNAL_SOURCE_KEYBOARD] = "keyboard",
+    [JOURNAL_SOURCE_POINTER]  = "pointer",
+    [JOURNAL_SOURCE_RESUMED]  = "resumed",
+    [JOURNAL_SOURCE_CONTROL]  = "control",
+    [JOURNAL_SOURCE_DBUS]     = "dbus",
+    [JOURNAL_SOURCE_CLOSED]   = "closed",
+};
+
+static size_t journal_bytes(uint64_t capacity)
+{
+    return sizeof(JournalHeader) + (size_t)capacity * sizeof(JournalRecord);
+}
+
+/* Kopf einer bestehenden Datei der Größe size prüfen */
+static bool journal_valid(const JournalHeader *h, size_t size)
+{
+    return memcmp(h->magic, JOURNAL_MAGIC, sizeof(JOURNAL_MAGIC)) == 0 &&
+           h->version == JOURNAL_VERSION &&
+           h->record_size == sizeof(JournalRecord) &&
+           h->capacity > 0 && journal_bytes(h->capacity) == size;
+}
+
+/* Kopf nur aus Nullbytes: angelegt, aber vor dem Schreiben abgebrochen */
+static bool journal_blank(int fd)
+{
+    JournalHeader h;
+    if (pread(fd, &h, sizeof(h), 0) != (ssize_t)sizeof(h))
+        return false;
+    static const JournalHeader zero;
+    return memcmp(&h, &zero, sizeof(h)) == 0;
+}
+
+bool journal_open(const char *path)
+{
+    journal_fd = open(path, O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (journal_fd < 0) {
+        perror(path);
+        return false;
+    }
+    if (flock(journal_fd, LOCK_EX | LOCK_NB) < 0) {
+        fprintf(stderr, "%s: %s\n", path, errno == EWOULDBLOCK
+                ? "wird bereits von einem anderen blkout geschrieben"
+                : strerror(errno));
+        goto fail;
+    }
+
+    /* Neue oder nie fertig angelegte Datei: ganz belegen, Kopf schreiben */
+    struct stat st;
+    if (fstat(journal_fd, &st) < 0) {
+        perror(path);
+        goto fail;
+    }
+    bool fresh = st.st_size == 0 ||
+                 (st.st_size <= (off_t)journal_bytes(JOURNAL_RECORDS) &&
+                  journal_blank(journal_fd));
+    if (fresh) {
+        JournalHeader h = {
+            .version     = JOURNAL_VERSION,
+            .record_size = sizeof(JournalRecord),
+            .capacity    = JOURNAL_RECORDS,
+            .next_seq    = 1,
+        };
+        memcpy(h.magic, JOURNAL_MAGIC, sizeof(JOURNAL_MAGIC));
+        int err = posix_fallocate(journal_fd, 0,
+                                  (off_t)journal_bytes(h.capacity));
+        if (err != 0) {
+            fprintf(stderr, "%s: %s\n", path, strerror(err));
+            goto fail;
+        }
+        if (pwrite(journal_fd, &h, sizeof(h), 0) != (ssize_t)sizeof(h)) {
+            perror(path);
+            goto fail;
+        }
+        st.st_size = (off_t)journal_bytes(h.capacity);
+    }
+
+    journal_size = (size_t)st.st_size;
+    void *map = mmap(NULL, journal_size, PROT_READ | PROT_WRITE, MAP_SHARED,
+                     journal_fd, 0);
+    if (map == MAP_FAILED) {
+        perror("mmap");
+        goto fail;
+    }
+    if (journal_size < sizeof(JournalHeader) ||
+        !journal_valid(map, journal_size)) {
+        fprintf(stderr, "%s: kein blkout-Journal (Version %d)\n", path,
+                JOURNAL_VERSION);
+        munmap(map, journal_size);
+        goto fail;
+    }
+    journal_header  = map;
+    journal_records = (JournalRecord *)(journal_header + 1);
+
+    journal_write(JOURNAL_START, (uint32_t)getpid(), 0);
+    return true;
+
+fail:
+    close(journal_fd);
+    journal_fd = -1;
+    return false;
+}
+
+void journal_close(void)
+{
+    if (!journal_header)
+        return;
+    munmap(journal_header, journal_size);
+    journal_header  = NULL;
+    journal_records = NULL;
+    close(journal_fd);
+    journal_fd = -1;
+}
+
+void journal_write(JournalType type, uint32_t arg, uint64_t latency_ns)
+{
+    if (!journal_header)
+        return;
+
+    struct timespec wall;
+    clock_gettime(CLOCK_REALTIME, &wall);
+
+    uint64_t seq = journal_header->next_seq++;
+    JournalRecord *r = &journal_records[(seq - 1) % journal_header->capacity];
+    __atomic_store_n(&r->seq, 0, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    r->mono_ns    = monotonic_ns();
+    r->wall_ns    = (int64_t)wall.tv_sec * 1000000000ll + wall.tv_nsec;
+    r->latency_ns = latency_ns;
+    r->type       = (uint16_t)type;
+    r->reserved   = 0;
+    r->arg        = arg;
+    __atomic_store_n(&r->seq, seq, __ATOMIC_RELEASE);
+}
+
+/* =========================================================================
+ * CSV-Ausgabe (--journal-dump)
+ * =========================================================================
+ * Spalten: seq, event, detail, monotonic_ns, realtime_ns, time (UTC, ISO
+ * 8601), latency_us. detail ist bei arm der Timeout in ms, bei start die
+ * PID, bei presented das Refresh-Intervall in ns und bei wake/hide der
+ * Name der Weckquelle.
+ */
+static void dump_record(const JournalRecord *r, FILE *out)
+{
+    const char *type = r->type < JOURNAL_TYPE_COUNT ? type_names[r->type]
+                                                    : "unknown";
+    fprintf(out, "%llu,%s,", (unsigned long long)r->seq, type);
+    if (r->type == JOURNAL_WAKE || r->type == JOURNAL_HIDE)
+        fputs(r->arg < JOURNAL_SOURCE_COUNT ? source_names[r->arg]
+                                            : "unknown", out);
+    else if (r->type != JOURNAL_IDLED && r->type != JOURNAL_SHOW)
+        fprintf(out, "%u", r->arg);
+
+    time_t secs = (time_t)(r->wall_ns / 1000000000ll);
+    struct tm tm;
+    char stamp[32] = "";
+    if (gmtime_r(&secs, &tm))
+        strftime(stamp, sizeof(stamp), "%Y-%m-%dT%H:%M:%S", &tm);
+    fprintf(out, ",%llu,%lld,%s.%03dZ,", (unsigned long long)r->mono_ns,
+            (long long)r->wall_ns, stamp,
+            (int)(r->wall_ns % 1000000000ll / 1000000));
+    if (r->latency_ns)
+        fprintf(out, "%.1f", (double)r->latency_ns / 1e3);
+    fputc('\n', out);
+}
+
+bool journal_dump(const char *path, FILE *out)
+{
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st) < 0) {
+        perror(path);
+        if (fd >= 0)
+            close(fd);
+        return false;
+    }
+    size_t size = (size_t)st.st_size;
+    void *map = size >= sizeof(JournalHeader)
+                    ? mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0)
+                    : MAP_FAILED;
+    close(fd);
+    if (map == MAP_FAILED || !journal_valid(map, size)) {
+        fprintf(stderr, "%s: kein blkout-Journal (Version %d)\n", path,
+                JOURNAL_VERSION);
+        if (map != MAP_FAILED)
+            munmap(map, size);
+        return false;
+    }
+
+    /* Vom ältesten noch vorhandenen Eintrag bis zum jüngsten */
+    const JournalHeader *h = map;
+    const JournalRecord *records = (const JournalRecord *)(h + 1);
+    uint64_t next  = __atomic_load_n(&h->next_seq, __ATOMIC_ACQUIRE);
+    uint64_t first = next > h->capacity ? next - h->capacity : 1;
+
+    fputs("seq,event,detail,monotonic_ns,realtime_ns,time,latency_us\n", out);
+    for (uint64_t seq = first; seq < next; seq++) {
+        const JournalRecord *slot = &records[(seq - 1) % h->capacity];
+        if (__atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE) != seq)
+            continue;
+        JournalRecord r = *slot;
+        /* Kopie abschließen, bevor seq erneut gelesen wird */
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        if (__atomic_load_n(&slot->seq, __ATOMIC_RELAXED) != seq)
+            continue;
+        dump_record(&r, out);
+    }
+    munmap(map, size);
+    return fflush(out) == 0;
+}
@@ -0,0 +1,98 @@
+/*
+ * journal.h — Dauerhaftes Protokoll der Übergänge als Ringdatei
+ *
+ * Mit --journal <datei> hält blkout jeden Übergang (scharf geschaltet,
+ * idled, angezeigt, erster Frame präsentiert, Weckquelle, entfernt) als
+ * Datensatz fester Größe in einer per mmap eingeblendeten Ringdatei fest,
+ * mit monotoner Zeit, Uhrzeit und der Latenz des Übergangs. Ein Eintrag
+ * ist ein paar Speicherzugriffe ohne Systemaufruf; clock_gettime() läuft
+ * über den vDSO, auf die Platte schreibt der Kernel die Seiten selbst
+ * zurück. Bei vollem Ring wird der älteste Eintrag überschrieben:
+ * JOURNAL_RECORDS Einträge reichen bei üblicher Nutzung für Monate.
+ *
+ * Die Datei bleibt über Neustarts von blkout erhalten und wird
+ * fortgeschrieben. blkout --journal-dump <datei> gibt sie als CSV aus.
+ *
+ * Format (native Byte-Reihenfolge, nur für diesen Rechner gedacht):
+ *   JournalHeader, danach capacity mal JournalRecord
+ */
+
+#ifndef BLKOUT_JOURNAL_H
+#define BLKOUT_JOURNAL_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#define JOURNAL_MAGIC    "BLKJRNL"
+#define JOURNAL_VERSION  1
+#define JOURNAL_RECORDS  65536   /* 2,5 MiB bei 40 Bytes je Eintrag */
+
+/* Art eines Eintrags */
+typedef enum {
+    JOURNAL_START,      /* blkout gestartet; arg = PID */
+    JOURNAL_ARM,        /* Inaktivität beobachtet; arg = Timeout in ms */
+    JOURNAL_IDLED,      /* Alle beobachteten Seats inaktiv */
+    JOURNAL_SHOW,       /* Overlay angezeigt; Latenz ab idled */
+    JOURNAL_PRESENTED,  /* Erster Frame auf dem Schirm; Latenz ab Anzeige,
+                           arg = Refresh-Intervall in ns */
+    JOURNAL_WAKE,       /* Weckendes Ereignis; Latenz ab dessen Zeitstempel,
+                           arg = JournalSource */
+    JOURNAL_HIDE,       /* Overlay entfernt; Latenz ab weckendem Ereignis,
+                           arg = JournalSource */
+    JOURNAL_TYPE_COUNT
+} JournalType;
+
+/* Was das Overlay geschlossen hat */
+typedef enum {
+    JOURNAL_SOURCE_NONE,      /* Programmende, Selbstmessung */
+    JOURNAL_SOURCE_KEYBOARD,
+    JOURNAL_SOURCE_POINTER,
+    JOURNAL_SOURCE_RESUMED,   /* idle-resumed bzw. evdev */
+    JOURNAL_SOURCE_CONTROL,   /* Steuersocket */
+    JOURNAL_SOURCE_DBUS,      /* org.freedesktop.ScreenSaver */
+    JOURNAL_SOURCE_CLOSED,    /* Compositor hat die Surface geschlossen */
+    JOURNAL_SOURCE_COUNT
+} JournalSource;
+
+typedef struct {
+    char     magic[8];      /* JOURNAL_MAGIC mit abschließender Null */
+    uint32_t version;       /* JOURNAL_VERSION */
+    uint32_t record_size;   /* sizeof(JournalRecord) */
+    uint64_t capacity;      /* Einträge im Ring */
+    uint64_t next_seq;      /* Nummer des nächsten Eintrags, ab 1 */
+    uint8_t  reserved[32];
+} JournalHeader;
+
+typedef struct {
+    uint64_t seq;           /* Laufende Nummer; 0 = leer oder unvollständig */
+    uint64_t mono_ns;       /* CLOCK_MONOTONIC */
+    int64_t  wall_ns;       /* CLOCK_REALTIME */
+    uint64_t latency_ns;    /* Latenz des Übergangs, 0 = keine */
+    uint16_t type;          /* JournalType */
+    uint16_t reserved;
+    uint32_t arg;           /* Je nach Art, siehe JournalType */
+} JournalRecord;
+
+/* Eingeblendeter Kopf, NULL = Journal aus */
+extern JournalHeader *journal_header;
+
+/*
+ * Datei öffnen oder anlegen, exklusiv sperren und einblenden; schreibt
+ * einen JOURNAL_START-Eintrag. Gibt false bei Fehler zurück.
+ */
+bool journal_open(const char *path);
+
+void journal_close(void);
+
+/* Eintrag anhängen */
+void journal_write(JournalType type, uint32_t arg, uint64_t latency_ns);
+
+/* Eintrag, ohne --journal nur ein Zeigervergleich */
+#define journal_event(type, arg, latency_ns) \
+    do { if (journal_header) journal_write((type), (arg), (latency_ns)); } while (0)
+
+/* Alle Einträge der Datei in Reihenfolge als CSV nach out schreiben */
+bool journal_dump(const char *path, FILE *out);
+
+#endif
@@ -10,13 +10,91 @@
  * Zeigt ein schwarzes Vollbild-Overlay über allen Fenstern an.
  * Wird bei Tastendruck oder Mausbewegung wieder geschlossen.
  *
- * Aufruf: blkout [-s <sekunden>] [-e]
+ * Aufruf: blkout [-s <sekunden>] [-e] [-r [-k]] [-m <pixel>[:<ms>]] [--stats]
+ *               [--trace <datei>] [--metrics-socket <pfad>]
+ *               [--metrics-file <pfad>] [--strategy <art>] [--opaque-region]
+ *               [--record <datei>] [--config <pfad>]
+ *               [--control-socket <pfad>] [--exit-idle <sekunden>]
+ *               [--dbus-screensaver] [--memory-pressure <ms>]
+ *               [--idle-backend <art>] [--evdev-dir <pfad>] [--seats <liste>]
+ *               [--content <art>] [--image <datei>]
+ *               [--color <farbe>] [--pattern <art>] [--journal <datei>]
+ *               [--journal-dump <datei>]
+ *               [--benchmark <n> [--benchmark-outputs] [--benchmark-strategies]]
  *   -s <n>  : Overlay erst nach n Sekunden Inaktivität anzeigen
  *   -e      : Programm nach erstem Schließen des Overlays beenden
+ *   -r      : Nur das idle-resumed-Ereignis weckt auf; Tastatur und Maus
+ *             werden nicht gebunden (keine Eingabe-Events an blkout)
+ *   -k      : Mit -r: Tastaturfokus trotzdem exklusiv halten, damit
+ *             Tastendrücke nicht an darunterliegende Fenster gehen
+ *   -m <p>[:<ms>] : Mausbewegung weckt erst ab p Pixeln Weg innerhalb von
+ *             ms Millisekunden (Standard 0 = jede Bewegung, Fenster 500 ms)
+ *   --stats : Wakeup- und Ereigniszähler beim Beenden ausgeben
+ *             (jederzeit auch per SIGUSR1)
+ *   --trace <datei> : Zeitspannen und Ereignisse als Chrome-Trace-JSON
+ *             schreiben (in Perfetto oder chrome://tracing ladbar)
+ *   --metrics-socket <pfad> : Prometheus-Metriken über einen Unix-Socket
+ *             ausliefern (jede Verbindung erhält den aktuellen Stand)
+ *   --metrics-file <pfad>   : Prometheus-Metriken bei jedem Übergang in
+ *             diese Datei schreiben (Textfile-Collector des node_exporter)
+ *   --strategy <art> : Wie das Overlay angezeigt und entfernt wird:
+ *             full (Standard), small, persistent, cached oder gamma
+ *             (kein Overlay, Gamma-Rampen auf null; weckt wie -r)
+ *   --opaque-region : Overlay als undurchsichtig markieren, damit der
+ *             Compositor verdeckte Fenster nicht mehr zeichnen muss
+ *   --record <datei> : Alle ausgewerteten Wayland-Ereignisse mit Zeitstempel
+ *             mitschneiden (abspielbar mit tools/replay)
+ *   --config <pfad> : Konfigurationsdatei statt
+ *             $XDG_CONFIG_HOME/blkout/config; Änderungen werden per inotify
+ *             ohne Neustart übernommen, die Kommandozeile hat Vorrang
+ *   --control-socket <pfad> : Befehle show, hide und quit über einen
+ *             Unix-Socket annehmen; ohne -s erscheint das Overlay dann nur
+ *             auf show. Ein per Socket-Aktivierung (LISTEN_FDS) geerbter
+ *             Socket wird auch ohne diese Option verwendet.
+ *   --exit-idle <n> : Mit Steuersocket oder D-Bus nach n Sekunden ohne
+ *             Overlay, Befehl und gespannte Idle-Notification beenden
+ *   --dbus-screensaver : org.freedesktop.ScreenSaver auf dem Session-Bus
+ *             übernehmen (SetActive, GetActive, GetActiveTime); ohne -s
+ *             erscheint das Overlay dann nur auf SetActive(true). Nur mit
+ *             make DBUS=1 gebaut
+ *   --memory-pressure <ms> : Zurückbehaltene Puffer und Surfaces
+ *             (persistent, cached) verwerfen, sobald Tasks je 2 s länger
+ *             als ms auf Speicher warten (PSI, Standard 200, 0 = aus)
+ *   --idle-backend <art> : Inaktivität erkennen über wayland
+ *             (ext-idle-notify), evdev (/dev/input, Gruppe input nötig) oder
+ *             auto (Standard: evdev nur, wenn der Compositor ext-idle-notify
+ *             nicht anbietet)
+ *   --evdev-dir <pfad> : Verzeichnis der Eingabegeräte statt /dev/input
+ *             (zum Abspielen mit tools/evdev-replay)
+ *   --seats <liste> : Nur diese Seats (Namen durch Komma getrennt, z.B.
+ *             seat0,seat1) auf Inaktivität beobachten; ohne die Option alle.
+ *             Das Overlay erscheint erst, wenn alle beobachteten Seats
+ *             inaktiv sind, und schließt bei Aktivität an einem von ihnen
+ *   --content <art> : Auf dem Overlay none (Standard), clock (gedimmte
+ *             Uhrzeit) oder marker (kleines Quadrat) zeigen; springt jede
+ *             Minute an eine neue Stelle (gegen Einbrennen bei OLED)
+ *   --image <datei> : Statt Schwarz ein mit tools/png2blk umgewandeltes
+ *             Standbild zeigen (ohne Dekodieren, ohne Kopie je Anzeige)
+ *   --color <farbe> : Overlay in RRGGBB (hexadezimal), black (Standard)
+ *             oder privacy (gedimmtes Grau) statt Schwarz
+ *   --pattern <art> : Farbe als solid (Standard), lines (jede zweite
+ *             Zeile) oder checker (Schachbrett aus Einzelpixeln)
+ *   --journal <datei> : Jeden Übergang mit Zeitstempeln und Latenz in eine
+ *             Ringdatei schreiben (per mmap, ohne Systemaufruf je Eintrag)
+ *   --journal-dump <datei> : Ringdatei als CSV ausgeben und beenden
+ *   --benchmark <n> : Overlay n-mal anzeigen und entfernen, Zeiten bis
+ *             configure, für den Pufferaufbau und bis zum Scanout sowie den
+ *             Spitzenspeicher ausgeben, dann beenden (-s und -e wirken nicht)
+ *   --benchmark-outputs    : Mit --benchmark: jede Ausgabe getrennt messen
+ *   --benchmark-strategies : Mit --benchmark: full, small, persistent und
+ *             cached nacheinander messen statt nur --strategy
  *
  * Abhängigkeiten: libwayland-client (Laufzeit)
  *                 wlr-layer-shell-unstable-v1 (Protokoll, compiliert rein)
  *                 ext-idle-notify-v1           (Protokoll, compiliert rein)
+ *                 presentation-time            (Protokoll, optional genutzt)
+ *                 viewporter                   (Protokoll, für --strategy small)
+ *                 wlr-gamma-control-unstable-v1 (Protokoll, für --strategy gamma)
  */
 
 #define _GNU_SOURCE
@@ -28,7 +106,11 @@
 #include <unistd.h>
 #include <errno.h>
 #include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
 #include <sys/mman.h>
+#include <sys/signalfd.h>
+#include <sys/timerfd.h>
 
 /* Wayland-Kern-API */
 #include <wayland-client.h>
@@ -36,54 +118,336 @@
 /* Generierte Protocol-Bindings (erzeugt vom Makefile via wayland-scanner) */
 #include "wlr-layer-shell-unstable-v1-client-protocol.h"
 #include "ext-idle-notify-v1-client-protocol.h"
+#include "presentation-time-client-protocol.h"
+#include "viewporter-client-protocol.h"
+#include "wlr-gamma-control-unstable-v1-client-protocol.h"
+
+/* Zählung, Trace, Metriken, Mitschnitt, Messung, Konfiguration, Steuerung */
+#include "clock.h"
+#include "config.h"
+#include "content.h"
+#include "control.h"
+#include "fill.h"
+#include "screensaver.h"
+#include "psi.h"
+#include "evdev.h"
+#include "image.h"
+#include "journal.h"
+#include "metrics.h"
+#include "record.h"
+#include "selfbench.h"
+#include "stats.h"
+#include "trace.h"
 
 /* =========================================================================
  * Anwendungszustand
  * ========================================================================= */
 
+struct App;
+
+/*
+ * Zusätzliche Ereignisquelle der Hauptschleife (neben der Wayland-
+ * Verbindung). Der Handler wird aufgerufen, wenn fd lesbar ist (bzw.
+ * bereit für events).
+ */
+typedef struct {
+    int        fd;                             /* Überwachter Dateideskriptor */
+    short      events;                         /* poll()-Maske, meist POLLIN */
+    WakeCause  cause;                          /* Wakeup-Ursache für stats */
+    void     (*handler)(struct App *app, int fd);
+    unsigned   gen;                            /* Laufende Nummer aus add_source() */
+} Source;
+
+#define MAX_SOURCES 20
+
+/*
+ * Art, das Overlay anzuzeigen und wieder zu entfernen (--strategy).
+ * Die Varianten tauschen Speicher gegen Arbeit beim Aufwachen ein.
+ */
+typedef enum {
+    STRATEGY_FULL,        /* Surface und Vollbild-Puffer bei jedem Anzeigen neu */
+    STRATEGY_SMALL,       /* 1x1-Puffer, per wp_viewporter auf Vollbild skaliert */
+    STRATEGY_PERSISTENT,  /* Surface und Puffer bleiben, werden nur un-/gemappt */
+    STRATEGY_CACHED,      /* Surface neu, Puffer bleibt für das nächste Mal */
+    STRATEGY_GAMMA,       /* Keine Surface, Gamma-Rampen aller Ausgaben auf null */
+} Strategy;
+
+/* Quelle für idled/resumed (--idle-backend) */
+typedef enum {
+    IDLE_BACKEND_AUTO,     /* ext-idle-notify, sonst evdev */
+    IDLE_BACKEND_WAYLAND,  /* Nur ext-idle-notify */
+    IDLE_BACKEND_EVDEV,    /* Immer /dev/input */
+} IdleBackend;
+
+/*
+ * Gebundene Ausgabe. Solange das Overlay mit --strategy gamma als sichtbar
+ * gilt, hält control die Gamma-Rampen der Ausgabe auf null. Lehnt der
+ * Compositor das ab, deckt stattdessen eine schwarze Layer-Surface allein
+ * diese Ausgabe ab (fallback). Für die Vorab-Füllung farbiger Puffer misst
+ * eine nie gemappte Layer-Surface (probe) die Größe, die das Overlay auf
+ * dieser Ausgabe bekäme, siehe prefill_next().
+ */
+typedef struct {
+    struct App                   *app;
+    struct wl_output             *output;
+    uint32_t                      name;     /* Registry-Name für global_remove */
+    char                          label[32]; /* wl_output.name, z.B. "DP-1" */
+    struct zwlr_gamma_control_v1 *control;  /* NULL = Gamma unverändert */
+    struct wl_surface            *fallback; /* NULL = kein Ersatz-Overlay */
+    struct zwlr_layer_surface_v1 *fallback_layer;
+    struct wl_buffer             *fallback_buffer;
+    int                           fallback_width;  /* Größe des Puffers */
+    int                           fallback_height;
+    struct wl_surface            *probe;    /* NULL = keine Messung offen */
+    struct zwlr_layer_surface_v1 *probe_layer;
+    bool                          measured; /* Messung abgeschlossen */
+    int                           width;    /* Gemessene Größe, 0 = keine */
+    int                           height;
+} Output;
+
+#define MAX_OUTPUTS 8
+
+/*
+ * Gebundener Seat. Jeder Seat hat eigene Eingabeobjekte und eine eigene
+ * Idle-Notification; das Overlay erscheint erst, wenn alle beobachteten
+ * Seats (--seats) inaktiv sind.
+ */
+typedef struct {
+    struct App                      *app;
+    struct wl_seat                  *seat;
+    uint32_t                         name;      /* Registry-Name für global_remove */
+    char                             label[32]; /* wl_seat.name, z.B. "seat0" */
+    struct wl_keyboard              *keyboard;  /* Tastaturereignisse */
+    struct wl_pointer               *pointer;   /* Mausereignisse */
+    struct ext_idle_notification_v1 *idle_notification; /* NULL = nicht beobachtet */
+    bool                             idled;     /* idled empfangen, resumed ausstehend */
+
+    /* Zeigerereignisse, gesammelt bis zum nächsten wl_pointer.frame */
+    bool     ptr_inside;        /* Zeiger steht auf dem Overlay (enter..leave) */
+    bool     ptr_motion;        /* Bewegung im laufenden Frame */
+    bool     ptr_wake;          /* Taste/Rad im laufenden Frame: sofort wecken */
+    double   ptr_x, ptr_y;      /* Letzte bekannte Zeigerposition */
+    bool     ptr_anchor_valid;  /* Ankerpunkt des Zeitfensters gesetzt */
+    double   ptr_anchor_x;      /* Position zu Beginn des Zeitfensters */
+    double   ptr_anchor_y;
+    uint32_t ptr_anchor_time;   /* Zeitstempel zu Beginn des Zeitfensters */
+    uint32_t ptr_event_time;    /* Zeitstempel des letzten Zeigerereignisses */
+} Seat;
+
+#define MAX_SEATS 8
+
+/*
+ * Gefüllter Puffer ohne Mapping und wl_buffer, zum Wiederverwenden beim
+ * nächsten Anzeigen in derselben Farbe und Größe (siehe fill_cache_take()).
+ */
 typedef struct {
+    int      fd;          /* memfd mit fertigen Pixeln */
+    size_t   size;
+    int      width, height;
+    uint32_t color;
+    Pattern  pattern;
+} FilledBuffer;
+
+#define FILL_CACHE_SLOTS 2
+#define PREFILL_CALM_S   30   /* Nach Speicherdruck so lange nicht vorab füllen */
+
+typedef struct App {
     /* --- Kommandozeilenparameter --- */
     int  timeout_ms;       /* Wartezeit in Millisekunden (0 = sofort anzeigen) */
     bool exit_on_hide;     /* Programm nach Schließen des Overlays beenden */
+    bool resume_only;      /* Nur idle-resumed weckt auf, keine Eingabe-Listener */
+    bool keyboard_grab;    /* Mit resume_only: Tastaturfokus trotzdem exklusiv */
+    int  motion_threshold; /* Mindestweg der Maus in Pixeln (0 = jede Bewegung) */
+    int  motion_window_ms; /* Zeitfenster, in dem der Mindestweg erreicht sein muss */
+    bool print_stats;      /* Zähler beim Beenden ausgeben (--stats) */
+    const char *trace_path; /* Ziel für Chrome-Trace-JSON (--trace), NULL = aus */
+    const char *metrics_socket; /* Unix-Socket für Metriken, NULL = aus */
+    const char *metrics_file;   /* Textfile für Metriken, NULL = aus */
+    Strategy strategy;     /* Anzeige-/Entfernungsstrategie (--strategy) */
+    bool opaque_region;    /* Overlay als undurchsichtig markieren (--opaque-region) */
+    const char *record_path; /* Ziel für den Mitschnitt (--record), NULL = aus */
+    const char *journal_path; /* Ringdatei der Übergänge (--journal), NULL = aus */
+    const char *journal_dump; /* Nur diese Ringdatei ausgeben (--journal-dump) */
+    int  benchmark_cycles; /* Zyklen der Selbstmessung (--benchmark), 0 = aus */
+    bool benchmark_outputs;    /* Jede Ausgabe getrennt messen */
+    bool benchmark_strategies; /* Alle Overlay-Strategien messen */
+    const char *config_path; /* Konfigurationsdatei (--config), NULL = keine */
+    const char *control_socket; /* Steuersocket (--control-socket), NULL = aus */
+    int  exit_idle_ms;     /* Beenden nach so langer Ruhe (--exit-idle), 0 = nie */
+    bool dbus_screensaver; /* org.freedesktop.ScreenSaver übernehmen */
+    int  psi_stall_ms;     /* PSI-Schwelle je Fenster (--memory-pressure), 0 = aus */
+    IdleBackend idle_backend; /* Inaktivitätserkennung (--idle-backend) */
+    const char *evdev_dir;    /* Verzeichnis der Eingabegeräte (--evdev-dir) */
+    ContentMode content_mode; /* Inhalt auf dem Overlay (--content) */
+    const char *image_path;   /* Standbild statt Schwarz (--image), NULL = aus */
+    uint32_t color;           /* Farbe des Overlays in XRGB8888 (--color) */
+    Pattern  pattern;         /* Muster der Farbe (--pattern) */
+    const char *seat_filter;  /* Beobachtete Seats (--seats), NULL = alle */
+    char *conf_evdev_dir;     /* Kopien der Werte aus der Konfigurationsdatei, */
+    char *conf_seats;         /* auf die evdev_dir bzw. seat_filter zeigen können */
+    int    argc;           /* Kommandozeile, erneut ausgewertet beim Neuladen */
+    char **argv;
 
     /* --- Wayland-Kernobjekte --- */
     struct wl_display    *display;     /* Verbindung zum Compositor */
     struct wl_registry   *registry;   /* Globale Objekte des Compositors */
     struct wl_compositor *compositor;  /* Erstellt wl_surface-Objekte */
     struct wl_shm        *shm;         /* Shared-Memory für Pixeldaten */
-    struct wl_seat       *seat;        /* Eingabegeräte-Gruppe */
-    struct wl_keyboard   *keyboard;    /* Tastaturereignisse */
-    struct wl_pointer    *pointer;     /* Mausereignisse */
 
     /* --- Layer-Shell-Objekte (für das Overlay-Fenster) --- */
     struct zwlr_layer_shell_v1   *layer_shell;    /* Erzeugt Layer-Surfaces */
     struct zwlr_layer_surface_v1 *layer_surface;  /* Die eigentliche Overlay-Surface */
     struct wl_surface            *surface;         /* Wayland-Surface des Overlays */
+    bool                          surface_closed;  /* closed empfangen, nicht wiederverwendbar */
+
+    /* --- Skalierung (nur --strategy small) --- */
+    struct wp_viewporter *viewporter;  /* NULL = nicht angeboten */
+    struct wp_viewport   *viewport;    /* Skaliert den 1x1-Puffer auf Vollbild */
+
+    /* --- Ausgaben und Gamma-Blanking (nur --strategy gamma) --- */
+    struct zwlr_gamma_control_manager_v1 *gamma_manager; /* NULL = nicht angeboten */
+    Output            outputs[MAX_OUTPUTS];  /* Gebundene Ausgaben */
+    int               noutputs;              /* Anzahl belegter Einträge */
+    struct wl_output *target_output;  /* Ausgabe des Overlays, NULL = Compositor wählt */
+
+    /* --- Seats: Eingabegeräte-Gruppen mit je eigener Idle-Notification --- */
+    Seat seats[MAX_SEATS];  /* Gebundene Seats */
+    int  nseats;            /* Anzahl belegter Einträge */
 
     /* --- Idle-Notification-Objekte (für die Timeout-Erkennung) --- */
-    struct ext_idle_notifier_v1    *idle_notifier;    /* Manager-Objekt */
-    struct ext_idle_notification_v1 *idle_notification; /* Aktive Benachrichtigung */
+    struct ext_idle_notifier_v1 *idle_notifier; /* Manager-Objekt */
+    bool idle_wayland;     /* Notifications je Seat gespannt (nicht evdev) */
+    bool idled;            /* true = alle beobachteten Seats inaktiv */
+    EvdevIdle evdev;       /* Ersatz über /dev/input, evdev.epoll_fd -1 = aus */
+
+    /* --- Präsentationszeitpunkte (optional, für Latenzmessung) --- */
+    struct wp_presentation          *presentation; /* NULL = nicht angeboten */
+    struct wp_presentation_feedback *feedback;     /* Ausstehende Rückmeldung */
+    uint32_t presentation_clock;  /* Uhr der Zeitstempel (clockid_t) */
 
     /* --- Shared-Memory-Puffer (schwarzes Pixelbild) --- */
     struct wl_buffer *buffer;     /* Wayland-Puffer-Objekt */
+    bool              buffer_busy; /* Eingereicht, release steht aus */
     void             *shm_data;   /* Zeiger auf den gemappten Speicher */
     int               shm_fd;     /* Dateideskriptor des Shared-Memory */
     size_t            shm_size;   /* Größe des Puffers in Bytes */
+    int               buf_width;  /* Abmessungen des vorhandenen Puffers */
+    int               buf_height;
+    uint32_t          buf_color;  /* Farbe und Muster des vorhandenen Puffers */
+    Pattern           buf_pattern;
+    FilledBuffer      fill_cache[FILL_CACHE_SLOTS]; /* Gefüllte memfds, älteste zuerst */
+    int               nfill_cache;
+    FillAsync         prefill;    /* Vorab-Füllung im Hintergrund, done_fd -1 = aus */
+    int               prefill_timer_fd; /* Nach Speicherdruck: erneut füllen */
+    bool              prefill_hold;     /* Druck liegt kurz zurück: nicht füllen */
     int               width;      /* Breite der Surface in Pixeln */
     int               height;     /* Höhe der Surface in Pixeln */
+    Content           content;    /* Gezeichneter Inhalt (--content) */
+    Image             image;      /* Standbild im versiegelten memfd (--image) */
+    int               content_timer_fd; /* Nächste Änderung des Inhalts */
+    bool              content_pending;  /* Änderung wartet auf release */
 
     /* --- Programmzustand --- */
     bool overlay_visible;   /* true = Overlay wird gerade angezeigt */
     bool configured;        /* true = configure-Event empfangen, Größe bekannt */
     bool running;           /* false = Hauptschleife verlassen */
+    bool show_on_reconnect; /* Nach dem Neuverbinden Overlay anzeigen */
+
+    /* --- Hauptschleife --- */
+    Source sources[MAX_SOURCES];  /* Weitere Ereignisquellen */
+    int    nsources;              /* Anzahl belegter Einträge */
+    unsigned source_gen;          /* Zuletzt vergebene Source.gen */
+    int    signal_fd;             /* signalfd für SIGINT/SIGTERM/SIGUSR1 */
+    int    config_fd;             /* inotify auf das Konfigurationsverzeichnis */
+    int    control_fd;            /* Lauschender Steuersocket (eigen oder geerbt) */
+    ControlClient control_clients[CONTROL_MAX_CLIENTS]; /* Älteste zuerst */
+    int    ncontrol_clients;
+    int    exit_timer_fd;         /* timerfd für --exit-idle */
+    ScreenSaver *screensaver;     /* D-Bus-Dienst (--dbus-screensaver), NULL = aus */
+    Psi    psi;                   /* Speicherdruck, psi.epoll_fd -1 = aus */
+    bool   evict_on_hide;         /* Druck bei sichtbarem Overlay: danach verwerfen */
+    bool   evicted;               /* Vorrat verworfen, nächster Puffer ist Neuaufbau */
+    bool   rebuild_on_hide;       /* Surface/Puffer nach dem Schließen verwerfen */
+    Stats  stats;                 /* Wakeup- und Ereigniszähler */
+
+    /* --- Metriken --- */
+    Metrics  metrics;             /* Zähler und Latenz-Histogramme */
+    int      metrics_fd;          /* Lauschender Metrik-Socket */
+    MetricsClient metrics_clients[METRICS_MAX_CLIENTS]; /* Rest ausstehend */
+    int      nmetrics_clients;
+    uint64_t idled_ns;            /* Zeitpunkt des letzten idled-Events (0 = keins) */
+    uint64_t show_ns;             /* Zeitpunkt des letzten show_overlay() */
+    uint64_t wake_ns;             /* Zeitpunkt der weckenden Eingabe (0 = keine) */
+    JournalSource wake_source;    /* Was das Overlay gerade schließt */
+
+    /* --- Messpunkte des laufenden Zyklus (nur --benchmark) --- */
+    uint64_t configure_ns;        /* Erstes configure nach show_overlay() */
+    uint64_t buffer_ns;           /* Dauer des Pufferaufbaus */
+    uint64_t commit_ns;           /* Commit des schwarzen Puffers */
+    uint64_t presented_ns;        /* Scanout laut wp_presentation (0 = keiner) */
 } App;
 
+/*
+ * Timeout der Idle-Notification im Modus -r ohne -s. Das Overlay wird dann
+ * sofort angezeigt; die Notification dient nur als Weckquelle. Der Wert 0
+ * ist laut Protokoll ungültig, 1 ms wird praktisch sofort erreicht.
+ */
+#define RESUME_ONLY_TIMEOUT_MS 1
+
+/* Standard-Zeitfenster für die Bewegungsschwelle (-m) */
+#define MOTION_WINDOW_MS_DEFAULT 500
+
+/* --color privacy: gedimmtes Grau, Inhalte unlesbar, Bildschirm sichtbar an */
+#define PRIVACY_COLOR 0x00202020u
+
+/*
+ * Eingabe-Zeitstempel, die weiter als dies zurückliegen, stammen von einer
+ * anderen Uhr als CLOCK_MONOTONIC und werden nicht für Latenzen verwendet.
+ */
+#define INPUT_TIME_MAX_AGE_MS 10000
+
 /* =========================================================================
  * Vorwärtsdeklarationen
  * ========================================================================= */
 
 static void show_overlay(App *app);
 static void hide_overlay(App *app);
+static void note_wake(App *app, JournalSource source, uint64_t input_ns);
+static void destroy_overlay_surface(App *app);
+static void destroy_buffer(App *app);
+static void update_exit_timer(App *app);
+static void probe_start(Output *o);
+
+/* Wird das Overlay von außen ausgelöst (Steuersocket oder D-Bus)? */
+static bool remote_control(const App *app)
+{
+    return app->control_fd >= 0 || app->screensaver;
+}
+
+/* =========================================================================
+ * Zeit- und Metrik-Hilfsfunktionen
+ * =========================================================================
+ * Eingabeereignisse tragen einen Zeitstempel in Millisekunden. KWin und
+ * wlroots verwenden dafür CLOCK_MONOTONIC, sodass sich die Zeit von der
+ * Eingabe bis zum Abbau des Overlays messen lässt. Bei einer fremden Uhr
+ * wird auf den Empfangszeitpunkt zurückgegriffen.
+ */
+static uint64_t input_time_ns(uint32_t time_ms)
+{
+    uint64_t now    = monotonic_ns();
+    uint32_t age_ms = (uint32_t)(now / 1000000) - time_ms;
+
+    if (age_ms > INPUT_TIME_MAX_AGE_MS)
+        return now;
+    return now - (uint64_t)age_ms * 1000000;
+}
+
+/* Metrik-Datei neu schreiben (nur mit --metrics-file) */
+static void publish_metrics(App *app)
+{
+    if (app->metrics_file)
+        metrics_write_file(&app->metrics, app->metrics_file);
+}
 
 /* =========================================================================
  * Shared-Memory-Hilfsfunktion
@@ -114,58 +478,316 @@ static int create_shm_file(size_t size)
 /* =========================================================================
  * Puffer erstellen
  * =========================================================================
- * Allociert einen Shared-Memory-Puffer mit den gegebenen Abmessungen und
- * füllt ihn komplett schwarz. Gibt true zurück bei Erfolg.
+ * Der schwarze Speicher und das wl_buffer-Objekt darauf werden getrennt
+ * angelegt: Nach dem Wiederverbinden (siehe reconnect()) bleibt der
+ * gefüllte Speicher erhalten, nur das Wayland-Objekt entsteht neu.
  */
-static bool create_buffer(App *app)
-{
-    /* Größe berechnen: 4 Bytes pro Pixel (Format XRGB8888) */
-    app->shm_size = (size_t)(app->width * app->height * 4);
-
-    /* Shared-Memory-Dateideskriptor erzeugen */
-    app->shm_fd = create_shm_file(app->shm_size);
-    if (app->shm_fd < 0)
-        return false;
-
-    /* Speicher in den Prozessadressraum einblenden */
-    app->shm_data = mmap(NULL, app->shm_size,
-                         PROT_READ | PROT_WRITE,
-                         MAP_SHARED, app->shm_fd, 0);
-    if (app->shm_data == MAP_FAILED) {
-        perror("mmap");
-        close(app->shm_fd);
-        app->shm_fd = -1;
-        return false;
-    }
 
-    /* Alle Pixel auf Schwarz setzen (0x00000000 im Format XRGB8888 = schwarz) */
-    memset(app->shm_data, 0, app->shm_size);
+static const struct wl_buffer_listener buffer_listener;
 
+/* wl_buffer für den vorhandenen Shared-Memory-Puffer anlegen */
+static bool create_wl_buffer(App *app)
+{
     /* Wayland-SHM-Pool aus dem Dateideskriptor erstellen */
+    trace_begin("pool");
     struct wl_shm_pool *pool = wl_shm_create_pool(app->shm, app->shm_fd,
                                                    (int32_t)app->shm_size);
     if (!pool) {
         fprintf(stderr, "wl_shm_create_pool fehlgeschlagen\n");
-        munmap(app->shm_data, app->shm_size);
-        close(app->shm_fd);
+        trace_end("pool");
         return false;
     }
 
     /* Puffer-Objekt aus dem Pool erzeugen */
     app->buffer = wl_shm_pool_create_buffer(pool, 0,
-                                             app->width, app->height,
-                                             app->width * 4,
+                                             app->buf_width, app->buf_height,
+                                             app->buf_width * 4,
                                              WL_SHM_FORMAT_XRGB8888);
     /* Pool-Referenz freigeben (Puffer bleibt gültig) */
     wl_shm_pool_destroy(pool);
+    trace_end("pool");
 
     if (!app->buffer) {
         fprintf(stderr, "wl_shm_pool_create_buffer fehlgeschlagen\n");
-        munmap(app->shm_data, app->shm_size);
+        return false;
+    }
+    wl_buffer_add_listener(app->buffer, &buffer_listener, app);
+    app->buffer_busy = false;
+    return true;
+}
+
+/*
+ * wl_buffer auf dem Standbild (--image): Der Pool liegt direkt auf dem
+ * beim Start gefüllten memfd, es wird nichts kopiert oder gefüllt.
+ */
+static bool create_image_buffer(App *app)
+{
+    trace_begin("pool");
+    struct wl_shm_pool *pool = wl_shm_create_pool(app->shm, app->image.fd,
+                                                   (int32_t)app->image.size);
+    if (!pool) {
+        fprintf(stderr, "wl_shm_create_pool fehlgeschlagen\n");
+        trace_end("pool");
+        return false;
+    }
+    app->buffer = wl_shm_pool_create_buffer(pool, (int32_t)app->image.offset,
+                                             app->image.width,
+                                             app->image.height,
+                                             app->image.stride,
+                                             app->image.format);
+    wl_shm_pool_destroy(pool);
+    trace_end("pool");
+
+    if (!app->buffer) {
+        fprintf(stderr, "wl_shm_pool_create_buffer fehlgeschlagen\n");
+        return false;
+    }
+    wl_buffer_add_listener(app->buffer, &buffer_listener, app);
+    app->buffer_busy = false;
+    return true;
+}
+
+/*
+ * Schwarz in jedem Muster, das nur aus Farbe und Schwarz besteht: braucht
+ * keinen Schreibzugriff und wird nicht zwischengespeichert.
+ */
+static bool is_black(uint32_t color)
+{
+    return color == 0;
+}
+
+/*
+ * Gefüllten memfd passender Farbe und Größe aus dem Zwischenspeicher
+ * nehmen. Gibt -1 zurück, wenn keiner passt.
+ */
+static int fill_cache_take(App *app, int width, int height)
+{
+    for (int i = 0; i < app->nfill_cache; i++) {
+        FilledBuffer *fb = &app->fill_cache[i];
+        if (fb->width != width || fb->height != height ||
+            fb->color != app->color || fb->pattern != app->pattern)
+            continue;
+        int fd = fb->fd;
+        app->fill_cache[i] = app->fill_cache[--app->nfill_cache];
+        return fd;
+    }
+    return -1;
+}
+
+/* Gefüllten memfd zurücklegen; bei vollem Speicher den ältesten schließen */
+static void fill_cache_put(App *app, FilledBuffer fb)
+{
+    if (app->nfill_cache == FILL_CACHE_SLOTS) {
+        close(app->fill_cache[0].fd);
+        memmove(&app->fill_cache[0], &app->fill_cache[1],
+                (FILL_CACHE_SLOTS - 1) * sizeof(app->fill_cache[0]));
+        app->nfill_cache--;
+    }
+    app->fill_cache[app->nfill_cache++] = fb;
+}
+
+/* Alle zurückgelegten memfds schließen */
+static void fill_cache_drop(App *app)
+{
+    for (int i = 0; i < app->nfill_cache; i++)
+        close(app->fill_cache[i].fd);
+    app->nfill_cache = 0;
+}
+
+/* =========================================================================
+ * Vorab-Füllung (--color, --pattern)
+ * =========================================================================
+ * Einen 8K-Puffer zu füllen kostet trotz Threads über 100 ms, die sonst
+ * zwischen idled und dem ersten Frame lägen. Sobald die Größe bekannt ist,
+ * die das Overlay auf einer Ausgabe bekommt, füllt FillAsync deshalb in
+ * einem eigenen Thread einen memfd und legt ihn in den Vorrat; das
+ * Anzeigen blendet ihn dann nur noch ein. Die Größe liefert das Configure
+ * einer Mess-Surface (probe_start()), nicht Modus und Skalierung der
+ * Ausgabe, die bei gebrochener Skalierung davon abweichen. Verwirft blkout
+ * den Vorrat unter Speicherdruck, füllt es erst nach PREFILL_CALM_S
+ * Sekunden ohne weiteren Druck nach. Vorab gefüllt wird höchstens, was in
+ * den Vorrat passt; eine erst per Konfiguration gesetzte Farbe wird
+ * ebenso vorbereitet wie eine beim Start gesetzte.
+ */
+
+/* Braucht das Overlay einen gefüllten Vollbild-Puffer? */
+static bool prefill_wanted(const App *app)
+{
+    return !is_black(app->color) && app->strategy != STRATEGY_SMALL &&
+           app->strategy != STRATEGY_GAMMA && app->image.fd < 0;
+}
+
+/* Liegt ein Puffer dieser Größe in der aktuellen Farbe schon bereit? */
+static bool filled_as(const App *app, int width, int height)
+{
+    if (app->shm_data && app->buf_width == width &&
+        app->buf_height == height && app->buf_color == app->color &&
+        app->buf_pattern == app->pattern)
+        return true;
+    for (int i = 0; i < app->nfill_cache; i++) {
+        const FilledBuffer *fb = &app->fill_cache[i];
+        if (fb->width == width && fb->height == height &&
+            fb->color == app->color && fb->pattern == app->pattern)
+            return true;
+    }
+    return false;
+}
+
+/* Füllt der Hintergrund-Thread gerade genau diesen Puffer? */
+static bool prefill_running_as(const App *app, int width, int height)
+{
+    const FillAsync *a = &app->prefill;
+    return a->busy && a->width == width && a->height == height &&
+           a->color == app->color && a->pattern == app->pattern;
+}
+
+/*
+ * Nächste Ausgabe ohne passenden Puffer im Hintergrund füllen, noch nicht
+ * gemessene zuvor messen. Halten
+ * schon alle Plätze des Vorrats die aktuelle Farbe, bleibt es dabei;
+ * sonst würden sich bei mehr Größen als Plätzen die Füllungen gegenseitig
+ * verdrängen.
+ */
+static void prefill_next(App *app)
+{
+    if (app->prefill.done_fd < 0 || app->prefill.busy || app->prefill_hold ||
+        !prefill_wanted(app))
+        return;
+    int current = 0;
+    for (int i = 0; i < app->nfill_cache; i++)
+        if (app->fill_cache[i].color == app->color &&
+            app->fill_cache[i].pattern == app->pattern)
+            current++;
+    if (current >= FILL_CACHE_SLOTS)
+        return;
+    for (int i = 0; i < app->noutputs; i++) {
+        Output *o = &app->outputs[i];
+        if (!o->measured) {
+            probe_start(o);
+            continue;
+        }
+        if (o->width <= 0 || filled_as(app, o->width, o->height))
+            continue;
+        if (fill_async_start(&app->prefill, o->width, o->height, app->color,
+                             app->pattern))
+            trace_instant_args("prefill", "\"width\":%d,\"height\":%d",
+                               o->width, o->height);
+        return;
+    }
+}
+
+/*
+ * Speicherdruck: laufende Füllung verwerfen und erst wieder füllen, wenn
+ * PREFILL_CALM_S Sekunden ohne weiteren Druck vergangen sind
+ */
+static void prefill_hold_start(App *app)
+{
+    if (app->prefill_timer_fd < 0)
+        return;
+    app->prefill_hold = true;
+    struct itimerspec its = { .it_value.tv_sec = PREFILL_CALM_S };
+    timerfd_settime(app->prefill_timer_fd, 0, &its, NULL);
+}
+
+/* Fertigen memfd in den Vorrat legen, sofern er noch gebraucht wird */
+static void prefill_store(App *app, int fd)
+{
+    const FillAsync *a = &app->prefill;
+    if (fd < 0)
+        return;
+    if (app->prefill_hold || a->color != app->color ||
+        a->pattern != app->pattern || filled_as(app, a->width, a->height)) {
+        close(fd);
+        return;
+    }
+    fill_cache_put(app, (FilledBuffer){
+        .fd      = fd,
+        .size    = (size_t)a->width * (size_t)a->height * 4,
+        .width   = a->width,
+        .height  = a->height,
+        .color   = a->color,
+        .pattern = a->pattern,
+    });
+    app->metrics.fills++;
+}
+
+/*
+ * Allociert einen Shared-Memory-Puffer mit den gegebenen Abmessungen in der
+ * Farbe des Overlays (--color, --pattern). Gibt true zurück bei Erfolg.
+ */
+static bool create_buffer(App *app, int width, int height)
+{
+    /* Größe berechnen: 4 Bytes pro Pixel (Format XRGB8888) */
+    app->shm_size = (size_t)width * (size_t)height * 4;
+
+    trace_begin_args("create_buffer", "\"width\":%d,\"height\":%d,\"bytes\":%zu",
+                     width, height, app->shm_size);
+
+    /*
+     * Schon einmal in dieser Farbe und Größe gefüllt: nur neu mappen. Füllt
+     * der Hintergrund gerade genau diesen Puffer, auf ihn warten statt ein
+     * zweites Mal zu füllen.
+     */
+    app->shm_fd = fill_cache_take(app, width, height);
+    if (app->shm_fd < 0 && prefill_running_as(app, width, height)) {
+        trace_begin("prefill_wait");
+        app->shm_fd = fill_async_wait(&app->prefill);
+        trace_end("prefill_wait");
+        if (app->shm_fd >= 0)
+            app->metrics.fills++;
+    }
+    bool filled = app->shm_fd >= 0;
+    if (filled) {
+        app->metrics.fill_cache_hits++;
+    } else {
+        /* Shared-Memory-Dateideskriptor erzeugen */
+        trace_begin("memfd");
+        app->shm_fd = create_shm_file(app->shm_size);
+        trace_end("memfd");
+    }
+    if (app->shm_fd < 0) {
+        trace_end("create_buffer");
+        return false;
+    }
+
+    /* Speicher in den Prozessadressraum einblenden */
+    trace_begin("mmap");
+    app->shm_data = mmap(NULL, app->shm_size,
+                         PROT_READ | PROT_WRITE,
+                         MAP_SHARED, app->shm_fd, 0);
+    trace_end("mmap");
+    if (app->shm_data == MAP_FAILED) {
+        perror("mmap");
         close(app->shm_fd);
+        app->shm_fd = -1;
+        trace_end("create_buffer");
         return false;
     }
 
+    /*
+     * Pixel setzen. Schwarz (0x00000000 im Format XRGB8888) steht nach
+     * ftruncate() bereits in der Datei; Schreiben würde nur jede Seite
+     * einmal mehr anfassen.
+     */
+    if (!filled && !is_black(app->color)) {
+        trace_begin("fill");
+        fill_buffer(app->shm_data, width, height, app->color, app->pattern);
+        trace_end("fill");
+        app->metrics.fills++;
+    }
+
+    app->buf_width   = width;
+    app->buf_height  = height;
+    app->buf_color   = app->color;
+    app->buf_pattern = app->pattern;
+    metrics_buffer_alloc(&app->metrics, app->shm_size);
+
+    if (!create_wl_buffer(app)) {
+        destroy_buffer(app);
+        trace_end("create_buffer");
+        return false;
+    }
+    trace_end("create_buffer");
     return true;
 }
 
@@ -176,101 +798,469 @@ static void destroy_buffer(App *app)
         wl_buffer_destroy(app->buffer);
         app->buffer = NULL;
     }
+    app->buffer_busy     = false;
+    app->content_pending = false;
     if (app->shm_data && app->shm_data != MAP_FAILED) {
         munmap(app->shm_data, app->shm_size);
+        metrics_buffer_free(&app->metrics, app->shm_size);
         app->shm_data = NULL;
     }
     if (app->shm_fd >= 0) {
-        close(app->shm_fd);
+        /* Gefüllte Pixel aufheben, Schwarz entsteht ohnehin kostenlos neu */
+        if (is_black(app->buf_color))
+            close(app->shm_fd);
+        else
+            fill_cache_put(app, (FilledBuffer){
+                .fd      = app->shm_fd,
+                .size    = app->shm_size,
+                .width   = app->buf_width,
+                .height  = app->buf_height,
+                .color   = app->buf_color,
+                .pattern = app->buf_pattern,
+            });
         app->shm_fd = -1;
     }
+    app->buf_width  = 0;
+    app->buf_height = 0;
+}
+
+/* Bleibt der Puffer beim Entfernen des Overlays für das nächste Mal? */
+static bool keep_buffer(const App *app)
+{
+    return app->strategy == STRATEGY_PERSISTENT ||
+           app->strategy == STRATEGY_CACHED;
+}
+
+/*
+ * Unter Speicherdruck: zurückbehaltenen Puffer und vorgehaltene Surface
+ * verwerfen, wie create_buffer() und map_overlay_surface() sie beim
+ * nächsten Anzeigen ohnehin neu anlegen. Vor dem Schließen werden die
+ * Seiten aus dem memfd gestanzt: Der Compositor hält den Pool gemappt, bis
+ * er wl_buffer.destroy verarbeitet hat, und so lange blieben sie belegt.
+ * Zurückgelegte farbige Puffer gehen mit. Das Standbild (--image) bleibt,
+ * es ist die einzige Kopie der Datei.
+ */
+static void evict_warm(App *app)
+{
+    size_t bytes = app->shm_data ? app->shm_size : 0;
+    size_t cached = 0;
+    for (int i = 0; i < app->nfill_cache; i++)
+        cached += app->fill_cache[i].size;
+    if (bytes == 0 && cached == 0 && !app->surface)
+        return;
+
+    trace_begin_args("evict", "\"bytes\":%zu", bytes + cached);
+    if (bytes > 0 &&
+        fallocate(app->shm_fd, FALLOC_FL_PUNCH_HOLE | FALLOC_FL_KEEP_SIZE,
+                  0, (off_t)app->shm_size) < 0)
+        perror("fallocate");
+    destroy_overlay_surface(app);
+    if (app->image.fd < 0)
+        destroy_buffer(app);
+    fill_cache_drop(app);
+    if (app->display)
+        wl_display_flush(app->display);
+
+    app->metrics.evictions++;
+    app->metrics.evicted_bytes += bytes + cached;
+    app->evicted = bytes > 0;
+    prefill_hold_start(app);
+    trace_end("evict");
+    publish_metrics(app);
 }
 
 /* =========================================================================
- * Layer-Surface-Ereignisse
+ * Präsentationsrückmeldung
  * =========================================================================
- * Der Compositor teilt uns hier die tatsächliche Größe der Surface mit.
- * Wir müssen daraufhin ack_configure senden und dann einen Puffer anhängen.
+ * Für den ersten schwarzen Frame jedes Overlays fordern wir über
+ * wp_presentation eine Rückmeldung an. Sie liefert den Zeitpunkt, zu dem
+ * der Frame tatsächlich auf dem Bildschirm erschien — das ist die Latenz,
+ * die der Benutzer wahrnimmt, nicht der Zeitpunkt unseres Commits.
  */
-static void layer_surface_configure(void *data,
-                                    struct zwlr_layer_surface_v1 *surface,
-                                    uint32_t serial,
-                                    uint32_t width, uint32_t height)
+
+/* Präsentationszeitstempel in CLOCK_MONOTONIC-Nanosekunden umrechnen */
+static uint64_t presentation_time_ns(App *app, uint32_t tv_sec_hi,
+                                     uint32_t tv_sec_lo, uint32_t tv_nsec)
+{
+    uint64_t t = ((((uint64_t)tv_sec_hi << 32) | tv_sec_lo) * 1000000000ull) +
+                 tv_nsec;
+
+    if (app->presentation_clock == CLOCK_MONOTONIC)
+        return t;
+
+    /* Andere Uhr (z.B. CLOCK_MONOTONIC_RAW): aktuellen Versatz abziehen */
+    struct timespec ts;
+    clock_gettime((clockid_t)app->presentation_clock, &ts);
+    uint64_t clk_now = (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+    return monotonic_ns() - (clk_now - t);
+}
+
+/* Abstand zweier Zeitpunkte; 0, falls b vor a liegt */
+static uint64_t elapsed_ns(uint64_t a, uint64_t b)
 {
+    return b > a ? b - a : 0;
+}
+
+static void presentation_clock_id(void *data, struct wp_presentation *pres,
+                                  uint32_t clk_id)
+{
+    (void)pres;
     App *app = data;
+    app->presentation_clock = clk_id;
+}
 
-    /* Größe merken, die der Compositor vorgegeben hat */
-    app->width  = (int)width;
-    app->height = (int)height;
+static const struct wp_presentation_listener presentation_listener = {
+    .clock_id = presentation_clock_id,
+};
 
-    /* Configure quittieren — Pflicht vor dem nächsten Commit */
-    zwlr_layer_surface_v1_ack_configure(surface, serial);
+static void feedback_sync_output(void *data,
+                                 struct wp_presentation_feedback *fb,
+                                 struct wl_output *output)
+{
+    /* Ausgabe, auf die synchronisiert wurde — nicht ausgewertet */
+    (void)data; (void)fb; (void)output;
+}
 
-    if (!app->configured) {
-        /* Erster Configure-Event: jetzt den schwarzen Puffer erstellen und anhängen */
-        app->configured = true;
+static void feedback_presented(void *data, struct wp_presentation_feedback *fb,
+                               uint32_t tv_sec_hi, uint32_t tv_sec_lo,
+                               uint32_t tv_nsec, uint32_t refresh,
+                               uint32_t seq_hi, uint32_t seq_lo,
+                               uint32_t flags)
+{
+    (void)seq_hi; (void)seq_lo;
+    App *app = data;
 
-        if (!create_buffer(app)) {
-            fprintf(stderr, "Puffer konnte nicht erstellt werden\n");
-            app->running = false;
-            return;
-        }
+    uint64_t scanout    = presentation_time_ns(app, tv_sec_hi, tv_sec_lo, tv_nsec);
+    uint64_t trigger_ns = elapsed_ns(app->show_ns, scanout);
+    uint64_t idle_ns    = app->idled_ns ? elapsed_ns(app->idled_ns, scanout) : 0;
+    app->presented_ns   = scanout;
 
-        /* Puffer an die Surface binden und einreichen */
-        wl_surface_attach(app->surface, app->buffer, 0, 0);
-        wl_surface_commit(app->surface);
-    } else {
-        /*
-         * Nachfolgende Configure-Events (z.B. bei Größenänderung durch den
-         * Compositor): alten Puffer freigeben, neuen erstellen.
-         */
-        destroy_buffer(app);
-        if (!create_buffer(app)) {
-            fprintf(stderr, "Puffer-Neuerstellen fehlgeschlagen\n");
-            app->running = false;
-            return;
-        }
-        wl_surface_attach(app->surface, app->buffer, 0, 0);
-        wl_surface_commit(app->surface);
-    }
+    stats_presented(&app->stats, trigger_ns, idle_ns, refresh, flags);
+    journal_event(JOURNAL_PRESENTED, refresh, trigger_ns);
+    metrics_presented(&app->metrics, (double)trigger_ns / 1e9,
+                      app->idled_ns ? (double)idle_ns / 1e9 : -1.0,
+                      refresh, flags);
+    trace_write_at('i', "scanout", scanout,
+                   "\"trigger_ms\":%.3f,\"idled_ms\":%.3f,"
+                   "\"refresh_ns\":%u,\"flags\":%u",
+                   (double)trigger_ns / 1e6, (double)idle_ns / 1e6,
+                   refresh, flags);
+
+    /* Die Rückmeldung ist einmalig; das Objekt ist serverseitig zerstört */
+    wp_presentation_feedback_destroy(fb);
+    app->feedback = NULL;
+    app->idled_ns = 0;
+    publish_metrics(app);
 }
 
-/* Compositor signalisiert, dass die Surface geschlossen werden soll */
-static void layer_surface_closed(void *data,
-                                  struct zwlr_layer_surface_v1 *surface)
+static void feedback_discarded(void *data, struct wp_presentation_feedback *fb)
 {
-    (void)surface;
+    /* Frame wurde nie angezeigt (z.B. sofort durch einen neuen ersetzt) */
     App *app = data;
-    /* Overlay von unserer Seite aus abbauen */
-    hide_overlay(app);
+    app->stats.discarded++;
+    app->metrics.discarded++;
+    trace_instant("discarded");
+
+    wp_presentation_feedback_destroy(fb);
+    app->feedback = NULL;
+    app->idled_ns = 0;
 }
 
-static const struct zwlr_layer_surface_v1_listener layer_surface_listener = {
-    .configure = layer_surface_configure,
-    .closed    = layer_surface_closed,
+static const struct wp_presentation_feedback_listener feedback_listener = {
+    .sync_output = feedback_sync_output,
+    .presented   = feedback_presented,
+    .discarded   = feedback_discarded,
 };
 
+/* Noch ausstehende Präsentationsrückmeldung verwerfen */
+static void drop_feedback(App *app)
+{
+    if (app->feedback) {
+        wp_presentation_feedback_destroy(app->feedback);
+        app->feedback = NULL;
+    }
+}
+
 /* =========================================================================
- * Overlay anzeigen
+ * Inhalt auf dem Overlay (--content)
  * =========================================================================
- * Erstellt eine neue Layer-Surface, die vollflächig über allen anderen
- * Fenstern liegt, und sendet ein erstes Commit, um den Configure-Event
- * des Compositors auszulösen.
+ * Uhr oder Marke werden in den schwarzen Puffer gezeichnet. Ein timerfd auf
+ * CLOCK_REALTIME weckt nur zur nächsten Minute, also weit seltener als
+ * einmal pro Sekunde, und nur solange das Overlay sichtbar ist. Gemeldet
+ * werden nur die geänderten Rechtecke; der Compositor muss so nicht den
+ * ganzen Bildschirm neu übernehmen. Es gibt nur den einen Puffer: Gezeichnet
+ * wird erst, wenn der Compositor ihn per wl_buffer.release zurückgegeben
+ * hat, sonst könnte ein halb gezeichneter Frame auf den Schirm kommen.
  */
-static void show_overlay(App *app)
+
+/* Timer auf die nächste Änderung stellen bzw. anhalten */
+static void content_schedule(App *app)
 {
-    /* Nichts tun, wenn das Overlay bereits sichtbar ist */
-    if (app->overlay_visible)
+    if (app->content_timer_fd < 0)
         return;
 
-    /* Neue Wayland-Surface erstellen */
-    app->surface = wl_compositor_create_surface(app->compositor);
-    if (!app->surface) {
-        fprintf(stderr, "wl_compositor_create_surface fehlgeschlagen\n");
+    struct itimerspec its = { 0 };
+    if (app->overlay_visible && app->content_mode != CONTENT_NONE)
+        its.it_value.tv_sec = content_next_update(time(NULL));
+    /* CANCEL_ON_SET: Nach dem Verstellen der Uhr sofort neu zeichnen */
+    timerfd_settime(app->content_timer_fd,
+                    TFD_TIMER_ABSTIME | TFD_TIMER_CANCEL_ON_SET, &its, NULL);
+}
+
+/* Geänderte Rechtecke zeichnen und als Schaden melden; true = geändert */
+static bool content_draw(App *app)
+{
+    ContentRect damage[2];
+    int n = content_update(&app->content, time(NULL), damage);
+
+    for (int i = 0; i < n; i++) {
+        if (wl_proxy_get_version((struct wl_proxy *)app->surface) >= 4)
+            wl_surface_damage_buffer(app->surface, damage[i].x, damage[i].y,
+                                     damage[i].w, damage[i].h);
+        else
+            wl_surface_damage(app->surface, damage[i].x, damage[i].y,
+                              damage[i].w, damage[i].h);
+    }
+    return n > 0;
+}
+
+/*
+ * Geänderten Bereich zeichnen und einreichen. Solange der Compositor den
+ * eingereichten Puffer noch liest (kein wl_buffer.release), würde das
+ * Zeichnen in seinen Frame fallen; dann wartet die Änderung auf release.
+ */
+static void content_commit(App *app)
+{
+    if (!app->overlay_visible || !app->configured || !app->buffer)
+        return;
+    if (app->buffer_busy) {
+        app->content_pending = true;
+        return;
+    }
+
+    app->content_pending = false;
+    trace_begin("content");
+    if (content_draw(app)) {
+        wl_surface_attach(app->surface, app->buffer, 0, 0);
+        wl_surface_commit(app->surface);
+        app->buffer_busy = true;
+    }
+    trace_end("content");
+}
+
+/* Minute um: nur den geänderten Bereich neu einreichen */
+static void handle_content_timer(App *app, int fd)
+{
+    uint64_t expirations;
+    if (read(fd, &expirations, sizeof(expirations)) < 0 && errno != ECANCELED)
+        return;
+
+    content_commit(app);
+    content_schedule(app);
+}
+
+/* Compositor liest den Puffer nicht mehr: zurückgestellte Änderung zeichnen */
+static void buffer_release(void *data, struct wl_buffer *buffer)
+{
+    App *app = data;
+    if (buffer != app->buffer)
+        return;
+    app->buffer_busy = false;
+    if (app->content_pending)
+        content_commit(app);
+}
+
+static const struct wl_buffer_listener buffer_listener = {
+    .release = buffer_release,
+};
+
+/* =========================================================================
+ * Layer-Surface-Ereignisse
+ * =========================================================================
+ * Der Compositor teilt uns hier die tatsächliche Größe der Surface mit.
+ * Wir müssen daraufhin ack_configure senden und dann einen Puffer anhängen.
+ */
+static void layer_surface_configure(void *data,
+                                    struct zwlr_layer_surface_v1 *surface,
+                                    uint32_t serial,
+                                    uint32_t width, uint32_t height)
+{
+    App *app = data;
+    stats_event(&app->stats, EV_LAYER_CONFIGURE);
+    record_event_args("zwlr_layer_surface_v1.configure", "%u %u",
+                      width, height);
+    app->metrics.configures++;
+    trace_begin_args("configure", "\"width\":%u,\"height\":%u,\"serial\":%u",
+                     width, height, serial);
+
+    /* Größe merken, die der Compositor vorgegeben hat */
+    app->width  = (int)width;
+    app->height = (int)height;
+
+    /* Configure quittieren — Pflicht vor dem nächsten Commit */
+    zwlr_layer_surface_v1_ack_configure(surface, serial);
+
+    bool first = !app->configured;
+    app->configured = true;
+
+    /* Messpunkte für --benchmark: Empfang, Pufferaufbau, Commit */
+    if (first)
+        app->configure_ns = monotonic_ns();
+
+    /*
+     * Mit Viewport genügt ein einzelnes schwarzes Pixel; der Compositor
+     * skaliert es auf die vorgegebene Größe. Ein Standbild anderer Größe
+     * wird auf demselben Weg auf die Ausgabe gestreckt.
+     */
+    int buf_w = app->width, buf_h = app->height;
+    if (app->viewport && width > 0 && height > 0) {
+        wp_viewport_set_destination(app->viewport, (int32_t)width,
+                                    (int32_t)height);
+        if (app->strategy == STRATEGY_SMALL)
+            buf_w = buf_h = 1;
+    }
+
+    /*
+     * Vorhandenen Puffer passender Größe und Farbe weiterverwenden (nach
+     * einem Configure ohne Größenänderung, aus dem Cache oder aus der
+     * vorigen Verbindung), sonst alten freigeben und den Puffer neu
+     * erstellen.
+     */
+    bool ok = true, created = false;
+    if (app->image.fd >= 0) {
+        /* Standbild: nur der wl_buffer entsteht, die Pixel liegen bereit */
+        if (!app->buffer)
+            ok = create_image_buffer(app);
+    } else if (!app->shm_data || app->buf_width != buf_w ||
+               app->buf_height != buf_h || app->buf_color != app->color ||
+               app->buf_pattern != app->pattern) {
+        destroy_buffer(app);
+        /*
+         * Nach dem Verwerfen unter Druck: Neuaufbau zählen und seine Dauer
+         * messen. Das ist nur blkouts Anteil; die Seiten eines schwarzen
+         * Puffers fasst erst der Compositor an.
+         */
+        uint64_t t0 = app->evicted ? monotonic_ns() : 0;
+        ok = created = create_buffer(app, buf_w, buf_h);
+        if (app->evicted) {
+            app->metrics.rebuilds++;
+            metrics_observe(&app->metrics.rebuild_time,
+                            (double)(monotonic_ns() - t0) / 1e9);
+            app->evicted = false;
+        }
+    } else if (!app->buffer) {
+        /* Speicher hat das Wiederverbinden überlebt, wl_buffer fehlt */
+        ok = create_wl_buffer(app);
+    }
+    if (!ok) {
+        fprintf(stderr, "Puffer konnte nicht erstellt werden\n");
         app->running = false;
+        trace_end("configure");
         return;
     }
 
+    if (first)
+        app->buffer_ns = monotonic_ns() - app->configure_ns;
+
+    /*
+     * Uhr oder Marke in den (ggf. zurückbehaltenen) Puffer zeichnen; liest
+     * der Compositor ihn noch, erst nach dessen release (content_commit)
+     */
+    if (app->content_mode != CONTENT_NONE) {
+        content_attach(&app->content, app->content_mode, app->shm_data,
+                       buf_w, buf_h, created);
+        if (app->buffer_busy)
+            app->content_pending = true;
+        else
+            content_draw(app);
+        content_schedule(app);
+    }
+
+    /* Puffer an die Surface binden und einreichen */
+    trace_begin("attach_commit");
+    wl_surface_attach(app->surface, app->buffer, 0, 0);
+
+    /* Für den ersten schwarzen Frame den Präsentationszeitpunkt anfordern */
+    if (first && app->presentation) {
+        drop_feedback(app);
+        app->feedback = wp_presentation_feedback(app->presentation, app->surface);
+        wp_presentation_feedback_add_listener(app->feedback,
+                                              &feedback_listener, app);
+    }
+    wl_surface_commit(app->surface);
+    app->buffer_busy = true;
+    trace_end("attach_commit");
+    if (first)
+        app->commit_ns = monotonic_ns();
+
+    /*
+     * Erster schwarzer Frame nach idled: Latenz bis zum Commit festhalten.
+     * Der idled-Zeitpunkt bleibt für die Präsentationsrückmeldung erhalten.
+     */
+    if (first && app->idled_ns) {
+        metrics_observe(&app->metrics.idle_to_black,
+                        (double)(monotonic_ns() - app->idled_ns) / 1e9);
+        if (!app->feedback)
+            app->idled_ns = 0;
+    }
+    if (first)
+        publish_metrics(app);
+    trace_end("configure");
+}
+
+/* Compositor signalisiert, dass die Surface geschlossen werden soll */
+static void layer_surface_closed(void *data,
+                                  struct zwlr_layer_surface_v1 *surface)
+{
+    (void)surface;
+    App *app = data;
+    stats_event(&app->stats, EV_LAYER_CLOSED);
+    record_event("zwlr_layer_surface_v1.closed");
+    /*
+     * Overlay von unserer Seite aus abbauen. Eine geschlossene Surface darf
+     * auch bei --strategy persistent nicht wiederverwendet werden.
+     */
+    app->surface_closed = true;
+    note_wake(app, JOURNAL_SOURCE_CLOSED, 0);
+    hide_overlay(app);
+    if (app->surface_closed)
+        destroy_overlay_surface(app);
+}
+
+static const struct zwlr_layer_surface_v1_listener layer_surface_listener = {
+    .configure = layer_surface_configure,
+    .closed    = layer_surface_closed,
+};
+
+/* =========================================================================
+ * Overlay-Surface erstellen und abbauen
+ * =========================================================================
+ * Erstellt eine neue Layer-Surface, die vollflächig über allen anderen
+ * Fenstern liegt. Mit --strategy persistent lebt sie über mehrere
+ * Anzeige-Zyklen hinweg, sonst wird sie bei jedem Entfernen zerstört.
+ */
+static bool create_overlay_surface(App *app)
+{
+    /* Neue Wayland-Surface erstellen */
+    app->surface = wl_compositor_create_surface(app->compositor);
+    if (!app->surface) {
+        fprintf(stderr, "wl_compositor_create_surface fehlgeschlagen\n");
+        return false;
+    }
+    app->surface_closed = false;
+
+    /*
+     * --opaque-region: Surface als vollständig undurchsichtig markieren.
+     * Der Compositor darf dann alles darunter beim Zeichnen auslassen. Der
+     * Zustand gilt ab dem ersten Commit und bleibt für die Surface bestehen.
+     */
+    if (app->opaque_region) {
+        struct wl_region *region = wl_compositor_create_region(app->compositor);
+        wl_region_add(region, 0, 0, INT32_MAX, INT32_MAX);
+        wl_surface_set_opaque_region(app->surface, region);
+        wl_region_destroy(region);
+    }
+
     /*
      * Layer-Surface aus der Surface erzeugen.
      * Layer OVERLAY = höchste Ebene, liegt über allen anderen Fenstern.
@@ -279,7 +1269,7 @@ static void show_overlay(App *app)
     app->layer_surface = zwlr_layer_shell_v1_get_layer_surface(
         app->layer_shell,
         app->surface,
-        NULL,                              /* output: NULL = Compositor wählt */
+        app->target_output,                /* NULL = Compositor wählt */
         ZWLR_LAYER_SHELL_V1_LAYER_OVERLAY,
         "blkout"
     );
@@ -287,8 +1277,7 @@ static void show_overlay(App *app)
         fprintf(stderr, "get_layer_surface fehlgeschlagen\n");
         wl_surface_destroy(app->surface);
         app->surface = NULL;
-        app->running = false;
-        return;
+        return false;
     }
 
     /* Listener für Configure- und Closed-Events registrieren */
@@ -319,214 +1308,909 @@ static void show_overlay(App *app)
     /*
      * EXCLUSIVE Keyboard-Interaktivität: alle Tastatureingaben gehen
      * ausschließlich an unser Overlay, solange es sichtbar ist.
+     * Im Modus -r ohne -k wird kein Fokus angefordert. Mit -k behält das
+     * Overlay den Fokus, ohne dass wir wl_keyboard binden — die Tasten
+     * landen dann bei niemandem und werden verworfen.
      */
-    zwlr_layer_surface_v1_set_keyboard_interactivity(
-        app->layer_surface,
-        ZWLR_LAYER_SURFACE_V1_KEYBOARD_INTERACTIVITY_EXCLUSIVE);
-
-    /* Zustand zurücksetzen, da wir gleich einen neuen Configure-Event erwarten */
-    app->configured = false;
+    if (!app->resume_only || app->keyboard_grab)
+        zwlr_layer_surface_v1_set_keyboard_interactivity(
+            app->layer_surface,
+            ZWLR_LAYER_SURFACE_V1_KEYBOARD_INTERACTIVITY_EXCLUSIVE);
+    else
+        zwlr_layer_surface_v1_set_keyboard_interactivity(
+            app->layer_surface,
+            ZWLR_LAYER_SURFACE_V1_KEYBOARD_INTERACTIVITY_NONE);
 
     /*
-     * Erstes Commit ohne Puffer: veranlasst den Compositor, uns die
-     * tatsächliche Bildschirmgröße per Configure-Event mitzuteilen.
+     * --strategy small: 1x1-Puffer wird im Configure auf Vollbild skaliert.
+     * --image: Standbild ebenso, falls seine Größe von der Ausgabe abweicht.
      */
-    wl_surface_commit(app->surface);
-
-    /* Zustandsvariable setzen */
-    app->overlay_visible = true;
+    if (app->strategy == STRATEGY_SMALL ||
+        (app->image.fd >= 0 && app->viewporter))
+        app->viewport = wp_viewporter_get_viewport(app->viewporter,
+                                                   app->surface);
+    return true;
 }
 
-/* =========================================================================
- * Overlay entfernen
- * =========================================================================
- * Zerstört die Layer-Surface und den Puffer. Entscheidet anschließend,
- * ob das Programm beendet wird oder von vorne beginnt.
- */
-static void hide_overlay(App *app)
+/* Layer-Surface, Viewport und Wayland-Surface zerstören */
+static void destroy_overlay_surface(App *app)
 {
-    /* Nichts tun, wenn das Overlay gar nicht sichtbar ist */
-    if (!app->overlay_visible)
-        return;
-
-    /* Zustand sofort zurücksetzen, um Doppel-Aufrufe zu verhindern */
-    app->overlay_visible = false;
-    app->configured      = false;
-
-    /* Layer-Surface zerstören */
+    if (app->viewport) {
+        wp_viewport_destroy(app->viewport);
+        app->viewport = NULL;
+    }
     if (app->layer_surface) {
         zwlr_layer_surface_v1_destroy(app->layer_surface);
         app->layer_surface = NULL;
     }
-
-    /* Wayland-Surface zerstören */
     if (app->surface) {
         wl_surface_destroy(app->surface);
         app->surface = NULL;
     }
+    app->surface_closed = false;
+}
 
-    /* Pixel-Puffer freigeben */
-    destroy_buffer(app);
-
-    /* Ausstehende Requests zum Compositor schicken */
-    wl_display_flush(app->display);
+/* =========================================================================
+ * Gamma-Blanking (--strategy gamma)
+ * =========================================================================
+ * Statt eine Surface anzuzeigen, setzt blkout die Gamma-Rampen jeder
+ * Ausgabe auf null. Der Compositor muss dafür nichts zusätzlich
+ * compositen. Beim Zerstören der Gamma-Steuerung stellt er die
+ * ursprünglichen Rampen wieder her. Ohne Surface gibt es keine
+ * Eingabeereignisse; geweckt wird daher wie mit -r über idle-resumed.
+ *
+ * Meldet der Compositor für eine Ausgabe "failed" (keine Gamma-Tabellen,
+ * etwa kopflos oder virtuell, oder ein anderer Client hält sie), bekommt
+ * nur diese Ausgabe eine schwarze Layer-Surface wie bei --strategy full.
+ * Der Puffer ist ein frischer memfd und damit ohne Schreibzugriff schwarz.
+ */
 
-    /* -e gesetzt: Programm beenden */
-    if (app->exit_on_hide) {
-        app->running = false;
-        return;
+/* Erste abgedunkelte Ausgabe nach idled: Latenz festhalten */
+static void gamma_note_black(App *app)
+{
+    if (app->idled_ns) {
+        metrics_observe(&app->metrics.idle_to_black,
+                        (double)(monotonic_ns() - app->idled_ns) / 1e9);
+        app->idled_ns = 0;
+        publish_metrics(app);
     }
+}
 
-    /*
-     * Kein Timeout (-s nicht gesetzt): Overlay sofort wieder anzeigen.
-     * Mit Timeout: die Idle-Notification ist automatisch neu gespannt und
-     * wird nach erneutem Ablauf wieder feuern — nichts weiter zu tun.
-     */
-    if (app->timeout_ms == 0)
-        show_overlay(app);
+static void fallback_destroy(Output *go)
+{
+    if (go->fallback_layer) {
+        zwlr_layer_surface_v1_destroy(go->fallback_layer);
+        go->fallback_layer = NULL;
+    }
+    if (go->fallback) {
+        wl_surface_destroy(go->fallback);
+        go->fallback = NULL;
+    }
+    if (go->fallback_buffer) {
+        wl_buffer_destroy(go->fallback_buffer);
+        go->fallback_buffer = NULL;
+    }
+    go->fallback_width = go->fallback_height = 0;
 }
 
-/* =========================================================================
- * Tastaturereignisse
- * =========================================================================
- * Bei jedem Tastendruck wird das Overlay geschlossen.
- */
-static void keyboard_keymap(void *data, struct wl_keyboard *kb,
-                             uint32_t format, int32_t fd, uint32_t size)
+/* Schwarzen Puffer in der vorgegebenen Größe anlegen */
+static bool fallback_create_buffer(Output *go, int width, int height)
 {
-    /* Keymap-Daten werden von uns nicht ausgewertet */
-    (void)data; (void)kb; (void)format; (void)size;
+    App *app = go->app;
+    size_t size = (size_t)width * (size_t)height * 4;
+    int fd = create_shm_file(size);
+    if (fd < 0)
+        return false;
+    struct wl_shm_pool *pool = wl_shm_create_pool(app->shm, fd, (int32_t)size);
     close(fd);
+    if (!pool)
+        return false;
+    go->fallback_buffer = wl_shm_pool_create_buffer(pool, 0, width, height,
+                                                    width * 4,
+                                                    WL_SHM_FORMAT_XRGB8888);
+    wl_shm_pool_destroy(pool);
+    go->fallback_width  = width;
+    go->fallback_height = height;
+    return go->fallback_buffer != NULL;
 }
 
-static void keyboard_enter(void *data, struct wl_keyboard *kb,
-                            uint32_t serial, struct wl_surface *surface,
-                            struct wl_array *keys)
+static void fallback_configure(void *data,
+                               struct zwlr_layer_surface_v1 *surface,
+                               uint32_t serial, uint32_t width,
+                               uint32_t height)
 {
-    /* Fokus erhalten — keine Aktion nötig */
-    (void)data; (void)kb; (void)serial; (void)surface; (void)keys;
+    Output *go = data;
+    App *app = go->app;
+    stats_event(&app->stats, EV_LAYER_CONFIGURE);
+    zwlr_layer_surface_v1_ack_configure(surface, serial);
+
+    if (go->fallback_buffer && (go->fallback_width != (int)width ||
+                                go->fallback_height != (int)height)) {
+        wl_buffer_destroy(go->fallback_buffer);
+        go->fallback_buffer = NULL;
+    }
+    if (!go->fallback_buffer &&
+        (width == 0 || height == 0 ||
+         !fallback_create_buffer(go, (int)width, (int)height))) {
+        fprintf(stderr, "%s: Ersatz-Overlay ohne Puffer\n", go->label);
+        return;
+    }
+    wl_surface_attach(go->fallback, go->fallback_buffer, 0, 0);
+    wl_surface_commit(go->fallback);
+    gamma_note_black(app);
 }
 
-static void keyboard_leave(void *data, struct wl_keyboard *kb,
-                            uint32_t serial, struct wl_surface *surface)
+static void fallback_closed(void *data, struct zwlr_layer_surface_v1 *surface)
 {
-    /* Fokus verloren — keine Aktion nötig */
-    (void)data; (void)kb; (void)serial; (void)surface;
+    (void)surface;
+    Output *go = data;
+    stats_event(&go->app->stats, EV_LAYER_CLOSED);
+    fallback_destroy(go);
 }
 
-static void keyboard_key(void *data, struct wl_keyboard *kb,
-                          uint32_t serial, uint32_t time,
-                          uint32_t key, uint32_t state)
-{
-    (void)kb; (void)serial; (void)time; (void)key;
-    App *app = data;
+static const struct zwlr_layer_surface_v1_listener fallback_listener = {
+    .configure = fallback_configure,
+    .closed    = fallback_closed,
+};
 
-    /* Nur beim Drücken (state=1) reagieren, nicht beim Loslassen */
-    if (state == WL_KEYBOARD_KEY_STATE_PRESSED)
-        hide_overlay(app);
+/* Ausgabe ohne Gamma-Steuerung mit einer eigenen Layer-Surface abdecken */
+static void fallback_show(Output *go)
+{
+    App *app = go->app;
+    if (go->fallback)
+        return;
+    go->fallback = wl_compositor_create_surface(app->compositor);
+    if (!go->fallback)
+        return;
+    if (app->opaque_region) {
+        struct wl_region *region = wl_compositor_create_region(app->compositor);
+        wl_region_add(region, 0, 0, INT32_MAX, INT32_MAX);
+        wl_surface_set_opaque_region(go->fallback, region);
+        wl_region_destroy(region);
+    }
+    go->fallback_layer = zwlr_layer_shell_v1_get_layer_surface(
+        app->layer_shell, go->fallback, go->output,
+        ZWLR_LAYER_SHELL_V1_LAYER_OVERLAY, "blkout");
+    zwlr_layer_surface_v1_add_listener(go->fallback_layer, &fallback_listener,
+                                       go);
+    zwlr_layer_surface_v1_set_anchor(go->fallback_layer,
+        ZWLR_LAYER_SURFACE_V1_ANCHOR_TOP    |
+        ZWLR_LAYER_SURFACE_V1_ANCHOR_BOTTOM |
+        ZWLR_LAYER_SURFACE_V1_ANCHOR_LEFT   |
+        ZWLR_LAYER_SURFACE_V1_ANCHOR_RIGHT);
+    zwlr_layer_surface_v1_set_size(go->fallback_layer, 0, 0);
+    zwlr_layer_surface_v1_set_exclusive_zone(go->fallback_layer, -1);
+    /* Geweckt wird weiter über idle-resumed; Tastatur bleibt frei */
+    zwlr_layer_surface_v1_set_keyboard_interactivity(
+        go->fallback_layer,
+        ZWLR_LAYER_SURFACE_V1_KEYBOARD_INTERACTIVITY_NONE);
+    wl_surface_commit(go->fallback);
 }
 
-static void keyboard_modifiers(void *data, struct wl_keyboard *kb,
-                                uint32_t serial, uint32_t mods_depressed,
-                                uint32_t mods_latched, uint32_t mods_locked,
-                                uint32_t group)
+static void gamma_control_size(void *data,
+                               struct zwlr_gamma_control_v1 *control,
+                               uint32_t size)
 {
-    /* Modifier-Zustände werden nicht ausgewertet */
-    (void)data; (void)kb; (void)serial; (void)mods_depressed;
-    (void)mods_latched; (void)mods_locked; (void)group;
+    Output *go = data;
+    App *app = go->app;
+    stats_event(&app->stats, EV_GAMMA_SIZE);
+    trace_begin_args("set_gamma", "\"size\":%u", size);
+
+    /*
+     * Drei Rampen (R, G, B) zu je size 16-Bit-Werten. Eine frisch
+     * vergrößerte memfd-Datei ist bereits mit Nullen gefüllt.
+     */
+    int fd = create_shm_file((size_t)size * 3 * sizeof(uint16_t));
+    if (fd < 0) {
+        trace_end("set_gamma");
+        return;
+    }
+    zwlr_gamma_control_v1_set_gamma(control, fd);
+    close(fd);
+    gamma_note_black(app);
+    trace_end("set_gamma");
 }
 
-static void keyboard_repeat_info(void *data, struct wl_keyboard *kb,
-                                  int32_t rate, int32_t delay)
+static void gamma_control_failed(void *data,
+                                 struct zwlr_gamma_control_v1 *control)
 {
-    /* Wiederholungsrate wird nicht verwendet */
-    (void)data; (void)kb; (void)rate; (void)delay;
+    /* Ausgabe ohne Gamma-Tabellen oder von einem anderen Client belegt */
+    Output *go = data;
+    stats_event(&go->app->stats, EV_GAMMA_FAILED);
+    fprintf(stderr, "%s: Gamma-Steuerung fehlgeschlagen, "
+                    "schwärze per Layer-Surface\n", go->label);
+    zwlr_gamma_control_v1_destroy(control);
+    go->control = NULL;
+    if (go->app->overlay_visible)
+        fallback_show(go);
 }
 
-static const struct wl_keyboard_listener keyboard_listener = {
-    .keymap      = keyboard_keymap,
-    .enter       = keyboard_enter,
-    .leave       = keyboard_leave,
-    .key         = keyboard_key,
-    .modifiers   = keyboard_modifiers,
-    .repeat_info = keyboard_repeat_info,
+static const struct zwlr_gamma_control_v1_listener gamma_control_listener = {
+    .gamma_size = gamma_control_size,
+    .failed     = gamma_control_failed,
 };
 
+/* Ausgabe abdunkeln; die Rampen werden nach gamma_size gesetzt */
+static void gamma_blank_output(App *app, Output *go)
+{
+    if (go->control || go->fallback || !app->gamma_manager)
+        return;
+    go->control = zwlr_gamma_control_manager_v1_get_gamma_control(
+        app->gamma_manager, go->output);
+    zwlr_gamma_control_v1_add_listener(go->control, &gamma_control_listener, go);
+}
+
+/* Ursprüngliche Gamma-Rampen wiederherstellen bzw. Ersatz-Overlay abbauen */
+static void gamma_restore_output(Output *go)
+{
+    if (go->control) {
+        zwlr_gamma_control_v1_destroy(go->control);
+        go->control = NULL;
+    }
+    fallback_destroy(go);
+}
+
 /* =========================================================================
- * Mausereignisse
+ * Ausgaben
  * =========================================================================
- * Jede Mausbewegung oder Maustaste schließt das Overlay.
+ * Ausgaben werden immer gebunden, damit auch eine erst per Konfiguration
+ * gesetzte Farbe vorab gefüllt werden kann. Ausgewertet werden der Name
+ * (wl_output ab Version 4), mit dem die Selbstmessung ihre Varianten
+ * beschriftet, und wl_output.done als Zeichen, dass sich Modus,
+ * Skalierung oder Drehung geändert haben könnten.
+ *
+ * Welche Puffergröße das Overlay auf einer Ausgabe bekommt, meldet nur
+ * ihr Configure; aus Modus und Skalierung lässt sie sich bei gebrochener
+ * Skalierung nicht ableiten. Zum Messen legt probe_start() deshalb eine
+ * Layer-Surface mit denselben Ankern an, reicht sie ohne Puffer ein und
+ * zerstört sie nach dem ersten Configure wieder. Ungemappt bleibt sie
+ * unsichtbar und bekommt keinen Fokus.
  */
-static void pointer_enter(void *data, struct wl_pointer *ptr,
-                           uint32_t serial, struct wl_surface *surface,
-                           wl_fixed_t sx, wl_fixed_t sy)
+static void probe_destroy(Output *o)
 {
-    /* Zeiger betritt unsere Surface — Cursor verstecken */
-    (void)data; (void)surface; (void)sx; (void)sy;
-
-    /* Unsichtbaren Cursor setzen: NULL-Surface = kein Cursor */
-    wl_pointer_set_cursor(ptr, serial, NULL, 0, 0);
+    if (o->probe_layer) {
+        zwlr_layer_surface_v1_destroy(o->probe_layer);
+        o->probe_layer = NULL;
+    }
+    if (o->probe) {
+        wl_surface_destroy(o->probe);
+        o->probe = NULL;
+    }
 }
 
-static void pointer_leave(void *data, struct wl_pointer *ptr,
-                           uint32_t serial, struct wl_surface *surface)
+static void probe_configure(void *data, struct zwlr_layer_surface_v1 *surface,
+                            uint32_t serial, uint32_t width, uint32_t height)
 {
-    /* Zeiger verlässt unsere Surface — keine Aktion nötig */
-    (void)data; (void)ptr; (void)serial; (void)surface;
+    (void)surface; (void)serial;
+    Output *o = data;
+    stats_event(&o->app->stats, EV_LAYER_CONFIGURE);
+    record_event_args("probe.configure", "%u %u", width, height);
+    probe_destroy(o);
+    o->measured = true;
+    o->width    = (int)width;
+    o->height   = (int)height;
+    prefill_next(o->app);
 }
 
-static void pointer_motion(void *data, struct wl_pointer *ptr,
-                            uint32_t time, wl_fixed_t sx, wl_fixed_t sy)
+/* Compositor lehnt die Surface ab: nicht erneut messen */
+static void probe_closed(void *data, struct zwlr_layer_surface_v1 *surface)
 {
-    /* Mausbewegung erkannt: Overlay schließen */
-    (void)ptr; (void)time; (void)sx; (void)sy;
-    App *app = data;
-    hide_overlay(app);
+    (void)surface;
+    Output *o = data;
+    stats_event(&o->app->stats, EV_LAYER_CLOSED);
+    probe_destroy(o);
+    o->measured = true;
+    o->width = o->height = 0;
 }
 
-static void pointer_button(void *data, struct wl_pointer *ptr,
+static const struct zwlr_layer_surface_v1_listener probe_listener = {
+    .configure = probe_configure,
+    .closed    = probe_closed,
+};
+
+/* Größe des Overlays auf dieser Ausgabe erfragen, siehe oben */
+static void probe_start(Output *o)
+{
+    App *app = o->app;
+    if (o->probe || !app->compositor || !app->layer_shell)
+        return;
+    o->probe = wl_compositor_create_surface(app->compositor);
+    if (!o->probe)
+        return;
+    o->probe_layer = zwlr_layer_shell_v1_get_layer_surface(
+        app->layer_shell, o->probe, o->output,
+        ZWLR_LAYER_SHELL_V1_LAYER_OVERLAY, "blkout");
+    zwlr_layer_surface_v1_add_listener(o->probe_layer, &probe_listener, o);
+    zwlr_layer_surface_v1_set_anchor(o->probe_layer,
+        ZWLR_LAYER_SURFACE_V1_ANCHOR_TOP    |
+        ZWLR_LAYER_SURFACE_V1_ANCHOR_BOTTOM |
+        ZWLR_LAYER_SURFACE_V1_ANCHOR_LEFT   |
+        ZWLR_LAYER_SURFACE_V1_ANCHOR_RIGHT);
+    zwlr_layer_surface_v1_set_size(o->probe_layer, 0, 0);
+    zwlr_layer_surface_v1_set_exclusive_zone(o->probe_layer, -1);
+    zwlr_layer_surface_v1_set_keyboard_interactivity(
+        o->probe_layer, ZWLR_LAYER_SURFACE_V1_KEYBOARD_INTERACTIVITY_NONE);
+    wl_surface_commit(o->probe);
+}
+
+static void output_geometry(void *data, struct wl_output *output,
+                            int32_t x, int32_t y, int32_t phys_w,
+                            int32_t phys_h, int32_t subpixel,
+                            const char *make, const char *model,
+                            int32_t transform)
+{
+    (void)output; (void)x; (void)y; (void)phys_w; (void)phys_h;
+    (void)subpixel; (void)make; (void)model; (void)transform;
+    Output *o = data;
+    stats_event(&o->app->stats, EV_OUTPUT_OTHER);
+}
+
+static void output_mode(void *data, struct wl_output *output, uint32_t flags,
+                        int32_t width, int32_t height, int32_t refresh)
+{
+    (void)output; (void)flags; (void)width; (void)height; (void)refresh;
+    Output *o = data;
+    stats_event(&o->app->stats, EV_OUTPUT_OTHER);
+}
+
+/* Neuer Stand der Ausgabe: bei Bedarf neu messen */
+static void output_done(void *data, struct wl_output *output)
+{
+    (void)output;
+    Output *o = data;
+    stats_event(&o->app->stats, EV_OUTPUT_OTHER);
+    probe_destroy(o);
+    o->measured = false;
+    o->width = o->height = 0;
+    prefill_next(o->app);
+}
+
+static void output_scale(void *data, struct wl_output *output, int32_t factor)
+{
+    (void)output; (void)factor;
+    Output *o = data;
+    stats_event(&o->app->stats, EV_OUTPUT_OTHER);
+}
+
+static void output_name(void *data, struct wl_output *output, const char *name)
+{
+    (void)output;
+    Output *o = data;
+    stats_event(&o->app->stats, EV_OUTPUT_NAME);
+    snprintf(o->label, sizeof(o->label), "%s", name);
+}
+
+static void output_description(void *data, struct wl_output *output,
+                               const char *description)
+{
+    (void)output; (void)description;
+    Output *o = data;
+    stats_event(&o->app->stats, EV_OUTPUT_OTHER);
+}
+
+static const struct wl_output_listener output_listener = {
+    .geometry    = output_geometry,
+    .mode        = output_mode,
+    .done        = output_done,
+    .scale       = output_scale,
+    .name        = output_name,
+    .description = output_description,
+};
+
+/* Neue Ausgabe binden; bei sichtbarem Gamma-Overlay sofort abdunkeln */
+static void add_output(App *app, struct wl_registry *registry,
+                       uint32_t name, uint32_t version)
+{
+    if (app->noutputs >= MAX_OUTPUTS) {
+        fprintf(stderr, "Zu viele Ausgaben, ignoriere weitere\n");
+        return;
+    }
+    Output *o = &app->outputs[app->noutputs++];
+    *o = (Output){ .app = app, .name = name };
+    /* Ohne wl_output.name (Version < 4) bleibt die Registry-Nummer */
+    snprintf(o->label, sizeof(o->label), "wl_output#%u", name);
+    o->output  = wl_registry_bind(registry, name, &wl_output_interface,
+                                  (version < 4 ? version : 4));
+    wl_output_add_listener(o->output, &output_listener, o);
+    if (app->overlay_visible && app->strategy == STRATEGY_GAMMA)
+        gamma_blank_output(app, o);
+}
+
+/* Entfernte Ausgabe freigeben; gibt false zurück, wenn sie unbekannt ist */
+static bool remove_output(App *app, uint32_t name)
+{
+    for (int i = 0; i < app->noutputs; i++) {
+        Output *o = &app->outputs[i];
+        if (o->name != name)
+            continue;
+        gamma_restore_output(o);
+        probe_destroy(o);
+        if (app->target_output == o->output)
+            app->target_output = NULL;
+        wl_output_destroy(o->output);
+        /* Letzten Eintrag nachrücken; die Listener-Daten zeigen auf den Platz */
+        app->noutputs--;
+        if (i != app->noutputs) {
+            *o = app->outputs[app->noutputs];
+            wl_proxy_set_user_data((struct wl_proxy *)o->output, o);
+            if (o->control)
+                wl_proxy_set_user_data((struct wl_proxy *)o->control, o);
+            if (o->fallback_layer)
+                wl_proxy_set_user_data((struct wl_proxy *)o->fallback_layer,
+                                       o);
+            if (o->probe_layer)
+                wl_proxy_set_user_data((struct wl_proxy *)o->probe_layer, o);
+        }
+        return true;
+    }
+    return false;
+}
+
+/* =========================================================================
+ * Overlay anzeigen
+ * =========================================================================
+ * Erstellt bei Bedarf die Layer-Surface und sendet ein Commit ohne Puffer,
+ * um den Configure-Event des Compositors auszulösen. Eine mit --strategy
+ * persistent nur ungemappte Surface wird auf demselben Weg erneut gemappt.
+ * Mit --strategy gamma werden stattdessen alle Ausgaben abgedunkelt.
+ */
+static bool map_overlay_surface(App *app)
+{
+    /* Vom Compositor geschlossene Surface lässt sich nicht wieder mappen */
+    if (app->surface_closed)
+        destroy_overlay_surface(app);
+
+    if (!app->layer_surface && !create_overlay_surface(app))
+        return false;
+
+    /* Zustand zurücksetzen, da wir gleich einen neuen Configure-Event erwarten */
+    app->configured = false;
+
+    /*
+     * Erstes Commit ohne Puffer: veranlasst den Compositor, uns die
+     * tatsächliche Bildschirmgröße per Configure-Event mitzuteilen.
+     */
+    wl_surface_commit(app->surface);
+    return true;
+}
+
+static void show_overlay(App *app)
+{
+    /* Nichts tun, wenn das Overlay bereits sichtbar ist */
+    if (app->overlay_visible)
+        return;
+
+    /* Während reconnect() (z.B. Befehl oder evdev): nach dem Verbinden */
+    if (!app->display) {
+        app->show_on_reconnect = true;
+        return;
+    }
+
+    trace_begin("show_overlay");
+    record_event("show_overlay");
+    app->show_ns = monotonic_ns();
+
+    if (app->strategy == STRATEGY_GAMMA) {
+        for (int i = 0; i < app->noutputs; i++)
+            gamma_blank_output(app, &app->outputs[i]);
+    } else if (!map_overlay_surface(app)) {
+        app->running = false;
+        trace_end("show_overlay");
+        return;
+    }
+
+    /* Zustandsvariable setzen */
+    app->overlay_visible = true;
+    stats_set_phase(&app->stats, PHASE_BLANKED);
+    metrics_show(&app->metrics);
+    journal_event(JOURNAL_SHOW, 0,
+                  app->idled_ns ? elapsed_ns(app->idled_ns, app->show_ns) : 0);
+    if (app->screensaver)
+        screensaver_changed(app->screensaver, true);
+    update_exit_timer(app);
+    trace_end("show_overlay");
+}
+
+/* =========================================================================
+ * Overlay entfernen
+ * =========================================================================
+ * Zerstört die Layer-Surface und den Puffer (je nach --strategy bleiben
+ * beide erhalten). Entscheidet anschließend, ob das Programm beendet wird
+ * oder von vorne beginnt.
+ */
+static void hide_overlay(App *app)
+{
+    /* Ein während reconnect() angefordertes Overlay ist damit hinfällig */
+    app->show_on_reconnect = false;
+
+    /* Nichts tun, wenn das Overlay gar nicht sichtbar ist */
+    if (!app->overlay_visible)
+        return;
+
+    trace_begin("hide_overlay");
+    record_event("hide_overlay");
+
+    /* Zustand sofort zurücksetzen, um Doppel-Aufrufe zu verhindern */
+    app->overlay_visible = false;
+    app->configured      = false;
+    stats_set_phase(&app->stats, PHASE_ARMED);
+
+    /* Mit dem Overlay verlässt der Zeiger unsere Surface, auch ohne leave */
+    for (int i = 0; i < app->nseats; i++)
+        app->seats[i].ptr_inside = false;
+    content_schedule(app);
+    if (app->screensaver)
+        screensaver_changed(app->screensaver, false);
+
+    /*
+     * --strategy persistent: Puffer abhängen und so die Layer-Surface nur
+     * unmappen; beim nächsten Anzeigen genügt ein Commit. Sonst Layer-
+     * Surface und Wayland-Surface zerstören. --strategy gamma stellt nur die
+     * Gamma-Rampen wieder her.
+     */
+    if (app->strategy == STRATEGY_GAMMA) {
+        for (int i = 0; i < app->noutputs; i++)
+            gamma_restore_output(&app->outputs[i]);
+    } else if (app->strategy == STRATEGY_PERSISTENT && !app->surface_closed &&
+               app->surface) {
+        wl_surface_attach(app->surface, NULL, 0, 0);
+        wl_surface_commit(app->surface);
+    } else {
+        destroy_overlay_surface(app);
+    }
+
+    /* Pixel-Puffer freigeben; eine ausstehende Rückmeldung ist hinfällig */
+    if (!keep_buffer(app))
+        destroy_buffer(app);
+    drop_feedback(app);
+
+    /* Während der Anzeige neu geladene Einstellungen gelten ab jetzt */
+    if (app->rebuild_on_hide) {
+        destroy_overlay_surface(app);
+        destroy_buffer(app);
+        app->rebuild_on_hide = false;
+    }
+
+    /* Während der Anzeige kam Speicherdruck: Vorrat nicht behalten */
+    if (app->evict_on_hide) {
+        evict_warm(app);
+        app->evict_on_hide = false;
+    }
+    app->idled_ns = 0;
+
+    /* Ausstehende Requests zum Compositor schicken */
+    wl_display_flush(app->display);
+
+    /* Zeit von der weckenden Eingabe bis hierher festhalten */
+    uint64_t wake_latency = app->wake_ns
+                                ? elapsed_ns(app->wake_ns, monotonic_ns()) : 0;
+    metrics_hide(&app->metrics);
+    if (app->wake_ns) {
+        metrics_observe(&app->metrics.input_to_hide,
+                        (double)wake_latency / 1e9);
+        app->wake_ns = 0;
+    }
+    journal_event(JOURNAL_HIDE, app->wake_source, wake_latency);
+    app->wake_source = JOURNAL_SOURCE_NONE;
+    publish_metrics(app);
+
+    update_exit_timer(app);
+    trace_end("hide_overlay");
+
+    /* Selbstmessung: den nächsten Zyklus startet run_benchmark() */
+    if (app->benchmark_cycles > 0)
+        return;
+
+    /* -e gesetzt: Programm beenden */
+    if (app->exit_on_hide) {
+        app->running = false;
+        return;
+    }
+
+    /*
+     * Kein Timeout (-s nicht gesetzt): Overlay sofort wieder anzeigen.
+     * Mit Timeout: die Idle-Notification ist automatisch neu gespannt und
+     * wird nach erneutem Ablauf wieder feuern — nichts weiter zu tun.
+     * Mit Steuersocket oder D-Bus wird nur auf Befehl angezeigt.
+     */
+    if (app->timeout_ms == 0 && !remote_control(app))
+        show_overlay(app);
+}
+
+/*
+ * Weckendes Ereignis bei sichtbarem Overlay festhalten, bevor
+ * hide_overlay() es abbaut. input_ns ist sein Zeitstempel auf
+ * CLOCK_MONOTONIC, 0 wenn es keinen gibt (Befehle).
+ */
+static void note_wake(App *app, JournalSource source, uint64_t input_ns)
+{
+    if (!app->overlay_visible)
+        return;
+    app->wake_ns     = input_ns;
+    app->wake_source = source;
+    journal_event(JOURNAL_WAKE, source,
+                  input_ns ? elapsed_ns(input_ns, monotonic_ns()) : 0);
+}
+
+/* =========================================================================
+ * Tastaturereignisse
+ * =========================================================================
+ * Bei jedem Tastendruck wird das Overlay geschlossen.
+ */
+static void keyboard_keymap(void *data, struct wl_keyboard *kb,
+                             uint32_t format, int32_t fd, uint32_t size)
+{
+    /* Keymap-Daten werden von uns nicht ausgewertet */
+    (void)kb; (void)format; (void)size;
+    App *app = ((Seat *)data)->app;
+    stats_event(&app->stats, EV_KEYBOARD_KEYMAP);
+    close(fd);
+}
+
+static void keyboard_enter(void *data, struct wl_keyboard *kb,
+                            uint32_t serial, struct wl_surface *surface,
+                            struct wl_array *keys)
+{
+    /* Fokus erhalten — keine Aktion nötig */
+    (void)kb; (void)serial; (void)surface; (void)keys;
+    Seat *s   = data;
+    App  *app = s->app;
+    stats_event(&app->stats, EV_KEYBOARD_ENTER);
+    record_event_args("wl_keyboard.enter", "%s", s->label);
+}
+
+static void keyboard_leave(void *data, struct wl_keyboard *kb,
+                            uint32_t serial, struct wl_surface *surface)
+{
+    /* Fokus verloren — keine Aktion nötig */
+    (void)kb; (void)serial; (void)surface;
+    Seat *s   = data;
+    App  *app = s->app;
+    stats_event(&app->stats, EV_KEYBOARD_LEAVE);
+    record_event_args("wl_keyboard.leave", "%s", s->label);
+}
+
+static void keyboard_key(void *data, struct wl_keyboard *kb,
+                          uint32_t serial, uint32_t time,
+                          uint32_t key, uint32_t state)
+{
+    (void)kb; (void)serial;
+    Seat *s   = data;
+    App  *app = s->app;
+    stats_event(&app->stats, EV_KEYBOARD_KEY);
+    record_event_args("wl_keyboard.key", "%u %u %u %s", key, state, time,
+                      s->label);
+    trace_instant_args("wl_keyboard.key", "\"key\":%u,\"state\":%u,\"time\":%u",
+                       key, state, time);
+
+    /* Nur beim Drücken (state=1) reagieren, nicht beim Loslassen */
+    if (state == WL_KEYBOARD_KEY_STATE_PRESSED) {
+        note_wake(app, JOURNAL_SOURCE_KEYBOARD, input_time_ns(time));
+        hide_overlay(app);
+    }
+}
+
+static void keyboard_modifiers(void *data, struct wl_keyboard *kb,
+                                uint32_t serial, uint32_t mods_depressed,
+                                uint32_t mods_latched, uint32_t mods_locked,
+                                uint32_t group)
+{
+    /* Modifier-Zustände werden nicht ausgewertet */
+    (void)kb; (void)serial; (void)mods_depressed;
+    (void)mods_latched; (void)mods_locked; (void)group;
+    App *app = ((Seat *)data)->app;
+    stats_event(&app->stats, EV_KEYBOARD_MODIFIERS);
+}
+
+static void keyboard_repeat_info(void *data, struct wl_keyboard *kb,
+                                  int32_t rate, int32_t delay)
+{
+    /* Wiederholungsrate wird nicht verwendet */
+    (void)kb; (void)rate; (void)delay;
+    App *app = ((Seat *)data)->app;
+    stats_event(&app->stats, EV_KEYBOARD_REPEAT);
+}
+
+static const struct wl_keyboard_listener keyboard_listener = {
+    .keymap      = keyboard_keymap,
+    .enter       = keyboard_enter,
+    .leave       = keyboard_leave,
+    .key         = keyboard_key,
+    .modifiers   = keyboard_modifiers,
+    .repeat_info = keyboard_repeat_info,
+};
+
+/* =========================================================================
+ * Mausereignisse
+ * =========================================================================
+ * Zeigerereignisse werden bis zum abschließenden wl_pointer.frame gesammelt
+ * und dann gemeinsam ausgewertet. Maustaste und Mausrad wecken sofort auf.
+ * Bewegung weckt erst, wenn der Zeiger innerhalb von motion_window_ms
+ * mindestens motion_threshold Pixel vom Ankerpunkt entfernt wurde — ein
+ * einzelnes zitterndes Sensor-Event oder ein Stoß gegen den Tisch baut das
+ * Overlay so nicht ab, nur um es Augenblicke später neu zu erstellen.
+ */
+
+/* Gesammelte Zeigerereignisse des abgeschlossenen Frames auswerten */
+static void pointer_flush(Seat *s)
+{
+    App *app = s->app;
+    bool wake = s->ptr_wake;
+
+    if (s->ptr_motion && !wake) {
+        if (app->motion_threshold <= 0) {
+            wake = true;
+        } else {
+            /* Zurückgelegten Weg seit dem Ankerpunkt prüfen */
+            double dx = s->ptr_x - s->ptr_anchor_x;
+            double dy = s->ptr_y - s->ptr_anchor_y;
+            double limit = (double)app->motion_threshold;
+            if (dx * dx + dy * dy >= limit * limit)
+                wake = true;
+        }
+    }
+
+    s->ptr_motion = false;
+    s->ptr_wake   = false;
+
+    if (wake) {
+        s->ptr_anchor_valid = false;
+        note_wake(app, JOURNAL_SOURCE_POINTER,
+                  input_time_ns(s->ptr_event_time));
+        hide_overlay(app);
+    }
+}
+
+/*
+ * Ältere Seats (Version < 5) kennen kein frame-Event. Dann wird jedes
+ * Zeigerereignis für sich als abgeschlossener Frame behandelt.
+ */
+static void pointer_event_done(Seat *s, struct wl_pointer *ptr)
+{
+    if (wl_pointer_get_version(ptr) < WL_POINTER_FRAME_SINCE_VERSION)
+        pointer_flush(s);
+}
+
+static void pointer_enter(void *data, struct wl_pointer *ptr,
+                           uint32_t serial, struct wl_surface *surface,
+                           wl_fixed_t sx, wl_fixed_t sy)
+{
+    /* Zeiger betritt unsere Surface — Cursor verstecken */
+    (void)surface;
+    Seat *s   = data;
+    App  *app = s->app;
+    stats_event(&app->stats, EV_POINTER_ENTER);
+    record_event_args("wl_pointer.enter", "%.2f %.2f %s",
+                      wl_fixed_to_double(sx), wl_fixed_to_double(sy), s->label);
+
+    /* Startposition merken; das Zeitfenster beginnt mit der ersten Bewegung */
+    s->ptr_inside       = true;
+    s->ptr_x            = wl_fixed_to_double(sx);
+    s->ptr_y            = wl_fixed_to_double(sy);
+    s->ptr_anchor_valid = false;
+
+    /* Unsichtbaren Cursor setzen: NULL-Surface = kein Cursor */
+    wl_pointer_set_cursor(ptr, serial, NULL, 0, 0);
+}
+
+static void pointer_leave(void *data, struct wl_pointer *ptr,
+                           uint32_t serial, struct wl_surface *surface)
+{
+    /* Zeiger verlässt unsere Surface — angefangenen Frame verwerfen */
+    (void)ptr; (void)serial; (void)surface;
+    Seat *s   = data;
+    App  *app = s->app;
+    stats_event(&app->stats, EV_POINTER_LEAVE);
+    record_event_args("wl_pointer.leave", "%s", s->label);
+    s->ptr_inside       = false;
+    s->ptr_motion       = false;
+    s->ptr_wake         = false;
+    s->ptr_anchor_valid = false;
+}
+
+static void pointer_motion(void *data, struct wl_pointer *ptr,
+                            uint32_t time, wl_fixed_t sx, wl_fixed_t sy)
+{
+    /* Mausbewegung erkannt: Position bis zum Frame-Ende vormerken */
+    Seat *s   = data;
+    App  *app = s->app;
+    stats_event(&app->stats, EV_POINTER_MOTION);
+    record_event_args("wl_pointer.motion", "%.2f %.2f %u %s",
+                      wl_fixed_to_double(sx), wl_fixed_to_double(sy), time,
+                      s->label);
+    trace_instant_args("wl_pointer.motion", "\"x\":%.1f,\"y\":%.1f,\"time\":%u",
+                       wl_fixed_to_double(sx), wl_fixed_to_double(sy), time);
+
+    /*
+     * Erste Bewegung nach enter oder Zeitfenster abgelaufen: das Fenster
+     * beginnt neu an der Position vor dieser Bewegung.
+     */
+    if (!s->ptr_anchor_valid ||
+        time - s->ptr_anchor_time > (uint32_t)app->motion_window_ms) {
+        s->ptr_anchor_x     = s->ptr_x;
+        s->ptr_anchor_y     = s->ptr_y;
+        s->ptr_anchor_time  = time;
+        s->ptr_anchor_valid = true;
+    }
+
+    s->ptr_x          = wl_fixed_to_double(sx);
+    s->ptr_y          = wl_fixed_to_double(sy);
+    s->ptr_event_time = time;
+    s->ptr_motion     = true;
+    pointer_event_done(s, ptr);
+}
+
+static void pointer_button(void *data, struct wl_pointer *ptr,
                             uint32_t serial, uint32_t time,
                             uint32_t button, uint32_t state)
 {
-    /* Maustaste gedrückt: Overlay schließen */
-    (void)ptr; (void)serial; (void)time; (void)button;
-    App *app = data;
+    /* Maustaste gedrückt: Overlay am Frame-Ende schließen */
+    (void)serial;
+    Seat *s   = data;
+    App  *app = s->app;
+    stats_event(&app->stats, EV_POINTER_BUTTON);
+    record_event_args("wl_pointer.button", "%u %u %u %s", button, state, time,
+                      s->label);
+    trace_instant_args("wl_pointer.button", "\"button\":%u,\"state\":%u,\"time\":%u",
+                       button, state, time);
 
-    if (state == WL_POINTER_BUTTON_STATE_PRESSED)
-        hide_overlay(app);
+    if (state == WL_POINTER_BUTTON_STATE_PRESSED) {
+        s->ptr_wake       = true;
+        s->ptr_event_time = time;
+    }
+    pointer_event_done(s, ptr);
 }
 
 static void pointer_axis(void *data, struct wl_pointer *ptr,
                           uint32_t time, uint32_t axis, wl_fixed_t value)
 {
-    /* Mausrad: Overlay schließen */
-    (void)ptr; (void)time; (void)axis; (void)value;
-    App *app = data;
-    hide_overlay(app);
+    /* Mausrad: Overlay am Frame-Ende schließen */
+    (void)value;
+    Seat *s   = data;
+    App  *app = s->app;
+    stats_event(&app->stats, EV_POINTER_AXIS);
+    record_event_args("wl_pointer.axis", "%u %.2f %u %s", axis,
+                      wl_fixed_to_double(value), time, s->label);
+    trace_instant_args("wl_pointer.axis", "\"axis\":%u,\"time\":%u", axis, time);
+    s->ptr_wake       = true;
+    s->ptr_event_time = time;
+    pointer_event_done(s, ptr);
 }
 
 static void pointer_frame(void *data, struct wl_pointer *ptr)
 {
-    /* Frame-Event: keine Aktion nötig */
-    (void)data; (void)ptr;
+    /* Frame abgeschlossen: gesammelte Ereignisse auswerten */
+    (void)ptr;
+    Seat *s   = data;
+    App  *app = s->app;
+    stats_event(&app->stats, EV_POINTER_FRAME);
+    record_event_args("wl_pointer.frame", "%s", s->label);
+    trace_instant("wl_pointer.frame");
+    pointer_flush(s);
 }
 
 static void pointer_axis_source(void *data, struct wl_pointer *ptr,
                                  uint32_t axis_source)
 {
-    (void)data; (void)ptr; (void)axis_source;
+    (void)ptr; (void)axis_source;
+    App *app = ((Seat *)data)->app;
+    stats_event(&app->stats, EV_POINTER_AXIS_OTHER);
 }
 
 static void pointer_axis_stop(void *data, struct wl_pointer *ptr,
                                uint32_t time, uint32_t axis)
 {
-    (void)data; (void)ptr; (void)time; (void)axis;
+    (void)ptr; (void)time; (void)axis;
+    App *app = ((Seat *)data)->app;
+    stats_event(&app->stats, EV_POINTER_AXIS_OTHER);
 }
 
 static void pointer_axis_discrete(void *data, struct wl_pointer *ptr,
                                    uint32_t axis, int32_t discrete)
 {
-    (void)data; (void)ptr; (void)axis; (void)discrete;
+    (void)ptr; (void)axis; (void)discrete;
+    App *app = ((Seat *)data)->app;
+    stats_event(&app->stats, EV_POINTER_AXIS_OTHER);
 }
 
 static const struct wl_pointer_listener pointer_listener = {
@@ -550,191 +2234,2240 @@ static const struct wl_pointer_listener pointer_listener = {
 static void seat_capabilities(void *data, struct wl_seat *seat,
                                uint32_t capabilities)
 {
-    App *app = data;
+    Seat *s   = data;
+    App  *app = s->app;
+    stats_event(&app->stats, EV_SEAT_CAPABILITIES);
+    record_event_args("wl_seat.capabilities", "%u", capabilities);
+
+    /*
+     * Modus -r: keine Eingabeobjekte binden. Der Compositor schickt uns
+     * dann überhaupt keine Tastatur- oder Mausereignisse; aufgeweckt wird
+     * ausschließlich über idle_notification_resumed().
+     */
+    if (app->resume_only)
+        return;
 
     /* Tastatur verfügbar und noch nicht angemeldet: Listener registrieren */
-    if ((capabilities & WL_SEAT_CAPABILITY_KEYBOARD) && !app->keyboard) {
-        app->keyboard = wl_seat_get_keyboard(seat);
-        wl_keyboard_add_listener(app->keyboard, &keyboard_listener, app);
+    if ((capabilities & WL_SEAT_CAPABILITY_KEYBOARD) && !s->keyboard) {
+        s->keyboard = wl_seat_get_keyboard(seat);
+        wl_keyboard_add_listener(s->keyboard, &keyboard_listener, s);
     }
 
     /* Maus/Touchpad verfügbar und noch nicht angemeldet: Listener registrieren */
-    if ((capabilities & WL_SEAT_CAPABILITY_POINTER) && !app->pointer) {
-        app->pointer = wl_seat_get_pointer(seat);
-        wl_pointer_add_listener(app->pointer, &pointer_listener, app);
+    if ((capabilities & WL_SEAT_CAPABILITY_POINTER) && !s->pointer) {
+        s->pointer = wl_seat_get_pointer(seat);
+        wl_pointer_add_listener(s->pointer, &pointer_listener, s);
+    }
+}
+
+static void seat_watch(Seat *s);
+
+static void seat_name(void *data, struct wl_seat *seat, const char *name)
+{
+    /* Name für --seats; ein Seat aus --seats wird erst jetzt beobachtet */
+    (void)seat;
+    Seat *s   = data;
+    App  *app = s->app;
+    stats_event(&app->stats, EV_SEAT_NAME);
+    snprintf(s->label, sizeof(s->label), "%s", name);
+    if (app->idle_wayland && !s->idle_notification)
+        seat_watch(s);
+}
+
+static const struct wl_seat_listener seat_listener = {
+    .capabilities = seat_capabilities,
+    .name         = seat_name,
+};
+
+/* =========================================================================
+ * Idle-Notification-Ereignisse
+ * =========================================================================
+ * Der Compositor feuert diese Events, wenn der Benutzer die eingestellte
+ * Zeit inaktiv war (idled) bzw. wieder aktiv wurde (resumed).
+ */
+/* Inaktivitäts-Schwelle erreicht: schwarzes Overlay anzeigen */
+static void idle_idled(App *app)
+{
+    trace_instant("idled");
+    app->idled = true;
+    if (!app->overlay_visible) {
+        app->idled_ns = monotonic_ns();
+        journal_event(JOURNAL_IDLED, 0, 0);
+    }
+    show_overlay(app);
+}
+
+/*
+ * Entscheidet mit -m der Mindestweg über das Wecken? Das gilt, solange der
+ * Zeiger eines Seats auf dem Overlay steht: Dann kommen seine Bewegungen
+ * bei uns an, und resumed, das der Compositor schon beim kleinsten Zittern
+ * schickt, darf das Overlay nicht vorher abbauen. Steht der Zeiger auf
+ * einer anderen Ausgabe, meldet nur resumed die Bewegung.
+ */
+static bool motion_decides(const App *app)
+{
+    if (app->motion_threshold <= 0)
+        return false;
+    for (int i = 0; i < app->nseats; i++)
+        if (app->seats[i].pointer && app->seats[i].ptr_inside)
+            return true;
+    return false;
+}
+
+/*
+ * Benutzer wieder aktiv: Overlay schließen, falls noch sichtbar.
+ * Normalerweise wird hide_overlay() bereits durch Tastatur-/Mausereignisse
+ * auf dem Overlay-Fenster ausgelöst. resumed dient als Absicherung — im
+ * Modus -r ist es die einzige Weckquelle. Mit -m überlässt es das Wecken
+ * den Tasten, Maustasten, dem Mausrad und dem Mindestweg (motion_decides).
+ *
+ * Der Compositor darf ein erstes resumed jederzeit nach dem Anlegen der
+ * Notification schicken, also auch ohne vorheriges idled. Das darf ein
+ * sofort angezeigtes Overlay (-r ohne -s) nicht schließen.
+ */
+static void idle_resumed(App *app)
+{
+    trace_instant("resumed");
+    if (!app->idled)
+        return;
+    app->idled = false;
+    if (motion_decides(app))
+        return;
+    note_wake(app, JOURNAL_SOURCE_RESUMED, monotonic_ns());
+    hide_overlay(app);
+}
+
+/* Wird mindestens ein Seat beobachtet? */
+static bool seats_watched(const App *app)
+{
+    for (int i = 0; i < app->nseats; i++)
+        if (app->seats[i].idle_notification)
+            return true;
+    return false;
+}
+
+/* Sind alle beobachteten Seats inaktiv? Ohne beobachteten Seat nie. */
+static bool seats_idle(const App *app)
+{
+    bool watched = false;
+
+    for (int i = 0; i < app->nseats; i++) {
+        const Seat *s = &app->seats[i];
+        if (!s->idle_notification)
+            continue;
+        if (!s->idled)
+            return false;
+        watched = true;
+    }
+    return watched;
+}
+
+/*
+ * Gesamtzustand nach idled, resumed oder einem entfernten Seat nachziehen:
+ * Das Overlay erscheint mit dem letzten inaktiven Seat und schließt mit dem
+ * ersten, der wieder aktiv wird. Ein neu hinzugekommener Seat weckt nicht.
+ */
+static void seats_update(App *app)
+{
+    if (seats_idle(app)) {
+        if (!app->idled)
+            idle_idled(app);
+    } else if (app->idled) {
+        idle_resumed(app);
+    }
+}
+
+/* Übergang eines Seats im Trace; der Name kommt vom Compositor */
+static void trace_seat(const char *name, const Seat *s)
+{
+    if (!trace_file)
+        return;
+    char label[6 * sizeof(s->label)];
+    trace_instant_args(name, "\"seat\":\"%s\"",
+                       trace_escape(s->label, label, sizeof(label)));
+}
+
+static void idle_notification_idled(void *data,
+                                    struct ext_idle_notification_v1 *notif)
+{
+    (void)notif;
+    Seat *s   = data;
+    App  *app = s->app;
+    stats_event(&app->stats, EV_IDLE_IDLED);
+    record_event_args("ext_idle_notification_v1.idled", "%s", s->label);
+    trace_seat("seat_idled", s);
+    s->idled = true;
+    seats_update(app);
+}
+
+static void idle_notification_resumed(void *data,
+                                      struct ext_idle_notification_v1 *notif)
+{
+    (void)notif;
+    Seat *s   = data;
+    App  *app = s->app;
+    stats_event(&app->stats, EV_IDLE_RESUMED);
+    record_event_args("ext_idle_notification_v1.resumed", "%s", s->label);
+    trace_seat("seat_resumed", s);
+    s->idled = false;
+    seats_update(app);
+}
+
+static const struct ext_idle_notification_v1_listener idle_notification_listener = {
+    .idled   = idle_notification_idled,
+    .resumed = idle_notification_resumed,
+};
+
+/* =========================================================================
+ * Seats verwalten
+ * =========================================================================
+ * Jeder angekündigte wl_seat bekommt einen Eintrag in app->seats. Beobachtet
+ * (mit eigener Idle-Notification) werden alle Seats oder nur die mit
+ * --seats genannten. Der Name kommt erst mit wl_seat.name nach dem Binden;
+ * bis dahin gilt "wl_seat#<registry-name>", und ein Filter greift noch nicht.
+ */
+
+/* Timeout für Notification bzw. evdev: -s, oder fast sofort bei -r */
+static int idle_timeout_ms(const App *app)
+{
+    return app->timeout_ms > 0 ? app->timeout_ms : RESUME_ONLY_TIMEOUT_MS;
+}
+
+/* Gehört der Seat zu den mit --seats genannten? Ohne --seats alle. */
+static bool seat_selected(const App *app, const Seat *s)
+{
+    if (!app->seat_filter)
+        return true;
+
+    size_t len = strlen(s->label);
+    for (const char *p = app->seat_filter; *p; ) {
+        const char *end = strchrnul(p, ',');
+        if ((size_t)(end - p) == len && strncmp(p, s->label, len) == 0)
+            return true;
+        p = *end ? end + 1 : end;
+    }
+    return false;
+}
+
+/* Idle-Notification für einen ausgewählten Seat anlegen */
+static void seat_watch(Seat *s)
+{
+    App *app = s->app;
+    if (!app->idle_notifier || !seat_selected(app, s))
+        return;
+
+    s->idled = false;
+    s->idle_notification = ext_idle_notifier_v1_get_idle_notification(
+        app->idle_notifier, (uint32_t)idle_timeout_ms(app), s->seat);
+    if (!s->idle_notification) {
+        fprintf(stderr, "get_idle_notification für %s fehlgeschlagen\n",
+                s->label);
+        return;
+    }
+    ext_idle_notification_v1_add_listener(s->idle_notification,
+                                          &idle_notification_listener, s);
+}
+
+static void seat_unwatch(Seat *s)
+{
+    if (s->idle_notification) {
+        ext_idle_notification_v1_destroy(s->idle_notification);
+        s->idle_notification = NULL;
+    }
+    s->idled = false;
+}
+
+/* Neuen Seat binden; bei gespannter Beobachtung sofort mitbeobachten */
+static void add_seat(App *app, struct wl_registry *registry,
+                     uint32_t name, uint32_t version)
+{
+    if (app->nseats >= MAX_SEATS) {
+        fprintf(stderr, "Zu viele Seats, ignoriere weitere\n");
+        return;
+    }
+    Seat *s = &app->seats[app->nseats++];
+    *s = (Seat){ .app = app, .name = name };
+    /* Ohne wl_seat.name (Version < 2) bleibt die Registry-Nummer */
+    snprintf(s->label, sizeof(s->label), "wl_seat#%u", name);
+    s->seat = wl_registry_bind(registry, name, &wl_seat_interface,
+                               (version < 5 ? version : 5));
+    wl_seat_add_listener(s->seat, &seat_listener, s);
+
+    /* Mit --seats erst nach wl_seat.name, sonst gleich */
+    if (app->idle_wayland && !app->seat_filter)
+        seat_watch(s);
+}
+
+/* Entfernten Seat freigeben; gibt false zurück, wenn er unbekannt ist */
+static bool remove_seat(App *app, uint32_t name)
+{
+    for (int i = 0; i < app->nseats; i++) {
+        Seat *s = &app->seats[i];
+        if (s->name != name)
+            continue;
+        seat_unwatch(s);
+        if (s->keyboard)
+            wl_keyboard_destroy(s->keyboard);
+        if (s->pointer)
+            wl_pointer_destroy(s->pointer);
+        wl_seat_destroy(s->seat);
+        /* Letzten Eintrag nachrücken; die Listener-Daten zeigen auf den Platz */
+        app->nseats--;
+        if (i != app->nseats) {
+            *s = app->seats[app->nseats];
+            wl_proxy_set_user_data((struct wl_proxy *)s->seat, s);
+            if (s->keyboard)
+                wl_proxy_set_user_data((struct wl_proxy *)s->keyboard, s);
+            if (s->pointer)
+                wl_proxy_set_user_data((struct wl_proxy *)s->pointer, s);
+            if (s->idle_notification)
+                wl_proxy_set_user_data((struct wl_proxy *)s->idle_notification, s);
+        }
+        return true;
+    }
+    return false;
+}
+
+/* =========================================================================
+ * Wayland Registry
+ * =========================================================================
+ * Der Compositor kündigt hier alle verfügbaren globalen Objekte an.
+ * Wir binden die Objekte, die wir benötigen.
+ */
+static void registry_global(void *data, struct wl_registry *registry,
+                             uint32_t name, const char *interface,
+                             uint32_t version)
+{
+    App *app = data;
+    stats_event(&app->stats, EV_REGISTRY_GLOBAL);
+    record_event_args("wl_registry.global", "%u %s %u",
+                      name, interface, version);
+    trace_begin_args("registry_global", "\"interface\":\"%s\",\"version\":%u",
+                     interface, version);
+
+    /* wl_compositor: zum Erstellen von Surfaces */
+    if (strcmp(interface, wl_compositor_interface.name) == 0) {
+        app->compositor = wl_registry_bind(registry, name,
+                                           &wl_compositor_interface,
+                                           (version < 4 ? version : 4));
+
+    /* wl_shm: für Shared-Memory-Pixelpuffer */
+    } else if (strcmp(interface, wl_shm_interface.name) == 0) {
+        app->shm = wl_registry_bind(registry, name,
+                                    &wl_shm_interface, 1);
+
+    /* wl_seat: für Tastatur- und Mauseingaben */
+    } else if (strcmp(interface, wl_seat_interface.name) == 0) {
+        add_seat(app, registry, name, version);
+
+    /* zwlr_layer_shell_v1: für das Overlay-Fenster über allen anderen */
+    } else if (strcmp(interface, zwlr_layer_shell_v1_interface.name) == 0) {
+        app->layer_shell = wl_registry_bind(registry, name,
+                                            &zwlr_layer_shell_v1_interface,
+                                            (version < 4 ? version : 4));
+
+    /* ext_idle_notifier_v1: für die Inaktivitätserkennung */
+    } else if (strcmp(interface, ext_idle_notifier_v1_interface.name) == 0) {
+        app->idle_notifier = wl_registry_bind(registry, name,
+                                              &ext_idle_notifier_v1_interface,
+                                              1);
+
+    /* wp_presentation: tatsächlicher Anzeigezeitpunkt (optional) */
+    } else if (strcmp(interface, wp_presentation_interface.name) == 0) {
+        app->presentation = wl_registry_bind(registry, name,
+                                             &wp_presentation_interface, 1);
+        wp_presentation_add_listener(app->presentation,
+                                     &presentation_listener, app);
+
+    /*
+     * wp_viewporter: Skalierung des 1x1-Puffers für --strategy small. Immer
+     * gebunden, da die Strategie per Konfigurationsdatei wechseln kann.
+     */
+    } else if (strcmp(interface, wp_viewporter_interface.name) == 0) {
+        app->viewporter = wl_registry_bind(registry, name,
+                                           &wp_viewporter_interface, 1);
+
+    /*
+     * wl_output (--strategy gamma, --benchmark-outputs, Vorab-Füllung).
+     * Immer gebunden: eine Farbe kann auch erst per Konfiguration kommen.
+     */
+    } else if (strcmp(interface, wl_output_interface.name) == 0) {
+        add_output(app, registry, name, version);
+
+    /* Gamma-Steuerung (nur --strategy gamma) */
+    } else if (strcmp(interface,
+                      zwlr_gamma_control_manager_v1_interface.name) == 0 &&
+               app->strategy == STRATEGY_GAMMA) {
+        app->gamma_manager = wl_registry_bind(
+            registry, name, &zwlr_gamma_control_manager_v1_interface, 1);
+    }
+
+    trace_end("registry_global");
+}
+
+static void registry_global_remove(void *data, struct wl_registry *registry,
+                                   uint32_t name)
+{
+    /* Bis auf abgesteckte Ausgaben und entfernte Seats ignoriert */
+    (void)registry;
+    App *app = data;
+    stats_event(&app->stats, EV_REGISTRY_REMOVE);
+    record_event_args("wl_registry.global_remove", "%u", name);
+    if (remove_output(app, name))
+        return;
+    /* Waren die übrigen Seats schon inaktiv, erscheint das Overlay jetzt */
+    if (remove_seat(app, name) && app->idle_wayland)
+        seats_update(app);
+}
+
+static const struct wl_registry_listener registry_listener = {
+    .global        = registry_global,
+    .global_remove = registry_global_remove,
+};
+
+/* =========================================================================
+ * Idle-Notification einrichten
+ * =========================================================================
+ * Erstellt für jeden beobachteten Seat eine Benachrichtigung für den
+ * angegebenen Timeout und registriert den Listener. Der Compositor beginnt
+ * sofort mit der Zeitmessung. Später angekündigte Seats kommen über
+ * add_seat() bzw. seat_name() hinzu, solange idle_wayland gesetzt ist.
+ */
+static bool setup_idle_notification(App *app)
+{
+    if (!app->idle_notifier) {
+        fprintf(stderr, "Compositor unterstützt ext-idle-notify-v1 nicht "
+                        "(--idle-backend evdev)\n");
+        return false;
+    }
+    if (app->nseats == 0) {
+        fprintf(stderr, "Kein Seat gefunden\n");
+        return false;
+    }
+
+    /* Je ausgewähltem Seat eine Notification für den gewünschten Timeout */
+    app->idle_wayland = true;
+    for (int i = 0; i < app->nseats; i++)
+        seat_watch(&app->seats[i]);
+
+    /* Ein Seat aus --seats kann auch später noch angekündigt werden */
+    if (!seats_watched(app))
+        fprintf(stderr, "Kein Seat aus --seats %s vorhanden, "
+                        "warte auf ihn\n", app->seat_filter);
+    return true;
+}
+
+/* Alle Idle-Notifications der Seats freigeben */
+static void teardown_idle_notification(App *app)
+{
+    for (int i = 0; i < app->nseats; i++)
+        seat_unwatch(&app->seats[i]);
+    app->idle_wayland = false;
+}
+
+/* =========================================================================
+ * Hauptschleife
+ * =========================================================================
+ * Wartet mit poll() ohne Timeout gleichzeitig auf die Wayland-Verbindung
+ * und alle registrierten Ereignisquellen. Jede Rückkehr aus poll() wird
+ * mit ihrer Ursache gezählt. Solange keine Quelle einen Timer registriert,
+ * wacht blkout nur auf, wenn tatsächlich ein Ereignis eintrifft.
+ */
+
+/*
+ * Ereignisquelle mit eigener poll()-Maske registrieren (z.B. POLLOUT für
+ * einen Socket mit ausstehender Antwort). Gibt false zurück, wenn kein
+ * Platz frei ist.
+ */
+static bool add_source_events(App *app, int fd, short events, WakeCause cause,
+                              void (*handler)(App *app, int fd))
+{
+    if (app->nsources >= MAX_SOURCES) {
+        fprintf(stderr, "Zu viele Ereignisquellen\n");
+        return false;
+    }
+    app->sources[app->nsources++] = (Source){
+        .fd = fd, .events = events, .cause = cause, .handler = handler,
+        .gen = ++app->source_gen,
+    };
+    return true;
+}
+
+/* Ereignisquelle registrieren. Gibt false zurück, wenn kein Platz frei ist. */
+static bool add_source(App *app, int fd, WakeCause cause,
+                       void (*handler)(App *app, int fd))
+{
+    return add_source_events(app, fd, POLLIN, cause, handler);
+}
+
+/* timerfd für --content anlegen, sobald ein Inhalt gewählt ist */
+static bool setup_content_timer(App *app)
+{
+    if (app->content_mode == CONTENT_NONE || app->content_timer_fd >= 0)
+        return true;
+    app->content_timer_fd = timerfd_create(CLOCK_REALTIME,
+                                           TFD_NONBLOCK | TFD_CLOEXEC);
+    if (app->content_timer_fd < 0) {
+        perror("timerfd_create");
+        return false;
+    }
+    return add_source(app, app->content_timer_fd, WAKE_TIMER,
+                      handle_content_timer);
+}
+
+/* Ereignisquelle austragen, bevor ihr fd geschlossen wird */
+static void remove_source(App *app, int fd)
+{
+    for (int i = 0; i < app->nsources; i++) {
+        if (app->sources[i].fd == fd) {
+            app->sources[i] = app->sources[--app->nsources];
+            return;
+        }
+    }
+}
+
+/*
+ * Ist die kopierte Quelle noch registriert? Ein früherer Handler derselben
+ * Runde kann sie ausgetragen und ihren fd geschlossen haben; ein neu
+ * geöffneter fd mit derselben Nummer trägt eine andere gen.
+ */
+static bool source_live(const App *app, const Source *s)
+{
+    for (int i = 0; i < app->nsources; i++)
+        if (app->sources[i].fd == s->fd && app->sources[i].gen == s->gen)
+            return true;
+    return false;
+}
+
+/*
+ * Handler der Quellen aufrufen, die poll() als bereit meldet (pfd[i]
+ * gehört zu src[i]). Gibt die Wakeup-Ursachen als Bitmaske zurück.
+ */
+static unsigned dispatch_sources(App *app, const Source *src,
+                                 const struct pollfd *pfd, int nsrc)
+{
+    unsigned causes = 0;
+    for (int i = 0; i < nsrc; i++) {
+        if (!pfd[i].revents || !source_live(app, &src[i]))
+            continue;
+        causes |= 1u << src[i].cause;
+        src[i].handler(app, src[i].fd);
+    }
+    return causes;
+}
+
+/* Verbindung i austragen und schließen; die Reihenfolge bleibt erhalten */
+static void metrics_client_drop(App *app, int i)
+{
+    remove_source(app, app->metrics_clients[i].fd);
+    metrics_client_close(&app->metrics_clients[i]);
+    app->nmetrics_clients--;
+    memmove(&app->metrics_clients[i], &app->metrics_clients[i + 1],
+            sizeof(MetricsClient) * (size_t)(app->nmetrics_clients - i));
+}
+
+/* Metrik-Verbindung schreibbar: Rest des Texts senden */
+static void handle_metrics_client(App *app, int fd)
+{
+    for (int i = 0; i < app->nmetrics_clients; i++) {
+        if (app->metrics_clients[i].fd != fd)
+            continue;
+        if (metrics_send(&app->metrics_clients[i]))
+            metrics_client_drop(app, i);
+        return;
+    }
+}
+
+/*
+ * Metrik-Socket: wartende Verbindungen annehmen und den Stand senden.
+ * Meist passt er ganz in den Socket-Puffer; sonst wartet der Rest als
+ * eigene Quelle auf POLLOUT, ohne die Hauptschleife aufzuhalten.
+ */
+static void handle_metrics(App *app, int fd)
+{
+    MetricsClient c;
+
+    while (metrics_accept(&app->metrics, fd, &c)) {
+        if (metrics_send(&c)) {
+            metrics_client_close(&c);
+            continue;
+        }
+        if (app->nmetrics_clients == METRICS_MAX_CLIENTS)
+            metrics_client_drop(app, 0);
+        if (!add_source_events(app, c.fd, POLLOUT, WAKE_IPC,
+                               handle_metrics_client)) {
+            metrics_client_close(&c);
+            continue;
+        }
+        app->metrics_clients[app->nmetrics_clients++] = c;
+    }
+}
+
+/* Signale über signalfd: SIGINT/SIGTERM beenden sauber, SIGUSR1 zeigt Zähler */
+static void handle_signal(App *app, int fd)
+{
+    struct signalfd_siginfo info;
+
+    while (read(fd, &info, sizeof(info)) == (ssize_t)sizeof(info)) {
+        if (info.ssi_signo == SIGUSR1)
+            stats_print(&app->stats, stderr);
+        else
+            app->running = false;
+    }
+}
+
+/*
+ * Signale blockieren und stattdessen über einen signalfd in die
+ * Hauptschleife holen. So läuft auch bei SIGTERM das normale Aufräumen.
+ */
+static bool setup_signals(App *app)
+{
+    sigset_t mask;
+    sigemptyset(&mask);
+    sigaddset(&mask, SIGINT);
+    sigaddset(&mask, SIGTERM);
+    sigaddset(&mask, SIGUSR1);
+
+    if (sigprocmask(SIG_BLOCK, &mask, NULL) < 0) {
+        perror("sigprocmask");
+        return false;
+    }
+    app->signal_fd = signalfd(-1, &mask, SFD_CLOEXEC | SFD_NONBLOCK);
+    if (app->signal_fd < 0) {
+        perror("signalfd");
+        sigprocmask(SIG_UNBLOCK, &mask, NULL);
+        return false;
+    }
+    return add_source(app, app->signal_fd, WAKE_SIGNAL, handle_signal);
+}
+
+/* =========================================================================
+ * Steuersocket und Beenden bei Ruhe (--control-socket, --exit-idle)
+ * =========================================================================
+ * Mit Steuersocket zeigt blkout das Overlay ohne -s nicht sofort, sondern
+ * erst auf den Befehl show. Per Socket-Aktivierung gestartet, muss blkout
+ * so nicht dauerhaft laufen: Die erste Verbindung startet es, und mit
+ * --exit-idle beendet es sich, sobald das Overlay so lange nicht sichtbar
+ * war, kein Befehl kam und keine Idle-Notification gespannt ist. Der
+ * nächste Befehl startet es dann erneut über den Socket.
+ */
+
+/* Wartet blkout gerade auf Inaktivität (Notification oder evdev)? */
+static bool idle_armed(const App *app)
+{
+    return app->idle_wayland || app->evdev.epoll_fd >= 0;
+}
+
+/* Ruhe-Timer neu starten bzw. anhalten, je nachdem ob Ruhe herrscht */
+static void update_exit_timer(App *app)
+{
+    if (app->exit_timer_fd < 0)
+        return;
+
+    struct itimerspec its = { 0 };
+    if (!app->overlay_visible && !idle_armed(app)) {
+        its.it_value.tv_sec  = app->exit_idle_ms / 1000;
+        its.it_value.tv_nsec = (long)(app->exit_idle_ms % 1000) * 1000000;
+    }
+    timerfd_settime(app->exit_timer_fd, 0, &its, NULL);
+}
+
+/* Ruhe-Timer abgelaufen */
+static void handle_exit_timer(App *app, int fd)
+{
+    uint64_t expirations;
+    if (read(fd, &expirations, sizeof(expirations)) < 0)
+        return;
+    if (app->overlay_visible || idle_armed(app))
+        return;
+    fprintf(stderr, "Seit %d s untätig, beende\n", app->exit_idle_ms / 1000);
+    app->running = false;
+}
+
+/* Befehl vom Steuersocket ausführen */
+static void run_control_command(App *app, ControlCommand cmd)
+{
+    switch (cmd) {
+    case CONTROL_SHOW:
+        trace_instant("control_show");
+        show_overlay(app);
+        break;
+    case CONTROL_HIDE:
+        trace_instant("control_hide");
+        note_wake(app, JOURNAL_SOURCE_CONTROL, 0);
+        hide_overlay(app);
+        break;
+    case CONTROL_QUIT:
+        app->running = false;
+        break;
+    default:
+        break;
+    }
+}
+
+/* Verbindung i austragen und schließen; die Reihenfolge bleibt erhalten */
+static void control_client_close(App *app, int i)
+{
+    int fd = app->control_clients[i].fd;
+    remove_source(app, fd);
+    close(fd);
+    app->ncontrol_clients--;
+    memmove(&app->control_clients[i], &app->control_clients[i + 1],
+            sizeof(ControlClient) * (size_t)(app->ncontrol_clients - i));
+}
+
+/* Verbindung lesbar: Befehl ausführen, sobald die Zeile vollständig ist */
+static void handle_control_client(App *app, int fd)
+{
+    for (int i = 0; i < app->ncontrol_clients; i++) {
+        if (app->control_clients[i].fd != fd)
+            continue;
+        ControlCommand cmd = control_read(&app->control_clients[i]);
+        if (cmd == CONTROL_PENDING)
+            return;
+        control_client_close(app, i);
+        run_control_command(app, cmd);
+
+        /* Jeder Befehl zählt als Aktivität */
+        update_exit_timer(app);
+        return;
+    }
+}
+
+/*
+ * Steuersocket: wartende Verbindungen annehmen. Jede wird eine eigene
+ * Quelle; meist steht die Zeile schon an und wird gleich gelesen.
+ */
+static void handle_control(App *app, int fd)
+{
+    int client;
+
+    while ((client = control_accept(fd)) >= 0) {
+        if (app->ncontrol_clients == CONTROL_MAX_CLIENTS)
+            control_client_close(app, 0);
+        if (!add_source(app, client, WAKE_IPC, handle_control_client)) {
+            close(client);
+            continue;
+        }
+        app->control_clients[app->ncontrol_clients++] =
+            (ControlClient){ .fd = client };
+        handle_control_client(app, client);
+    }
+}
+
+/* =========================================================================
+ * org.freedesktop.ScreenSaver (--dbus-screensaver)
+ * =========================================================================
+ * Dieselben Befehle wie über den Steuersocket, nur als Methodenaufrufe auf
+ * dem Session-Bus (siehe screensaver.h).
+ */
+static bool screensaver_get_active(void *data)
+{
+    App *app = data;
+    return app->overlay_visible;
+}
+
+static bool screensaver_set_active(void *data, bool active)
+{
+    App *app = data;
+    trace_instant_args("dbus_set_active", "\"active\":%d", active);
+    if (active) {
+        show_overlay(app);
+    } else {
+        note_wake(app, JOURNAL_SOURCE_DBUS, 0);
+        hide_overlay(app);
+    }
+    update_exit_timer(app);
+    return app->overlay_visible == active;
+}
+
+static uint32_t screensaver_get_active_time(void *data)
+{
+    App *app = data;
+    if (!app->overlay_visible)
+        return 0;
+    return (uint32_t)((monotonic_ns() - app->show_ns) / 1000000000ull);
+}
+
+/* Session-Bus: Methodenaufrufe ausführen; bei Verbindungsverlust abmelden */
+static void handle_screensaver(App *app, int fd)
+{
+    if (screensaver_dispatch(app->screensaver))
+        return;
+    remove_source(app, fd);
+    screensaver_close(app->screensaver);
+    app->screensaver = NULL;
+    update_exit_timer(app);
+}
+
+static bool setup_screensaver(App *app)
+{
+    static ScreenSaverHandler handler = {
+        .get_active      = screensaver_get_active,
+        .set_active      = screensaver_set_active,
+        .get_active_time = screensaver_get_active_time,
+    };
+    handler.data = app;
+
+    app->screensaver = screensaver_open(&handler);
+    if (!app->screensaver)
+        return false;
+    return add_source(app, screensaver_fd(app->screensaver), WAKE_IPC,
+                      handle_screensaver);
+}
+
+/* =========================================================================
+ * Speicherdruck (--memory-pressure)
+ * =========================================================================
+ * Siehe psi.h. Ohne Druck weckt der Trigger nie; mit Druck höchstens
+ * einmal je PSI-Fenster. Ein sichtbares Overlay behält seinen Puffer, der
+ * Vorrat wird dann erst beim Schließen verworfen.
+ */
+static void handle_psi(App *app, int fd)
+{
+    bool fired = psi_dispatch(&app->psi);
+    if (app->psi.epoll_fd < 0)
+        remove_source(app, fd);
+    if (!fired)
+        return;
+
+    trace_instant("memory_pressure");
+    app->metrics.pressure_events++;
+    prefill_hold_start(app);
+    if (app->overlay_visible)
+        app->evict_on_hide = true;
+    else
+        evict_warm(app);
+    publish_metrics(app);
+}
+
+static void setup_psi(App *app)
+{
+    if (app->psi_stall_ms == 0 ||
+        !psi_open(&app->psi, PSI_MEMORY_PATH, app->psi_stall_ms))
+        return;
+    if (!add_source(app, app->psi.epoll_fd, WAKE_PRESSURE, handle_psi))
+        psi_close(&app->psi);
+}
+
+/* =========================================================================
+ * Vorab-Füllung in der Hauptschleife
+ * =========================================================================
+ * Siehe prefill_next(). Der Thread meldet sich über ein eventfd, das Ende
+ * der Druckpause über einen timerfd; ohne Farbe gibt es beides nicht.
+ */
+static void handle_prefill(App *app, int fd)
+{
+    (void)fd;
+    prefill_store(app, fill_async_finish(&app->prefill));
+    publish_metrics(app);
+    prefill_next(app);
+}
+
+static void handle_prefill_timer(App *app, int fd)
+{
+    uint64_t expirations;
+    if (read(fd, &expirations, sizeof(expirations)) < 0)
+        return;
+    app->prefill_hold = false;
+    prefill_next(app);
+}
+
+/* Nur mit Farbe; ohne Thread oder Timer füllt wie bisher das Anzeigen */
+static void setup_prefill(App *app)
+{
+    if (app->prefill.done_fd >= 0 || !prefill_wanted(app))
+        return;
+    if (!fill_async_init(&app->prefill))
+        return;
+    app->prefill_timer_fd = timerfd_create(CLOCK_MONOTONIC,
+                                           TFD_NONBLOCK | TFD_CLOEXEC);
+    if (app->prefill_timer_fd >= 0 &&
+        add_source(app, app->prefill.done_fd, WAKE_FILL, handle_prefill) &&
+        add_source(app, app->prefill_timer_fd, WAKE_FILL,
+                   handle_prefill_timer))
+        return;
+
+    perror("Vorab-Füllung");
+    remove_source(app, app->prefill.done_fd);
+    fill_async_close(&app->prefill);
+    if (app->prefill_timer_fd >= 0)
+        close(app->prefill_timer_fd);
+    app->prefill_timer_fd = -1;
+}
+
+/* =========================================================================
+ * Inaktivität über /dev/input (--idle-backend evdev)
+ * =========================================================================
+ * Ersatz für ext-idle-notify (siehe evdev.h). Liefert dieselben idled- und
+ * resumed-Übergänge wie die Notification, nur aus einer eigenen Quelle in
+ * der Hauptschleife statt über die Wayland-Verbindung.
+ */
+static void handle_evdev(App *app, int fd)
+{
+    (void)fd;
+    switch (evdev_idle_dispatch(&app->evdev)) {
+    case EVDEV_IDLE_IDLED:
+        idle_idled(app);
+        break;
+    case EVDEV_IDLE_RESUMED:
+        idle_resumed(app);
+        break;
+    default:
+        break;
+    }
+}
+
+/* Wird die Inaktivität über /dev/input erkannt? */
+static bool use_evdev(const App *app)
+{
+    return app->idle_backend == IDLE_BACKEND_EVDEV ||
+           (app->idle_backend == IDLE_BACKEND_AUTO && !app->idle_notifier);
+}
+
+/* Beobachtung beenden und aus der Hauptschleife austragen */
+static void evdev_stop(App *app)
+{
+    if (app->evdev.epoll_fd < 0)
+        return;
+    remove_source(app, app->evdev.epoll_fd);
+    evdev_idle_close(&app->evdev);
+}
+
+/* Beobachtung starten bzw. mit dem aktuellen Timeout neu beginnen */
+static bool evdev_start(App *app, int timeout_ms)
+{
+    if (app->evdev.epoll_fd >= 0) {
+        evdev_idle_set_timeout(&app->evdev, timeout_ms);
+        return true;
+    }
+    if (!evdev_idle_open(&app->evdev, app->evdev_dir, timeout_ms))
+        return false;
+    if (!add_source(app, app->evdev.epoll_fd, WAKE_EVDEV, handle_evdev)) {
+        evdev_idle_close(&app->evdev);
+        return false;
+    }
+    return true;
+}
+
+/*
+ * Ausstehende Requests zum Compositor schicken. Ist der Socket-Puffer voll
+ * (EAGAIN), behält libwayland den Rest; dann muss poll() zusätzlich auf
+ * POLLOUT warten, sonst blieben die Requests liegen, bis zufällig ein
+ * Ereignis eintrifft. Gibt die poll()-Maske für den Display-fd zurück,
+ * -1 bei Verbindungsfehler.
+ */
+static short flush_display(App *app)
+{
+    if (wl_display_flush(app->display) >= 0)
+        return POLLIN;
+    if (errno != EAGAIN)
+        return -1;
+    return POLLIN | POLLOUT;
+}
+
+/* Läuft, bis app->running false wird. Gibt -1 bei Verbindungsfehler zurück. */
+static int run_loop(App *app)
+{
+    struct pollfd pfd[1 + MAX_SOURCES];
+    Source        src[MAX_SOURCES];
+
+    while (app->running) {
+        /* Bereits gelesene Ereignisse abarbeiten, bevor wir schlafen */
+        while (wl_display_prepare_read(app->display) != 0) {
+            if (wl_display_dispatch_pending(app->display) < 0)
+                return -1;
+        }
+        if (!app->running) {
+            wl_display_cancel_read(app->display);
+            break;
+        }
+
+        /* Ausstehende Requests zum Compositor schicken */
+        short display_events = flush_display(app);
+        if (display_events < 0) {
+            wl_display_cancel_read(app->display);
+            return -1;
+        }
+
+        /* Quellen kopieren: Handler dürfen die Liste verändern */
+        int nsrc = app->nsources;
+        memcpy(src, app->sources, sizeof(Source) * (size_t)nsrc);
+
+        pfd[0] = (struct pollfd){
+            .fd = wl_display_get_fd(app->display), .events = display_events,
+        };
+        for (int i = 0; i < nsrc; i++)
+            pfd[1 + i] = (struct pollfd){
+                .fd = src[i].fd, .events = src[i].events,
+            };
+
+        if (poll(pfd, (nfds_t)(1 + nsrc), -1) < 0) {
+            wl_display_cancel_read(app->display);
+            if (errno == EINTR)
+                continue;
+            perror("poll");
+            return -1;
+        }
+
+        /* Phase und Zählerstand vor dem Dispatch für die Wakeup-Zählung */
+        Phase    phase         = app->stats.phase;
+        uint64_t events_before = app->stats.events_total;
+        unsigned causes        = 0;
+
+        trace_begin("wakeup");
+        if (pfd[0].revents)
+            causes |= 1u << WAKE_WAYLAND;
+        if (pfd[0].revents & ~POLLOUT) {
+            if (wl_display_read_events(app->display) < 0) {
+                trace_end("wakeup");
+                return -1;
+            }
+        } else {
+            wl_display_cancel_read(app->display);
+        }
+        if (wl_display_dispatch_pending(app->display) < 0) {
+            trace_end("wakeup");
+            return -1;
+        }
+
+        causes |= dispatch_sources(app, src, &pfd[1], nsrc);
+
+        stats_wakeup(&app->stats, phase, causes, events_before);
+        trace_end("wakeup");
+    }
+    return 0;
+}
+
+/* =========================================================================
+ * Selbstmessung (--benchmark)
+ * =========================================================================
+ * Zeigt und entfernt das Overlay N-mal gegen den laufenden Compositor, ohne
+ * auf Inaktivität oder Eingaben zu warten. Jeder Zyklus wartet auf das
+ * configure-Event und, falls wp_presentation angeboten wird, auf die
+ * Präsentationsrückmeldung des ersten schwarzen Frames; nach dem Entfernen
+ * bestätigt ein Roundtrip, dass der Compositor das Overlay abgebaut hat.
+ * Die Messpunkte setzen layer_surface_configure() und feedback_presented().
+ */
+
+/* Frist je Wartepunkt; danach gilt der Zyklus als unvollständig */
+#define BENCH_TIMEOUT_MS 2000
+
+static const char *const strategy_names[] = {
+    [STRATEGY_FULL]       = "full",
+    [STRATEGY_SMALL]      = "small",
+    [STRATEGY_PERSISTENT] = "persistent",
+    [STRATEGY_CACHED]     = "cached",
+    [STRATEGY_GAMMA]      = "gamma",
+};
+
+static bool bench_committed(const App *app)
+{
+    /* Ohne Overlay (z.B. closed oder Tastendruck) kommt kein Commit mehr */
+    return app->commit_ns != 0 || !app->overlay_visible;
+}
+
+static bool bench_feedback_done(const App *app)
+{
+    return app->feedback == NULL;
+}
+
+/*
+ * Ereignisse wie in run_loop() verarbeiten, bis done() zutrifft oder die
+ * Frist abläuft. Gibt false bei Verbindungsfehler oder Signal zurück.
+ */
+static bool bench_wait(App *app, bool (*done)(const App *app))
+{
+    uint64_t deadline = monotonic_ns() + (uint64_t)BENCH_TIMEOUT_MS * 1000000;
+
+    while (app->running && !done(app)) {
+        while (wl_display_prepare_read(app->display) != 0) {
+            if (wl_display_dispatch_pending(app->display) < 0)
+                return false;
+        }
+        if (done(app)) {
+            wl_display_cancel_read(app->display);
+            break;
+        }
+        short display_events = flush_display(app);
+        if (display_events < 0) {
+            wl_display_cancel_read(app->display);
+            return false;
+        }
+
+        uint64_t now = monotonic_ns();
+        if (now >= deadline) {
+            wl_display_cancel_read(app->display);
+            break;
+        }
+        struct pollfd pfd[2] = {
+            { .fd = wl_display_get_fd(app->display),
+              .events = display_events },
+            { .fd = app->signal_fd, .events = POLLIN },
+        };
+        int timeout = (int)((deadline - now + 999999) / 1000000);
+        if (poll(pfd, 2, timeout) < 0) {
+            wl_display_cancel_read(app->display);
+            if (errno == EINTR)
+                continue;
+            perror("poll");
+            return false;
+        }
+
+        if (pfd[0].revents & ~POLLOUT) {
+            if (wl_display_read_events(app->display) < 0)
+                return false;
+        } else {
+            wl_display_cancel_read(app->display);
+        }
+        if (wl_display_dispatch_pending(app->display) < 0)
+            return false;
+        if (pfd[1].revents)
+            handle_signal(app, app->signal_fd);
+    }
+    return app->running;
+}
+
+/* Ein Zyklus anzeigen → configure → Scanout → entfernen */
+static bool bench_cycle(App *app, BenchSeries *bs)
+{
+    app->configure_ns = 0;
+    app->buffer_ns    = 0;
+    app->commit_ns    = 0;
+    app->presented_ns = 0;
+    bs->cycles++;
+
+    show_overlay(app);
+    if (!bench_wait(app, bench_committed))
+        return false;
+
+    if (!app->commit_ns) {
+        bs->failed++;
+    } else {
+        bench_series_add(bs, BENCH_CONFIGURE,
+                         elapsed_ns(app->show_ns, app->configure_ns));
+        bench_series_add(bs, BENCH_BUFFER, app->buffer_ns);
+        if (!bench_wait(app, bench_feedback_done))
+            return false;
+        if (app->presented_ns)
+            bench_series_add(bs, BENCH_PRESENT,
+                             elapsed_ns(app->commit_ns, app->presented_ns));
+        else if (app->presentation)
+            bs->unpresented++;
+    }
+
+    hide_overlay(app);
+    return wl_display_roundtrip(app->display) >= 0 && app->running;
+}
+
+/*
+ * Alle Varianten messen und je eine Tabelle nach stdout schreiben: jede
+ * Ausgabe (--benchmark-outputs, sonst wählt der Compositor) mal jede
+ * Overlay-Strategie (--benchmark-strategies, sonst --strategy).
+ */
+static bool run_benchmark(App *app)
+{
+    static const Strategy all[] = {
+        STRATEGY_FULL, STRATEGY_SMALL, STRATEGY_PERSISTENT, STRATEGY_CACHED,
+    };
+    int nstrategies = app->benchmark_strategies
+                          ? (int)(sizeof(all) / sizeof(all[0])) : 1;
+    Strategy only = app->strategy;
+
+    if (app->benchmark_outputs && app->noutputs == 0) {
+        fprintf(stderr, "Keine Ausgabe gefunden\n");
+        return false;
+    }
+
+    BenchSeries bs;
+    if (!bench_series_init(&bs, app->benchmark_cycles)) {
+        fprintf(stderr, "Kein Speicher für %d Messwerte\n",
+                app->benchmark_cycles);
+        return false;
+    }
+
+    printf("blkout --benchmark: %d Zyklen je Variante, wp_presentation %s\n",
+           app->benchmark_cycles,
+           app->presentation ? "vorhanden" : "fehlt (kein Scanout messbar)");
+
+    bool ok = true;
+    for (int o = 0; ok && o < (app->benchmark_outputs ? app->noutputs : 1);
+         o++) {
+        for (int k = 0; ok && k < nstrategies; k++) {
+            Strategy st = app->benchmark_strategies ? all[k] : only;
+            if (st == STRATEGY_SMALL && !app->viewporter) {
+                printf("Strategie small übersprungen: wp_viewporter fehlt\n");
+                continue;
+            }
+
+            /* Jede Variante beginnt ohne Surface und Puffer der vorigen */
+            destroy_overlay_surface(app);
+            destroy_buffer(app);
+            app->strategy      = st;
+            app->target_output = app->benchmark_outputs
+                                     ? app->outputs[o].output : NULL;
+            const char *label  = app->benchmark_outputs
+                                     ? app->outputs[o].label : "(Compositor)";
+
+            bench_series_reset(&bs);
+            app->metrics.shm_peak = app->metrics.shm_resident;
+            bench_reset_peak_rss();
+
+            for (int i = 0; ok && i < app->benchmark_cycles; i++)
+                ok = bench_cycle(app, &bs);
+
+            putchar('\n');
+            bench_series_print(&bs, label, strategy_names[st],
+                               app->metrics.shm_peak, bench_peak_rss_kb(),
+                               stdout);
+        }
+    }
+
+    destroy_overlay_surface(app);
+    destroy_buffer(app);
+    app->target_output = NULL;
+    bench_series_free(&bs);
+    return ok;
+}
+
+/* =========================================================================
+ * Einstellungen
+ * =========================================================================
+ * Die Einstellungen, die sowohl auf der Kommandozeile als auch in der
+ * Konfigurationsdatei stehen dürfen. Reihenfolge beim Start und bei jedem
+ * Neuladen: Standardwerte, dann die Datei, dann die Kommandozeile — die
+ * Kommandozeile gewinnt also immer.
+ */
+typedef struct {
+    int      timeout_ms;
+    bool     exit_on_hide;
+    bool     resume_only;
+    bool     keyboard_grab;
+    int      motion_threshold;
+    int      motion_window_ms;
+    Strategy strategy;
+    bool     opaque_region;
+    ContentMode content_mode;
+    uint32_t color;
+    Pattern  pattern;
+    IdleBackend idle_backend;
+    const char *evdev_dir;
+    const char *seat_filter;
+} Settings;
+
+static void settings_save(const App *app, Settings *s)
+{
+    *s = (Settings){
+        .timeout_ms       = app->timeout_ms,
+        .exit_on_hide     = app->exit_on_hide,
+        .resume_only      = app->resume_only,
+        .keyboard_grab    = app->keyboard_grab,
+        .motion_threshold = app->motion_threshold,
+        .motion_window_ms = app->motion_window_ms,
+        .strategy         = app->strategy,
+        .opaque_region    = app->opaque_region,
+        .content_mode     = app->content_mode,
+        .color            = app->color,
+        .pattern          = app->pattern,
+        .idle_backend     = app->idle_backend,
+        .evdev_dir        = app->evdev_dir,
+        .seat_filter      = app->seat_filter,
+    };
+}
+
+static void settings_restore(App *app, const Settings *s)
+{
+    app->timeout_ms       = s->timeout_ms;
+    app->exit_on_hide     = s->exit_on_hide;
+    app->resume_only      = s->resume_only;
+    app->keyboard_grab    = s->keyboard_grab;
+    app->motion_threshold = s->motion_threshold;
+    app->motion_window_ms = s->motion_window_ms;
+    app->strategy         = s->strategy;
+    app->opaque_region    = s->opaque_region;
+    app->content_mode     = s->content_mode;
+    app->color            = s->color;
+    app->pattern          = s->pattern;
+    app->idle_backend     = s->idle_backend;
+    app->evdev_dir        = s->evdev_dir;
+    app->seat_filter      = s->seat_filter;
+}
+
+/*
+ * Standardwerte ohne -s, -e, -r, -k, -m, --strategy, --opaque-region,
+ * --content, --color, --pattern, --idle-backend, --evdev-dir und --seats
+ */
+static void settings_defaults(App *app)
+{
+    settings_restore(app, &(Settings){
+        .motion_window_ms = MOTION_WINDOW_MS_DEFAULT,
+        .strategy         = STRATEGY_FULL,
+        .evdev_dir        = EVDEV_DEFAULT_DIR,
+    });
+}
+
+/* Bewegungsschwelle <pixel>[:<ms>] (-m, motion = ...) */
+static bool parse_motion(App *app, const char *value)
+{
+    char *end;
+    long px = strtol(value, &end, 10);
+    long ms = MOTION_WINDOW_MS_DEFAULT;
+    if (end == value)
+        return false;
+    if (*end == ':')
+        ms = strtol(end + 1, &end, 10);
+    if (*end != '\0' || px < 0 || px > 100000 || ms <= 0 || ms > 60000)
+        return false;
+    app->motion_threshold = (int)px;
+    app->motion_window_ms = (int)ms;
+    return true;
+}
+
+/* Strategiename (--strategy, strategy = ...) */
+static bool parse_strategy(App *app, const char *value)
+{
+    if (strcmp(value, "full") == 0)
+        app->strategy = STRATEGY_FULL;
+    else if (strcmp(value, "small") == 0)
+        app->strategy = STRATEGY_SMALL;
+    else if (strcmp(value, "persistent") == 0)
+        app->strategy = STRATEGY_PERSISTENT;
+    else if (strcmp(value, "cached") == 0)
+        app->strategy = STRATEGY_CACHED;
+    else if (strcmp(value, "gamma") == 0)
+        app->strategy = STRATEGY_GAMMA;
+    else
+        return false;
+    return true;
+}
+
+/* Inhalt auf dem Overlay (--content, content = ...) */
+static bool parse_content(App *app, const char *value)
+{
+    if (strcmp(value, "none") == 0)
+        app->content_mode = CONTENT_NONE;
+    else if (strcmp(value, "clock") == 0)
+        app->content_mode = CONTENT_CLOCK;
+    else if (strcmp(value, "marker") == 0)
+        app->content_mode = CONTENT_MARKER;
+    else
+        return false;
+    return true;
+}
+
+/* Farbe RRGGBB, black oder privacy (--color, color = ...) */
+static bool parse_color(App *app, const char *value)
+{
+    if (strcmp(value, "black") == 0) {
+        app->color = 0x00000000u;
+        return true;
+    }
+    if (strcmp(value, "privacy") == 0) {
+        app->color = PRIVACY_COLOR;
+        return true;
+    }
+    if (value[0] == '#')
+        value++;
+    if (strlen(value) != 6 || strspn(value, "0123456789abcdefABCDEF") != 6)
+        return false;
+    app->color = (uint32_t)strtoul(value, NULL, 16);
+    return true;
+}
+
+/* Muster der Farbe (--pattern, pattern = ...) */
+static bool parse_pattern(App *app, const char *value)
+{
+    if (strcmp(value, "solid") == 0)
+        app->pattern = PATTERN_SOLID;
+    else if (strcmp(value, "lines") == 0)
+        app->pattern = PATTERN_LINES;
+    else if (strcmp(value, "checker") == 0)
+        app->pattern = PATTERN_CHECKER;
+    else
+        return false;
+    return true;
+}
+
+/* Inaktivitätserkennung (--idle-backend, idle-backend = ...) */
+static bool parse_idle_backend(App *app, const char *value)
+{
+    if (strcmp(value, "auto") == 0)
+        app->idle_backend = IDLE_BACKEND_AUTO;
+    else if (strcmp(value, "wayland") == 0)
+        app->idle_backend = IDLE_BACKEND_WAYLAND;
+    else if (strcmp(value, "evdev") == 0)
+        app->idle_backend = IDLE_BACKEND_EVDEV;
+    else
+        return false;
+    return true;
+}
+
+/*
+ * Zeichenkette aus der Konfigurationsdatei behalten (evdev-dir, seats).
+ * Die vorige Kopie gibt erst reload_config() frei, weil die bisherigen
+ * Einstellungen bis zur Übernahme auf sie zeigen.
+ */
+static bool keep_conf_string(char **slot, const char *value,
+                             const char **target)
+{
+    char *copy = strdup(value);
+    if (!copy)
+        return false;
+    free(*slot);
+    *slot = copy;
+    *target = copy;
+    return true;
+}
+
+/* Wahrheitswert der Konfigurationsdatei: ja/nein, yes/no, true/false, 1/0 */
+static bool parse_bool(const char *value, bool *out)
+{
+    if (strcmp(value, "ja") == 0 || strcmp(value, "yes") == 0 ||
+        strcmp(value, "true") == 0 || strcmp(value, "1") == 0)
+        *out = true;
+    else if (strcmp(value, "nein") == 0 || strcmp(value, "no") == 0 ||
+             strcmp(value, "false") == 0 || strcmp(value, "0") == 0)
+        *out = false;
+    else
+        return false;
+    return true;
+}
+
+/* =========================================================================
+ * Kommandozeile auswerten
+ * =========================================================================
+ * Parst -s <sekunden>, -e, -r, -k, -m <pixel>[:<ms>], --stats,
+ * --trace <datei>, --metrics-socket/--metrics-file <pfad>,
+ * --strategy <art>, --opaque-region, --record <datei>, --config <pfad>,
+ * --control-socket <pfad>, --exit-idle <sekunden>, --dbus-screensaver,
+ * --memory-pressure <ms>,
+ * --idle-backend <art>, --evdev-dir <pfad>, --seats <liste>,
+ * --content <art>, --color <farbe>, --pattern <art>,
+ * --journal <datei>, --journal-dump <datei>,
+ * --image <datei> und
+ * --benchmark <n> [--benchmark-outputs] [--benchmark-strategies].
+ * Schreibt Ergebnisse direkt in App-Struktur.
+ * Gibt true zurück bei Erfolg, false bei Fehler.
+ */
+static bool parse_args(App *app, int argc, char *argv[])
+{
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-s") == 0) {
+            /* Auf den Sekundenwert prüfen */
+            if (i + 1 >= argc) {
+                fprintf(stderr, "Fehler: -s benötigt einen Wert\n");
+                return false;
+            }
+            i++;
+            char *end;
+            long secs = strtol(argv[i], &end, 10);
+            if (*end != '\0' || secs <= 0) {
+                fprintf(stderr, "Fehler: Ungültiger Wert für -s: %s\n", argv[i]);
+                return false;
+            }
+            /* Sekunden in Millisekunden umrechnen */
+            app->timeout_ms = (int)(secs * 1000);
+
+        } else if (strcmp(argv[i], "-e") == 0) {
+            app->exit_on_hide = true;
+
+        } else if (strcmp(argv[i], "-r") == 0) {
+            app->resume_only = true;
+
+        } else if (strcmp(argv[i], "-k") == 0) {
+            app->keyboard_grab = true;
+
+        } else if (strcmp(argv[i], "-m") == 0) {
+            /* Bewegungsschwelle, optional mit Zeitfenster: <pixel>[:<ms>] */
+            if (i + 1 >= argc) {
+                fprintf(stderr, "Fehler: -m benötigt einen Wert\n");
+                return false;
+            }
+            i++;
+            if (!parse_motion(app, argv[i])) {
+                fprintf(stderr, "Fehler: Ungültiger Wert für -m: %s\n", argv[i]);
+                return false;
+            }
+
+        } else if (strcmp(argv[i], "--stats") == 0) {
+            app->print_stats = true;
+
+        } else if (strcmp(argv[i], "--trace") == 0) {
+            if (i + 1 >= argc) {
+                fprintf(stderr, "Fehler: --trace benötigt einen Dateinamen\n");
+                return false;
+            }
+            app->trace_path = argv[++i];
+
+        } else if (strcmp(argv[i], "--metrics-socket") == 0) {
+            if (i + 1 >= argc) {
+                fprintf(stderr, "Fehler: --metrics-socket benötigt einen Pfad\n");
+                return false;
+            }
+            app->metrics_socket = argv[++i];
+
+        } else if (strcmp(argv[i], "--metrics-file") == 0) {
+            if (i + 1 >= argc) {
+                fprintf(stderr, "Fehler: --metrics-file benötigt einen Pfad\n");
+                return false;
+            }
+            app->metrics_file = argv[++i];
+
+        } else if (strcmp(argv[i], "--strategy") == 0) {
+            if (i + 1 >= argc) {
+                fprintf(stderr, "Fehler: --strategy benötigt einen Wert\n");
+                return false;
+            }
+            i++;
+            if (!parse_strategy(app, argv[i])) {
+                fprintf(stderr, "Fehler: Ungültiger Wert für --strategy: %s\n",
+                        argv[i]);
+                return false;
+            }
+
+        } else if (strcmp(argv[i], "--opaque-region") == 0) {
+            app->opaque_region = true;
+
+        } else if (strcmp(argv[i], "--journal") == 0) {
+            if (i + 1 >= argc) {
+                fprintf(stderr, "Fehler: --journal benötigt einen Dateinamen\n");
+                return false;
+            }
+            app->journal_path = argv[++i];
+
+        } else if (strcmp(argv[i], "--journal-dump") == 0) {
+            if (i + 1 >= argc) {
+                fprintf(stderr, "Fehler: --journal-dump benötigt einen "
+                                "Dateinamen\n");
+                return false;
+            }
+            app->journal_dump = argv[++i];
+
+        } else if (strcmp(argv[i], "--record") == 0) {
+            if (i + 1 >= argc) {
+                fprintf(stderr, "Fehler: --record benötigt einen Dateinamen\n");
+                return false;
+            }
+            app->record_path = argv[++i];
+
+        } else if (strcmp(argv[i], "--config") == 0) {
+            if (i + 1 >= argc) {
+                fprintf(stderr, "Fehler: --config benötigt einen Pfad\n");
+                return false;
+            }
+            app->config_path = argv[++i];
+
+        } else if (strcmp(argv[i], "--control-socket") == 0) {
+            if (i + 1 >= argc) {
+                fprintf(stderr, "Fehler: --control-socket benötigt einen Pfad\n");
+                return false;
+            }
+            app->control_socket = argv[++i];
+
+        } else if (strcmp(argv[i], "--exit-idle") == 0) {
+            if (i + 1 >= argc) {
+                fprintf(stderr, "Fehler: --exit-idle benötigt einen Wert\n");
+                return false;
+            }
+            i++;
+            char *end;
+            long secs = strtol(argv[i], &end, 10);
+            if (*end != '\0' || secs <= 0 || secs > INT32_MAX / 1000) {
+                fprintf(stderr, "Fehler: Ungültiger Wert für --exit-idle: %s\n",
+                        argv[i]);
+                return false;
+            }
+            app->exit_idle_ms = (int)(secs * 1000);
+
+        } else if (strcmp(argv[i], "--memory-pressure") == 0) {
+            if (i + 1 >= argc) {
+                fprintf(stderr, "Fehler: --memory-pressure benötigt einen Wert\n");
+                return false;
+            }
+            i++;
+            char *end;
+            long ms = strtol(argv[i], &end, 10);
+            if (*end != '\0' || ms < 0 || ms >= PSI_WINDOW_MS) {
+                fprintf(stderr, "Fehler: Ungültiger Wert für --memory-pressure: "
+                                "%s\n", argv[i]);
+                return false;
+            }
+            app->psi_stall_ms = (int)ms;
+
+        } else if (strcmp(argv[i], "--dbus-screensaver") == 0) {
+            app->dbus_screensaver = true;
+
+        } else if (strcmp(argv[i], "--idle-backend") == 0) {
+            if (i + 1 >= argc) {
+                fprintf(stderr, "Fehler: --idle-backend benötigt einen Wert\n");
+                return false;
+            }
+            i++;
+            if (!parse_idle_backend(app, argv[i])) {
+                fprintf(stderr, "Fehler: Ungültiger Wert für --idle-backend: %s\n",
+                        argv[i]);
+                return false;
+            }
+
+        } else if (strcmp(argv[i], "--evdev-dir") == 0) {
+            if (i + 1 >= argc) {
+                fprintf(stderr, "Fehler: --evdev-dir benötigt einen Pfad\n");
+                return false;
+            }
+            app->evdev_dir = argv[++i];
+
+        } else if (strcmp(argv[i], "--seats") == 0) {
+            if (i + 1 >= argc || argv[i + 1][0] == '\0') {
+                fprintf(stderr, "Fehler: --seats benötigt eine Liste\n");
+                return false;
+            }
+            app->seat_filter = argv[++i];
+
+        } else if (strcmp(argv[i], "--image") == 0) {
+            if (i + 1 >= argc) {
+                fprintf(stderr, "Fehler: --image benötigt einen Dateinamen\n");
+                return false;
+            }
+            app->image_path = argv[++i];
+
+        } else if (strcmp(argv[i], "--content") == 0) {
+            if (i + 1 >= argc) {
+                fprintf(stderr, "Fehler: --content benötigt einen Wert\n");
+                return false;
+            }
+            i++;
+            if (!parse_content(app, argv[i])) {
+                fprintf(stderr, "Fehler: Ungültiger Wert für --content: %s\n",
+                        argv[i]);
+                return false;
+            }
+
+        } else if (strcmp(argv[i], "--color") == 0) {
+            if (i + 1 >= argc) {
+                fprintf(stderr, "Fehler: --color benötigt einen Wert\n");
+                return false;
+            }
+            i++;
+            if (!parse_color(app, argv[i])) {
+                fprintf(stderr, "Fehler: Ungültiger Wert für --color: %s\n",
+                        argv[i]);
+                return false;
+            }
+
+        } else if (strcmp(argv[i], "--pattern") == 0) {
+            if (i + 1 >= argc) {
+                fprintf(stderr, "Fehler: --pattern benötigt einen Wert\n");
+                return false;
+            }
+            i++;
+            if (!parse_pattern(app, argv[i])) {
+                fprintf(stderr, "Fehler: Ungültiger Wert für --pattern: %s\n",
+                        argv[i]);
+                return false;
+            }
+
+        } else if (strcmp(argv[i], "--benchmark") == 0) {
+            if (i + 1 >= argc) {
+                fprintf(stderr, "Fehler: --benchmark benötigt eine Anzahl\n");
+                return false;
+            }
+            i++;
+            char *end;
+            long n = strtol(argv[i], &end, 10);
+            if (*end != '\0' || n <= 0 || n > 100000) {
+                fprintf(stderr, "Fehler: Ungültiger Wert für --benchmark: %s\n",
+                        argv[i]);
+                return false;
+            }
+            app->benchmark_cycles = (int)n;
+
+        } else if (strcmp(argv[i], "--benchmark-outputs") == 0) {
+            app->benchmark_outputs = true;
+
+        } else if (strcmp(argv[i], "--benchmark-strategies") == 0) {
+            app->benchmark_strategies = true;
+
+        } else {
+            fprintf(stderr, "Unbekannter Parameter: %s\n", argv[i]);
+            fprintf(stderr, "Verwendung: blkout [-s <sekunden>] [-e] [-r [-k]]"
+                            " [-m <pixel>[:<ms>]] [--stats]"
+                            " [--trace <datei>] [--metrics-socket <pfad>]"
+                            " [--metrics-file <pfad>]"
+                            " [--strategy full|small|persistent|cached|gamma]"
+                            " [--opaque-region] [--record <datei>]"
+                            " [--config <pfad>]"
+                            " [--control-socket <pfad>] [--exit-idle <sekunden>]"
+                            " [--dbus-screensaver] [--memory-pressure <ms>]"
+                            " [--idle-backend auto|wayland|evdev]"
+                            " [--evdev-dir <pfad>]"
+                            " [--seats <name>[,<name>...]]"
+                            " [--content none|clock|marker]"
+                            " [--image <datei>]"
+                            " [--color RRGGBB|black|privacy]"
+                            " [--pattern solid|lines|checker]"
+                            " [--journal <datei>] [--journal-dump <datei>]"
+                            " [--benchmark <n> [--benchmark-outputs]"
+                            " [--benchmark-strategies]]\n");
+            return false;
+        }
+    }
+
+    if (app->keyboard_grab && !app->resume_only) {
+        fprintf(stderr, "Fehler: -k ist nur zusammen mit -r sinnvoll\n");
+        return false;
+    }
+
+    if ((app->benchmark_outputs || app->benchmark_strategies) &&
+        app->benchmark_cycles == 0) {
+        fprintf(stderr, "Fehler: --benchmark-outputs und "
+                        "--benchmark-strategies nur mit --benchmark\n");
+        return false;
+    }
+    if (app->benchmark_cycles > 0 && app->strategy == STRATEGY_GAMMA &&
+        !app->benchmark_strategies) {
+        fprintf(stderr, "Fehler: --benchmark misst nur Strategien mit "
+                        "Overlay, nicht gamma\n");
+        return false;
+    }
+
+    /* Inhalt braucht einen Vollbild-Puffer, in den gezeichnet werden kann */
+    if (app->content_mode != CONTENT_NONE &&
+        (app->strategy == STRATEGY_SMALL || app->strategy == STRATEGY_GAMMA)) {
+        fprintf(stderr, "Fehler: --content nicht mit --strategy small "
+                        "oder gamma\n");
+        return false;
+    }
+
+    /* Das Standbild ersetzt den schwarzen Puffer und ist nicht beschreibbar */
+    if (app->image_path &&
+        (app->content_mode != CONTENT_NONE ||
+         app->strategy == STRATEGY_SMALL || app->strategy == STRATEGY_GAMMA)) {
+        fprintf(stderr, "Fehler: --image nicht mit --content oder "
+                        "--strategy small/gamma\n");
+        return false;
+    }
+
+    /*
+     * Farbe gibt es nur im eigenen Puffer: nicht bei gamma und --image.
+     * Der Inhalt löscht seine vorige Stelle mit Schwarz, ein Muster braucht
+     * einen Vollbild-Puffer.
+     */
+    if (!is_black(app->color) &&
+        (app->strategy == STRATEGY_GAMMA || app->image_path ||
+         app->content_mode != CONTENT_NONE)) {
+        fprintf(stderr, "Fehler: --color nicht mit --strategy gamma, "
+                        "--image oder --content\n");
+        return false;
+    }
+    if (!is_black(app->color) && app->pattern != PATTERN_SOLID &&
+        app->strategy == STRATEGY_SMALL) {
+        fprintf(stderr, "Fehler: --pattern nicht mit --strategy small\n");
+        return false;
+    }
+
+    /* Ohne Surface kommen keine Eingaben an: nur idle-resumed weckt */
+    if (app->strategy == STRATEGY_GAMMA)
+        app->resume_only = true;
+    return true;
+}
+
+/* =========================================================================
+ * Konfigurationsdatei
+ * =========================================================================
+ * Schlüssel: timeout (Sekunden, 0 = sofort), exit-on-hide, resume-only,
+ * keyboard-grab, motion (<pixel>[:<ms>]), strategy, opaque-region,
+ * content, color, pattern, idle-backend, evdev-dir und seats.
+ * Ändert sich die Datei, wird sie über inotify in der Hauptschleife neu
+ * geladen. Die Wayland-Verbindung bleibt bestehen; neu aufgebaut wird nur,
+ * was von einer geänderten Einstellung abhängt: die Idle-Notification bzw.
+ * die Beobachtung von /dev/input bei timeout, idle-backend, evdev-dir und
+ * seats, Surface und zwischengespeicherter Puffer bei strategy,
+ * opaque-region, content, color und pattern. resume-only, keyboard-grab
+ * und ein Wechsel von oder zu gamma bestimmen, welche Objekte beim Start
+ * gebunden werden, und gelten deshalb erst nach einem Neustart.
+ */
+static bool apply_setting(void *data, const char *key, const char *value)
+{
+    App *app = data;
+
+    if (strcmp(key, "timeout") == 0) {
+        char *end;
+        long secs = strtol(value, &end, 10);
+        if (end == value || *end != '\0' || secs < 0 || secs > INT32_MAX / 1000)
+            return false;
+        app->timeout_ms = (int)(secs * 1000);
+        return true;
+    }
+    if (strcmp(key, "exit-on-hide") == 0)
+        return parse_bool(value, &app->exit_on_hide);
+    if (strcmp(key, "resume-only") == 0)
+        return parse_bool(value, &app->resume_only);
+    if (strcmp(key, "keyboard-grab") == 0)
+        return parse_bool(value, &app->keyboard_grab);
+    if (strcmp(key, "opaque-region") == 0)
+        return parse_bool(value, &app->opaque_region);
+    if (strcmp(key, "motion") == 0)
+        return parse_motion(app, value);
+    if (strcmp(key, "strategy") == 0)
+        return parse_strategy(app, value);
+    if (strcmp(key, "content") == 0)
+        return parse_content(app, value);
+    if (strcmp(key, "color") == 0)
+        return parse_color(app, value);
+    if (strcmp(key, "pattern") == 0)
+        return parse_pattern(app, value);
+    if (strcmp(key, "idle-backend") == 0)
+        return parse_idle_backend(app, value);
+    if (strcmp(key, "evdev-dir") == 0)
+        return value[0] != '\0' &&
+               keep_conf_string(&app->conf_evdev_dir, value, &app->evdev_dir);
+    if (strcmp(key, "seats") == 0)
+        return value[0] != '\0' &&
+               keep_conf_string(&app->conf_seats, value, &app->seat_filter);
+    return false;
+}
+
+/* Standardwerte, Datei und Kommandozeile übereinanderlegen */
+static bool load_settings(App *app)
+{
+    settings_defaults(app);
+    if (app->config_path &&
+        !config_load(app->config_path, apply_setting, app))
+        return false;
+    return parse_args(app, app->argc, app->argv);
+}
+
+/*
+ * Idle-Notification mit dem aktuellen Timeout (neu) anlegen: beim Start,
+ * nach dem Neuladen und nach dem Wiederverbinden. Ohne Timeout (und ohne
+ * -r) gibt es keine Notification, das Overlay erscheint sofort — mit
+ * Steuersocket erst auf den Befehl show. Fehlt ext-idle-notify (oder mit
+ * --idle-backend evdev), übernimmt die Beobachtung von /dev/input.
+ */
+static void rearm_idle_notification(App *app)
+{
+    teardown_idle_notification(app);
+    app->idled = false;
+
+    if (app->timeout_ms > 0 || app->resume_only) {
+        bool ok;
+        if (use_evdev(app)) {
+            ok = evdev_start(app, idle_timeout_ms(app));
+        } else {
+            evdev_stop(app);
+            ok = setup_idle_notification(app);
+        }
+        if (!ok) {
+            app->running = false;
+            return;
+        }
+        journal_event(JOURNAL_ARM, (uint32_t)idle_timeout_ms(app), 0);
+    } else {
+        evdev_stop(app);
     }
+    if (app->timeout_ms == 0 && !remote_control(app))
+        show_overlay(app);
+    update_exit_timer(app);
 }
 
-static void seat_name(void *data, struct wl_seat *seat, const char *name)
+/* Zwei Werte wie evdev_dir oder seat_filter gleich? NULL nur gleich NULL. */
+static bool same_string(const char *a, const char *b)
 {
-    /* Seat-Name wird nicht verwendet */
-    (void)data; (void)seat; (void)name;
+    return a == b || (a && b && strcmp(a, b) == 0);
 }
 
-static const struct wl_seat_listener seat_listener = {
-    .capabilities = seat_capabilities,
-    .name         = seat_name,
-};
-
-/* =========================================================================
- * Idle-Notification-Ereignisse
- * =========================================================================
- * Der Compositor feuert diese Events, wenn der Benutzer die eingestellte
- * Zeit inaktiv war (idled) bzw. wieder aktiv wurde (resumed).
- */
-static void idle_notification_idled(void *data,
-                                    struct ext_idle_notification_v1 *notif)
+/* Hängt die Inaktivitätserkennung an einer geänderten Einstellung? */
+static bool idle_settings_changed(const App *app, const Settings *old)
 {
-    /* Inaktivitäts-Schwelle erreicht: schwarzes Overlay anzeigen */
-    (void)notif;
-    App *app = data;
-    show_overlay(app);
+    return app->timeout_ms != old->timeout_ms ||
+           app->idle_backend != old->idle_backend ||
+           !same_string(app->evdev_dir, old->evdev_dir) ||
+           !same_string(app->seat_filter, old->seat_filter);
 }
 
-static void idle_notification_resumed(void *data,
-                                      struct ext_idle_notification_v1 *notif)
+/* Nach einer Änderung: neu laden und nur das Betroffene neu aufbauen */
+static void reload_config(App *app)
 {
-    /*
-     * Benutzer wieder aktiv: Overlay schließen, falls noch sichtbar.
-     * Normalerweise wird hide_overlay() bereits durch Tastatur-/Mausereignisse
-     * auf dem Overlay-Fenster ausgelöst. Dieser Callback dient als Absicherung.
-     */
-    (void)notif;
-    App *app = data;
-    hide_overlay(app);
-}
+    Settings old;
+    settings_save(app, &old);
 
-static const struct ext_idle_notification_v1_listener idle_notification_listener = {
-    .idled   = idle_notification_idled,
-    .resumed = idle_notification_resumed,
-};
+    /* Die bisherigen Kopien bleiben gültig, bis die neuen übernommen sind */
+    char *old_evdev_dir = app->conf_evdev_dir;
+    char *old_seats     = app->conf_seats;
+    app->conf_evdev_dir = NULL;
+    app->conf_seats     = NULL;
 
-/* =========================================================================
- * Wayland Registry
- * =========================================================================
- * Der Compositor kündigt hier alle verfügbaren globalen Objekte an.
- * Wir binden die Objekte, die wir benötigen.
- */
-static void registry_global(void *data, struct wl_registry *registry,
-                             uint32_t name, const char *interface,
-                             uint32_t version)
-{
-    App *app = data;
+    trace_begin("reload_config");
+    if (!load_settings(app)) {
+        fprintf(stderr, "Konfiguration nicht übernommen, "
+                        "bisherige Einstellungen bleiben\n");
+        settings_restore(app, &old);
+        free(app->conf_evdev_dir);
+        free(app->conf_seats);
+        app->conf_evdev_dir = old_evdev_dir;
+        app->conf_seats     = old_seats;
+        trace_end("reload_config");
+        return;
+    }
 
-    /* wl_compositor: zum Erstellen von Surfaces */
-    if (strcmp(interface, wl_compositor_interface.name) == 0) {
-        app->compositor = wl_registry_bind(registry, name,
-                                           &wl_compositor_interface,
-                                           (version < 4 ? version : 4));
+    /* Beim Start gebundene Objekte hängen hiervon ab: erst nach Neustart */
+    if (app->resume_only != old.resume_only ||
+        app->keyboard_grab != old.keyboard_grab ||
+        (app->strategy == STRATEGY_GAMMA) != (old.strategy == STRATEGY_GAMMA)) {
+        fprintf(stderr, "resume-only, keyboard-grab und strategy gamma "
+                        "gelten erst nach einem Neustart\n");
+        app->resume_only   = old.resume_only;
+        app->keyboard_grab = old.keyboard_grab;
+        if (app->strategy == STRATEGY_GAMMA || old.strategy == STRATEGY_GAMMA)
+            app->strategy = old.strategy;
+    }
+    if (app->strategy == STRATEGY_SMALL && !app->viewporter) {
+        fprintf(stderr, "wp_viewporter nicht verfügbar, "
+                        "verwende --strategy full\n");
+        app->strategy = STRATEGY_FULL;
+    }
+    if (!setup_content_timer(app))
+        app->content_mode = CONTENT_NONE;
+    setup_prefill(app);
 
-    /* wl_shm: für Shared-Memory-Pixelpuffer */
-    } else if (strcmp(interface, wl_shm_interface.name) == 0) {
-        app->shm = wl_registry_bind(registry, name,
-                                    &wl_shm_interface, 1);
+    /* Neue Bewegungsschwelle: Zeitfenster neu beginnen */
+    if (app->motion_threshold != old.motion_threshold ||
+        app->motion_window_ms != old.motion_window_ms)
+        for (int i = 0; i < app->nseats; i++)
+            app->seats[i].ptr_anchor_valid = false;
 
-    /* wl_seat: für Tastatur- und Mauseingaben */
-    } else if (strcmp(interface, wl_seat_interface.name) == 0) {
-        app->seat = wl_registry_bind(registry, name,
-                                     &wl_seat_interface,
-                                     (version < 5 ? version : 5));
-        wl_seat_add_listener(app->seat, &seat_listener, app);
+    /*
+     * Surface und zurückbehaltener Puffer passen nicht mehr zur Strategie.
+     * Ein sichtbares Overlay bleibt bis zum Schließen unverändert.
+     */
+    if (app->strategy != old.strategy ||
+        app->opaque_region != old.opaque_region ||
+        app->content_mode != old.content_mode ||
+        app->color != old.color || app->pattern != old.pattern) {
+        if (app->overlay_visible) {
+            app->rebuild_on_hide = true;
+        } else {
+            destroy_overlay_surface(app);
+            destroy_buffer(app);
+        }
+    }
 
-    /* zwlr_layer_shell_v1: für das Overlay-Fenster über allen anderen */
-    } else if (strcmp(interface, zwlr_layer_shell_v1_interface.name) == 0) {
-        app->layer_shell = wl_registry_bind(registry, name,
-                                            &zwlr_layer_shell_v1_interface,
-                                            (version < 4 ? version : 4));
+    /*
+     * Ohne Verbindung spannt reconnect() die Notification ohnehin neu. Ein
+     * anderes Verzeichnis braucht eine frisch geöffnete Beobachtung. Lässt
+     * sich die neue Erkennung nicht einrichten (kein ext-idle-notify, kein
+     * lesbares Gerät), gilt weiter die bisherige, statt blkout zu beenden.
+     */
+    if (idle_settings_changed(app, &old) && app->display) {
+        if (!same_string(app->evdev_dir, old.evdev_dir))
+            evdev_stop(app);
+        rearm_idle_notification(app);
+        if (!app->running) {
+            fprintf(stderr, "Inaktivitätserkennung nicht umstellbar, "
+                            "bisherige bleibt\n");
+            app->idle_backend = old.idle_backend;
+            app->evdev_dir    = old.evdev_dir;
+            app->seat_filter  = old.seat_filter;
+            app->running      = true;
+            evdev_stop(app);
+            rearm_idle_notification(app);
+        }
+    }
 
-    /* ext_idle_notifier_v1: für die Inaktivitätserkennung */
-    } else if (strcmp(interface, ext_idle_notifier_v1_interface.name) == 0) {
-        app->idle_notifier = wl_registry_bind(registry, name,
-                                              &ext_idle_notifier_v1_interface,
-                                              1);
+    /* Neue Farbe: passende Puffer im Hintergrund vorbereiten */
+    prefill_next(app);
+
+    /*
+     * Kopien der vorigen Datei freigeben, außer sie gelten weiter. Eine
+     * laufende Beobachtung hat denselben Pfad, zeigt aber womöglich noch
+     * auf die alte Kopie.
+     */
+    if (app->evdev.epoll_fd >= 0)
+        app->evdev.dir = app->evdev_dir;
+    if (app->evdev_dir == old_evdev_dir) {
+        free(app->conf_evdev_dir);
+        app->conf_evdev_dir = old_evdev_dir;
+    } else {
+        free(old_evdev_dir);
+    }
+    if (app->seat_filter == old_seats) {
+        free(app->conf_seats);
+        app->conf_seats = old_seats;
+    } else {
+        free(old_seats);
     }
+    trace_end("reload_config");
 }
 
-static void registry_global_remove(void *data, struct wl_registry *registry,
-                                   uint32_t name)
+/* inotify: Konfigurationsverzeichnis geändert */
+static void handle_config(App *app, int fd)
 {
-    /* Objekte, die zur Laufzeit entfernt werden, ignorieren wir */
-    (void)data; (void)registry; (void)name;
+    if (config_changed(fd, app->config_path))
+        reload_config(app);
 }
 
-static const struct wl_registry_listener registry_listener = {
-    .global        = registry_global,
-    .global_remove = registry_global_remove,
-};
-
 /* =========================================================================
- * Idle-Notification einrichten
+ * Verbindung zum Compositor
  * =========================================================================
- * Erstellt die Benachrichtigung für den angegebenen Timeout und registriert
- * den Listener. Der Compositor beginnt sofort mit der Zeitmessung.
+ * Beendet oder startet der Compositor neu (KWin-Absturz, kwin_wayland
+ * --replace), endet die Verbindung und run_loop() kehrt mit -1 zurück.
+ * reconnect() verwirft dann alle Wayland-Objekte und verbindet mit
+ * wachsendem Abstand neu. Einstellungen, Ereignisquellen und der schwarze
+ * Shared-Memory-Puffer bleiben erhalten; nach dem Neuverbinden werden die
+ * Globals neu gebunden, die Idle-Notification neu gespannt und ein zuvor
+ * sichtbares Overlay wieder angezeigt. KWins Wrapper behält den Socket über
+ * Neustarts hinweg, daher genügt WAYLAND_DISPLAY aus der Umgebung.
  */
-static bool setup_idle_notification(App *app)
+
+/* Erster und größter Abstand zwischen zwei Versuchen */
+#define RECONNECT_DELAY_MIN_MS 100
+#define RECONNECT_DELAY_MAX_MS 5000
+
+/* Nach dieser Zeit ohne Compositor aufgeben (z.B. Sitzung beendet) */
+#define RECONNECT_GIVE_UP_MS 120000
+
+/*
+ * Verbinden, Globals binden und Pflichtkomponenten prüfen. Bei false ist
+ * die Verbindung halb aufgebaut; disconnect_compositor() räumt sie ab.
+ */
+static bool connect_compositor(App *app)
 {
-    if (!app->idle_notifier) {
-        fprintf(stderr, "Compositor unterstützt ext-idle-notify-v1 nicht\n");
-        return false;
-    }
-    if (!app->seat) {
-        fprintf(stderr, "Kein Seat gefunden\n");
+    app->display = wl_display_connect(NULL);
+    if (!app->display) {
+        fprintf(stderr, "Keine Verbindung zum Wayland-Display möglich\n");
         return false;
     }
 
-    /* Notification-Objekt für den gewünschten Timeout erstellen */
-    app->idle_notification = ext_idle_notifier_v1_get_idle_notification(
-        app->idle_notifier,
-        (uint32_t)app->timeout_ms,
-        app->seat
-    );
+    /* --- Registry anfordern, um globale Objekte zu binden --- */
+    app->registry = wl_display_get_registry(app->display);
+    wl_registry_add_listener(app->registry, &registry_listener, app);
+
+    /*
+     * Zwei Roundtrips durchführen:
+     * - Erster Roundtrip: Registry-Events empfangen (Objekte ankündigen)
+     * - Zweiter Roundtrip: Seat-Capabilities empfangen (Keyboard/Pointer binden)
+     */
+    trace_begin("roundtrip");
+    wl_display_roundtrip(app->display);
+    trace_end("roundtrip");
+    trace_begin("roundtrip");
+    wl_display_roundtrip(app->display);
+    trace_end("roundtrip");
 
-    if (!app->idle_notification) {
-        fprintf(stderr, "get_idle_notification fehlgeschlagen\n");
+    /* --- Pflichtkomponenten prüfen --- */
+    if (!app->compositor) {
+        fprintf(stderr, "wl_compositor nicht verfügbar\n");
+        return false;
+    }
+    if (!app->shm) {
+        fprintf(stderr, "wl_shm nicht verfügbar\n");
+        return false;
+    }
+    if (!app->layer_shell) {
+        fprintf(stderr, "zwlr_layer_shell_v1 nicht verfügbar\n"
+                        "Ist der Compositor kompatibel (KDE Plasma 6+)?\n");
         return false;
     }
+    if (app->strategy == STRATEGY_SMALL && !app->viewporter) {
+        fprintf(stderr, "wp_viewporter nicht verfügbar, "
+                        "verwende --strategy full\n");
+        app->strategy = STRATEGY_FULL;
+    }
+    if (app->strategy == STRATEGY_GAMMA && !app->gamma_manager) {
+        fprintf(stderr, "zwlr_gamma_control_manager_v1 nicht verfügbar, "
+                        "verwende --strategy full -r\n");
+        app->strategy = STRATEGY_FULL;
+    }
 
-    /* Listener für idled- und resumed-Events registrieren */
-    ext_idle_notification_v1_add_listener(app->idle_notification,
-                                          &idle_notification_listener, app);
+    app->metrics.connected = true;
     return true;
 }
 
-/* =========================================================================
- * Kommandozeile auswerten
- * =========================================================================
- * Parst -s <sekunden> und -e. Schreibt Ergebnisse direkt in App-Struktur.
- * Gibt true zurück bei Erfolg, false bei Fehler.
+/*
+ * Alle Wayland-Objekte freigeben und die Verbindung trennen. Auch nach
+ * einem Verbindungsabbruch zulässig: Die Destruktoren senden dann nichts
+ * mehr und geben nur die Proxys frei. Der Shared-Memory-Puffer bleibt.
  */
-static bool parse_args(App *app, int argc, char *argv[])
+static void disconnect_compositor(App *app)
 {
-    for (int i = 1; i < argc; i++) {
-        if (strcmp(argv[i], "-s") == 0) {
-            /* Auf den Sekundenwert prüfen */
-            if (i + 1 >= argc) {
-                fprintf(stderr, "Fehler: -s benötigt einen Wert\n");
-                return false;
-            }
-            i++;
-            char *end;
-            long secs = strtol(argv[i], &end, 10);
-            if (*end != '\0' || secs <= 0) {
-                fprintf(stderr, "Fehler: Ungültiger Wert für -s: %s\n", argv[i]);
-                return false;
-            }
-            /* Sekunden in Millisekunden umrechnen */
-            app->timeout_ms = (int)(secs * 1000);
+    destroy_overlay_surface(app);
+    if (app->buffer) {
+        wl_buffer_destroy(app->buffer);
+        app->buffer = NULL;
+    }
+    app->buffer_busy     = false;
+    app->content_pending = false;
+    if (app->viewporter) {
+        wp_viewporter_destroy(app->viewporter);
+        app->viewporter = NULL;
+    }
 
-        } else if (strcmp(argv[i], "-e") == 0) {
-            app->exit_on_hide = true;
+    /* Ausgaben und Gamma-Steuerung freigeben (Rampen sind wiederhergestellt) */
+    while (app->noutputs > 0)
+        remove_output(app, app->outputs[0].name);
+    if (app->gamma_manager) {
+        zwlr_gamma_control_manager_v1_destroy(app->gamma_manager);
+        app->gamma_manager = NULL;
+    }
 
-        } else {
-            fprintf(stderr, "Unbekannter Parameter: %s\n", argv[i]);
-            fprintf(stderr, "Verwendung: blkout [-s <sekunden>] [-e]\n");
+    /* Idle-Notifications freigeben */
+    teardown_idle_notification(app);
+    if (app->idle_notifier) {
+        ext_idle_notifier_v1_destroy(app->idle_notifier);
+        app->idle_notifier = NULL;
+    }
+
+    /* Seats samt Eingabeobjekten freigeben */
+    while (app->nseats > 0)
+        remove_seat(app, app->seats[0].name);
+
+    /* Präsentations-Objekte freigeben */
+    drop_feedback(app);
+    if (app->presentation) {
+        wp_presentation_destroy(app->presentation);
+        app->presentation = NULL;
+    }
+
+    /* Layer-Shell freigeben */
+    if (app->layer_shell) {
+        zwlr_layer_shell_v1_destroy(app->layer_shell);
+        app->layer_shell = NULL;
+    }
+
+    /* Wayland-Kernobjekte freigeben */
+    if (app->shm) {
+        wl_shm_destroy(app->shm);
+        app->shm = NULL;
+    }
+    if (app->compositor) {
+        wl_compositor_destroy(app->compositor);
+        app->compositor = NULL;
+    }
+    if (app->registry) {
+        wl_registry_destroy(app->registry);
+        app->registry = NULL;
+    }
+
+    /* Verbindung zum Compositor trennen */
+    if (app->display) {
+        wl_display_disconnect(app->display);
+        app->display = NULL;
+    }
+    app->metrics.connected = false;
+}
+
+/*
+ * Bis zu ms Millisekunden warten und dabei alle Ereignisquellen wie in
+ * run_loop() bedienen, nur ohne Wayland-Verbindung: Signale, Steuersocket,
+ * D-Bus, Metriken, Timer und Konfiguration laufen während des Ausfalls
+ * weiter. Ein angefordertes Overlay merkt sich show_overlay() für später.
+ */
+static void reconnect_wait(App *app, int ms)
+{
+    struct pollfd pfd[MAX_SOURCES];
+    Source        src[MAX_SOURCES];
+    uint64_t      deadline = monotonic_ns() + (uint64_t)ms * 1000000;
+
+    while (app->running) {
+        uint64_t now = monotonic_ns();
+        if (now >= deadline)
+            break;
+
+        int nsrc = app->nsources;
+        memcpy(src, app->sources, sizeof(Source) * (size_t)nsrc);
+        for (int i = 0; i < nsrc; i++)
+            pfd[i] = (struct pollfd){
+                .fd = src[i].fd, .events = src[i].events,
+            };
+
+        int timeout = (int)((deadline - now + 999999) / 1000000);
+        int n = poll(pfd, (nfds_t)nsrc, timeout);
+        if (n < 0) {
+            if (errno == EINTR)
+                continue;
+            perror("poll");
+            return;
+        }
+        if (n == 0)
+            break;
+
+        Phase    phase         = app->stats.phase;
+        uint64_t events_before = app->stats.events_total;
+        unsigned causes        = dispatch_sources(app, src, pfd, nsrc);
+        stats_wakeup(&app->stats, phase, causes, events_before);
+    }
+}
+
+/*
+ * Nach Verbindungsverlust neu verbinden und den Zustand wiederherstellen.
+ * Gibt false zurück bei Protokollfehler (ein Fehler in blkout, der sich
+ * beim Neuverbinden wiederholen würde), Beenden per Signal oder wenn der
+ * Compositor nach RECONNECT_GIVE_UP_MS nicht zurück ist.
+ */
+static bool reconnect(App *app)
+{
+    int err = app->display ? wl_display_get_error(app->display) : 0;
+    if (err == EPROTO) {
+        fprintf(stderr, "Protokollfehler, beende\n");
+        return false;
+    }
+
+    uint64_t lost_ns = monotonic_ns();
+    fprintf(stderr, "Verbindung zum Compositor verloren (%s), "
+                    "verbinde neu\n", strerror(err ? err : EPIPE));
+    trace_instant("disconnected");
+
+    /* Der Compositor hat das Overlay mit der Verbindung verworfen */
+    app->show_on_reconnect = app->overlay_visible;
+    if (app->overlay_visible) {
+        app->overlay_visible = false;
+        stats_set_phase(&app->stats, PHASE_ARMED);
+        metrics_hide(&app->metrics);
+    }
+    app->configured       = false;
+    app->idled            = false;
+    app->idled_ns         = 0;
+    app->wake_ns          = 0;
+    disconnect_compositor(app);
+    if (app->rebuild_on_hide) {
+        destroy_buffer(app);
+        app->rebuild_on_hide = false;
+    }
+    publish_metrics(app);
+
+    int delay_ms = RECONNECT_DELAY_MIN_MS;
+    for (;;) {
+        reconnect_wait(app, delay_ms);
+        if (!app->running)
+            return false;
+        if (connect_compositor(app))
+            break;
+        disconnect_compositor(app);
+
+        if (monotonic_ns() - lost_ns >= (uint64_t)RECONNECT_GIVE_UP_MS * 1000000) {
+            fprintf(stderr, "Compositor nach %d s nicht zurück, gebe auf\n",
+                    RECONNECT_GIVE_UP_MS / 1000);
             return false;
         }
+        delay_ms = delay_ms * 2 < RECONNECT_DELAY_MAX_MS
+                       ? delay_ms * 2 : RECONNECT_DELAY_MAX_MS;
     }
-    return true;
+
+    /* Ausfallzeit melden und als Metrik festhalten */
+    double outage_s = (double)(monotonic_ns() - lost_ns) / 1e9;
+    fprintf(stderr, "Verbindung nach %.0f ms wiederhergestellt\n",
+            outage_s * 1e3);
+    trace_instant_args("reconnected", "\"outage_ms\":%.3f", outage_s * 1e3);
+    app->metrics.reconnects++;
+    metrics_observe(&app->metrics.reconnect_outage, outage_s);
+
+    rearm_idle_notification(app);
+    if (app->show_on_reconnect) {
+        app->show_on_reconnect = false;
+        show_overlay(app);
+    }
+    publish_metrics(app);
+    return app->running;
 }
 
 /* =========================================================================
@@ -744,68 +4477,169 @@ int main(int argc, char *argv[])
 {
     /* --- Anwendungszustand initialisieren --- */
     App app = {
-        .timeout_ms    = 0,
-        .exit_on_hide  = false,
         .overlay_visible = false,
         .configured    = false,
         .running       = true,
         .shm_fd        = -1,
+        .signal_fd     = -1,
+        .metrics_fd    = -1,
+        .config_fd     = -1,
+        .control_fd    = -1,
+        .exit_timer_fd = -1,
+        .evdev         = { .epoll_fd = -1 },
+        .evdev_dir     = EVDEV_DEFAULT_DIR,
+        .psi           = { .epoll_fd = -1, .psi_fd = -1 },
+        .psi_stall_ms  = PSI_STALL_MS_DEFAULT,
+        .content_timer_fd = -1,
+        .prefill       = { .done_fd = -1, .fd = -1 },
+        .prefill_timer_fd = -1,
+        .image         = { .fd = -1 },
+        .presentation_clock = CLOCK_MONOTONIC,
+        .argc          = argc,
+        .argv          = argv,
     };
+    int status = EXIT_FAILURE;  /* Bis die Einrichtung durch ist */
+    stats_init(&app.stats);
+    metrics_init(&app.metrics);
 
-    /* --- Kommandozeilenparameter auswerten --- */
+    /*
+     * --- Kommandozeilenparameter auswerten ---
+     * Ein erster Durchgang liefert den Pfad der Konfigurationsdatei, der
+     * zweite legt die Kommandozeile über deren Einstellungen.
+     */
+    char *default_config = NULL;
     if (!parse_args(&app, argc, argv))
         return EXIT_FAILURE;
 
-    /* --- Verbindung zum Wayland-Compositor herstellen --- */
-    app.display = wl_display_connect(NULL);
-    if (!app.display) {
-        fprintf(stderr, "Keine Verbindung zum Wayland-Display möglich\n");
+    /* --- Nur Ringdatei ausgeben (--journal-dump) --- */
+    if (app.journal_dump)
+        return journal_dump(app.journal_dump, stdout) ? EXIT_SUCCESS
+                                                      : EXIT_FAILURE;
+    if (!app.config_path)
+        app.config_path = default_config = config_default_path();
+    if (!load_settings(&app))
         return EXIT_FAILURE;
-    }
 
-    /* --- Registry anfordern, um globale Objekte zu binden --- */
-    app.registry = wl_display_get_registry(app.display);
-    wl_registry_add_listener(app.registry, &registry_listener, &app);
+    /* --- Trace-Datei öffnen (--trace) --- */
+    if (app.trace_path && !trace_open(app.trace_path))
+        return EXIT_FAILURE;
+
+    /* --- Ereignis-Mitschnitt öffnen (--record) --- */
+    if (app.record_path && !record_open(app.record_path, argc, argv))
+        goto cleanup;
+
+    /* --- Ringdatei der Übergänge einblenden (--journal) --- */
+    if (app.journal_path && !journal_open(app.journal_path))
+        goto cleanup;
+
+    /* --- Signale in die Hauptschleife umleiten --- */
+    if (!setup_signals(&app))
+        goto cleanup;
+
+    /* --- Metrik-Socket öffnen (--metrics-socket) --- */
+    if (app.metrics_socket) {
+        app.metrics_fd = metrics_listen(app.metrics_socket);
+        if (app.metrics_fd < 0 ||
+            !add_source(&app, app.metrics_fd, WAKE_IPC, handle_metrics))
+            goto cleanup;
+    }
+    publish_metrics(&app);
 
     /*
-     * Zwei Roundtrips durchführen:
-     * - Erster Roundtrip: Registry-Events empfangen (Objekte ankündigen)
-     * - Zweiter Roundtrip: Seat-Capabilities empfangen (Keyboard/Pointer binden)
+     * --- Steuersocket: geerbt per Socket-Aktivierung oder selbst angelegt ---
      */
-    wl_display_roundtrip(app.display);
-    wl_display_roundtrip(app.display);
+    app.control_fd = control_inherited();
+    if (app.control_fd >= 0) {
+        app.control_socket = NULL;   /* Geerbten Socket nicht entfernen */
+    } else if (app.control_socket) {
+        app.control_fd = control_listen(app.control_socket);
+        if (app.control_fd < 0)
+            goto cleanup;
+    }
+    if (app.control_fd >= 0 &&
+        !add_source(&app, app.control_fd, WAKE_IPC, handle_control))
+        goto cleanup;
 
-    /* --- Pflichtkomponenten prüfen --- */
-    if (!app.compositor) {
-        fprintf(stderr, "wl_compositor nicht verfügbar\n");
+    /* --- org.freedesktop.ScreenSaver auf dem Session-Bus (optional) --- */
+    if (app.dbus_screensaver && !setup_screensaver(&app))
+        goto cleanup;
+
+    /* --- Vorgehaltene Puffer weichen unter Speicherdruck (PSI) --- */
+    setup_psi(&app);
+
+    if (remote_control(&app) && app.resume_only && app.timeout_ms == 0) {
+        fprintf(stderr, "Fehler: -r ohne -s zeigt das Overlay sofort und "
+                        "passt nicht zu Steuersocket oder D-Bus\n");
         goto cleanup;
     }
-    if (!app.shm) {
-        fprintf(stderr, "wl_shm nicht verfügbar\n");
+    if (app.exit_idle_ms > 0) {
+        if (!remote_control(&app)) {
+            fprintf(stderr, "Fehler: --exit-idle nur mit Steuersocket "
+                            "oder --dbus-screensaver\n");
+            goto cleanup;
+        }
+        app.exit_timer_fd = timerfd_create(CLOCK_MONOTONIC,
+                                           TFD_NONBLOCK | TFD_CLOEXEC);
+        if (app.exit_timer_fd < 0) {
+            perror("timerfd_create");
+            goto cleanup;
+        }
+        if (!add_source(&app, app.exit_timer_fd, WAKE_TIMER, handle_exit_timer))
+            goto cleanup;
+    }
+
+    /* --- Standbild einmalig in den memfd übernehmen (--image) --- */
+    if (app.image_path) {
+        if (!image_load(&app.image, app.image_path))
+            goto cleanup;
+        metrics_buffer_alloc(&app.metrics, app.image.size);
+    }
+
+    /* --- Timer für den Inhalt auf dem Overlay (--content) --- */
+    if (!setup_content_timer(&app))
         goto cleanup;
+
+    /* --- Farbige Puffer im Hintergrund vorab füllen (--color) --- */
+    setup_prefill(&app);
+
+    /* --- Konfigurationsdatei beobachten (nicht bei --benchmark) --- */
+    if (app.config_path && app.benchmark_cycles == 0) {
+        app.config_fd = config_watch(app.config_path);
+        if (app.config_fd >= 0 &&
+            !add_source(&app, app.config_fd, WAKE_CONFIG, handle_config))
+            goto cleanup;
     }
-    if (!app.layer_shell) {
-        fprintf(stderr, "zwlr_layer_shell_v1 nicht verfügbar\n"
-                        "Ist der Compositor kompatibel (KDE Plasma 6+)?\n");
+
+    /* Einrichtung vollständig; ab hier bestimmt der Lauf den Status */
+    status = EXIT_SUCCESS;
+
+    /* --- Verbindung zum Wayland-Compositor herstellen --- */
+    if (!connect_compositor(&app)) {
+        status = EXIT_FAILURE;
         goto cleanup;
     }
 
-    /* --- Idle-Notification einrichten (nur bei -s) --- */
-    if (app.timeout_ms > 0) {
-        if (!setup_idle_notification(&app))
-            goto cleanup;
-    } else {
-        /* Kein Timeout: Overlay sofort anzeigen */
-        show_overlay(&app);
+    /* --- Selbstmessung (--benchmark): Zyklen fahren, dann beenden --- */
+    if (app.benchmark_cycles > 0) {
+        if (!run_benchmark(&app))
+            status = EXIT_FAILURE;
+        goto cleanup;
     }
 
+    /*
+     * --- Idle-Notification einrichten (bei -s, und bei -r als Weckquelle) ---
+     * Ohne Timeout wird das Overlay sofort angezeigt.
+     */
+    rearm_idle_notification(&app);
+
     /*
      * --- Hauptschleife ---
-     * wl_display_dispatch() blockiert, bis mindestens ein Ereignis
-     * verarbeitet wurde, und ruft alle registrierten Listener-Callbacks auf.
-     * Die Schleife läuft, bis app.running auf false gesetzt wird.
+     * run_loop() blockiert in poll(), bis ein Ereignis eintrifft, und ruft
+     * alle registrierten Listener-Callbacks auf. Die Schleife läuft, bis
+     * app.running auf false gesetzt wird. Geht die Verbindung verloren,
+     * verbindet reconnect() neu und die Schleife beginnt von vorn.
      */
-    while (app.running && wl_display_dispatch(app.display) != -1)
+    while (app.running && run_loop(&app) < 0 && reconnect(&app))
         ;
 
     /* --- Aufräumen --- */
@@ -816,35 +4650,59 @@ cleanup:
         hide_overlay(&app);
     }
 
-    /* Idle-Notification freigeben */
-    if (app.idle_notification)
-        ext_idle_notification_v1_destroy(app.idle_notification);
-    if (app.idle_notifier)
-        ext_idle_notifier_v1_destroy(app.idle_notifier);
+    /* Bei persistent/cached zurückbehaltene Surface und Puffer freigeben */
+    destroy_overlay_surface(&app);
+    destroy_buffer(&app);
+    fill_async_close(&app.prefill);
+    fill_cache_drop(&app);
+    disconnect_compositor(&app);
+    evdev_stop(&app);
 
-    /* Eingabeobjekte freigeben */
-    if (app.keyboard)
-        wl_keyboard_destroy(app.keyboard);
-    if (app.pointer)
-        wl_pointer_destroy(app.pointer);
-    if (app.seat)
-        wl_seat_destroy(app.seat);
+    /* Zählerstände ausgeben (--stats) */
+    if (app.print_stats)
+        stats_print(&app.stats, stderr);
 
-    /* Layer-Shell freigeben */
-    if (app.layer_shell)
-        zwlr_layer_shell_v1_destroy(app.layer_shell);
+    if (app.signal_fd >= 0)
+        close(app.signal_fd);
+    if (app.config_fd >= 0)
+        close(app.config_fd);
+    if (app.exit_timer_fd >= 0)
+        close(app.exit_timer_fd);
+    if (app.content_timer_fd >= 0)
+        close(app.content_timer_fd);
+    if (app.prefill_timer_fd >= 0)
+        close(app.prefill_timer_fd);
+    if (app.image.fd >= 0) {
+        metrics_buffer_free(&app.metrics, app.image.size);
+        image_close(&app.image);
+    }
+    while (app.ncontrol_clients > 0)
+        control_client_close(&app, 0);
+    if (app.control_fd >= 0) {
+        close(app.control_fd);
+        if (app.control_socket)
+            unlink(app.control_socket);
+    }
+    if (app.screensaver)
+        screensaver_close(app.screensaver);
+    psi_close(&app.psi);
+    free(default_config);
+    free(app.conf_evdev_dir);
+    free(app.conf_seats);
 
-    /* Wayland-Kernobjekte freigeben */
-    if (app.shm)
-        wl_shm_destroy(app.shm);
-    if (app.compositor)
-        wl_compositor_destroy(app.compositor);
-    if (app.registry)
-        wl_registry_destroy(app.registry);
+    /* Letzten Metrik-Stand schreiben, Socket entfernen */
+    publish_metrics(&app);
+    while (app.nmetrics_clients > 0)
+        metrics_client_drop(&app, 0);
+    if (app.metrics_fd >= 0) {
+        close(app.metrics_fd);
+        unlink(app.metrics_socket);
+    }
 
-    /* Verbindung zum Compositor trennen */
-    if (app.display)
-        wl_display_disconnect(app.display);
+    /* Trace-Array abschließen, Mitschnitt schließen */
+    trace_close();
+    record_close();
+    journal_close();
 
-    return EXIT_SUCCESS;
+    return status;
 }
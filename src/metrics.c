@@ -0,0 +1,297 @@
+/*
+ * metrics.c — Laufzeitmetriken im Prometheus-Textformat
+ *
+ * Siehe metrics.h.
+ */
+
+#define _GNU_SOURCE
+
+#include "metrics.h"
+#include "clock.h"
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+
+/* Bucket-Obergrenzen in Sekunden, aufsteigend */
+static const double bucket_bounds[METRICS_BUCKETS] = {
+    0.001, 0.0025, 0.005, 0.01, 0.025, 0.05,
+    0.1,   0.25,   0.5,   1.0,  2.5,   5.0,
+};
+
+void metrics_init(Metrics *m)
+{
+    memset(m, 0, sizeof(*m));
+}
+
+void metrics_show(Metrics *m)
+{
+    m->shows++;
+    m->blanked          = true;
+    m->blanked_since_ns = monotonic_ns();
+}
+
+void metrics_hide(Metrics *m)
+{
+    m->hides++;
+    if (m->blanked)
+        m->blanked_ns += monotonic_ns() - m->blanked_since_ns;
+    m->blanked = false;
+}
+
+void metrics_buffer_alloc(Metrics *m, size_t bytes)
+{
+    m->shm_allocated += bytes;
+    m->shm_resident  += bytes;
+    if (m->shm_resident > m->shm_peak)
+        m->shm_peak = m->shm_resident;
+}
+
+void metrics_buffer_free(Metrics *m, size_t bytes)
+{
+    m->shm_freed    += bytes;
+    m->shm_resident -= bytes;
+}
+
+void metrics_presented(Metrics *m, double trigger_s, double idle_s,
+                       uint32_t refresh_ns, uint32_t flags)
+{
+    m->presented++;
+    m->last_refresh_ns = refresh_ns;
+    m->last_flags      = flags;
+    metrics_observe(&m->trigger_to_scanout, trigger_s);
+    if (idle_s >= 0)
+        metrics_observe(&m->idle_to_scanout, idle_s);
+}
+
+void metrics_observe(Histogram *h, double seconds)
+{
+    for (int i = 0; i < METRICS_BUCKETS; i++) {
+        if (seconds <= bucket_bounds[i]) {
+            h->buckets[i]++;
+            break;
+        }
+    }
+    h->count++;
+    h->sum += seconds;
+}
+
+/* Ein Histogramm mit kumulativen Buckets ausgeben */
+static void print_histogram(FILE *out, const char *name, const char *help,
+                            const Histogram *h)
+{
+    uint64_t cumulative = 0;
+
+    fprintf(out, "# HELP %s %s\n# TYPE %s histogram\n", name, help, name);
+    for (int i = 0; i < METRICS_BUCKETS; i++) {
+        cumulative += h->buckets[i];
+        fprintf(out, "%s_bucket{le=\"%g\"} %llu\n", name, bucket_bounds[i],
+                (unsigned long long)cumulative);
+    }
+    fprintf(out, "%s_bucket{le=\"+Inf\"} %llu\n", name,
+            (unsigned long long)h->count);
+    fprintf(out, "%s_sum %.6f\n", name, h->sum);
+    fprintf(out, "%s_count %llu\n", name, (unsigned long long)h->count);
+}
+
+/* Einen einzelnen Zähler oder Messwert ausgeben */
+static void print_value(FILE *out, const char *name, const char *type,
+                        const char *help, double value)
+{
+    fprintf(out, "# HELP %s %s\n# TYPE %s %s\n%s %.9g\n",
+            name, help, name, type, name, value);
+}
+
+void metrics_print(const Metrics *m, FILE *out)
+{
+    /* Laufende Schwarzphase bis jetzt mitzählen */
+    uint64_t blanked_ns = m->blanked_ns;
+    if (m->blanked)
+        blanked_ns += monotonic_ns() - m->blanked_since_ns;
+
+    print_value(out, "blkout_overlay_shows_total", "counter",
+                "Overlays shown", (double)m->shows);
+    print_value(out, "blkout_overlay_hides_total", "counter",
+                "Overlays hidden", (double)m->hides);
+    print_value(out, "blkout_blanked", "gauge",
+                "1 while the overlay is shown", m->blanked ? 1.0 : 0.0);
+    print_value(out, "blkout_blanked_seconds_total", "counter",
+                "Total time the overlay was shown", (double)blanked_ns / 1e9);
+    print_value(out, "blkout_configures_total", "counter",
+                "Layer surface configure events", (double)m->configures);
+    print_value(out, "blkout_shm_allocated_bytes_total", "counter",
+                "Shared memory buffer bytes allocated", (double)m->shm_allocated);
+    print_value(out, "blkout_shm_freed_bytes_total", "counter",
+                "Shared memory buffer bytes freed", (double)m->shm_freed);
+    print_value(out, "blkout_shm_resident_bytes", "gauge",
+                "Shared memory buffer bytes currently mapped",
+                (double)m->shm_resident);
+    print_value(out, "blkout_shm_peak_bytes", "gauge",
+                "Peak shared memory buffer bytes mapped at once",
+                (double)m->shm_peak);
+    print_value(out, "blkout_fills_total", "counter",
+                "Buffers filled with a colour or pattern", (double)m->fills);
+    print_value(out, "blkout_fill_cache_hits_total", "counter",
+                "Filled buffers reused without filling",
+                (double)m->fill_cache_hits);
+    print_value(out, "blkout_memory_pressure_events_total", "counter",
+                "PSI memory pressure triggers received",
+                (double)m->pressure_events);
+    print_value(out, "blkout_evictions_total", "counter",
+                "Warm buffers and surfaces dropped under memory pressure",
+                (double)m->evictions);
+    print_value(out, "blkout_evicted_bytes_total", "counter",
+                "Shared memory buffer bytes dropped under memory pressure",
+                (double)m->evicted_bytes);
+    print_value(out, "blkout_evict_rebuilds_total", "counter",
+                "Buffers rebuilt on show after an eviction",
+                (double)m->rebuilds);
+    print_histogram(out, "blkout_evict_rebuild_seconds",
+                    "Time blkout spends recreating an evicted buffer "
+                    "(memfd, mmap, colour fill, wl_buffer)",
+                    &m->rebuild_time);
+    print_histogram(out, "blkout_idle_to_black_seconds",
+                    "Time from idled event to commit of the black buffer",
+                    &m->idle_to_black);
+    print_histogram(out, "blkout_input_to_hide_seconds",
+                    "Time from waking input event to overlay teardown",
+                    &m->input_to_hide);
+
+    print_value(out, "blkout_presented_total", "counter",
+                "First black frames reported as presented", (double)m->presented);
+    print_value(out, "blkout_discarded_total", "counter",
+                "First black frames reported as discarded", (double)m->discarded);
+    print_value(out, "blkout_refresh_seconds", "gauge",
+                "Output refresh interval of the last presentation",
+                (double)m->last_refresh_ns / 1e9);
+    print_value(out, "blkout_presentation_flags", "gauge",
+                "wp_presentation_feedback kind bits of the last presentation",
+                (double)m->last_flags);
+    print_histogram(out, "blkout_idle_to_scanout_seconds",
+                    "Time from idled event to scanout of the black frame",
+                    &m->idle_to_scanout);
+    print_histogram(out, "blkout_trigger_to_scanout_seconds",
+                    "Time from show_overlay to scanout of the black frame",
+                    &m->trigger_to_scanout);
+
+    print_value(out, "blkout_connected", "gauge",
+                "1 while connected to the compositor", m->connected ? 1.0 : 0.0);
+    print_value(out, "blkout_reconnects_total", "counter",
+                "Reconnects after losing the compositor connection",
+                (double)m->reconnects);
+    print_histogram(out, "blkout_reconnect_outage_seconds",
+                    "Time from losing the compositor connection to reconnect",
+                    &m->reconnect_outage);
+}
+
+int metrics_listen(const char *path)
+{
+    struct sockaddr_un addr = { .sun_family = AF_UNIX };
+
+    if (strlen(path) >= sizeof(addr.sun_path)) {
+        fprintf(stderr, "Socket-Pfad zu lang: %s\n", path);
+        return -1;
+    }
+    strcpy(addr.sun_path, path);
+
+    /* Verwaisten Socket einer früheren Instanz entfernen, sonst nichts */
+    struct stat st;
+    if (lstat(path, &st) == 0) {
+        if (!S_ISSOCK(st.st_mode)) {
+            fprintf(stderr, "%s existiert und ist kein Socket\n", path);
+            return -1;
+        }
+        unlink(path);
+    }
+
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        perror("socket");
+        return -1;
+    }
+
+    if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0 ||
+        listen(fd, 4) < 0) {
+        perror(path);
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+bool metrics_accept(const Metrics *m, int listen_fd, MetricsClient *c)
+{
+    for (;;) {
+        int client = accept4(listen_fd, NULL, NULL,
+                             SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (client < 0) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+                perror("accept4");
+            return false;
+        }
+
+        /* Stand zum Zeitpunkt der Verbindung festhalten */
+        *c = (MetricsClient){ .fd = client };
+        FILE *mem = open_memstream(&c->text, &c->len);
+        if (!mem) {
+            close(client);
+            continue;
+        }
+        metrics_print(m, mem);
+        fclose(mem);
+        return true;
+    }
+}
+
+bool metrics_send(MetricsClient *c)
+{
+    while (c->sent < c->len) {
+        ssize_t n = send(c->fd, c->text + c->sent, c->len - c->sent,
+                         MSG_DONTWAIT | MSG_NOSIGNAL);
+        if (n > 0) {
+            c->sent += (size_t)n;
+            continue;
+        }
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+            return false;
+        /* EPIPE u.ä.: Leser hat aufgegeben */
+        if (n < 0 && errno != EPIPE && errno != ECONNRESET)
+            perror("send");
+        return true;
+    }
+    return true;
+}
+
+void metrics_client_close(MetricsClient *c)
+{
+    free(c->text);
+    c->text = NULL;
+    close(c->fd);
+    c->fd = -1;
+}
+
+bool metrics_write_file(const Metrics *m, const char *path)
+{
+    char tmp[4096];
+    if (snprintf(tmp, sizeof(tmp), "%s.tmp", path) >= (int)sizeof(tmp))
+        return false;
+
+    FILE *out = fopen(tmp, "we");
+    if (!out) {
+        perror(tmp);
+        return false;
+    }
+    metrics_print(m, out);
+    if (fclose(out) != 0 || rename(tmp, path) < 0) {
+        perror(path);
+        unlink(tmp);
+        return false;
+    }
+    return true;
+}
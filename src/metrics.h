@@ -0,0 +1,128 @@
+/*
+ * metrics.h — Laufzeitmetriken im Prometheus-Textformat
+ *
+ * Zähler, Messgrößen und Latenz-Histogramme, die an den bestehenden
+ * Übergängen in main.c fortgeschrieben werden. Ausgeliefert werden sie
+ * entweder über einen Unix-Socket (jede Verbindung erhält den aktuellen
+ * Stand, z.B. per "socat - UNIX-CONNECT:<pfad>") oder als Datei für den
+ * Textfile-Collector des node_exporter, die bei jedem Übergang atomar
+ * neu geschrieben wird. Beides kommt ohne periodischen Timer aus.
+ */
+
+#ifndef BLKOUT_METRICS_H
+#define BLKOUT_METRICS_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+/* Obergrenzen der Histogramm-Buckets in Sekunden (ohne +Inf) */
+#define METRICS_BUCKETS 12
+
+typedef struct {
+    uint64_t buckets[METRICS_BUCKETS];  /* Nicht kumulativ, je Bucket */
+    uint64_t count;                     /* Anzahl aller Beobachtungen */
+    double   sum;                       /* Summe aller Beobachtungen [s] */
+} Histogram;
+
+typedef struct {
+    /* --- Overlay --- */
+    uint64_t shows;             /* Angezeigte Overlays */
+    uint64_t hides;             /* Geschlossene Overlays */
+    uint64_t configures;        /* Empfangene configure-Events */
+    bool     blanked;           /* Overlay gerade sichtbar */
+    uint64_t blanked_since_ns;  /* Beginn der laufenden Schwarzphase */
+    uint64_t blanked_ns;        /* Abgeschlossene Schwarzzeit */
+
+    /* --- Shared-Memory-Puffer --- */
+    uint64_t shm_allocated;     /* Insgesamt angelegte Bytes */
+    uint64_t shm_freed;         /* Insgesamt freigegebene Bytes */
+    uint64_t shm_resident;      /* Aktuell gemappte Bytes */
+    uint64_t shm_peak;          /* Höchststand von shm_resident */
+    uint64_t fills;             /* Farbig gefüllte Puffer (--color) */
+    uint64_t fill_cache_hits;   /* Davon ohne Füllen wiederverwendet */
+
+    /* --- Vorgehaltene Puffer unter Speicherdruck (PSI) --- */
+    uint64_t pressure_events;   /* Ausgelöste PSI-Trigger */
+    uint64_t evictions;         /* Davon mit verworfenem Puffer/Surface */
+    uint64_t evicted_bytes;     /* Dabei freigegebene Pufferbytes */
+    uint64_t rebuilds;          /* Nach dem Verwerfen neu aufgebaute Puffer */
+    Histogram rebuild_time;     /* Dauer des Neuaufbaus in blkout (create_buffer) */
+
+    /* --- Latenzen --- */
+    Histogram idle_to_black;    /* idled-Event bis Commit des schwarzen Puffers */
+    Histogram input_to_hide;    /* Eingabe-Zeitstempel bis Overlay abgebaut */
+
+    /* --- Präsentation des ersten schwarzen Frames (wp_presentation) --- */
+    uint64_t  presented;        /* Gemeldete Präsentationen */
+    uint64_t  discarded;        /* Verworfene erste Frames */
+    uint32_t  last_refresh_ns;  /* Refresh-Intervall der letzten Meldung */
+    uint32_t  last_flags;       /* wp_presentation_feedback.kind-Bits */
+    Histogram idle_to_scanout;  /* idled-Event bis Scanout */
+    Histogram trigger_to_scanout; /* show_overlay() bis Scanout */
+
+    /* --- Verbindung zum Compositor --- */
+    bool      connected;        /* Verbindung steht */
+    uint64_t  reconnects;       /* Erfolgreiche Neuverbindungen */
+    Histogram reconnect_outage; /* Verbindungsverlust bis Neuverbindung */
+} Metrics;
+
+void metrics_init(Metrics *m);
+
+/* Übergänge */
+void metrics_show(Metrics *m);
+void metrics_hide(Metrics *m);
+void metrics_buffer_alloc(Metrics *m, size_t bytes);
+void metrics_buffer_free(Metrics *m, size_t bytes);
+
+/*
+ * Präsentation des ersten schwarzen Frames. Latenzen in Sekunden;
+ * idle_s < 0, wenn das Overlay nicht durch idled ausgelöst wurde.
+ */
+void metrics_presented(Metrics *m, double trigger_s, double idle_s,
+                       uint32_t refresh_ns, uint32_t flags);
+
+/* Beobachtung in Sekunden in ein Histogramm eintragen */
+void metrics_observe(Histogram *h, double seconds);
+
+/* Aktuellen Stand im Prometheus-Textformat ausgeben */
+void metrics_print(const Metrics *m, FILE *out);
+
+/*
+ * Unix-Socket anlegen und lauschen. Ein vorhandener Socket an path wird
+ * ersetzt, jede andere Datei nicht. Gibt den fd zurück, -1 bei Fehler.
+ */
+int metrics_listen(const char *path);
+
+/* Gleichzeitig offene Verbindungen; eine weitere verdrängt die älteste */
+#define METRICS_MAX_CLIENTS 4
+
+/* Verbindung mit dem beim Annehmen erzeugten, noch nicht gesendeten Text */
+typedef struct {
+    int    fd;
+    char  *text;
+    size_t len;
+    size_t sent;
+} MetricsClient;
+
+/*
+ * Eine wartende Verbindung nicht blockierend annehmen und den aktuellen
+ * Stand als Text bereitlegen. Gibt false zurück, wenn keine wartet.
+ */
+bool metrics_accept(const Metrics *m, int listen_fd, MetricsClient *c);
+
+/*
+ * So viel senden, wie der Socket-Puffer aufnimmt. Gibt true zurück, wenn
+ * der Text vollständig gesendet ist oder der Leser aufgegeben hat, sonst
+ * muss der Aufrufer auf POLLOUT warten und erneut senden.
+ */
+bool metrics_send(MetricsClient *c);
+
+/* Text freigeben und Verbindung schließen */
+void metrics_client_close(MetricsClient *c);
+
+/* Datei über temporäre Datei + rename() atomar neu schreiben */
+bool metrics_write_file(const Metrics *m, const char *path);
+
+#endif
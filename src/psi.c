@@ -0,0 +1,75 @@
+/*
+ * psi.c — Speicherdruck über PSI-Trigger
+ *
+ * Siehe psi.h. Der Kern setzt das Ereignis beim Auslösen und löscht es
+ * beim nächsten poll; epoll_wait() verbraucht es also, ein Trigger weckt
+ * genau einmal. Innerhalb eines Fensters löst derselbe Trigger höchstens
+ * einmal aus.
+ */
+
+#define _GNU_SOURCE
+
+#include "psi.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+
+bool psi_open(Psi *p, const char *path, int stall_ms)
+{
+    p->epoll_fd = -1;
+    p->psi_fd   = open(path, O_RDWR | O_NONBLOCK | O_CLOEXEC);
+    if (p->psi_fd < 0) {
+        /* Kern ohne CONFIG_PSI oder mit psi=0: still weiter ohne */
+        if (errno != ENOENT && errno != EOPNOTSUPP)
+            perror(path);
+        return false;
+    }
+
+    /* Schwelle und Fenster in Mikrosekunden, inklusive Nullbyte schreiben */
+    char trigger[64];
+    int len = snprintf(trigger, sizeof(trigger), "some %d %d",
+                       stall_ms * 1000, PSI_WINDOW_MS * 1000);
+    if (write(p->psi_fd, trigger, (size_t)len + 1) < 0) {
+        fprintf(stderr, "%s: Trigger \"%s\" abgelehnt: %s\n",
+                path, trigger, strerror(errno));
+        psi_close(p);
+        return false;
+    }
+
+    p->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    struct epoll_event e = { .events = EPOLLPRI, .data.fd = p->psi_fd };
+    if (p->epoll_fd < 0 ||
+        epoll_ctl(p->epoll_fd, EPOLL_CTL_ADD, p->psi_fd, &e) < 0) {
+        perror("epoll");
+        psi_close(p);
+        return false;
+    }
+    return true;
+}
+
+bool psi_dispatch(Psi *p)
+{
+    struct epoll_event e;
+    if (epoll_wait(p->epoll_fd, &e, 1, 0) != 1)
+        return false;
+    if (e.events & EPOLLERR) {
+        fprintf(stderr, "PSI-Trigger entfernt, beobachte keinen "
+                        "Speicherdruck mehr\n");
+        psi_close(p);
+        return false;
+    }
+    return (e.events & EPOLLPRI) != 0;
+}
+
+void psi_close(Psi *p)
+{
+    if (p->epoll_fd >= 0)
+        close(p->epoll_fd);
+    if (p->psi_fd >= 0)
+        close(p->psi_fd);
+    p->epoll_fd = p->psi_fd = -1;
+}
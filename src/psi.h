@@ -0,0 +1,48 @@
+/*
+ * psi.h — Speicherdruck über PSI-Trigger (/proc/pressure/memory)
+ *
+ * Mit --strategy persistent und cached hält blkout Puffer und Surface
+ * zwischen zwei Anzeigen vor, damit das Schwärzen schnell geht. Unter
+ * Speicherdruck soll dieser Vorrat weichen. Der Kern meldet über einen
+ * PSI-Trigger, sobald Tasks innerhalb eines Zeitfensters zusammen länger
+ * als die Schwelle auf Speicher gewartet haben ("some"). Ohne Druck
+ * verursacht der Trigger keinen einzigen Wakeup.
+ *
+ * Der Trigger signalisiert POLLPRI statt POLLIN. Damit er wie jede andere
+ * Quelle in der Hauptschleife hängen kann, steckt er in einem epoll-fd,
+ * der beim Auslösen lesbar wird.
+ *
+ * Ohne CAP_SYS_RESOURCE erlaubt der Kern (ab 6.4) nur Fenster in
+ * Vielfachen von 2 s; PSI_WINDOW_MS hält sich daran.
+ */
+
+#ifndef BLKOUT_PSI_H
+#define BLKOUT_PSI_H
+
+#include <stdbool.h>
+
+#define PSI_MEMORY_PATH      "/proc/pressure/memory"
+#define PSI_WINDOW_MS        2000
+#define PSI_STALL_MS_DEFAULT 200   /* 10 % des Fensters */
+
+typedef struct {
+    int epoll_fd;   /* Quelle für die Hauptschleife, -1 = aus */
+    int psi_fd;     /* Offene Druckdatei mit registriertem Trigger */
+} Psi;
+
+/*
+ * Trigger für stall_ms Wartezeit je PSI_WINDOW_MS registrieren. Gibt
+ * false zurück, wenn der Kern kein PSI kennt oder den Trigger ablehnt;
+ * gemeldet wird nur Letzteres.
+ */
+bool psi_open(Psi *p, const char *path, int stall_ms);
+
+/*
+ * Nach einem Wakeup: true, wenn der Trigger ausgelöst hat. Verschwindet
+ * der Trigger (EPOLLERR), wird abgemeldet und epoll_fd danach -1.
+ */
+bool psi_dispatch(Psi *p);
+
+void psi_close(Psi *p);
+
+#endif
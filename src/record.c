@@ -0,0 +1,68 @@
+/*
+ * record.c — Mitschnitt der von blkout ausgewerteten Wayland-Ereignisse
+ *
+ * Siehe record.h. Zeitstempel sind Mikrosekunden auf CLOCK_MONOTONIC,
+ * gezählt ab record_open(), damit Mitschnitte verschiedener Rechner
+ * vergleichbar bleiben.
+ */
+
+#define _GNU_SOURCE
+
+#include "record.h"
+
+#include <stdarg.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "clock.h"
+
+FILE *record_file;
+
+static uint64_t record_start_ns;   /* Bezugspunkt der Zeitstempel */
+
+bool record_open(const char *path, int argc, char *argv[])
+{
+    record_file = fopen(path, "we");
+    if (!record_file) {
+        perror(path);
+        return false;
+    }
+    setvbuf(record_file, NULL, _IOLBF, 0);
+    record_start_ns = monotonic_ns();
+
+    fprintf(record_file, "# blkout-record %d\n# args", RECORD_FORMAT_VERSION);
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--record") == 0) {
+            i++;
+            continue;
+        }
+        fprintf(record_file, " %s", argv[i]);
+    }
+    fputc('\n', record_file);
+    return true;
+}
+
+void record_close(void)
+{
+    if (!record_file)
+        return;
+    fclose(record_file);
+    record_file = NULL;
+}
+
+void record_write(const char *name, const char *args_fmt, ...)
+{
+    if (!record_file)
+        return;
+
+    uint64_t t = (monotonic_ns() - record_start_ns) / 1000u;
+    fprintf(record_file, "%llu %s", (unsigned long long)t, name);
+    if (args_fmt) {
+        va_list ap;
+        va_start(ap, args_fmt);
+        fputc(' ', record_file);
+        vfprintf(record_file, args_fmt, ap);
+        va_end(ap);
+    }
+    fputc('\n', record_file);
+}
@@ -0,0 +1,57 @@
+/*
+ * record.h — Mitschnitt der von blkout ausgewerteten Wayland-Ereignisse
+ *
+ * Mit --record <datei> schreibt blkout jedes Ereignis, das ein Listener
+ * auswertet (Registry, Seat, configure/closed, Tastatur, Maus, idled/
+ * resumed), als Textzeile mit Zeitstempel mit. Dazu kommen Marken für die
+ * eigenen Übergänge (show_overlay, hide_overlay), an denen sich
+ * tools/replay beim Abspielen synchronisiert und Abweichungen erkennt.
+ *
+ * Format (eine Zeile pro Ereignis, Argumente durch Leerzeichen getrennt):
+ *   # blkout-record 2
+ *   # args <Kommandozeile ohne --record>
+ *   <µs seit Start> <interface.event | marke> [argumente...]
+ *
+ * Ereignisse eines Seats (Tastatur, Maus, idled/resumed) tragen seit
+ * Version 2 als letztes Argument dessen Namen (wl_seat.name, vorher
+ * "wl_seat#<registry-name>"); der Rest der Zeile gehört dazu.
+ *
+ * Die Datei ist zeilengepuffert, damit ein Mitschnitt auch nach einem
+ * Absturz bis zum letzten Ereignis vollständig ist. Ohne --record sind
+ * alle Aufrufe ein einzelner Zeigervergleich.
+ */
+
+#ifndef BLKOUT_RECORD_H
+#define BLKOUT_RECORD_H
+
+#include <stdbool.h>
+#include <stdio.h>
+
+#define RECORD_FORMAT_VERSION 2
+
+/* Geöffnete Mitschnitt-Datei, NULL = Mitschnitt aus */
+extern FILE *record_file;
+
+/*
+ * Datei anlegen und Kopf schreiben. argv wird ohne "--record <datei>"
+ * als Kommandozeile vermerkt. Gibt false bei Fehler zurück.
+ */
+bool record_open(const char *path, int argc, char *argv[]);
+
+/* Datei schließen */
+void record_close(void);
+
+/*
+ * Ein Ereignis schreiben. args_fmt ist optional (NULL) und ergibt die
+ * Argumente hinter dem Namen, z.B. "%u %u".
+ */
+void record_write(const char *name, const char *args_fmt, ...)
+    __attribute__((format(printf, 2, 3)));
+
+/* Ereignis ohne bzw. mit Argumenten */
+#define record_event(name) \
+    do { if (record_file) record_write((name), NULL); } while (0)
+#define record_event_args(name, ...) \
+    do { if (record_file) record_write((name), __VA_ARGS__); } while (0)
+
+#endif
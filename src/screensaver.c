@@ -0,0 +1,186 @@
+/*
+ * screensaver.c — org.freedesktop.ScreenSaver über sd-bus
+ *
+ * Siehe screensaver.h. sd-bus schreibt Antworten und Signale sofort, wenn
+ * der Socket es zulässt; was liegen bleibt, schiebt sd_bus_flush() am Ende
+ * von screensaver_dispatch() nach. Die Hauptschleife braucht deshalb nur
+ * POLLIN und keine Zeitgrenze: blkout ruft selbst keine Methoden asynchron
+ * auf, auf deren Antwort es warten müsste.
+ */
+
+#define _GNU_SOURCE
+
+#include "screensaver.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#ifdef HAVE_DBUS
+
+#include <errno.h>
+#include <string.h>
+#include <systemd/sd-bus.h>
+
+#define SCREENSAVER_NAME      "org.freedesktop.ScreenSaver"
+#define SCREENSAVER_INTERFACE "org.freedesktop.ScreenSaver"
+#define SCREENSAVER_PATH      "/org/freedesktop/ScreenSaver"
+#define SCREENSAVER_PATH_KDE  "/ScreenSaver"
+
+struct ScreenSaver {
+    sd_bus            *bus;
+    sd_bus_slot       *slots[2];   /* Je Objektpfad eine vtable */
+    ScreenSaverHandler handler;
+};
+
+static int method_set_active(sd_bus_message *m, void *userdata,
+                             sd_bus_error *error)
+{
+    (void)error;
+    ScreenSaver *ss = userdata;
+    int active;
+    int r = sd_bus_message_read(m, "b", &active);
+    if (r < 0)
+        return r;
+    bool ok = ss->handler.set_active(ss->handler.data, active != 0);
+    return sd_bus_reply_method_return(m, "b", ok);
+}
+
+static int method_get_active(sd_bus_message *m, void *userdata,
+                             sd_bus_error *error)
+{
+    (void)error;
+    ScreenSaver *ss = userdata;
+    return sd_bus_reply_method_return(m, "b",
+                                      ss->handler.get_active(ss->handler.data));
+}
+
+static int method_get_active_time(sd_bus_message *m, void *userdata,
+                                  sd_bus_error *error)
+{
+    (void)error;
+    ScreenSaver *ss = userdata;
+    return sd_bus_reply_method_return(
+        m, "u", ss->handler.get_active_time(ss->handler.data));
+}
+
+static const sd_bus_vtable screensaver_vtable[] = {
+    SD_BUS_VTABLE_START(0),
+    SD_BUS_METHOD("SetActive", "b", "b", method_set_active,
+                  SD_BUS_VTABLE_UNPRIVILEGED),
+    SD_BUS_METHOD("GetActive", "", "b", method_get_active,
+                  SD_BUS_VTABLE_UNPRIVILEGED),
+    SD_BUS_METHOD("GetActiveTime", "", "u", method_get_active_time,
+                  SD_BUS_VTABLE_UNPRIVILEGED),
+    SD_BUS_SIGNAL("ActiveChanged", "b", 0),
+    SD_BUS_VTABLE_END
+};
+
+ScreenSaver *screensaver_open(const ScreenSaverHandler *handler)
+{
+    ScreenSaver *ss = calloc(1, sizeof(*ss));
+    if (!ss) {
+        perror("calloc");
+        return NULL;
+    }
+    ss->handler = *handler;
+
+    int r = sd_bus_open_user(&ss->bus);
+    if (r < 0) {
+        fprintf(stderr, "Session-Bus nicht erreichbar: %s\n", strerror(-r));
+        screensaver_close(ss);
+        return NULL;
+    }
+
+    const char *paths[2] = { SCREENSAVER_PATH, SCREENSAVER_PATH_KDE };
+    for (int i = 0; i < 2; i++) {
+        r = sd_bus_add_object_vtable(ss->bus, &ss->slots[i], paths[i],
+                                     SCREENSAVER_INTERFACE,
+                                     screensaver_vtable, ss);
+        if (r < 0) {
+            fprintf(stderr, "%s nicht anmeldbar: %s\n", paths[i],
+                    strerror(-r));
+            screensaver_close(ss);
+            return NULL;
+        }
+    }
+
+    /* Ohne Ersetzen: Der Bildschirmschoner der Sitzung behält den Namen */
+    r = sd_bus_request_name(ss->bus, SCREENSAVER_NAME, 0);
+    if (r < 0) {
+        fprintf(stderr, "%s nicht übernommen: %s\n", SCREENSAVER_NAME,
+                r == -EEXIST ? "bereits vergeben" : strerror(-r));
+        screensaver_close(ss);
+        return NULL;
+    }
+    return ss;
+}
+
+int screensaver_fd(const ScreenSaver *ss)
+{
+    return sd_bus_get_fd(ss->bus);
+}
+
+bool screensaver_dispatch(ScreenSaver *ss)
+{
+    int r;
+    while ((r = sd_bus_process(ss->bus, NULL)) > 0)
+        ;
+    if (r < 0 || sd_bus_flush(ss->bus) < 0) {
+        fprintf(stderr, "Verbindung zum Session-Bus verloren\n");
+        return false;
+    }
+    return true;
+}
+
+/* Auf beiden Pfaden, an denen die vtable hängt; KDE-Clients hören auf /ScreenSaver */
+void screensaver_changed(ScreenSaver *ss, bool active)
+{
+    const char *paths[2] = { SCREENSAVER_PATH, SCREENSAVER_PATH_KDE };
+    int on = active;
+    for (int i = 0; i < 2; i++)
+        sd_bus_emit_signal(ss->bus, paths[i], SCREENSAVER_INTERFACE,
+                           "ActiveChanged", "b", on);
+}
+
+void screensaver_close(ScreenSaver *ss)
+{
+    for (int i = 0; i < 2; i++)
+        sd_bus_slot_unref(ss->slots[i]);
+    if (ss->bus)
+        sd_bus_flush_close_unref(ss->bus);
+    free(ss);
+}
+
+#else /* !HAVE_DBUS */
+
+/* Ohne libsystemd gebaut: --dbus-screensaver meldet nur den Grund */
+ScreenSaver *screensaver_open(const ScreenSaverHandler *handler)
+{
+    (void)handler;
+    fprintf(stderr, "blkout ohne D-Bus gebaut (make DBUS=1)\n");
+    return NULL;
+}
+
+int screensaver_fd(const ScreenSaver *ss)
+{
+    (void)ss;
+    return -1;
+}
+
+bool screensaver_dispatch(ScreenSaver *ss)
+{
+    (void)ss;
+    return false;
+}
+
+void screensaver_changed(ScreenSaver *ss, bool active)
+{
+    (void)ss; (void)active;
+}
+
+void screensaver_close(ScreenSaver *ss)
+{
+    free(ss);
+}
+
+#endif
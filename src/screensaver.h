@@ -0,0 +1,57 @@
+/*
+ * screensaver.h — org.freedesktop.ScreenSaver auf dem Session-Bus
+ *
+ * Statt blkout bei jedem Leerlauf per Skript neu zu starten (fork, exec,
+ * Wayland-Verbindung, Globals binden), kann ein dauerhaft laufendes blkout
+ * den Namen org.freedesktop.ScreenSaver übernehmen. Desktop-Komponenten
+ * schwärzen dann mit einem einzigen Methodenaufruf:
+ *
+ *   SetActive(b) -> b     Overlay anzeigen bzw. entfernen
+ *   GetActive()  -> b     Ist das Overlay sichtbar?
+ *   GetActiveTime() -> u  Sekunden seit dem Anzeigen, 0 wenn nicht sichtbar
+ *   Signal ActiveChanged(b) bei jedem Wechsel
+ *
+ * unter /org/freedesktop/ScreenSaver und /ScreenSaver (ältere KDE-Clients).
+ * Die Verbindung ist ein einzelner fd, der als Quelle in der Hauptschleife
+ * hängt. Verfügbar nur mit "make DBUS=1" (sd-bus aus libsystemd); sonst
+ * meldet screensaver_open() lediglich den Grund.
+ */
+
+#ifndef BLKOUT_SCREENSAVER_H
+#define BLKOUT_SCREENSAVER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Rückrufe in blkout; data wird unverändert durchgereicht */
+typedef struct {
+    void    *data;
+    bool     (*get_active)(void *data);
+    bool     (*set_active)(void *data, bool active);
+    uint32_t (*get_active_time)(void *data);
+} ScreenSaverHandler;
+
+typedef struct ScreenSaver ScreenSaver;
+
+/*
+ * Mit dem Session-Bus verbinden, die Objekte anmelden und den Namen
+ * übernehmen. Gibt NULL zurück, wenn kein Bus erreichbar oder der Name
+ * schon vergeben ist (etwa an den Bildschirmschoner der Sitzung).
+ */
+ScreenSaver *screensaver_open(const ScreenSaverHandler *handler);
+
+/* fd für poll(); bereit zum Lesen heißt: screensaver_dispatch() aufrufen */
+int screensaver_fd(const ScreenSaver *ss);
+
+/*
+ * Eingegangene Methodenaufrufe ausführen und beantworten. Gibt false
+ * zurück, wenn die Verbindung zum Bus verloren ist.
+ */
+bool screensaver_dispatch(ScreenSaver *ss);
+
+/* ActiveChanged senden */
+void screensaver_changed(ScreenSaver *ss, bool active);
+
+void screensaver_close(ScreenSaver *ss);
+
+#endif
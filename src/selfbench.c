@@ -0,0 +1,144 @@
+/*
+ * selfbench.c — Messreihen der eingebauten Selbstmessung (--benchmark)
+ *
+ * Siehe selfbench.h. Die Zyklen selbst treibt main.c; hier werden nur
+ * Messwerte gesammelt, ausgewertet und ausgegeben.
+ */
+
+#define _GNU_SOURCE
+
+#include "selfbench.h"
+
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+static const char *const time_names[BENCH_COUNT] = {
+    [BENCH_CONFIGURE] = "Anzeigen→configure",
+    [BENCH_BUFFER]    = "Pufferaufbau",
+    [BENCH_PRESENT]   = "Commit→Scanout",
+};
+
+bool bench_series_init(BenchSeries *bs, int cycles)
+{
+    memset(bs, 0, sizeof(*bs));
+    for (int t = 0; t < BENCH_COUNT; t++) {
+        bs->samples[t] = calloc((size_t)cycles, sizeof(uint64_t));
+        if (!bs->samples[t]) {
+            bench_series_free(bs);
+            return false;
+        }
+    }
+    bs->capacity = cycles;
+    return true;
+}
+
+void bench_series_free(BenchSeries *bs)
+{
+    for (int t = 0; t < BENCH_COUNT; t++) {
+        free(bs->samples[t]);
+        bs->samples[t] = NULL;
+    }
+}
+
+void bench_series_reset(BenchSeries *bs)
+{
+    memset(bs->count, 0, sizeof(bs->count));
+    bs->cycles      = 0;
+    bs->failed      = 0;
+    bs->unpresented = 0;
+}
+
+void bench_series_add(BenchSeries *bs, BenchTime t, uint64_t ns)
+{
+    if (bs->count[t] < bs->capacity)
+        bs->samples[t][bs->count[t]++] = ns;
+}
+
+static int cmp_u64(const void *a, const void *b)
+{
+    uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+    return (x > y) - (x < y);
+}
+
+/* Wert am Rang p (0..1) einer sortierten Reihe, Nächster-Rang-Verfahren */
+static double rank_ms(const uint64_t *sorted, int n, double p)
+{
+    int k = (int)(p * (double)n + 0.999999);
+    if (k < 1)
+        k = 1;
+    if (k > n)
+        k = n;
+    return (double)sorted[k - 1] / 1e6;
+}
+
+void bench_series_print(const BenchSeries *bs, const char *output,
+                        const char *strategy, uint64_t shm_peak,
+                        long rss_peak_kb, FILE *out)
+{
+    fprintf(out, "Ausgabe %s, Strategie %s: %d Zyklen",
+            output, strategy, bs->cycles);
+    if (bs->failed)
+        fprintf(out, ", %d ohne configure", bs->failed);
+    if (bs->unpresented)
+        fprintf(out, ", %d ohne Scanout", bs->unpresented);
+    fputc('\n', out);
+
+    fprintf(out, "  %-22s %6s %10s %10s %10s\n",
+            "[ms]", "n", "Median", "p95", "max");
+    for (int t = 0; t < BENCH_COUNT; t++) {
+        int n = bs->count[t];
+        if (n == 0) {
+            fprintf(out, "  %-22s %6d %10s %10s %10s\n",
+                    time_names[t], 0, "-", "-", "-");
+            continue;
+        }
+        /* Die Reihe selbst bleibt unsortiert, sortiert wird eine Kopie */
+        uint64_t *sorted = malloc((size_t)n * sizeof(uint64_t));
+        if (!sorted)
+            continue;
+        memcpy(sorted, bs->samples[t], (size_t)n * sizeof(uint64_t));
+        qsort(sorted, (size_t)n, sizeof(uint64_t), cmp_u64);
+        fprintf(out, "  %-22s %6d %10.3f %10.3f %10.3f\n",
+                time_names[t], n, rank_ms(sorted, n, 0.50),
+                rank_ms(sorted, n, 0.95), (double)sorted[n - 1] / 1e6);
+        free(sorted);
+    }
+
+    fprintf(out, "  %-22s %10llu KiB\n", "Puffer-Spitze",
+            (unsigned long long)(shm_peak / 1024));
+    if (rss_peak_kb >= 0)
+        fprintf(out, "  %-22s %10ld KiB\n", "VmHWM", rss_peak_kb);
+    fflush(out);
+}
+
+void bench_reset_peak_rss(void)
+{
+    /* "5" setzt VmHWM auf den aktuellen Stand zurück (seit Linux 4.0) */
+    int fd = open("/proc/self/clear_refs", O_WRONLY | O_CLOEXEC);
+    if (fd < 0)
+        return;
+    if (write(fd, "5", 1) < 0) {
+        /* Ohne Rücksetzen gilt der Spitzenwert seit Programmstart */
+    }
+    close(fd);
+}
+
+long bench_peak_rss_kb(void)
+{
+    FILE *f = fopen("/proc/self/status", "re");
+    if (!f)
+        return -1;
+
+    char line[256];
+    long kb = -1;
+    while (fgets(line, sizeof(line), f)) {
+        if (strncmp(line, "VmHWM:", 6) == 0) {
+            kb = strtol(line + 6, NULL, 10);
+            break;
+        }
+    }
+    fclose(f);
+    return kb;
+}
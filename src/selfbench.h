@@ -0,0 +1,64 @@
+/*
+ * selfbench.h — Messreihen der eingebauten Selbstmessung (--benchmark)
+ *
+ * blkout --benchmark N zeigt und entfernt das Overlay N-mal gegen den
+ * laufenden Compositor und hält je Zyklus drei Zeiten fest:
+ *
+ *   configure    show_overlay() bis zum configure-Event (Roundtrip)
+ *   Puffer       Aufbau bzw. Wiederverwendung des schwarzen Puffers
+ *   Präsentation Commit des Puffers bis zum Scanout (wp_presentation)
+ *
+ * Eine Messreihe gehört zu einer Variante aus Ausgabe und Strategie und
+ * wird nach Ende der Zyklen als Tabelle mit Median, p95 und Maximum
+ * ausgegeben, zusammen mit dem Spitzenspeicher der Variante.
+ */
+
+#ifndef BLKOUT_SELFBENCH_H
+#define BLKOUT_SELFBENCH_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+typedef enum {
+    BENCH_CONFIGURE,     /* show_overlay() → configure */
+    BENCH_BUFFER,        /* Pufferaufbau */
+    BENCH_PRESENT,       /* Commit des Puffers → Scanout */
+    BENCH_COUNT
+} BenchTime;
+
+typedef struct {
+    uint64_t *samples[BENCH_COUNT];  /* Messwerte in Nanosekunden */
+    int       count[BENCH_COUNT];    /* Belegte Einträge je Zeit */
+    int       capacity;              /* Platz je Zeit (= Zyklen) */
+    int       cycles;                /* Gestartete Zyklen */
+    int       failed;                /* Zyklen ohne configure */
+    int       unpresented;           /* Erster Frame verworfen oder ungemeldet */
+} BenchSeries;
+
+/* Platz für cycles Zyklen anlegen. Gibt false bei Speichermangel zurück. */
+bool bench_series_init(BenchSeries *bs, int cycles);
+void bench_series_free(BenchSeries *bs);
+
+/* Messwerte und Zähler für die nächste Variante leeren */
+void bench_series_reset(BenchSeries *bs);
+
+/* Messwert eintragen */
+void bench_series_add(BenchSeries *bs, BenchTime t, uint64_t ns);
+
+/*
+ * Tabelle einer Variante ausgeben. shm_peak ist der höchste Stand der
+ * Shared-Memory-Puffer in Bytes, rss_peak_kb der Spitzenwert des
+ * residenten Speichers (VmHWM) in KiB, -1 = unbekannt.
+ */
+void bench_series_print(const BenchSeries *bs, const char *output,
+                        const char *strategy, uint64_t shm_peak,
+                        long rss_peak_kb, FILE *out);
+
+/* Spitzenwert des residenten Speichers zurücksetzen (best effort) */
+void bench_reset_peak_rss(void);
+
+/* VmHWM des eigenen Prozesses in KiB, -1 bei Fehler */
+long bench_peak_rss_kb(void);
+
+#endif
@@ -0,0 +1,161 @@
+/*
+ * stats.c — Wakeup-Zählung für blkout
+ *
+ * Siehe stats.h. Die Zähler werden ausschließlich von der Hauptschleife
+ * und den Listener-Callbacks fortgeschrieben; es gibt keinen eigenen
+ * Timer, die Zählung selbst verursacht also keine Wakeups.
+ */
+
+#include "stats.h"
+#include "clock.h"
+
+#include <string.h>
+
+/* Namen der Ereignistypen für die Ausgabe, Reihenfolge wie EventType */
+static const char *const event_names[EV_COUNT] = {
+    [EV_REGISTRY_GLOBAL]    = "wl_registry.global",
+    [EV_REGISTRY_REMOVE]    = "wl_registry.global_remove",
+    [EV_SEAT_CAPABILITIES]  = "wl_seat.capabilities",
+    [EV_SEAT_NAME]          = "wl_seat.name",
+    [EV_LAYER_CONFIGURE]    = "layer_surface.configure",
+    [EV_LAYER_CLOSED]       = "layer_surface.closed",
+    [EV_KEYBOARD_KEYMAP]    = "wl_keyboard.keymap",
+    [EV_KEYBOARD_ENTER]     = "wl_keyboard.enter",
+    [EV_KEYBOARD_LEAVE]     = "wl_keyboard.leave",
+    [EV_KEYBOARD_KEY]       = "wl_keyboard.key",
+    [EV_KEYBOARD_MODIFIERS] = "wl_keyboard.modifiers",
+    [EV_KEYBOARD_REPEAT]    = "wl_keyboard.repeat_info",
+    [EV_POINTER_ENTER]      = "wl_pointer.enter",
+    [EV_POINTER_LEAVE]      = "wl_pointer.leave",
+    [EV_POINTER_MOTION]     = "wl_pointer.motion",
+    [EV_POINTER_BUTTON]     = "wl_pointer.button",
+    [EV_POINTER_AXIS]       = "wl_pointer.axis",
+    [EV_POINTER_FRAME]      = "wl_pointer.frame",
+    [EV_POINTER_AXIS_OTHER] = "wl_pointer.axis_*",
+    [EV_IDLE_IDLED]         = "idle_notification.idled",
+    [EV_IDLE_RESUMED]       = "idle_notification.resumed",
+    [EV_GAMMA_SIZE]         = "gamma_control.gamma_size",
+    [EV_GAMMA_FAILED]       = "gamma_control.failed",
+    [EV_OUTPUT_NAME]        = "wl_output.name",
+    [EV_OUTPUT_OTHER]       = "wl_output.*",
+};
+
+static const char *const cause_names[WAKE_COUNT] = {
+    [WAKE_WAYLAND]  = "Wayland",
+    [WAKE_TIMER]    = "Timer",
+    [WAKE_SIGNAL]   = "Signal",
+    [WAKE_IPC]      = "IPC",
+    [WAKE_CONFIG]   = "Konfiguration",
+    [WAKE_EVDEV]    = "Eingabegeräte",
+    [WAKE_PRESSURE] = "Speicherdruck",
+    [WAKE_FILL]     = "Vorab-Füllung",
+};
+
+void stats_init(Stats *st)
+{
+    memset(st, 0, sizeof(*st));
+    st->start_ns       = monotonic_ns();
+    st->phase_start_ns = st->start_ns;
+    st->phase          = PHASE_ARMED;
+}
+
+void stats_set_phase(Stats *st, Phase phase)
+{
+    if (phase == st->phase)
+        return;
+
+    uint64_t now = monotonic_ns();
+    st->phase_ns[st->phase] += now - st->phase_start_ns;
+    st->phase_start_ns       = now;
+    st->phase                = phase;
+}
+
+void stats_wakeup(Stats *st, Phase phase, unsigned causes_mask,
+                  uint64_t events_before)
+{
+    st->wakeups[phase]++;
+    for (int c = 0; c < WAKE_COUNT; c++)
+        if (causes_mask & (1u << c))
+            st->causes[phase][c]++;
+
+    /*
+     * Wakeup ohne ausgewertetes Ereignis: z.B. nur wl_buffer.release oder
+     * wl_display.delete_id, für die blkout keinen Listener hat.
+     */
+    if (causes_mask == (1u << WAKE_WAYLAND) && st->events_total == events_before)
+        st->empty[phase]++;
+}
+
+void stats_presented(Stats *st, uint64_t trigger_ns, uint64_t idle_ns,
+                     uint32_t refresh_ns, uint32_t flags)
+{
+    st->presented++;
+    st->trigger_scanout_sum += trigger_ns;
+    if (trigger_ns > st->trigger_scanout_max)
+        st->trigger_scanout_max = trigger_ns;
+    if (idle_ns) {
+        st->idle_scanout_count++;
+        st->idle_scanout_sum += idle_ns;
+        if (idle_ns > st->idle_scanout_max)
+            st->idle_scanout_max = idle_ns;
+    }
+    st->last_refresh_ns = refresh_ns;
+    st->last_flags      = flags;
+}
+
+void stats_print(const Stats *st, FILE *out)
+{
+    /* Laufende Phase bis jetzt mitzählen, ohne den Zustand zu ändern */
+    uint64_t now = monotonic_ns();
+    uint64_t phase_ns[PHASE_COUNT];
+    memcpy(phase_ns, st->phase_ns, sizeof(phase_ns));
+    phase_ns[st->phase] += now - st->phase_start_ns;
+
+    fprintf(out, "blkout-Statistik (Laufzeit %.1f s)\n",
+            (double)(now - st->start_ns) / 1e9);
+    fprintf(out, "  %-30s %12s %12s\n", "", "scharf", "schwarz");
+    fprintf(out, "  %-30s %12.1f %12.1f\n", "Zeit [s]",
+            (double)phase_ns[PHASE_ARMED] / 1e9,
+            (double)phase_ns[PHASE_BLANKED] / 1e9);
+    fprintf(out, "  %-30s %12llu %12llu\n", "Wakeups",
+            (unsigned long long)st->wakeups[PHASE_ARMED],
+            (unsigned long long)st->wakeups[PHASE_BLANKED]);
+    for (int c = 0; c < WAKE_COUNT; c++)
+        fprintf(out, "    %-28s %12llu %12llu\n", cause_names[c],
+                (unsigned long long)st->causes[PHASE_ARMED][c],
+                (unsigned long long)st->causes[PHASE_BLANKED][c]);
+    fprintf(out, "    %-28s %12llu %12llu\n", "davon ohne Ereignis",
+            (unsigned long long)st->empty[PHASE_ARMED],
+            (unsigned long long)st->empty[PHASE_BLANKED]);
+
+    fprintf(out, "  %-30s\n", "Ereignisse");
+    for (int e = 0; e < EV_COUNT; e++) {
+        /* Nur Ereignisse ausgeben, die überhaupt aufgetreten sind */
+        if (!st->events[PHASE_ARMED][e] && !st->events[PHASE_BLANKED][e])
+            continue;
+        fprintf(out, "    %-28s %12llu %12llu\n", event_names[e],
+                (unsigned long long)st->events[PHASE_ARMED][e],
+                (unsigned long long)st->events[PHASE_BLANKED][e]);
+    }
+
+    /* Präsentation des ersten schwarzen Frames (nur mit wp_presentation) */
+    if (st->presented || st->discarded) {
+        fprintf(out, "  %-30s %12llu\n", "Präsentiert",
+                (unsigned long long)st->presented);
+        fprintf(out, "  %-30s %12llu\n", "Verworfen",
+                (unsigned long long)st->discarded);
+    }
+    if (st->presented) {
+        fprintf(out, "  %-30s %12.2f %12.2f\n", "Auslöser→Scanout ø/max [ms]",
+                (double)st->trigger_scanout_sum / (double)st->presented / 1e6,
+                (double)st->trigger_scanout_max / 1e6);
+        if (st->idle_scanout_count)
+            fprintf(out, "  %-30s %12.2f %12.2f\n", "idled→Scanout ø/max [ms]",
+                    (double)st->idle_scanout_sum /
+                        (double)st->idle_scanout_count / 1e6,
+                    (double)st->idle_scanout_max / 1e6);
+        fprintf(out, "  %-30s %12.2f %12s0x%x\n", "Refresh [ms] / Flags",
+                (double)st->last_refresh_ns / 1e6, "", st->last_flags);
+    }
+    fflush(out);
+}
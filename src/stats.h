@@ -0,0 +1,120 @@
+/*
+ * stats.h — Wakeup-Zählung für blkout
+ *
+ * Zählt jede Rückkehr aus dem poll() der Hauptschleife mit ihrer Ursache
+ * sowie jedes ausgewertete Wayland-Ereignis, getrennt nach Programmphase:
+ * "scharf" (Overlay nicht sichtbar, Idle-Notification gespannt) und
+ * "schwarz" (Overlay sichtbar). Damit lässt sich belegen, dass blkout
+ * zwischen zwei Eingabeereignissen keine CPU-Wakeups verursacht.
+ */
+
+#ifndef BLKOUT_STATS_H
+#define BLKOUT_STATS_H
+
+#include <stdint.h>
+#include <stdio.h>
+
+/* Programmphase, in der ein Wakeup oder Ereignis gezählt wird */
+typedef enum {
+    PHASE_ARMED,     /* Overlay nicht sichtbar, warten auf Inaktivität */
+    PHASE_BLANKED,   /* Overlay sichtbar */
+    PHASE_COUNT
+} Phase;
+
+/* Ursache einer Rückkehr aus poll() */
+typedef enum {
+    WAKE_WAYLAND,    /* Daten auf der Wayland-Verbindung */
+    WAKE_TIMER,      /* timerfd abgelaufen */
+    WAKE_SIGNAL,     /* Signal über signalfd */
+    WAKE_IPC,        /* Steuer- oder Metrik-Socket */
+    WAKE_CONFIG,     /* Konfigurationsdatei geändert (inotify) */
+    WAKE_EVDEV,      /* Eingabegerät oder Frist (--idle-backend evdev) */
+    WAKE_PRESSURE,   /* PSI-Trigger: Speicherdruck */
+    WAKE_FILL,       /* Vorab-Füllung fertig oder fällig (--color) */
+    WAKE_COUNT
+} WakeCause;
+
+/* Ausgewertete Wayland-Ereignisse, nach Listener-Callback */
+typedef enum {
+    EV_REGISTRY_GLOBAL,
+    EV_REGISTRY_REMOVE,
+    EV_SEAT_CAPABILITIES,
+    EV_SEAT_NAME,
+    EV_LAYER_CONFIGURE,
+    EV_LAYER_CLOSED,
+    EV_KEYBOARD_KEYMAP,
+    EV_KEYBOARD_ENTER,
+    EV_KEYBOARD_LEAVE,
+    EV_KEYBOARD_KEY,
+    EV_KEYBOARD_MODIFIERS,
+    EV_KEYBOARD_REPEAT,
+    EV_POINTER_ENTER,
+    EV_POINTER_LEAVE,
+    EV_POINTER_MOTION,
+    EV_POINTER_BUTTON,
+    EV_POINTER_AXIS,
+    EV_POINTER_FRAME,
+    EV_POINTER_AXIS_OTHER,
+    EV_IDLE_IDLED,
+    EV_IDLE_RESUMED,
+    EV_GAMMA_SIZE,
+    EV_GAMMA_FAILED,
+    EV_OUTPUT_NAME,
+    EV_OUTPUT_OTHER,
+    EV_COUNT
+} EventType;
+
+typedef struct {
+    Phase    phase;                            /* Aktuelle Phase */
+    uint64_t phase_start_ns;                   /* Beginn der aktuellen Phase */
+    uint64_t start_ns;                         /* Programmstart */
+    uint64_t phase_ns[PHASE_COUNT];            /* Verweildauer je Phase */
+    uint64_t wakeups[PHASE_COUNT];             /* Rückkehrer aus poll() */
+    uint64_t causes[PHASE_COUNT][WAKE_COUNT];  /* Davon je Ursache */
+    uint64_t empty[PHASE_COUNT];               /* Wakeups ohne Ereignis */
+    uint64_t events[PHASE_COUNT][EV_COUNT];    /* Ausgewertete Ereignisse */
+    uint64_t events_total;                     /* Summe aller Ereignisse */
+
+    /* --- Präsentation des ersten schwarzen Frames (wp_presentation) --- */
+    uint64_t presented;              /* Gemeldete Präsentationen */
+    uint64_t discarded;              /* Verworfene erste Frames */
+    uint64_t trigger_scanout_sum;    /* Summe Auslöser → Scanout [ns] */
+    uint64_t trigger_scanout_max;
+    uint64_t idle_scanout_count;     /* Präsentationen mit idled-Zeitpunkt */
+    uint64_t idle_scanout_sum;       /* Summe idled → Scanout [ns] */
+    uint64_t idle_scanout_max;
+    uint32_t last_refresh_ns;        /* Refresh-Intervall der letzten Meldung */
+    uint32_t last_flags;             /* wp_presentation_feedback.kind-Bits */
+} Stats;
+
+/* Zähler zurücksetzen und Startzeit festhalten */
+void stats_init(Stats *st);
+
+/* Phasenwechsel: Verweildauer der bisherigen Phase aufaddieren */
+void stats_set_phase(Stats *st, Phase phase);
+
+/* Ein Wayland-Ereignis zählen (am Anfang jedes Listener-Callbacks) */
+static inline void stats_event(Stats *st, EventType ev)
+{
+    st->events[st->phase][ev]++;
+    st->events_total++;
+}
+
+/*
+ * Eine Rückkehr aus poll() zählen. phase ist die Phase, in der geschlafen
+ * wurde; events_before der Stand von events_total vor dem Dispatch.
+ */
+void stats_wakeup(Stats *st, Phase phase, unsigned causes_mask,
+                  uint64_t events_before);
+
+/*
+ * Präsentation des ersten schwarzen Frames festhalten. Latenzen in ns;
+ * idle_ns = 0, wenn das Overlay nicht durch idled ausgelöst wurde.
+ */
+void stats_presented(Stats *st, uint64_t trigger_ns, uint64_t idle_ns,
+                     uint32_t refresh_ns, uint32_t flags);
+
+/* Zählerstände als Tabelle ausgeben */
+void stats_print(const Stats *st, FILE *out);
+
+#endif
@@ -0,0 +1,145 @@
+/*
+ * trace.c — Trace-Ausgabe im Chrome-Trace-Event-Format
+ *
+ * Siehe trace.h. Die Ereignisse werden über einen großen stdio-Puffer
+ * geschrieben, damit das Tracing selbst möglichst wenige Systemaufrufe
+ * auf dem gemessenen Pfad verursacht.
+ */
+
+#define _GNU_SOURCE
+
+#include "trace.h"
+
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+/* Puffergröße der Trace-Datei */
+#define TRACE_BUFFER_SIZE (256 * 1024)
+
+FILE *trace_file;
+
+static char *trace_buffer;   /* stdio-Puffer der Trace-Datei */
+static int   trace_pid;      /* Prozess-ID für das "pid"-Feld */
+
+/* Zeitstempel einer Uhr in Mikrosekunden */
+static double clock_us(clockid_t clk)
+{
+    struct timespec ts;
+    clock_gettime(clk, &ts);
+    return (double)ts.tv_sec * 1e6 + (double)ts.tv_nsec / 1e3;
+}
+
+bool trace_open(const char *path)
+{
+    trace_file = fopen(path, "we");
+    if (!trace_file) {
+        perror(path);
+        return false;
+    }
+
+    trace_buffer = malloc(TRACE_BUFFER_SIZE);
+    if (trace_buffer)
+        setvbuf(trace_file, trace_buffer, _IOFBF, TRACE_BUFFER_SIZE);
+
+    trace_pid = (int)getpid();
+
+    /*
+     * Array öffnen und Prozess benennen (Metadaten-Ereignis). Alle weiteren
+     * Ereignisse werden mit vorangestelltem Komma angehängt.
+     */
+    fputs("[\n", trace_file);
+    fprintf(trace_file,
+            "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":%d,"
+            "\"args\":{\"name\":\"blkout\"}}",
+            trace_pid, trace_pid);
+    return true;
+}
+
+void trace_close(void)
+{
+    if (!trace_file)
+        return;
+
+    fputs("\n]\n", trace_file);
+    fclose(trace_file);
+    trace_file = NULL;
+    free(trace_buffer);
+    trace_buffer = NULL;
+}
+
+/* Gemeinsamer Teil von trace_write() und trace_write_at(); tts < 0 = ohne */
+static void write_event(char ph, const char *name, double ts, double tts,
+                        const char *args_fmt, va_list ap)
+{
+    fprintf(trace_file,
+            ",\n{\"name\":\"%s\",\"ph\":\"%c\",\"ts\":%.3f,"
+            "\"pid\":%d,\"tid\":%d",
+            name, ph, ts, trace_pid, trace_pid);
+    if (tts >= 0)
+        fprintf(trace_file, ",\"tts\":%.3f", tts);
+
+    /* Einzelereignisse gelten nur für den Thread ("s":"t") */
+    if (ph == 'i')
+        fputs(",\"s\":\"t\"", trace_file);
+
+    if (args_fmt) {
+        fputs(",\"args\":{", trace_file);
+        vfprintf(trace_file, args_fmt, ap);
+        fputc('}', trace_file);
+    }
+    fputc('}', trace_file);
+}
+
+void trace_write(char ph, const char *name, const char *args_fmt, ...)
+{
+    if (!trace_file)
+        return;
+
+    /* Zeit zuerst nehmen, damit die Formatierung nicht mitgemessen wird */
+    double ts  = clock_us(CLOCK_MONOTONIC);
+    double tts = clock_us(CLOCK_THREAD_CPUTIME_ID);
+
+    va_list ap;
+    va_start(ap, args_fmt);
+    write_event(ph, name, ts, tts, args_fmt, ap);
+    va_end(ap);
+}
+
+void trace_write_at(char ph, const char *name, uint64_t ts_ns,
+                    const char *args_fmt, ...)
+{
+    if (!trace_file)
+        return;
+
+    va_list ap;
+    va_start(ap, args_fmt);
+    write_event(ph, name, (double)ts_ns / 1e3, -1.0, args_fmt, ap);
+    va_end(ap);
+}
+
+const char *trace_escape(const char *s, char *buf, size_t size)
+{
+    size_t n = 0;
+    for (; *s; s++) {
+        unsigned char c = (unsigned char)*s;
+        char esc[7];
+        if (c == '"' || c == '\\')
+            snprintf(esc, sizeof(esc), "\\%c", c);
+        else if (c < 0x20)
+            snprintf(esc, sizeof(esc), "\\u%04x", c);
+        else
+            snprintf(esc, sizeof(esc), "%c", c);
+        size_t len = strlen(esc);
+        if (n + len >= size)
+            break;
+        memcpy(buf + n, esc, len);
+        n += len;
+    }
+    if (size > 0)
+        buf[n] = '\0';
+    return buf;
+}
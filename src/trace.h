@@ -0,0 +1,67 @@
+/*
+ * trace.h — Trace-Ausgabe im Chrome-Trace-Event-Format
+ *
+ * Mit --trace <datei> schreibt blkout Zeitspannen (B/E) und Einzelereignisse
+ * (i) als JSON-Array, das sich direkt in Perfetto oder chrome://tracing
+ * laden lässt. Jedes Ereignis trägt neben der monotonen Zeit (ts) auch die
+ * verbrauchte CPU-Zeit des Threads (tts), sodass Wartezeit und Rechenzeit
+ * zwischen "idled" und "schwarz" unterscheidbar werden.
+ *
+ * Ohne --trace sind alle Funktionen ein einzelner Zeigervergleich.
+ */
+
+#ifndef BLKOUT_TRACE_H
+#define BLKOUT_TRACE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+/* Geöffnete Trace-Datei, NULL = Tracing aus */
+extern FILE *trace_file;
+
+/* Trace-Datei anlegen und Kopf schreiben. Gibt false bei Fehler zurück. */
+bool trace_open(const char *path);
+
+/* Array abschließen und Datei schließen */
+void trace_close(void);
+
+/*
+ * Ein Ereignis schreiben. ph ist die Chrome-Phase ('B', 'E', 'i').
+ * args_fmt ist optional (NULL) und ergibt den Inhalt des JSON-Objekts
+ * "args", z.B. "\"width\":%d".
+ */
+void trace_write(char ph, const char *name, const char *args_fmt, ...)
+    __attribute__((format(printf, 3, 4)));
+
+/*
+ * Wie trace_write(), aber mit vorgegebenem Zeitstempel (CLOCK_MONOTONIC in
+ * Nanosekunden) und ohne CPU-Zeit — für Ereignisse, die der Compositor
+ * nachträglich meldet, z.B. den tatsächlichen Präsentationszeitpunkt.
+ */
+void trace_write_at(char ph, const char *name, uint64_t ts_ns,
+                    const char *args_fmt, ...)
+    __attribute__((format(printf, 4, 5)));
+
+/*
+ * s als Inhalt einer JSON-Zeichenkette nach buf schreiben: Anführungszeichen
+ * und Backslash maskiert, Steuerzeichen als \u00XX. Was nicht in size
+ * passt, entfällt. Gibt buf zurück, für "%s" in args_fmt.
+ */
+const char *trace_escape(const char *s, char *buf, size_t size);
+
+/* Zeitspanne beginnen/beenden (müssen paarweise im selben Thread liegen) */
+#define trace_begin(name) \
+    do { if (trace_file) trace_write('B', (name), NULL); } while (0)
+#define trace_begin_args(name, ...) \
+    do { if (trace_file) trace_write('B', (name), __VA_ARGS__); } while (0)
+#define trace_end(name) \
+    do { if (trace_file) trace_write('E', (name), NULL); } while (0)
+
+/* Einzelereignis ohne bzw. mit Argumenten */
+#define trace_instant(name) \
+    do { if (trace_file) trace_write('i', (name), NULL); } while (0)
+#define trace_instant_args(name, ...) \
+    do { if (trace_file) trace_write('i', (name), __VA_ARGS__); } while (0)
+
+#endif
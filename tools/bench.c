@@ -0,0 +1,626 @@
+/*
+ * bench.c — Leistungsmessung von blkout gegen den Mock-Compositor
+ *
+ * Aufruf:
+ *   bench [--cycles N] [--syscall-cycles N] [--out <datei>]
+ *         [--baseline <datei>] [--allow-missing-baseline]
+ *         [--threshold <prozent>] [--only <filter>]
+ *         -- BLKOUT [ARGUMENTE...]
+ *
+ * Für jede Kombination aus Ausgabe-Layout (1080p, 4K, 8K, mehrere
+ * Ausgaben) und Anzeigestrategie (--strategy full|small|persistent|cached)
+ * wird blkout gegen einen Mock-Compositor (mockcomp.c) gestartet und N-mal
+ * per idled schwarz geschaltet und per Tastendruck wieder geweckt.
+ * Gemessen werden:
+ *
+ *   show_ms   idled gesendet → Layer-Surface mit Puffer gemappt (p50/p99/max)
+ *   hide_ms   Taste gesendet → Layer-Surface ungemappt (p50/p99/max)
+ *   cpu_us    CPU-Zeit von blkout pro Zyklus (/proc/<pid>/schedstat)
+ *   shm       neu eingereichte Pufferbytes pro Zyklus
+ *   rss/hwm   VmRSS und VmHWM von blkout nach allen Zyklen
+ *   syscalls  Systemaufrufe von blkout pro Zyklus (eigener Lauf unter
+ *             ptrace, damit die Zeitmessung unbeeinflusst bleibt)
+ *   overlays  pro Zyklus gemappte Layer-Surfaces
+ *
+ * blkout legt ein einziges Overlay an, ohne Ausgabe; der Mock-Compositor
+ * setzt es wie sway auf die erste. Die Layouts mit mehreren Ausgaben
+ * messen also dieses eine Overlay, während weitere Ausgaben angesteckt
+ * sind; jede Zeile nennt dazu "outputs" und die gemessenen "overlays".
+ *
+ * Die Ergebnisse gehen als JSON-Array nach stdout bzw. --out. Mit
+ * --baseline wird jeder Wert gegen einen früheren Lauf verglichen; liegt er
+ * um mehr als --threshold Prozent (Standard 20) plus einer kleinen festen
+ * Toleranz darüber, wird die Regression gemeldet und mit Status 1 beendet.
+ * Die Vergleichsdatei liest nur Zeilen des von bench selbst geschriebenen
+ * Formats (ein Objekt pro Zeile); Zeilen mit "ok":false zählen nicht. Fehlt
+ * sie oder fehlt darin eine gemessene Zeile, endet bench mit Status 2,
+ * außer mit --allow-missing-baseline; make bench-baseline legt sie an.
+ */
+
+#define _GNU_SOURCE
+
+#include <signal.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/ptrace.h>
+#include <sys/wait.h>
+
+#include "mockcomp.h"
+#include "procstat.h"
+
+#define DEFAULT_CYCLES          200
+#define DEFAULT_SYSCALL_CYCLES  20
+#define DEFAULT_THRESHOLD_PCT   20.0
+#define WARMUP_CYCLES           3
+#define WAIT_TIMEOUT_MS         5000
+#define KEY_ESC                 1
+
+/* =========================================================================
+ * Messmatrix
+ * ========================================================================= */
+
+typedef struct {
+    const char *name;
+    int         count;
+    int         width[3];
+    int         height[3];
+} Layout;
+
+static const Layout layouts[] = {
+    { "1080p",      1, { 1920 },             { 1080 } },
+    { "4k",         1, { 3840 },             { 2160 } },
+    { "8k",         1, { 7680 },             { 4320 } },
+    { "2x1080p",    2, { 1920, 1920 },       { 1080, 1080 } },
+    { "1080p+4k",   2, { 1920, 3840 },       { 1080, 2160 } },
+    { "3x4k",       3, { 3840, 3840, 3840 }, { 2160, 2160, 2160 } },
+};
+
+static const char *const strategies[] = {
+    "full", "small", "persistent", "cached",
+};
+
+#define N_LAYOUTS    (sizeof(layouts) / sizeof(layouts[0]))
+#define N_STRATEGIES (sizeof(strategies) / sizeof(strategies[0]))
+
+/* Ergebnis einer Kombination */
+typedef struct {
+    char   name[64];
+    bool   ok;
+    int    cycles;
+    double show_p50, show_p99, show_max;   /* Millisekunden */
+    double hide_p50, hide_p99, hide_max;
+    double cpu_us;                         /* pro Zyklus */
+    double shm_bytes;                      /* pro Zyklus */
+    long   rss_kb, hwm_kb;
+    double syscalls;                       /* pro Zyklus */
+    bool   has_syscalls;                   /* syscalls gemessen */
+    int    outputs;                        /* Angesteckte Ausgaben */
+    int    overlays;                       /* Gemappte Surfaces pro Zyklus */
+} Result;
+
+/* Vergleichswerte: Schlüssel und feste Toleranz zusätzlich zum Prozentsatz */
+typedef struct {
+    const char *key;
+    size_t      offset;
+    double      slack;
+} Metric;
+
+static const Metric metrics[] = {
+    { "show_ms_p50",         offsetof(Result, show_p50),  0.05 },
+    { "show_ms_p99",         offsetof(Result, show_p99),  0.20 },
+    { "hide_ms_p50",         offsetof(Result, hide_p50),  0.05 },
+    { "hide_ms_p99",         offsetof(Result, hide_p99),  0.20 },
+    { "cpu_us_per_cycle",    offsetof(Result, cpu_us),    5.0  },
+    { "shm_bytes_per_cycle", offsetof(Result, shm_bytes), 0.0  },
+    { "syscalls_per_cycle",  offsetof(Result, syscalls),  1.0  },
+};
+
+#define N_METRICS (sizeof(metrics) / sizeof(metrics[0]))
+
+/* =========================================================================
+ * Hilfsfunktionen
+ * ========================================================================= */
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static int cmp_double(const void *a, const void *b)
+{
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+/* Perzentil (Nearest-Rank) eines sortierten Arrays */
+static double percentile(const double *v, int n, double q)
+{
+    if (n <= 0)
+        return 0.0;
+    int i = (int)(q * (n - 1) + 0.5);
+    return v[i];
+}
+
+/* =========================================================================
+ * Client starten, optional unter ptrace mit Systemaufrufzählung
+ * =========================================================================
+ * Für die Zählung läuft ein eigener Tracer-Prozess, der blkout als Kind
+ * startet und jeden Eintritt in einen Systemaufruf in einem gemeinsam
+ * genutzten Zähler vermerkt. So blockiert der Tracer in waitpid(), ohne die
+ * Ereignisschleife des Mock-Compositors aufzuhalten.
+ */
+
+typedef struct {
+    pid_t              pid;      /* blkout */
+    pid_t              waiter;   /* Direkter Kindprozess (blkout oder Tracer) */
+    volatile uint64_t *syscalls; /* Gemeinsamer Zähler, NULL = ohne Tracer */
+} Client;
+
+static void run_tracer(pid_t child, volatile uint64_t *counter)
+{
+    int status;
+    if (waitpid(child, &status, 0) != child || !WIFSTOPPED(status))
+        _exit(1);
+    ptrace(PTRACE_SETOPTIONS, child, NULL,
+           (void *)(long)(PTRACE_O_TRACESYSGOOD | PTRACE_O_EXITKILL));
+
+    bool in_syscall = false;
+    int sig = 0;
+    for (;;) {
+        if (ptrace(PTRACE_SYSCALL, child, NULL, (void *)(long)sig) < 0)
+            break;
+        if (waitpid(child, &status, 0) < 0)
+            break;
+        if (WIFEXITED(status) || WIFSIGNALED(status))
+            break;
+        sig = 0;
+        if (!WIFSTOPPED(status))
+            continue;
+        int stop = WSTOPSIG(status);
+        if (stop == (SIGTRAP | 0x80)) {
+            in_syscall = !in_syscall;
+            if (in_syscall)
+                (*counter)++;
+        } else if (stop != SIGTRAP && stop != SIGSTOP) {
+            /* Echte Signale (z.B. SIGTERM) an blkout weiterreichen */
+            sig = stop;
+        }
+    }
+    _exit(0);
+}
+
+static bool spawn_client(Client *c, char *const argv[], bool count_syscalls)
+{
+    c->syscalls = NULL;
+    if (count_syscalls) {
+        void *shm = mmap(NULL, sizeof(uint64_t), PROT_READ | PROT_WRITE,
+                         MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+        if (shm == MAP_FAILED) {
+            perror("mmap");
+            return false;
+        }
+        c->syscalls = shm;
+        *c->syscalls = 0;
+    }
+
+    /* Über diese Pipe meldet der Tracer die PID von blkout */
+    int pfd[2];
+    if (pipe(pfd) < 0) {
+        perror("pipe");
+        return false;
+    }
+
+    c->waiter = fork();
+    if (c->waiter < 0) {
+        perror("fork");
+        close(pfd[0]);
+        close(pfd[1]);
+        return false;
+    }
+    if (c->waiter == 0) {
+        close(pfd[0]);
+        pid_t pid = getpid();
+        if (count_syscalls) {
+            pid = fork();
+            if (pid == 0) {
+                close(pfd[1]);
+                ptrace(PTRACE_TRACEME, 0, NULL, NULL);
+                raise(SIGSTOP);
+                execvp(argv[0], argv);
+                _exit(127);
+            }
+            if (write(pfd[1], &pid, sizeof(pid)) != sizeof(pid))
+                _exit(1);
+            close(pfd[1]);
+            run_tracer(pid, c->syscalls);
+        }
+        if (write(pfd[1], &pid, sizeof(pid)) != sizeof(pid))
+            _exit(1);
+        close(pfd[1]);
+        execvp(argv[0], argv);
+        perror(argv[0]);
+        _exit(127);
+    }
+
+    close(pfd[1]);
+    bool ok = read(pfd[0], &c->pid, sizeof(c->pid)) == sizeof(c->pid);
+    close(pfd[0]);
+    return ok;
+}
+
+/* Client beenden; der Mock-Compositor verarbeitet dabei weiter Ereignisse */
+static void stop_client(Client *c, MockComp *mc)
+{
+    kill(c->pid, SIGTERM);
+    for (int ms = 0; ms < 2000; ms += 10) {
+        if (waitpid(c->waiter, NULL, WNOHANG) == c->waiter)
+            goto done;
+        mock_dispatch(mc, 10);
+    }
+    kill(c->pid, SIGKILL);
+    if (c->waiter != c->pid)
+        kill(c->waiter, SIGKILL);
+    waitpid(c->waiter, NULL, 0);
+done:
+    if (c->syscalls)
+        munmap((void *)c->syscalls, sizeof(uint64_t));
+}
+
+/* =========================================================================
+ * Ein Lauf: Mock-Compositor aufbauen, blkout starten, Zyklen messen
+ * ========================================================================= */
+
+static char **build_argv(char **base, int nbase, const char *strategy)
+{
+    char **argv = calloc((size_t)nbase + 5, sizeof(char *));
+    if (!argv)
+        return NULL;
+    int n = 0;
+    for (int i = 0; i < nbase; i++)
+        argv[n++] = base[i];
+    argv[n++] = "-s";
+    argv[n++] = "1";
+    argv[n++] = "--strategy";
+    argv[n++] = (char *)strategy;
+    argv[n] = NULL;
+    return argv;
+}
+
+/* Ein Zyklus: idled → gemappt, Taste → ungemappt. Zeiten in ms. */
+static bool cycle(MockComp *mc, double *show_ms, double *hide_ms)
+{
+    const MockStats *st = mock_stats(mc);
+
+    uint64_t t0 = now_ns();
+    mock_idle(mc);
+    if (!mock_wait_mapped(mc, true, WAIT_TIMEOUT_MS))
+        return false;
+    *show_ms = (double)(st->last_map_ns - t0) / 1e6;
+
+    uint64_t t1 = now_ns();
+    mock_key(mc, KEY_ESC);
+    if (!mock_wait_mapped(mc, false, WAIT_TIMEOUT_MS))
+        return false;
+    *hide_ms = (double)(st->last_unmap_ns - t1) / 1e6;
+    return true;
+}
+
+static MockComp *setup_compositor(const Layout *l)
+{
+    MockComp *mc = mock_create();
+    if (!mc)
+        return NULL;
+    /* Pixelprüfung würde bei 8K die Show-Latenz des Compositors verfälschen */
+    mock_set_pixel_check(mc, false);
+    for (int i = 0; i < l->count; i++)
+        mock_add_output(mc, l->width[i], l->height[i]);
+    setenv("WAYLAND_DISPLAY", mock_socket(mc), 1);
+    return mc;
+}
+
+static void measure(Result *r, const Layout *l, char **argv, int cycles)
+{
+    MockComp *mc = setup_compositor(l);
+    if (!mc)
+        return;
+
+    Client c;
+    if (!spawn_client(&c, argv, false)) {
+        mock_destroy(mc);
+        return;
+    }
+
+    double *show = calloc((size_t)cycles, sizeof(double));
+    double *hide = calloc((size_t)cycles, sizeof(double));
+    const MockStats *st = mock_stats(mc);
+    double s, h;
+    bool ok = show && hide;
+
+    for (int i = 0; ok && i < WARMUP_CYCLES; i++)
+        ok = cycle(mc, &s, &h);
+
+    uint64_t cpu0   = proc_cpu_ns(c.pid);
+    uint64_t bytes0 = st->buffer_bytes;
+    uint64_t maps0  = st->maps;
+    int done = 0;
+    for (; ok && done < cycles; done++)
+        ok = cycle(mc, &show[done], &hide[done]);
+
+    if (ok) {
+        uint64_t cpu1 = proc_cpu_ns(c.pid);
+        r->ok = true;
+        r->cycles = done;
+        r->cpu_us = (double)(cpu1 - cpu0) / 1e3 / done;
+        r->shm_bytes = (double)(st->buffer_bytes - bytes0) / done;
+        r->overlays = (int)((st->maps - maps0 + (uint64_t)done / 2) /
+                            (uint64_t)done);
+        r->rss_kb = proc_status_kb(c.pid, "VmRSS:");
+        r->hwm_kb = proc_status_kb(c.pid, "VmHWM:");
+
+        qsort(show, (size_t)done, sizeof(double), cmp_double);
+        qsort(hide, (size_t)done, sizeof(double), cmp_double);
+        r->show_p50 = percentile(show, done, 0.50);
+        r->show_p99 = percentile(show, done, 0.99);
+        r->show_max = show[done - 1];
+        r->hide_p50 = percentile(hide, done, 0.50);
+        r->hide_p99 = percentile(hide, done, 0.99);
+        r->hide_max = hide[done - 1];
+    } else {
+        fprintf(stderr, "%s: Zeitüberschreitung in Zyklus %d\n", r->name, done);
+    }
+
+    free(show);
+    free(hide);
+    stop_client(&c, mc);
+    mock_destroy(mc);
+}
+
+/* Eigener Lauf unter ptrace: nur die Systemaufrufe pro Zyklus */
+static void measure_syscalls(Result *r, const Layout *l, char **argv,
+                             int cycles)
+{
+    MockComp *mc = setup_compositor(l);
+    if (!mc)
+        return;
+
+    Client c;
+    if (!spawn_client(&c, argv, true)) {
+        mock_destroy(mc);
+        return;
+    }
+
+    double s, h;
+    bool ok = true;
+    for (int i = 0; ok && i < WARMUP_CYCLES; i++)
+        ok = cycle(mc, &s, &h);
+    uint64_t n0 = *c.syscalls;
+    for (int i = 0; ok && i < cycles; i++)
+        ok = cycle(mc, &s, &h);
+    if (ok) {
+        r->syscalls = (double)(*c.syscalls - n0) / cycles;
+        r->has_syscalls = true;
+    }
+
+    stop_client(&c, mc);
+    mock_destroy(mc);
+}
+
+/* =========================================================================
+ * Ausgabe und Vergleich
+ * ========================================================================= */
+
+/* syscalls_per_cycle fehlt, wenn nicht gemessen (--syscall-cycles 0) */
+static void print_result(FILE *f, const Result *r, bool last)
+{
+    fprintf(f, "  {\"name\":\"%s\",\"ok\":%s,\"cycles\":%d,"
+               "\"show_ms_p50\":%.4f,\"show_ms_p99\":%.4f,\"show_ms_max\":%.4f,"
+               "\"hide_ms_p50\":%.4f,\"hide_ms_p99\":%.4f,\"hide_ms_max\":%.4f,"
+               "\"cpu_us_per_cycle\":%.2f,\"shm_bytes_per_cycle\":%.0f,"
+               "\"rss_kb\":%ld,\"hwm_kb\":%ld,",
+            r->name, r->ok ? "true" : "false", r->cycles,
+            r->show_p50, r->show_p99, r->show_max,
+            r->hide_p50, r->hide_p99, r->hide_max,
+            r->cpu_us, r->shm_bytes, r->rss_kb, r->hwm_kb);
+    if (r->has_syscalls)
+        fprintf(f, "\"syscalls_per_cycle\":%.2f,", r->syscalls);
+    fprintf(f, "\"outputs\":%d,\"overlays\":%d}%s\n",
+            r->outputs, r->overlays, last ? "" : ",");
+}
+
+/* Zahl hinter "key": in einer Zeile; false, wenn nicht vorhanden */
+static bool json_number(const char *line, const char *key, double *out)
+{
+    char pat[64];
+    snprintf(pat, sizeof(pat), "\"%s\":", key);
+    const char *p = strstr(line, pat);
+    if (!p)
+        return false;
+    char *end;
+    *out = strtod(p + strlen(pat), &end);
+    return end != p + strlen(pat);
+}
+
+/*
+ * Ergebnisse mit der Vergleichsdatei abgleichen. Gibt die Zahl der
+ * Regressionen zurück und in *missing die Zahl der gemessenen Zeilen, zu
+ * denen die Datei keine erfolgreiche Zeile hat (alle, wenn sie fehlt).
+ */
+static int compare_baseline(const char *path, const Result *res, int n,
+                            double threshold, int *missing)
+{
+    *missing = 0;
+    FILE *f = fopen(path, "r");
+    if (!f) {
+        fprintf(stderr, "Keine Vergleichsdatei %s\n", path);
+        for (int i = 0; i < n; i++)
+            if (res[i].ok)
+                (*missing)++;
+        return 0;
+    }
+
+    int regressions = 0;
+    bool compared[N_LAYOUTS * N_STRATEGIES] = { false };
+    char line[2048];
+    while (fgets(line, sizeof(line), f)) {
+        for (int i = 0; i < n; i++) {
+            char pat[80];
+            snprintf(pat, sizeof(pat), "\"name\":\"%s\"", res[i].name);
+            if (!res[i].ok || !strstr(line, pat) ||
+                !strstr(line, "\"ok\":true"))
+                continue;
+            compared[i] = true;
+            for (size_t m = 0; m < N_METRICS; m++) {
+                double base;
+                double cur = *(const double *)((const char *)&res[i] +
+                                               metrics[m].offset);
+                if (metrics[m].offset == offsetof(Result, syscalls) &&
+                    !res[i].has_syscalls)
+                    continue;
+                if (!json_number(line, metrics[m].key, &base))
+                    continue;
+                double limit = base * (1.0 + threshold / 100.0) +
+                               metrics[m].slack;
+                if (cur > limit) {
+                    fprintf(stderr, "REGRESSION %s %s: %.4f -> %.4f "
+                                    "(Grenze %.4f)\n",
+                            res[i].name, metrics[m].key, base, cur, limit);
+                    regressions++;
+                }
+            }
+        }
+    }
+    fclose(f);
+
+    for (int i = 0; i < n; i++) {
+        if (res[i].ok && !compared[i]) {
+            fprintf(stderr, "%s: fehlt in %s\n",
+                    res[i].name, path);
+            (*missing)++;
+        }
+    }
+    return regressions;
+}
+
+/* =========================================================================
+ * Hauptprogramm
+ * ========================================================================= */
+
+static void usage(const char *prog)
+{
+    fprintf(stderr, "Aufruf: %s [--cycles N] [--syscall-cycles N] "
+                    "[--out <datei>] [--baseline <datei>] "
+                    "[--allow-missing-baseline] [--threshold <prozent>] [--only <filter>] "
+                    "-- BLKOUT [ARGUMENTE...]\n", prog);
+}
+
+int main(int argc, char *argv[])
+{
+    int cycles = DEFAULT_CYCLES;
+    int syscall_cycles = DEFAULT_SYSCALL_CYCLES;
+    double threshold = DEFAULT_THRESHOLD_PCT;
+    const char *out_path = NULL;
+    const char *baseline = NULL;
+    bool allow_missing = false;
+    const char *only = NULL;
+    int i;
+
+    for (i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--") == 0) {
+            i++;
+            break;
+        } else if (strcmp(argv[i], "--cycles") == 0 && i + 1 < argc) {
+            cycles = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--syscall-cycles") == 0 && i + 1 < argc) {
+            syscall_cycles = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--out") == 0 && i + 1 < argc) {
+            out_path = argv[++i];
+        } else if (strcmp(argv[i], "--baseline") == 0 && i + 1 < argc) {
+            baseline = argv[++i];
+        } else if (strcmp(argv[i], "--allow-missing-baseline") == 0) {
+            allow_missing = true;
+        } else if (strcmp(argv[i], "--threshold") == 0 && i + 1 < argc) {
+            threshold = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--only") == 0 && i + 1 < argc) {
+            only = argv[++i];
+        } else {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+    if (i >= argc || cycles <= 0 || syscall_cycles < 0) {
+        usage(argv[0]);
+        return 2;
+    }
+    char **base = &argv[i];
+    int nbase = argc - i;
+
+    /* Ein beendeter Client darf den Benchmark nicht per SIGPIPE abbrechen */
+    signal(SIGPIPE, SIG_IGN);
+
+    Result res[N_LAYOUTS * N_STRATEGIES];
+    int n = 0;
+    for (size_t l = 0; l < N_LAYOUTS; l++) {
+        for (size_t s = 0; s < N_STRATEGIES; s++) {
+            Result *r = &res[n];
+            memset(r, 0, sizeof(*r));
+            r->outputs = layouts[l].count;
+            snprintf(r->name, sizeof(r->name), "%s/%s",
+                     layouts[l].name, strategies[s]);
+            if (only && !strstr(r->name, only))
+                continue;
+
+            char **cargv = build_argv(base, nbase, strategies[s]);
+            if (!cargv)
+                return 2;
+            fprintf(stderr, "%s ...\n", r->name);
+            measure(r, &layouts[l], cargv, cycles);
+            if (r->ok && syscall_cycles > 0)
+                measure_syscalls(r, &layouts[l], cargv, syscall_cycles);
+            if (r->ok && r->overlays < r->outputs)
+                fprintf(stderr, "%s: %d Ausgaben, gemessen %d Overlay(s)\n",
+                        r->name, r->outputs, r->overlays);
+            free(cargv);
+            n++;
+        }
+    }
+
+    FILE *out = stdout;
+    if (out_path && !(out = fopen(out_path, "w"))) {
+        perror(out_path);
+        return 2;
+    }
+    fprintf(out, "[\n");
+    for (int k = 0; k < n; k++)
+        print_result(out, &res[k], k == n - 1);
+    fprintf(out, "]\n");
+    if (out != stdout)
+        fclose(out);
+
+    int failed = 0;
+    for (int k = 0; k < n; k++)
+        if (!res[k].ok)
+            failed++;
+    int missing = 0;
+    int regressions = baseline ? compare_baseline(baseline, res, n, threshold,
+                                                  &missing)
+                               : 0;
+    if (missing && !allow_missing) {
+        fprintf(stderr, "%d Zeilen ohne Vergleich — Baseline mit "
+                        "make bench-baseline auf dem Referenzrechner anlegen "
+                        "oder --allow-missing-baseline\n", missing);
+        return 2;
+    }
+    if (failed || regressions) {
+        fprintf(stderr, "%d fehlgeschlagen, %d Regressionen\n",
+                failed, regressions);
+        return 1;
+    }
+    return 0;
+}
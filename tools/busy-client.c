@@ -0,0 +1,266 @@
+/*
+ * busy-client.c — Ständig neu zeichnender Client als Last für den Compositor
+ *
+ * Aufruf:
+ *   busy-client
+ *
+ * Legt eine vollflächige Layer-Surface auf der Ebene BOTTOM an (unter
+ * Fenstern und damit erst recht unter dem Overlay von blkout) und reicht in
+ * jedem Frame-Callback einen neu gefüllten Puffer mit voller Damage ein,
+ * wie ein Video oder eine Animation. So muss der Compositor bei jedem
+ * Refresh neu zeichnen, solange ihn nichts davon befreit — genau das misst
+ * comp-bench für die verschiedenen Anzeigestrategien von blkout.
+ *
+ * Läuft, bis die Verbindung endet oder SIGTERM eintrifft.
+ */
+
+#define _GNU_SOURCE
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+#include <wayland-client.h>
+#include "wlr-layer-shell-unstable-v1-client-protocol.h"
+
+#define NBUFFERS 2
+
+typedef struct {
+    struct wl_buffer *buffer;
+    uint32_t         *data;
+    size_t            size;
+    bool              busy;     /* Beim Compositor, noch nicht freigegeben */
+} Buffer;
+
+typedef struct {
+    struct wl_display            *display;
+    struct wl_compositor         *compositor;
+    struct wl_shm                *shm;
+    struct zwlr_layer_shell_v1   *layer_shell;
+    struct wl_surface            *surface;
+    struct zwlr_layer_surface_v1 *layer_surface;
+    Buffer                        buffers[NBUFFERS];
+    int                           width, height;
+    uint32_t                      frame;
+    bool                          running;
+} Client;
+
+static void draw(Client *c);
+
+/* =========================================================================
+ * Puffer
+ * ========================================================================= */
+
+static void buffer_release(void *data, struct wl_buffer *buffer)
+{
+    (void)buffer;
+    Buffer *b = data;
+    b->busy = false;
+}
+
+static const struct wl_buffer_listener buffer_listener = {
+    .release = buffer_release,
+};
+
+static void destroy_buffers(Client *c)
+{
+    for (int i = 0; i < NBUFFERS; i++) {
+        Buffer *b = &c->buffers[i];
+        if (b->buffer)
+            wl_buffer_destroy(b->buffer);
+        if (b->data)
+            munmap(b->data, b->size);
+        memset(b, 0, sizeof(*b));
+    }
+}
+
+static bool create_buffers(Client *c)
+{
+    destroy_buffers(c);
+    for (int i = 0; i < NBUFFERS; i++) {
+        Buffer *b = &c->buffers[i];
+        int stride = c->width * 4;
+        b->size = (size_t)stride * (size_t)c->height;
+
+        int fd = memfd_create("busy-client", MFD_CLOEXEC);
+        if (fd < 0 || ftruncate(fd, (off_t)b->size) < 0) {
+            perror("memfd");
+            if (fd >= 0)
+                close(fd);
+            return false;
+        }
+        b->data = mmap(NULL, b->size, PROT_READ | PROT_WRITE, MAP_SHARED,
+                       fd, 0);
+        if (b->data == MAP_FAILED) {
+            perror("mmap");
+            b->data = NULL;
+            close(fd);
+            return false;
+        }
+        struct wl_shm_pool *pool = wl_shm_create_pool(c->shm, fd,
+                                                      (int32_t)b->size);
+        b->buffer = wl_shm_pool_create_buffer(pool, 0, c->width, c->height,
+                                              stride, WL_SHM_FORMAT_XRGB8888);
+        wl_buffer_add_listener(b->buffer, &buffer_listener, b);
+        wl_shm_pool_destroy(pool);
+        close(fd);
+    }
+    return true;
+}
+
+/* =========================================================================
+ * Zeichnen im Takt der Frame-Callbacks
+ * ========================================================================= */
+
+static void frame_done(void *data, struct wl_callback *cb, uint32_t time)
+{
+    (void)time;
+    Client *c = data;
+    wl_callback_destroy(cb);
+    draw(c);
+}
+
+static const struct wl_callback_listener frame_listener = {
+    .done = frame_done,
+};
+
+static void draw(Client *c)
+{
+    Buffer *b = NULL;
+    for (int i = 0; i < NBUFFERS && !b; i++)
+        if (!c->buffers[i].busy)
+            b = &c->buffers[i];
+
+    struct wl_callback *cb = wl_surface_frame(c->surface);
+    wl_callback_add_listener(cb, &frame_listener, c);
+
+    /* Beide Puffer beim Compositor: nur auf den nächsten Frame warten */
+    if (!b) {
+        wl_surface_commit(c->surface);
+        return;
+    }
+
+    /* Laufender Farbverlauf, jede Zeile etwas versetzt */
+    c->frame++;
+    for (int y = 0; y < c->height; y++) {
+        uint32_t v = (c->frame * 4 + (uint32_t)y) & 0xff;
+        uint32_t px = (v << 16) | ((255 - v) << 8) | 0x40;
+        uint32_t *row = b->data + (size_t)y * (size_t)c->width;
+        for (int x = 0; x < c->width; x++)
+            row[x] = px;
+    }
+
+    wl_surface_attach(c->surface, b->buffer, 0, 0);
+    wl_surface_damage_buffer(c->surface, 0, 0, c->width, c->height);
+    wl_surface_commit(c->surface);
+    b->busy = true;
+}
+
+/* =========================================================================
+ * Layer-Surface
+ * ========================================================================= */
+
+static void layer_configure(void *data, struct zwlr_layer_surface_v1 *ls,
+                            uint32_t serial, uint32_t width, uint32_t height)
+{
+    Client *c = data;
+    zwlr_layer_surface_v1_ack_configure(ls, serial);
+
+    bool first = c->width == 0;
+    if ((int)width != c->width || (int)height != c->height) {
+        c->width = (int)width;
+        c->height = (int)height;
+        if (!create_buffers(c)) {
+            c->running = false;
+            return;
+        }
+    }
+    if (first)
+        draw(c);
+}
+
+static void layer_closed(void *data, struct zwlr_layer_surface_v1 *ls)
+{
+    (void)ls;
+    Client *c = data;
+    c->running = false;
+}
+
+static const struct zwlr_layer_surface_v1_listener layer_listener = {
+    .configure = layer_configure,
+    .closed    = layer_closed,
+};
+
+/* =========================================================================
+ * Registry
+ * ========================================================================= */
+
+static void registry_global(void *data, struct wl_registry *registry,
+                            uint32_t name, const char *interface,
+                            uint32_t version)
+{
+    Client *c = data;
+    if (strcmp(interface, wl_compositor_interface.name) == 0)
+        c->compositor = wl_registry_bind(registry, name,
+                                         &wl_compositor_interface,
+                                         version < 4 ? version : 4);
+    else if (strcmp(interface, wl_shm_interface.name) == 0)
+        c->shm = wl_registry_bind(registry, name, &wl_shm_interface, 1);
+    else if (strcmp(interface, zwlr_layer_shell_v1_interface.name) == 0)
+        c->layer_shell = wl_registry_bind(registry, name,
+                                          &zwlr_layer_shell_v1_interface, 1);
+}
+
+static void registry_global_remove(void *data, struct wl_registry *registry,
+                                   uint32_t name)
+{
+    (void)data; (void)registry; (void)name;
+}
+
+static const struct wl_registry_listener registry_listener = {
+    .global        = registry_global,
+    .global_remove = registry_global_remove,
+};
+
+int main(void)
+{
+    Client c = { .running = true };
+    c.display = wl_display_connect(NULL);
+    if (!c.display) {
+        fprintf(stderr, "Keine Verbindung zum Wayland-Display möglich\n");
+        return 2;
+    }
+    struct wl_registry *registry = wl_display_get_registry(c.display);
+    wl_registry_add_listener(registry, &registry_listener, &c);
+    wl_display_roundtrip(c.display);
+    if (!c.compositor || !c.shm || !c.layer_shell) {
+        fprintf(stderr, "wl_compositor, wl_shm oder zwlr_layer_shell_v1 "
+                        "fehlt\n");
+        return 2;
+    }
+
+    c.surface = wl_compositor_create_surface(c.compositor);
+    c.layer_surface = zwlr_layer_shell_v1_get_layer_surface(
+        c.layer_shell, c.surface, NULL, ZWLR_LAYER_SHELL_V1_LAYER_BOTTOM,
+        "busy-client");
+    zwlr_layer_surface_v1_add_listener(c.layer_surface, &layer_listener, &c);
+    zwlr_layer_surface_v1_set_anchor(c.layer_surface,
+        ZWLR_LAYER_SURFACE_V1_ANCHOR_TOP    |
+        ZWLR_LAYER_SURFACE_V1_ANCHOR_BOTTOM |
+        ZWLR_LAYER_SURFACE_V1_ANCHOR_LEFT   |
+        ZWLR_LAYER_SURFACE_V1_ANCHOR_RIGHT);
+    zwlr_layer_surface_v1_set_size(c.layer_surface, 0, 0);
+    wl_surface_commit(c.surface);
+
+    while (c.running && wl_display_dispatch(c.display) >= 0)
+        ;
+
+    destroy_buffers(&c);
+    zwlr_layer_surface_v1_destroy(c.layer_surface);
+    wl_surface_destroy(c.surface);
+    wl_display_disconnect(c.display);
+    return 0;
+}
@@ -0,0 +1,290 @@
+/*
+ * comp-bench.c — CPU-Last des Compositors, während blkout schwärzt
+ *
+ * Aufruf:
+ *   comp-bench [--window S] [--settle MS] [--compositor PID]
+ *              [--busy BEFEHL] [--out <datei>] -- BLKOUT [ARGUMENTE...]
+ *
+ * Läuft gegen einen echten Compositor, z.B. kopfloses sway
+ * (tools/sway-headless.sh, das SWAY_PID setzt). Zuerst wird ein ständig neu
+ * zeichnender Client gestartet (Standard tools/busy-client), dann blkout
+ * nacheinander in jeder Anzeigestrategie:
+ *
+ *   none          ohne blkout (Referenz)
+ *   shm           --strategy full
+ *   small         --strategy small
+ *   opaque        --strategy full --opaque-region
+ *   small-opaque  --strategy small --opaque-region
+ *   gamma         --strategy gamma
+ *
+ * blkout wird ohne -s gestartet und zeigt das Overlay sofort. Nach --settle
+ * Millisekunden (Standard 1000) wird über --window Sekunden (Standard 10)
+ * die CPU-Zeit von Compositor, Last-Client und blkout aus /proc gemessen
+ * und als Anteil einer CPU angegeben. Ausgabe: JSON-Array mit einer Zeile
+ * pro Strategie nach stdout bzw. --out, im selben Zeilenformat wie bench.
+ *
+ * Das kopflose wlroots-Backend unterstützt keine Gammatabellen; dort
+ * meldet der Compositor "failed" und blkout deckt die Ausgabe ersatzweise
+ * mit einer Layer-Surface ab. Die Zeile gamma misst dann nicht Gamma,
+ * sondern diesen Ersatz: comp-bench erkennt das an der Meldung von blkout
+ * auf stderr und gibt sie mit "ok":false und "gamma_failed":true aus.
+ * Aussagekräftig ist sie erst auf DRM-Ausgaben.
+ */
+
+#define _GNU_SOURCE
+
+#include <signal.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+#include "procstat.h"
+
+#define DEFAULT_WINDOW_S  10
+#define DEFAULT_SETTLE_MS 1000
+#define DEFAULT_BUSY      "tools/busy-client"
+#define MAX_EXTRA_ARGS    3
+#define GAMMA_FAILED_MSG  "Gamma-Steuerung fehlgeschlagen"
+
+typedef struct {
+    const char *name;
+    const char *args[MAX_EXTRA_ARGS + 1];   /* NULL-terminiert */
+    bool        run_blkout;
+} Mode;
+
+static const Mode modes[] = {
+    { "none",         { NULL },                                        false },
+    { "shm",          { "--strategy", "full", NULL },                  true  },
+    { "small",        { "--strategy", "small", NULL },                 true  },
+    { "opaque",       { "--strategy", "full", "--opaque-region" },     true  },
+    { "small-opaque", { "--strategy", "small", "--opaque-region" },    true  },
+    { "gamma",        { "--strategy", "gamma", NULL },                 true  },
+};
+#define NMODES (sizeof(modes) / sizeof(modes[0]))
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+/* Prozess starten; stderr geht nach err_fd, bei -1 bleibt es erhalten */
+static pid_t spawn(char *const argv[], int err_fd)
+{
+    pid_t pid = fork();
+    if (pid < 0) {
+        perror("fork");
+        return -1;
+    }
+    if (pid == 0) {
+        if (err_fd >= 0)
+            dup2(err_fd, STDERR_FILENO);
+        execvp(argv[0], argv);
+        perror(argv[0]);
+        _exit(127);
+    }
+    return pid;
+}
+
+/* Mit SIGTERM beenden, nach einer Sekunde mit SIGKILL */
+static void stop(pid_t pid)
+{
+    kill(pid, SIGTERM);
+    for (int ms = 0; ms < 1000; ms++) {
+        pid_t r = waitpid(pid, NULL, WNOHANG);
+        if (r == pid || r < 0)      /* beendet oder schon eingesammelt */
+            return;
+        usleep(1000);
+    }
+    kill(pid, SIGKILL);
+    waitpid(pid, NULL, 0);
+}
+
+static bool alive(pid_t pid)
+{
+    return waitpid(pid, NULL, WNOHANG) == 0;
+}
+
+/* CPU-Anteil in Prozent einer CPU über das Messfenster */
+static double cpu_pct(uint64_t before, uint64_t after, uint64_t wall_ns)
+{
+    if (after < before || wall_ns == 0)
+        return 0.0;
+    return 100.0 * (double)(after - before) / (double)wall_ns;
+}
+
+/*
+ * Mitgeschnittene Ausgabe von blkout weiterreichen; true, wenn darin die
+ * Meldung über eine fehlgeschlagene Gamma-Steuerung steht.
+ */
+static bool forward_log(FILE *log)
+{
+    bool failed = false;
+    char line[512];
+    rewind(log);
+    while (fgets(line, sizeof(line), log)) {
+        fputs(line, stderr);
+        if (strstr(line, GAMMA_FAILED_MSG))
+            failed = true;
+    }
+    return failed;
+}
+
+/*
+ * Eine Strategie messen. Gibt false zurück, wenn blkout oder der
+ * Last-Client vor Ende des Fensters beendet wurde oder der Compositor die
+ * Gamma-Steuerung abgelehnt hat.
+ */
+static bool measure(const Mode *m, char **cargv, int nbase, pid_t compositor,
+                    pid_t busy, int window_s, int settle_ms, FILE *out,
+                    bool last)
+{
+    pid_t pid = 0;
+    FILE *log = NULL;
+    if (m->run_blkout) {
+        int k = nbase;
+        for (int a = 0; a < MAX_EXTRA_ARGS && m->args[a]; a++)
+            cargv[k++] = (char *)m->args[a];
+        cargv[k] = NULL;
+        if (!(log = tmpfile())) {
+            perror("tmpfile");
+            return false;
+        }
+        pid = spawn(cargv, fileno(log));
+        if (pid < 0) {
+            fclose(log);
+            return false;
+        }
+    }
+    usleep((useconds_t)settle_ms * 1000);
+
+    uint64_t t0 = now_ns();
+    uint64_t comp0 = proc_cpu_ns(compositor);
+    uint64_t busy0 = proc_cpu_ns(busy);
+    uint64_t self0 = pid ? proc_cpu_ns(pid) : 0;
+    sleep((unsigned)window_s);
+    uint64_t comp1 = proc_cpu_ns(compositor);
+    uint64_t busy1 = proc_cpu_ns(busy);
+    uint64_t self1 = pid ? proc_cpu_ns(pid) : 0;
+    uint64_t wall = now_ns() - t0;
+
+    bool ok = alive(busy) && (!pid || alive(pid));
+    bool gamma_failed = false;
+    if (pid) {
+        stop(pid);
+        gamma_failed = forward_log(log);
+        fclose(log);
+    }
+    if (gamma_failed)
+        ok = false;
+
+    double comp = cpu_pct(comp0, comp1, wall);
+    double client = cpu_pct(busy0, busy1, wall);
+    double self = cpu_pct(self0, self1, wall);
+    fprintf(out, "{\"name\":\"blanked/%s\",\"ok\":%s,\"gamma_failed\":%s,"
+                 "\"window_s\":%.3f,"
+                 "\"compositor_cpu_pct\":%.2f,\"client_cpu_pct\":%.2f,"
+                 "\"blkout_cpu_pct\":%.2f,\"total_cpu_pct\":%.2f}%s\n",
+            m->name, ok ? "true" : "false", gamma_failed ? "true" : "false",
+            (double)wall / 1e9, comp, client, self, comp + client + self,
+            last ? "" : ",");
+    fflush(out);
+    fprintf(stderr, "%-13s Compositor %6.2f %%, Client %6.2f %%, "
+                    "blkout %6.2f %%%s\n", m->name, comp, client, self,
+            gamma_failed ? " (Gamma abgelehnt, Ersatz-Overlay gemessen)" : "");
+    return ok;
+}
+
+static void usage(const char *prog)
+{
+    fprintf(stderr, "Aufruf: %s [--window S] [--settle MS] "
+                    "[--compositor PID] [--busy BEFEHL] [--out <datei>] "
+                    "-- BLKOUT [ARGUMENTE...]\n", prog);
+}
+
+/* =========================================================================
+ * Hauptprogramm
+ * ========================================================================= */
+
+int main(int argc, char *argv[])
+{
+    int window_s = DEFAULT_WINDOW_S;
+    int settle_ms = DEFAULT_SETTLE_MS;
+    const char *busy_cmd = DEFAULT_BUSY;
+    const char *out_path = NULL;
+    const char *env = getenv("SWAY_PID");
+    pid_t compositor = env ? (pid_t)atoi(env) : 0;
+    int i;
+
+    for (i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--") == 0) {
+            i++;
+            break;
+        } else if (strcmp(argv[i], "--window") == 0 && i + 1 < argc) {
+            window_s = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--settle") == 0 && i + 1 < argc) {
+            settle_ms = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--compositor") == 0 && i + 1 < argc) {
+            compositor = (pid_t)atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--busy") == 0 && i + 1 < argc) {
+            busy_cmd = argv[++i];
+        } else if (strcmp(argv[i], "--out") == 0 && i + 1 < argc) {
+            out_path = argv[++i];
+        } else {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+    if (i >= argc || window_s <= 0 || settle_ms < 0) {
+        usage(argv[0]);
+        return 2;
+    }
+    if (compositor <= 0 || proc_cpu_ns(compositor) == 0) {
+        fprintf(stderr, "Compositor-Prozess unbekannt: --compositor PID "
+                        "oder SWAY_PID setzen\n");
+        return 2;
+    }
+
+    /* Platz für die Basis-Befehlszeile, die Zusatzargumente und NULL */
+    int nbase = argc - i;
+    char **cargv = calloc((size_t)nbase + MAX_EXTRA_ARGS + 1, sizeof(char *));
+    if (!cargv)
+        return 2;
+    for (int k = 0; k < nbase; k++)
+        cargv[k] = argv[i + k];
+
+    char *busy_argv[] = { (char *)busy_cmd, NULL };
+    pid_t busy = spawn(busy_argv, -1);
+    if (busy < 0)
+        return 2;
+
+    FILE *out = out_path ? fopen(out_path, "w") : stdout;
+    if (!out) {
+        perror(out_path);
+        stop(busy);
+        return 2;
+    }
+
+    int failed = 0;
+    fputs("[\n", out);
+    for (size_t m = 0; m < NMODES; m++)
+        if (!measure(&modes[m], cargv, nbase, compositor, busy, window_s,
+                     settle_ms, out, m + 1 == NMODES))
+            failed++;
+    fputs("]\n", out);
+    if (out != stdout)
+        fclose(out);
+
+    int status = failed ? 1 : 0;
+    if (failed)
+        fprintf(stderr, "%d Zeilen fehlgeschlagen (vorzeitig beendet oder "
+                        "Gamma abgelehnt)\n", failed);
+    stop(busy);
+    free(cargv);
+    return status;
+}
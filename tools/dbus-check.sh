@@ -0,0 +1,113 @@
+#!/bin/sh
+#
+# dbus-check.sh — org.freedesktop.ScreenSaver gegen einen privaten dbus-daemon prüfen
+#
+# Aufruf:
+#   tools/dbus-check.sh [BLKOUT [ARGUMENTE...]]
+#
+# Startet sich selbst unter dbus-run-session, also mit einem eigenen
+# Session-Bus, auf dem niemand sonst org.freedesktop.ScreenSaver hält.
+# blkout läuft mit --dbus-screensaver gegen den Mock-Compositor
+# (tools/mockcomp-run); BLKOUT muss mit make DBUS=1 gebaut sein. Geprüft
+# wird per dbus-send:
+#
+#   - ohne -s zeigt blkout nichts, bis SetActive(true) kommt
+#   - SetActive(true) mappt ein schwarzes Overlay, GetActive liefert true
+#   - GetActiveTime zählt Sekunden seit dem Anzeigen
+#   - SetActive(false) entfernt das Overlay, GetActive liefert false
+#   - ActiveChanged kommt bei beiden Wechseln auf /org/freedesktop/ScreenSaver
+#     und auf /ScreenSaver (KDE)
+#
+# Rückgabe: 0 wenn alles stimmt, sonst 1; 2 wenn dbus-run-session fehlt.
+
+set -u
+
+MOCK=${MOCK:-tools/mockcomp-run}
+
+if [ $# -eq 0 ]; then
+    set -- ./blkout
+fi
+
+# Einmal mit privatem Session-Bus neu starten
+if [ -z "${BLKOUT_DBUS_CHECK:-}" ]; then
+    if ! command -v dbus-run-session >/dev/null 2>&1; then
+        echo "dbus-run-session nicht gefunden" >&2
+        exit 2
+    fi
+    export BLKOUT_DBUS_CHECK=1
+    exec dbus-run-session -- "$0" "$@"
+fi
+
+TMP=$(mktemp -d)
+trap 'rm -rf "$TMP"' EXIT
+
+# Methode aufrufen, nur den Wert der Antwort ausgeben (z.B. "true", "3")
+call() {
+    method=$1
+    shift
+    dbus-send --session --print-reply=literal \
+        --dest=org.freedesktop.ScreenSaver /org/freedesktop/ScreenSaver \
+        "org.freedesktop.ScreenSaver.$method" "$@" 2>/dev/null |
+        awk '{ print $NF }'
+}
+
+FAIL=0
+expect() {
+    if [ "$2" = "$3" ]; then
+        echo "ok   $1"
+    else
+        echo "FEHL $1: erwartet $3, erhalten ${2:-nichts}"
+        FAIL=1
+    fi
+}
+
+# Mock-Compositor: wartet auf das Overlay und dann auf dessen Verschwinden
+cat > "$TMP/script" <<EOF
+output 1920x1080
+wait-map 10000
+expect-black
+wait-unmap 10000
+EOF
+"$MOCK" "$TMP/script" -- "$@" --dbus-screensaver > "$TMP/stats" &
+MOCK_PID=$!
+
+# Warten, bis blkout den Namen übernommen hat
+for i in $(seq 50); do
+    dbus-send --session --print-reply --dest=org.freedesktop.DBus \
+        /org/freedesktop/DBus org.freedesktop.DBus.GetNameOwner \
+        string:org.freedesktop.ScreenSaver >/dev/null 2>&1 && break
+    sleep 0.1
+done
+
+# Signale mitschneiden, mit Pfad je Zeile
+dbus-monitor --session \
+    "type='signal',interface='org.freedesktop.ScreenSaver',member='ActiveChanged'" \
+    > "$TMP/signals" 2>/dev/null &
+MONITOR_PID=$!
+sleep 0.2
+
+expect "GetActive vor SetActive"   "$(call GetActive)" false
+expect "SetActive(true)"           "$(call SetActive boolean:true)" true
+expect "GetActive nach SetActive"  "$(call GetActive)" true
+sleep 1.2
+TIME=$(call GetActiveTime)
+expect "GetActiveTime >= 1"        "$([ "${TIME:-0}" -ge 1 ] && echo ja)" ja
+expect "SetActive(false)"          "$(call SetActive boolean:false)" true
+expect "GetActive nach Entfernen"  "$(call GetActive)" false
+expect "GetActiveTime ohne Overlay" "$(call GetActiveTime)" 0
+
+sleep 0.2
+kill "$MONITOR_PID" 2>/dev/null
+wait "$MONITOR_PID" 2>/dev/null
+for path in /org/freedesktop/ScreenSaver /ScreenSaver; do
+    N=$(grep -c "path=$path; interface=org.freedesktop.ScreenSaver; member=ActiveChanged" \
+        "$TMP/signals")
+    expect "ActiveChanged auf $path" "$N" 2
+done
+
+if ! wait "$MOCK_PID"; then
+    echo "FEHL Mock-Compositor: Overlay nicht schwarz angezeigt und entfernt"
+    cat "$TMP/stats"
+    FAIL=1
+fi
+exit $FAIL
@@ -0,0 +1,86 @@
+#!/bin/sh
+#
+# e2e-sway.sh — blkout gegen ein kopfloses sway prüfen
+#
+# Aufruf:
+#   tools/e2e-sway.sh [BLKOUT [ARGUMENTE...]]
+#
+# Startet sich selbst unter tools/sway-headless.sh (sway mit
+# WLR_BACKENDS=headless und pixman-Renderer). Für jede Ausgabekonfiguration
+# und jede Strategie wird blkout sofort angezeigt (ohne -s) und mit
+# tools/screencopy-check per zwlr_screencopy_manager_v1 geprüft, ob der
+# Bildschirm tatsächlich schwarz wird. Vorher stellt eine Kopie sicher, dass
+# er es nicht schon ist. Ausgabe pro Lauf eine Zeile:
+#
+#   <ausgaben> <strategie> time_to_black_ms <ms>
+#
+# Die Zeit stammt aus dem Präsentationszeitstempel des Compositors.
+# blkout deckt bisher nur die vom Compositor gewählte Ausgabe ab; bei
+# mehreren Ausgaben muss daher genau eine schwarz werden.
+#
+# Umgebungsvariablen:
+#   E2E_LAYOUTS     Ausgabekonfigurationen (Standard "1920x1080
+#                   1920x1080,1920x1080 1920x1080,3840x2160")
+#   E2E_STRATEGIES  Strategien (Standard "full small persistent cached")
+#   E2E_TIMEOUT_MS  Höchstdauer bis schwarz (Standard 5000)
+#
+# Rückgabe: 0 wenn alle Läufe schwarz wurden, sonst 1; 2 wenn sway fehlt.
+
+set -u
+
+CHECK=${CHECK:-tools/screencopy-check}
+LAYOUTS=${E2E_LAYOUTS:-"1920x1080 1920x1080,1920x1080 1920x1080,3840x2160"}
+STRATEGIES=${E2E_STRATEGIES:-"full small persistent cached"}
+TIMEOUT_MS=${E2E_TIMEOUT_MS:-5000}
+
+if [ $# -eq 0 ]; then
+    set -- ./blkout
+fi
+
+# Einmal unter einem frischen kopflosen sway neu starten
+if [ -z "${BLKOUT_E2E_SWAY:-}" ]; then
+    export BLKOUT_E2E_SWAY=1
+    exec "$(dirname "$0")/sway-headless.sh" "$0" "$@"
+fi
+
+# Ausgaben anlegen bzw. abschalten, bis genau die gewünschten aktiv sind
+NEXT=1
+ACTIVE=
+set_layout() {
+    for name in $ACTIVE; do
+        swaymsg -q output "$name" disable
+    done
+    ACTIVE=
+    for mode in $(echo "$1" | tr ',' ' '); do
+        swaymsg -q create_output
+        name=HEADLESS-$NEXT
+        NEXT=$((NEXT + 1))
+        swaymsg -q output "$name" enable mode --custom "$mode"
+        ACTIVE="$ACTIVE $name"
+    done
+    sleep 0.2
+}
+
+status=0
+for layout in $LAYOUTS; do
+    set_layout "$layout"
+    for strategy in $STRATEGIES; do
+        if ! "$CHECK" --expect not-black; then
+            echo "$layout $strategy FEHLER: Bildschirm schon vorher schwarz" >&2
+            status=1
+            continue
+        fi
+        out=$("$CHECK" --min-black 1 --timeout "$TIMEOUT_MS" \
+              -- "$@" --strategy "$strategy")
+        if [ $? -ne 0 ]; then
+            echo "$layout $strategy FEHLER: nicht schwarz geworden" >&2
+            echo "$out" >&2
+            status=1
+            continue
+        fi
+        echo "$layout $strategy $(echo "$out" | grep '^time_to_black_ms')"
+        sleep 0.2
+    done
+done
+
+exit $status
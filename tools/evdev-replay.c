@@ -0,0 +1,316 @@
+/*
+ * evdev-replay.c — Aufgezeichnete evdev-Ströme für --idle-backend evdev abspielen
+ *
+ * Aufruf:
+ *   evdev-replay [--speed F] [--hold MS] [--split MS] VERZEICHNIS AUFNAHME...
+ *                [-- BLKOUT [ARGUMENTE...]]
+ *
+ * Eine Aufnahme ist der rohe Strom eines Eingabegeräts, z.B. mit
+ * "cat /dev/input/event3 > tastatur.evdev" mitgeschnitten: eine Folge von
+ * struct input_event. Für jede Aufnahme legt evdev-replay im VERZEICHNIS
+ * ein FIFO event0, event1, ... an, wartet, bis blkout es zum Lesen öffnet,
+ * und schreibt dann alle Ereignisse nach Zeitstempel gemischt mit ihren
+ * ursprünglichen Abständen (geteilt durch --speed, Standard 1; 0 = ohne
+ * Pausen). Die Zeitstempel werden dabei auf CLOCK_MONOTONIC umgeschrieben,
+ * wie blkout sie von echten Geräten per EVIOCSCLOCKID anfordert.
+ *
+ * Stehen hinter "--" Argumente, startet evdev-replay BLKOUT selbst und
+ * hängt "--idle-backend evdev --evdev-dir VERZEICHNIS" an; sonst muss
+ * blkout getrennt mit diesen Optionen gestartet werden. Nach dem letzten
+ * Ereignis bleiben die FIFOs noch --hold ms offen (Standard 0), damit
+ * blkout eine abschließende Ruhephase erkennen kann; danach wird
+ * geschlossen und ein gestartetes blkout mit SIGTERM beendet.
+ *
+ * --split MS schreibt jedes Ereignis in zwei Teilen mit MS ms Abstand, so
+ * dass blkout zwischendurch ein angefangenes Ereignis liest — ein echtes
+ * Gerät tut das nie, ein FIFO schon.
+ */
+
+#define _GNU_SOURCE
+
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <linux/input.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+
+#define MAX_STREAMS     16
+#define MAX_ARGS        64
+#define OPEN_TIMEOUT_MS 5000
+#define SLICE_MS        10
+
+/* Eine Aufnahme und ihr FIFO */
+typedef struct {
+    struct input_event *events;
+    size_t              count;
+    size_t              next;    /* Nächstes zu schreibendes Ereignis */
+    char                fifo[512];
+    int                 fd;
+} Stream;
+
+static pid_t child = -1;
+static bool  exited;
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static void sleep_until(uint64_t t_ns)
+{
+    struct timespec ts = {
+        .tv_sec  = (time_t)(t_ns / 1000000000ull),
+        .tv_nsec = (long)(t_ns % 1000000000ull),
+    };
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR)
+        ;
+}
+
+static uint64_t event_ns(const struct input_event *ev)
+{
+    return (uint64_t)ev->input_event_sec * 1000000000ull +
+           (uint64_t)ev->input_event_usec * 1000;
+}
+
+/* Ganze Aufnahme lesen; ein unvollständiges letztes Ereignis entfällt */
+static bool read_stream(const char *path, Stream *s)
+{
+    FILE *f = fopen(path, "rb");
+    if (!f) {
+        perror(path);
+        return false;
+    }
+    size_t cap = 0;
+    struct input_event ev;
+    while (fread(&ev, sizeof(ev), 1, f) == 1) {
+        if (s->count == cap) {
+            cap = cap ? cap * 2 : 256;
+            struct input_event *p = realloc(s->events, cap * sizeof(ev));
+            if (!p) {
+                perror("realloc");
+                fclose(f);
+                return false;
+            }
+            s->events = p;
+        }
+        s->events[s->count++] = ev;
+    }
+    fclose(f);
+    return true;
+}
+
+static bool child_exited(void)
+{
+    if (child > 0 && !exited && waitpid(child, NULL, WNOHANG) == child)
+        exited = true;
+    return exited;
+}
+
+/*
+ * FIFO zum Schreiben öffnen, sobald ein Leser da ist. Mit eigenem blkout
+ * höchstens OPEN_TIMEOUT_MS lang, sonst ohne Frist.
+ */
+static int open_fifo(const char *path)
+{
+    for (int ms = 0; child < 0 || ms < OPEN_TIMEOUT_MS; ms += SLICE_MS) {
+        int fd = open(path, O_WRONLY | O_NONBLOCK | O_CLOEXEC);
+        if (fd >= 0) {
+            /* Schreiben darf blockieren, falls blkout nicht nachkommt */
+            fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) & ~O_NONBLOCK);
+            return fd;
+        }
+        if (errno != ENXIO || child_exited()) {
+            perror(path);
+            return -1;
+        }
+        usleep(SLICE_MS * 1000);
+    }
+    fprintf(stderr, "%s: blkout öffnet das FIFO nicht "
+                    "(--idle-backend evdev?)\n", path);
+    return -1;
+}
+
+static void usage(const char *prog)
+{
+    fprintf(stderr, "Aufruf: %s [--speed F] [--hold MS] [--split MS] "
+                    "VERZEICHNIS AUFNAHME... [-- BLKOUT [ARGUMENTE...]]\n",
+            prog);
+}
+
+/* Ereignis schreiben, mit split_ms > 0 in zwei Teilen */
+static bool write_event(int fd, const struct input_event *ev, int split_ms)
+{
+    const char *p = (const char *)ev;
+    size_t first = split_ms > 0 ? sizeof(*ev) / 2 : sizeof(*ev);
+
+    if (write(fd, p, first) != (ssize_t)first)
+        return false;
+    if (first == sizeof(*ev))
+        return true;
+    sleep_until(now_ns() + (uint64_t)split_ms * 1000000ull);
+    return write(fd, p + first, sizeof(*ev) - first) ==
+           (ssize_t)(sizeof(*ev) - first);
+}
+
+/* =========================================================================
+ * Hauptprogramm
+ * ========================================================================= */
+
+int main(int argc, char *argv[])
+{
+    double      speed   = 1.0;
+    int         hold_ms = 0;
+    int         split_ms = 0;
+    const char *dir     = NULL;
+    const char *paths[MAX_STREAMS];
+    int         npaths  = 0;
+    int         i;
+
+    for (i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--") == 0) {
+            i++;
+            break;
+        } else if (strcmp(argv[i], "--speed") == 0 && i + 1 < argc) {
+            speed = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--hold") == 0 && i + 1 < argc) {
+            hold_ms = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--split") == 0 && i + 1 < argc) {
+            split_ms = atoi(argv[++i]);
+        } else if (argv[i][0] == '-') {
+            usage(argv[0]);
+            return 2;
+        } else if (!dir) {
+            dir = argv[i];
+        } else if (npaths < MAX_STREAMS) {
+            paths[npaths++] = argv[i];
+        } else {
+            fprintf(stderr, "Höchstens %d Aufnahmen\n", MAX_STREAMS);
+            return 2;
+        }
+    }
+    if (!dir || npaths == 0 || speed < 0 || hold_ms < 0 || split_ms < 0) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    /* Aufnahmen lesen und FIFOs anlegen */
+    Stream streams[MAX_STREAMS] = { 0 };
+    if (mkdir(dir, 0755) < 0 && errno != EEXIST) {
+        perror(dir);
+        return 2;
+    }
+    for (int k = 0; k < npaths; k++) {
+        Stream *s = &streams[k];
+        s->fd = -1;
+        if (!read_stream(paths[k], s))
+            return 2;
+        snprintf(s->fifo, sizeof(s->fifo), "%s/event%d", dir, k);
+        unlink(s->fifo);
+        if (mkfifo(s->fifo, 0600) < 0) {
+            perror(s->fifo);
+            return 2;
+        }
+    }
+
+    /* blkout mit angehängtem --idle-backend evdev --evdev-dir starten */
+    if (i < argc) {
+        char *cargv[MAX_ARGS + 5];
+        int cargc = 0;
+        for (int k = i; k < argc && cargc < MAX_ARGS; k++)
+            cargv[cargc++] = argv[k];
+        cargv[cargc++] = "--idle-backend";
+        cargv[cargc++] = "evdev";
+        cargv[cargc++] = "--evdev-dir";
+        cargv[cargc++] = (char *)dir;
+        cargv[cargc]   = NULL;
+
+        child = fork();
+        if (child < 0) {
+            perror("fork");
+            return 2;
+        }
+        if (child == 0) {
+            execvp(cargv[0], cargv);
+            perror(cargv[0]);
+            _exit(127);
+        }
+    }
+
+    int status = 0;
+    for (int k = 0; k < npaths; k++) {
+        streams[k].fd = open_fifo(streams[k].fifo);
+        if (streams[k].fd < 0) {
+            status = 1;
+            goto out;
+        }
+    }
+
+    /* Gemeinsamer Zeitnullpunkt: das früheste Ereignis aller Aufnahmen */
+    uint64_t base = UINT64_MAX;
+    for (int k = 0; k < npaths; k++)
+        if (streams[k].count > 0 && event_ns(&streams[k].events[0]) < base)
+            base = event_ns(&streams[k].events[0]);
+
+    /* Nach Zeitstempel mischen und mit den ursprünglichen Abständen schreiben */
+    uint64_t start   = now_ns();
+    size_t   written = 0;
+    for (;;) {
+        Stream *s = NULL;
+        for (int k = 0; k < npaths; k++) {
+            Stream *c = &streams[k];
+            if (c->next < c->count &&
+                (!s || event_ns(&c->events[c->next]) <
+                       event_ns(&s->events[s->next])))
+                s = c;
+        }
+        if (!s)
+            break;
+
+        struct input_event ev = s->events[s->next++];
+        uint64_t t = now_ns();
+        if (speed > 0) {
+            uint64_t offset = event_ns(&ev) > base ? event_ns(&ev) - base : 0;
+            t = start + (uint64_t)((double)offset / speed);
+            sleep_until(t);
+        }
+        ev.input_event_sec  = (time_t)(t / 1000000000ull);
+        ev.input_event_usec = (suseconds_t)(t % 1000000000ull / 1000);
+        if (!write_event(s->fd, &ev, split_ms)) {
+            perror(s->fifo);
+            status = 1;
+            goto out;
+        }
+        written++;
+        if (child_exited()) {
+            fprintf(stderr, "blkout vorzeitig beendet\n");
+            status = 1;
+            goto out;
+        }
+    }
+    sleep_until(now_ns() + (uint64_t)hold_ms * 1000000ull);
+    printf("events %zu\n", written);
+
+out:
+    /* FIFOs schließen: blkout sieht EPOLLHUP und trägt die Geräte aus */
+    for (int k = 0; k < npaths; k++) {
+        if (streams[k].fd >= 0)
+            close(streams[k].fd);
+        unlink(streams[k].fifo);
+        free(streams[k].events);
+    }
+    if (child > 0 && !child_exited()) {
+        kill(child, SIGTERM);
+        waitpid(child, NULL, 0);
+    }
+    return status;
+}
@@ -0,0 +1,197 @@
+/*
+ * journal-check.c — Ringdatei von --journal schreiben und wieder auslesen
+ *
+ * Aufruf:
+ *   journal-check [VERZEICHNIS]
+ *
+ * Prüft src/journal.c ohne Compositor in einer temporären Datei:
+ *
+ *   write     Einträge schreiben, journal_dump() gibt sie in Reihenfolge aus
+ *   wrap      Mehr als JOURNAL_RECORDS Einträge: nur die jüngsten bleiben,
+ *             lückenlos und aufsteigend
+ *   torn      Ein Eintrag mit seq 0 (abgebrochenes Schreiben) wird
+ *             übersprungen
+ *   blank     Eine belegte Datei mit leerem Kopf (Abbruch zwischen
+ *             posix_fallocate und Kopf) wird neu angelegt statt abgelehnt
+ *   foreign   Eine fremde Datei wird nicht überschrieben
+ *
+ * Rückgabe: 0 wenn alle Prüfungen bestehen, sonst 1.
+ */
+
+#define _GNU_SOURCE
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "../src/journal.h"
+
+static char path[4096];
+static int  failures;
+
+static void check(bool ok, const char *name, const char *what)
+{
+    if (!ok) {
+        fprintf(stderr, "FEHL %s: %s\n", name, what);
+        failures++;
+    }
+}
+
+/*
+ * journal_dump() in eine temporäre Datei; liefert die Zahl der
+ * Datenzeilen und die Nummern der ersten und letzten; ascending meldet,
+ * ob die Nummern streng aufsteigen. -1 bei Fehler.
+ */
+static long dump_lines(unsigned long long *first, unsigned long long *last,
+                       bool *ascending)
+{
+    FILE *f = tmpfile();
+    if (!f || !journal_dump(path, f)) {
+        if (f)
+            fclose(f);
+        return -1;
+    }
+    rewind(f);
+
+    char line[256];
+    long n = 0;
+    unsigned long long prev = 0;
+    *ascending = true;
+    *first = *last = 0;
+    if (!fgets(line, sizeof(line), f) || strncmp(line, "seq,", 4) != 0) {
+        fclose(f);
+        return -1;
+    }
+    while (fgets(line, sizeof(line), f)) {
+        unsigned long long seq = strtoull(line, NULL, 10);
+        if (n == 0)
+            *first = seq;
+        else if (seq <= prev)
+            *ascending = false;
+        prev = *last = seq;
+        n++;
+    }
+    fclose(f);
+    return n;
+}
+
+static void test_write(void)
+{
+    unsigned long long first, last;
+    bool asc;
+
+    unlink(path);
+    check(journal_open(path), "write", "journal_open");
+    journal_write(JOURNAL_ARM, 300000, 0);
+    journal_write(JOURNAL_IDLED, 0, 0);
+    journal_write(JOURNAL_SHOW, 0, 1500000);
+    journal_write(JOURNAL_HIDE, JOURNAL_SOURCE_KEYBOARD, 250000);
+    journal_close();
+
+    /* start + vier Einträge */
+    long n = dump_lines(&first, &last, &asc);
+    check(n == 5, "write", "Zahl der Einträge");
+    check(first == 1 && last == 5 && asc, "write", "Nummern 1..5");
+
+    /* Fortschreiben über einen Neustart */
+    check(journal_open(path), "write", "erneutes journal_open");
+    journal_close();
+    n = dump_lines(&first, &last, &asc);
+    check(n == 6 && last == 6, "write", "Fortsetzung nach Neustart");
+}
+
+static void test_wrap(void)
+{
+    unsigned long long first, last;
+    bool asc;
+
+    check(journal_open(path), "wrap", "journal_open");
+    for (int i = 0; i < JOURNAL_RECORDS + 10; i++)
+        journal_write(JOURNAL_ARM, (uint32_t)i, 0);
+    uint64_t next = journal_header->next_seq;
+    journal_close();
+
+    long n = dump_lines(&first, &last, &asc);
+    check(n == JOURNAL_RECORDS, "wrap", "Ring nicht voll ausgegeben");
+    check(last == next - 1, "wrap", "jüngster Eintrag fehlt");
+    check(first == next - JOURNAL_RECORDS, "wrap", "ältester Eintrag falsch");
+    check(asc && last - first + 1 == (unsigned long long)n, "wrap",
+          "Nummern nicht lückenlos aufsteigend");
+}
+
+static void test_torn(void)
+{
+    unsigned long long first, last;
+    bool asc;
+
+    check(journal_open(path), "torn", "journal_open");
+    journal_write(JOURNAL_IDLED, 0, 0);
+    uint64_t seq = journal_header->next_seq - 1;
+    JournalRecord *records = (JournalRecord *)(journal_header + 1);
+    records[(seq - 1) % journal_header->capacity].seq = 0;
+
+    long n = dump_lines(&first, &last, &asc);
+    check(n == JOURNAL_RECORDS - 1, "torn", "halber Eintrag ausgegeben");
+    check(last == seq - 1, "torn", "falscher jüngster Eintrag");
+    journal_close();
+}
+
+static void test_blank(void)
+{
+    unsigned long long first, last;
+    bool asc;
+
+    unlink(path);
+    int fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    size_t size = sizeof(JournalHeader) +
+                  (size_t)JOURNAL_RECORDS * sizeof(JournalRecord);
+    check(fd >= 0 && ftruncate(fd, (off_t)size) == 0, "blank", "anlegen");
+    if (fd >= 0)
+        close(fd);
+
+    check(journal_open(path), "blank", "leerer Kopf abgelehnt");
+    journal_close();
+    long n = dump_lines(&first, &last, &asc);
+    check(n == 1 && first == 1, "blank", "nicht neu angelegt");
+}
+
+static void test_foreign(void)
+{
+    unlink(path);
+    int fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    static const char text[] = "keine Ringdatei\n";
+    check(fd >= 0 && write(fd, text, sizeof(text) - 1) ==
+                     (ssize_t)sizeof(text) - 1, "foreign", "anlegen");
+    if (fd >= 0)
+        close(fd);
+
+    check(!journal_open(path), "foreign", "fremde Datei angenommen");
+    char buf[sizeof(text)] = "";
+    fd = open(path, O_RDONLY);
+    check(fd >= 0 && read(fd, buf, sizeof(buf)) == (ssize_t)sizeof(text) - 1 &&
+          memcmp(buf, text, sizeof(text) - 1) == 0, "foreign",
+          "fremde Datei verändert");
+    if (fd >= 0)
+        close(fd);
+}
+
+int main(int argc, char *argv[])
+{
+    const char *dir = argc > 1 ? argv[1] : "/tmp";
+    snprintf(path, sizeof(path), "%s/blkout-journal-check.%d", dir,
+             (int)getpid());
+
+    test_write();
+    test_wrap();
+    test_torn();
+    test_blank();
+    test_foreign();
+    unlink(path);
+
+    if (failures)
+        return 1;
+    printf("ok   journal\n");
+    return 0;
+}
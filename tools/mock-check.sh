@@ -0,0 +1,43 @@
+#!/bin/sh
+#
+# mock-check.sh — Szenarien gegen den Mock-Compositor laufen lassen
+#
+# Aufruf:
+#   tools/mock-check.sh [BLKOUT]
+#
+# Führt jedes Skript tools/scenarios/*.mock mit tools/mockcomp-run aus.
+# Eine Zeile "# args: ..." im Skript gibt die blkout-Parameter vor. Statt
+# dessen kann "# command: ..." den ganzen Befehl vorgeben (z.B. blkout über
+# tools/evdev-replay); darin stehen @BLKOUT@ für blkout und @TMP@ für ein
+# temporäres Verzeichnis. Die Zähler des Mock-Compositors landen nur bei
+# einem Fehler auf der Ausgabe.
+#
+# Rückgabe: 0 wenn alle Szenarien bestehen, sonst 1.
+
+set -u
+
+MOCK=${MOCK:-tools/mockcomp-run}
+DIR=${SCENARIOS:-tools/scenarios}
+BLKOUT=${1:-./blkout}
+
+TMP=$(mktemp -d)
+trap 'rm -rf "$TMP"' EXIT
+
+FAIL=0
+for script in "$DIR"/*.mock; do
+    name=$(basename "$script" .mock)
+    cmd=$(sed -n 's/^# command: *//p' "$script" |
+          sed -e "s|@BLKOUT@|$BLKOUT|g" -e "s|@TMP@|$TMP|g")
+    if [ -z "$cmd" ]; then
+        cmd="$BLKOUT $(sed -n 's/^# args: *//p' "$script")"
+    fi
+    # cmd absichtlich ungequotet: einzelne Parameter
+    if "$MOCK" "$script" -- $cmd > "$TMP/stats" 2> "$TMP/err"; then
+        echo "ok   $name"
+    else
+        echo "FEHL $name"
+        cat "$TMP/err" "$TMP/stats"
+        FAIL=1
+    fi
+done
+exit $FAIL
@@ -0,0 +1,437 @@
+/*
+ * mockcomp-run.c — blkout gegen den Mock-Compositor laufen lassen
+ *
+ * Aufruf:
+ *   mockcomp-run SKRIPT -- BEFEHL [ARGUMENTE...]
+ *
+ * Legt einen Mock-Compositor in einem temporären XDG_RUNTIME_DIR an,
+ * startet BEFEHL (typischerweise ./blkout) mit passendem WAYLAND_DISPLAY
+ * und arbeitet dann SKRIPT zeilenweise ab. XDG_CONFIG_HOME zeigt auf
+ * dasselbe Verzeichnis, sodass blkout keine Konfiguration der Sitzung
+ * liest, sondern nur die der config-Anweisung. Schlägt eine Erwartung fehl,
+ * wird die Zeile gemeldet und mit Status 1 beendet. Am Ende werden die
+ * beobachteten Zähler als "name wert"-Zeilen ausgegeben.
+ *
+ * Skriptsprache (eine Anweisung pro Zeile, '#' leitet Kommentare ein):
+ *   output BxH          Ausgabe anstecken
+ *   remove-output N     Ausgabe N abziehen (closed an ihre Layer-Surfaces)
+ *   configure BxH       neues configure an alle Layer-Surfaces
+ *   seat NAME           weiteren wl_seat ankündigen (Seat 0 heißt seat0)
+ *   idle [SEAT]         idled an alle bzw. nur an die Notifications von SEAT
+ *   resume [SEAT]       resumed an alle bzw. nur an SEAT
+ *   close               allen Layer-Surfaces "closed" schicken
+ *   restart             Compositor-Neustart: alle Clients trennen
+ *   key CODE            Taste drücken und loslassen (evdev-Code)
+ *   motion X Y          Mausbewegung in Surface-Koordinaten
+ *   pointer X Y         Mausbewegung ohne vorheriges resumed
+ *   button [CODE]       Maustaste klicken (Standard 272, BTN_LEFT)
+ *   config KEY WERT     blkout/config mit genau dieser Zeile ersetzen
+ *   pixel-check on|off  Prüfung auf Schwarz bei jedem Commit (Standard on)
+ *   sleep MS            MS Millisekunden lang Ereignisse verarbeiten
+ *   wait-map [MS]       warten, bis eine Layer-Surface sichtbar ist
+ *   wait-unmap [MS]     warten, bis keine Layer-Surface mehr sichtbar ist
+ *   expect-black        zuletzt eingereichter Puffer muss schwarz sein
+ *   expect-exit [MS]    Client muss sich mit Status 0 beenden
+ *   expect NAME OP WERT Zähler vergleichen, OP ist == != < <= > >=,
+ *                       NAME wie in der Ausgabe von print; show_ms ist
+ *                       die Zeit von der letzten idle-Anweisung bis zum
+ *                       Mappen (0 = seitdem nicht gemappt)
+ *   mark                Requests und Kontextwechsel des Clients merken
+ *   expect-quiet        seit mark weder Requests noch Aufwachen des Clients
+ *   print               aktuelle Zähler auf stdout ausgeben
+ *
+ * Standard-Timeout für wait-map, wait-unmap und expect-exit: 5000 ms.
+ */
+
+#define _GNU_SOURCE
+
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+
+#include "mockcomp.h"
+#include "procstat.h"
+
+#define DEFAULT_TIMEOUT_MS 5000
+#define SLICE_MS           10
+#define BTN_LEFT           272
+
+static pid_t child = -1;
+static int   child_status = -1;     /* Exit-Status, sobald beendet */
+
+/* Stand bei der letzten mark-Anweisung */
+static uint64_t mark_requests;
+static long     mark_switches = -1;
+
+/* Zeitpunkt der letzten idle-Anweisung, für show_ms */
+static uint64_t idle_ns;
+
+/* Konfigurationsverzeichnis und -datei unter XDG_CONFIG_HOME */
+static char config_dir[512];
+static char config_file[544];
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+/* Zeitstempel für Eingabeereignisse, wie im Mock-Compositor */
+static uint32_t now_ms(void)
+{
+    return (uint32_t)(now_ns() / 1000000u);
+}
+
+/*
+ * Konfigurationsdatei durch eine mit der Zeile "key = value" ersetzen.
+ * Über rename(), damit blkout nie eine halb geschriebene Datei liest.
+ */
+static bool write_config(const char *key, const char *value)
+{
+    char tmp[560];
+    snprintf(tmp, sizeof(tmp), "%s.tmp", config_file);
+    FILE *f = fopen(tmp, "w");
+    if (!f) {
+        perror(tmp);
+        return false;
+    }
+    fprintf(f, "%s = %s\n", key, value);
+    if (fclose(f) != 0 || rename(tmp, config_file) != 0) {
+        perror(config_file);
+        unlink(tmp);
+        return false;
+    }
+    return true;
+}
+
+/* Prüft ohne Blockieren, ob der Client sich beendet hat */
+static bool child_exited(void)
+{
+    if (child < 0)
+        return true;
+    int status;
+    if (waitpid(child, &status, WNOHANG) == child) {
+        child_status = WIFEXITED(status) ? WEXITSTATUS(status)
+                                         : 128 + WTERMSIG(status);
+        child = -1;
+        return true;
+    }
+    return false;
+}
+
+/* Ereignisse ms Millisekunden lang verarbeiten */
+static void run_for(MockComp *mc, int ms)
+{
+    for (int left = ms; left > 0; left -= SLICE_MS) {
+        mock_dispatch(mc, left < SLICE_MS ? left : SLICE_MS);
+        child_exited();
+    }
+    mock_dispatch(mc, 0);
+}
+
+/* Zähler mit Namen, für print und expect */
+typedef struct {
+    const char *name;
+    long long   value;
+} StatValue;
+
+#define NSTATS 16
+
+static void collect_stats(const MockComp *mc, StatValue v[NSTATS])
+{
+    const MockStats *st = mock_stats(mc);
+    int n = 0;
+    v[n++] = (StatValue){ "outputs",         st->outputs };
+    v[n++] = (StatValue){ "layer_surfaces",  st->layer_surfaces };
+    v[n++] = (StatValue){ "mapped",          st->mapped };
+    v[n++] = (StatValue){ "maps",            (long long)st->maps };
+    v[n++] = (StatValue){ "unmaps",          (long long)st->unmaps };
+    v[n++] = (StatValue){ "configures_sent", (long long)st->configures_sent };
+    v[n++] = (StatValue){ "commits",         (long long)st->commits };
+    v[n++] = (StatValue){ "requests",        (long long)st->requests };
+    v[n++] = (StatValue){ "buffers",         (long long)st->buffers };
+    v[n++] = (StatValue){ "buffer_bytes",    (long long)st->buffer_bytes };
+    v[n++] = (StatValue){ "max_object_id",   st->max_object_id };
+    v[n++] = (StatValue){ "last_black",      st->last_black ? 1 : 0 };
+    v[n++] = (StatValue){ "clients",         st->clients };
+    v[n++] = (StatValue){ "keyboards_bound", (long long)st->keyboards_bound };
+    v[n++] = (StatValue){ "pointers_bound",  (long long)st->pointers_bound };
+    v[n++] = (StatValue){ "show_ms",
+                          idle_ns && st->last_map_ns > idle_ns
+                              ? (long long)((st->last_map_ns - idle_ns) / 1000000u)
+                              : 0 };
+}
+
+static void print_stats(const MockComp *mc)
+{
+    StatValue v[NSTATS];
+    collect_stats(mc, v);
+    for (int i = 0; i < NSTATS; i++)
+        printf("%s %lld\n", v[i].name, v[i].value);
+    fflush(stdout);
+}
+
+/* expect NAME OP WERT: Zähler mit einem festen Wert vergleichen */
+static bool expect_stat(const MockComp *mc, const char *name, const char *op,
+                        const char *arg)
+{
+    if (!name || !op || !arg)
+        return false;
+
+    StatValue v[NSTATS];
+    collect_stats(mc, v);
+    long long want = atoll(arg);
+    for (int i = 0; i < NSTATS; i++) {
+        if (strcmp(v[i].name, name) != 0)
+            continue;
+        long long got = v[i].value;
+        bool ok;
+        if (strcmp(op, "==") == 0)
+            ok = got == want;
+        else if (strcmp(op, "!=") == 0)
+            ok = got != want;
+        else if (strcmp(op, "<") == 0)
+            ok = got < want;
+        else if (strcmp(op, "<=") == 0)
+            ok = got <= want;
+        else if (strcmp(op, ">") == 0)
+            ok = got > want;
+        else if (strcmp(op, ">=") == 0)
+            ok = got >= want;
+        else {
+            fprintf(stderr, "Unbekannter Vergleich: %s\n", op);
+            return false;
+        }
+        if (!ok)
+            fprintf(stderr, "expect: %s ist %lld, erwartet %s %lld\n",
+                    name, got, op, want);
+        return ok;
+    }
+    fprintf(stderr, "Unbekannter Zähler: %s\n", name);
+    return false;
+}
+
+/*
+ * expect-quiet: Seit mark hat der Client keinen Request geschickt und ist
+ * kein einziges Mal aus poll() aufgewacht. Jedes Aufwachen ist mindestens
+ * ein freiwilliger Kontextwechsel, wenn er sich wieder schlafen legt.
+ */
+static bool expect_quiet(const MockComp *mc)
+{
+    uint64_t requests = mock_stats(mc)->requests - mark_requests;
+    long switches = child > 0 ? proc_ctxt_switches(child) : -1;
+    if (mark_switches < 0 || switches < 0) {
+        fprintf(stderr, "expect-quiet: Client läuft nicht oder kein mark\n");
+        return false;
+    }
+    if (requests == 0 && switches == mark_switches)
+        return true;
+    fprintf(stderr, "expect-quiet: %llu Requests, %ld Kontextwechsel\n",
+            (unsigned long long)requests, switches - mark_switches);
+    return false;
+}
+
+/* Optionales Timeout-Argument lesen */
+static int arg_timeout(const char *arg)
+{
+    return arg ? atoi(arg) : DEFAULT_TIMEOUT_MS;
+}
+
+/*
+ * Eine Skriptzeile ausführen. Gibt false zurück, wenn eine Erwartung
+ * nicht erfüllt wurde oder die Zeile nicht verstanden wird.
+ */
+static bool run_line(MockComp *mc, char *line)
+{
+    char *hash = strchr(line, '#');
+    if (hash)
+        *hash = '\0';
+
+    char *cmd = strtok(line, " \t\r\n");
+    if (!cmd)
+        return true;
+    char *a1 = strtok(NULL, " \t\r\n");
+    char *a2 = strtok(NULL, " \t\r\n");
+    char *a3 = strtok(NULL, " \t\r\n");
+    int w, h;
+
+    if (strcmp(cmd, "output") == 0) {
+        if (!a1 || sscanf(a1, "%dx%d", &w, &h) != 2)
+            return false;
+        return mock_add_output(mc, w, h) >= 0;
+    } else if (strcmp(cmd, "remove-output") == 0) {
+        if (!a1)
+            return false;
+        mock_remove_output(mc, atoi(a1));
+    } else if (strcmp(cmd, "configure") == 0) {
+        if (!a1 || sscanf(a1, "%dx%d", &w, &h) != 2)
+            return false;
+        mock_configure(mc, w, h);
+    } else if (strcmp(cmd, "seat") == 0) {
+        if (!a1 || mock_add_seat(mc, a1) < 0)
+            return false;
+    } else if (strcmp(cmd, "idle") == 0 || strcmp(cmd, "resume") == 0) {
+        bool idle = cmd[0] == 'i';
+        int seat = a1 ? mock_find_seat(mc, a1) : -1;
+        if (a1 && seat < 0) {
+            fprintf(stderr, "Unbekannter Seat: %s\n", a1);
+            return false;
+        }
+        if (idle)
+            idle_ns = now_ns();
+        if (!a1 && idle)
+            mock_idle(mc);
+        else if (!a1)
+            mock_resume(mc);
+        else if (idle)
+            mock_idle_seat(mc, seat);
+        else
+            mock_resume_seat(mc, seat);
+    } else if (strcmp(cmd, "close") == 0) {
+        mock_close(mc);
+    } else if (strcmp(cmd, "restart") == 0) {
+        mock_restart(mc);
+    } else if (strcmp(cmd, "key") == 0) {
+        if (!a1)
+            return false;
+        mock_key(mc, (uint32_t)atoi(a1));
+    } else if (strcmp(cmd, "motion") == 0) {
+        if (!a1 || !a2)
+            return false;
+        mock_motion(mc, atof(a1), atof(a2));
+    } else if (strcmp(cmd, "pointer") == 0) {
+        if (!a1 || !a2)
+            return false;
+        mock_pointer_motion(mc, atof(a1), atof(a2), now_ms());
+        mock_pointer_frame(mc);
+    } else if (strcmp(cmd, "button") == 0) {
+        mock_button(mc, a1 ? (uint32_t)atoi(a1) : BTN_LEFT);
+    } else if (strcmp(cmd, "config") == 0) {
+        if (!a1 || !a2 || !write_config(a1, a2))
+            return false;
+    } else if (strcmp(cmd, "pixel-check") == 0) {
+        if (!a1 || (strcmp(a1, "on") != 0 && strcmp(a1, "off") != 0))
+            return false;
+        mock_set_pixel_check(mc, strcmp(a1, "on") == 0);
+    } else if (strcmp(cmd, "sleep") == 0) {
+        if (!a1)
+            return false;
+        run_for(mc, atoi(a1));
+        return true;
+    } else if (strcmp(cmd, "wait-map") == 0) {
+        return mock_wait_mapped(mc, true, arg_timeout(a1));
+    } else if (strcmp(cmd, "wait-unmap") == 0) {
+        return mock_wait_mapped(mc, false, arg_timeout(a1));
+    } else if (strcmp(cmd, "expect-black") == 0) {
+        return mock_stats(mc)->buffers > 0 && mock_stats(mc)->last_black;
+    } else if (strcmp(cmd, "expect-exit") == 0) {
+        int ms = arg_timeout(a1);
+        while (!child_exited() && ms > 0) {
+            mock_dispatch(mc, SLICE_MS);
+            ms -= SLICE_MS;
+        }
+        return child < 0 && child_status == 0;
+    } else if (strcmp(cmd, "expect") == 0) {
+        /* Erst Anstehendes verarbeiten, damit der Stand aktuell ist */
+        mock_dispatch(mc, 0);
+        return expect_stat(mc, a1, a2, a3);
+    } else if (strcmp(cmd, "mark") == 0) {
+        mock_dispatch(mc, 0);
+        mark_requests = mock_stats(mc)->requests;
+        mark_switches = child > 0 ? proc_ctxt_switches(child) : -1;
+        return true;
+    } else if (strcmp(cmd, "expect-quiet") == 0) {
+        mock_dispatch(mc, 0);
+        return expect_quiet(mc);
+    } else if (strcmp(cmd, "print") == 0) {
+        print_stats(mc);
+    } else {
+        fprintf(stderr, "Unbekannte Anweisung: %s\n", cmd);
+        return false;
+    }
+
+    /* Gesendete Ereignisse sofort zustellen */
+    mock_dispatch(mc, 0);
+    return true;
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc < 4 || strcmp(argv[2], "--") != 0) {
+        fprintf(stderr, "Aufruf: %s SKRIPT -- BEFEHL [ARGUMENTE...]\n",
+                argv[0]);
+        return 2;
+    }
+
+    FILE *script = strcmp(argv[1], "-") == 0 ? stdin : fopen(argv[1], "r");
+    if (!script) {
+        perror(argv[1]);
+        return 2;
+    }
+
+    MockComp *mc = mock_create();
+    if (!mc)
+        return 2;
+    setenv("WAYLAND_DISPLAY", mock_socket(mc), 1);
+
+    /* Eigene, anfangs leere Konfiguration statt der der Sitzung */
+    snprintf(config_dir, sizeof(config_dir), "%s/blkout",
+             mock_runtime_dir(mc));
+    snprintf(config_file, sizeof(config_file), "%s/config", config_dir);
+    if (mkdir(config_dir, 0700) != 0) {
+        perror(config_dir);
+        mock_destroy(mc);
+        return 2;
+    }
+    setenv("XDG_CONFIG_HOME", mock_runtime_dir(mc), 1);
+
+    child = fork();
+    if (child < 0) {
+        perror("fork");
+        rmdir(config_dir);
+        mock_destroy(mc);
+        return 2;
+    }
+    if (child == 0) {
+        execvp(argv[3], &argv[3]);
+        perror(argv[3]);
+        _exit(127);
+    }
+
+    bool ok = true;
+    char line[256];
+    int lineno = 0;
+    while (fgets(line, sizeof(line), script)) {
+        lineno++;
+        if (!run_line(mc, line)) {
+            fprintf(stderr, "%s:%d: fehlgeschlagen\n", argv[1], lineno);
+            ok = false;
+            break;
+        }
+    }
+    if (script != stdin)
+        fclose(script);
+
+    /* Client beenden, falls er noch läuft */
+    if (!child_exited()) {
+        kill(child, SIGTERM);
+        for (int ms = 0; ms < 1000 && !child_exited(); ms += SLICE_MS)
+            mock_dispatch(mc, SLICE_MS);
+        if (!child_exited()) {
+            kill(child, SIGKILL);
+            waitpid(child, NULL, 0);
+        }
+    }
+
+    print_stats(mc);
+    unlink(config_file);
+    rmdir(config_dir);
+    mock_destroy(mc);
+    return ok ? 0 : 1;
+}
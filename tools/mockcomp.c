@@ -0,0 +1,1523 @@
+/*
+ * mockcomp.c — Minimaler Wayland-Compositor für reproduzierbare Läufe
+ *
+ * Siehe mockcomp.h. Alle Objekte werden in einfachen wl_list-Listen
+ * gehalten; Seats und Ausgaben sind feste Felder mit frei steuerbarer
+ * Belegung. Puffer werden nur gelesen (Schwarzprüfung), nie dargestellt.
+ */
+
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+#include <wayland-server.h>
+#include "wlr-layer-shell-unstable-v1-server-protocol.h"
+#include "ext-idle-notify-v1-server-protocol.h"
+#include "presentation-time-server-protocol.h"
+#include "viewporter-server-protocol.h"
+
+#include "mockcomp.h"
+
+#define MOCK_MAX_OUTPUTS 8
+#define MOCK_MAX_SEATS   4
+#define MOCK_MAX_GLOBALS (8 + MOCK_MAX_SEATS)
+
+/* Angebotene Protokollversionen (blkout bindet höchstens diese) */
+#define COMPOSITOR_VERSION   4
+#define SEAT_VERSION         5
+#define OUTPUT_VERSION       3
+#define LAYER_SHELL_VERSION  4
+#define IDLE_VERSION         1
+#define PRESENTATION_VERSION 1
+#define VIEWPORTER_VERSION   1
+
+/* Feste Bildwiederholrate der simulierten Ausgaben */
+#define REFRESH_MHZ 60000
+#define REFRESH_NS  (1000000000u / 60u)
+
+/* Ein Eintrag für Ressourcen ohne eigenen Zustand (Tastatur, Maus, ...) */
+typedef struct {
+    struct wl_list      link;
+    struct wl_resource *resource;
+} Res;
+
+typedef struct {
+    bool               present;
+    int                width, height;
+    struct wl_global  *global;
+    struct wl_list     resources;   /* Res */
+} Output;
+
+/*
+ * Angekündigter wl_seat. Jeder hat seinen eigenen Leerlauf; Eingaben
+ * gehen dagegen über die Tastaturen und Zeiger aller Seats.
+ */
+typedef struct {
+    MockComp          *mc;
+    bool               present;
+    bool               idle;
+    char               name[32];
+} Seat;
+
+/* Idle-Notification mit dem Seat, für den sie angefordert wurde */
+typedef struct {
+    struct wl_list      link;
+    struct wl_resource *resource;
+    Seat               *seat;
+} Notification;
+
+typedef struct LayerSurface LayerSurface;
+
+typedef struct {
+    MockComp           *mc;
+    struct wl_list      link;
+    struct wl_resource *resource;
+    struct wl_resource *pending_buffer;
+    bool                pending_attach;
+    bool                has_buffer;     /* Aktueller Zustand nach Commit */
+    bool                mapped;
+    struct wl_list      frame_callbacks; /* Res, ausstehend bis zum Commit */
+    struct wl_list      feedbacks;       /* Res, ausstehend bis zum Commit */
+    LayerSurface       *layer;
+} Surface;
+
+struct LayerSurface {
+    MockComp           *mc;
+    struct wl_list      link;
+    struct wl_resource *resource;
+    Surface            *surface;
+    int                 output;         /* Index oder -1 */
+    uint32_t            last_serial;
+    bool                acked;
+    bool                closed;
+};
+
+/* Bereits gesehene wl_buffer, damit jeder nur einmal gezählt wird */
+typedef struct {
+    struct wl_list      link;
+    struct wl_resource *resource;
+    struct wl_listener  destroy;
+} SeenBuffer;
+
+struct MockComp {
+    struct wl_display    *display;
+    struct wl_event_loop *loop;
+    char                  runtime_dir[64];
+    const char           *socket;
+    bool                  pixel_check;
+    uint32_t              capabilities;    /* Angekündigte Seat-Fähigkeiten */
+    double                ptr_x, ptr_y;    /* Eintrittsposition bei enter */
+    MockStats             stats;
+
+    struct wl_global     *globals[MOCK_MAX_GLOBALS]; /* Feste Globals */
+    int                   nglobals;
+
+    Output                outputs[MOCK_MAX_OUTPUTS];
+    Seat                  seat_slots[MOCK_MAX_SEATS];
+    struct wl_list        surfaces;        /* Surface */
+    struct wl_list        layers;          /* LayerSurface */
+    struct wl_list        keyboards;       /* Res */
+    struct wl_list        pointers;        /* Res */
+    struct wl_list        seats;           /* wl_resource-Links aller Seats */
+    struct wl_list        notifications;   /* Notification */
+    struct wl_list        buffers;         /* SeenBuffer */
+
+    Surface              *focus;           /* Gemappte Surface mit Fokus */
+    struct wl_listener    client_created;
+    struct wl_protocol_logger *logger;     /* Zählt Requests */
+};
+
+/* =========================================================================
+ * Hilfsfunktionen
+ * ========================================================================= */
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+/* Zeitstempel für Eingabeereignisse: Millisekunden auf CLOCK_MONOTONIC */
+static uint32_t now_ms(void)
+{
+    return (uint32_t)(now_ns() / 1000000ull);
+}
+
+static Res *res_add(struct wl_list *list, struct wl_resource *resource)
+{
+    Res *r = calloc(1, sizeof(*r));
+    if (!r)
+        return NULL;
+    r->resource = resource;
+    wl_list_insert(list->prev, &r->link);
+    return r;
+}
+
+/* Destruktor für Ressourcen, deren Benutzerdaten ein Res-Eintrag sind */
+static void res_destroy(struct wl_resource *resource)
+{
+    Res *r = wl_resource_get_user_data(resource);
+    if (!r)
+        return;
+    wl_list_remove(&r->link);
+    free(r);
+}
+
+static void track_id(MockComp *mc, struct wl_resource *resource)
+{
+    uint32_t id = wl_resource_get_id(resource);
+    /* Vom Server vergebene IDs (ab 0xff000000) zählen nicht */
+    if (id < 0xff000000u && id > mc->stats.max_object_id)
+        mc->stats.max_object_id = id;
+}
+
+static void destroy_request(struct wl_client *client,
+                            struct wl_resource *resource)
+{
+    (void)client;
+    wl_resource_destroy(resource);
+}
+
+/* =========================================================================
+ * Sichtbarkeit und Fokus
+ * ========================================================================= */
+
+static void set_focus(MockComp *mc, Surface *s)
+{
+    if (mc->focus == s)
+        return;
+
+    uint32_t serial = wl_display_next_serial(mc->display);
+    Res *r;
+
+    if (mc->focus) {
+        struct wl_client *old = wl_resource_get_client(mc->focus->resource);
+        wl_list_for_each(r, &mc->keyboards, link)
+            if (wl_resource_get_client(r->resource) == old)
+                wl_keyboard_send_leave(r->resource, serial,
+                                       mc->focus->resource);
+        wl_list_for_each(r, &mc->pointers, link) {
+            if (wl_resource_get_client(r->resource) != old)
+                continue;
+            wl_pointer_send_leave(r->resource, serial, mc->focus->resource);
+            if (wl_resource_get_version(r->resource) >= 5)
+                wl_pointer_send_frame(r->resource);
+        }
+    }
+
+    mc->focus = s;
+    if (!s)
+        return;
+
+    struct wl_client *client = wl_resource_get_client(s->resource);
+    struct wl_array keys;
+    wl_array_init(&keys);
+    wl_list_for_each(r, &mc->keyboards, link)
+        if (wl_resource_get_client(r->resource) == client)
+            wl_keyboard_send_enter(r->resource, serial, s->resource, &keys);
+    wl_array_release(&keys);
+    wl_list_for_each(r, &mc->pointers, link) {
+        if (wl_resource_get_client(r->resource) != client)
+            continue;
+        wl_pointer_send_enter(r->resource, serial, s->resource,
+                              wl_fixed_from_double(mc->ptr_x),
+                              wl_fixed_from_double(mc->ptr_y));
+        if (wl_resource_get_version(r->resource) >= 5)
+            wl_pointer_send_frame(r->resource);
+    }
+}
+
+static void set_mapped(Surface *s, bool mapped)
+{
+    MockComp *mc = s->mc;
+    if (s->mapped == mapped)
+        return;
+    s->mapped = mapped;
+
+    if (mapped) {
+        mc->stats.mapped++;
+        mc->stats.maps++;
+        mc->stats.last_map_ns = now_ns();
+        set_focus(mc, s);
+    } else {
+        mc->stats.mapped--;
+        mc->stats.unmaps++;
+        mc->stats.last_unmap_ns = now_ns();
+        if (mc->focus == s) {
+            /* Fokus an eine andere gemappte Surface weitergeben */
+            Surface *other, *next = NULL;
+            wl_list_for_each(other, &mc->surfaces, link)
+                if (other->mapped)
+                    next = other;
+            set_focus(mc, next);
+        }
+    }
+}
+
+/* Prüft, ob ein SHM-Puffer ausschließlich schwarze Pixel enthält */
+static bool buffer_is_black(struct wl_resource *buffer)
+{
+    struct wl_shm_buffer *shm = wl_shm_buffer_get(buffer);
+    if (!shm)
+        return false;
+
+    uint32_t format = wl_shm_buffer_get_format(shm);
+    if (format != WL_SHM_FORMAT_ARGB8888 && format != WL_SHM_FORMAT_XRGB8888)
+        return false;
+
+    int32_t w = wl_shm_buffer_get_width(shm);
+    int32_t h = wl_shm_buffer_get_height(shm);
+    int32_t stride = wl_shm_buffer_get_stride(shm);
+    bool black = true;
+
+    wl_shm_buffer_begin_access(shm);
+    const uint8_t *data = wl_shm_buffer_get_data(shm);
+    for (int32_t y = 0; y < h && black; y++) {
+        const uint32_t *row = (const uint32_t *)(data + (size_t)y * stride);
+        for (int32_t x = 0; x < w; x++) {
+            if (row[x] & 0x00ffffffu) {
+                black = false;
+                break;
+            }
+        }
+    }
+    wl_shm_buffer_end_access(shm);
+    return black;
+}
+
+static void seen_buffer_destroyed(struct wl_listener *listener, void *data)
+{
+    (void)data;
+    SeenBuffer *b = wl_container_of(listener, b, destroy);
+    wl_list_remove(&b->link);
+    wl_list_remove(&b->destroy.link);
+    free(b);
+}
+
+static void note_buffer(MockComp *mc, struct wl_resource *buffer)
+{
+    SeenBuffer *b;
+    wl_list_for_each(b, &mc->buffers, link)
+        if (b->resource == buffer)
+            return;
+
+    b = calloc(1, sizeof(*b));
+    if (!b)
+        return;
+    b->resource = buffer;
+    b->destroy.notify = seen_buffer_destroyed;
+    wl_resource_add_destroy_listener(buffer, &b->destroy);
+    wl_list_insert(&mc->buffers, &b->link);
+
+    mc->stats.buffers++;
+    struct wl_shm_buffer *shm = wl_shm_buffer_get(buffer);
+    if (shm)
+        mc->stats.buffer_bytes += (uint64_t)wl_shm_buffer_get_stride(shm) *
+                                  (uint64_t)wl_shm_buffer_get_height(shm);
+}
+
+/* =========================================================================
+ * wl_surface / wl_region / wl_compositor
+ * ========================================================================= */
+
+static void surface_attach(struct wl_client *client,
+                           struct wl_resource *resource,
+                           struct wl_resource *buffer, int32_t x, int32_t y)
+{
+    (void)client; (void)x; (void)y;
+    Surface *s = wl_resource_get_user_data(resource);
+    s->pending_buffer = buffer;
+    s->pending_attach = true;
+}
+
+static void surface_damage(struct wl_client *client,
+                           struct wl_resource *resource,
+                           int32_t x, int32_t y, int32_t w, int32_t h)
+{
+    (void)client; (void)resource; (void)x; (void)y; (void)w; (void)h;
+}
+
+static void surface_frame(struct wl_client *client,
+                          struct wl_resource *resource, uint32_t callback)
+{
+    Surface *s = wl_resource_get_user_data(resource);
+    struct wl_resource *cb = wl_resource_create(client, &wl_callback_interface,
+                                                1, callback);
+    if (!cb) {
+        wl_client_post_no_memory(client);
+        return;
+    }
+    track_id(s->mc, cb);
+    wl_resource_set_implementation(cb, NULL,
+                                   res_add(&s->frame_callbacks, cb),
+                                   res_destroy);
+}
+
+static void surface_set_region(struct wl_client *client,
+                               struct wl_resource *resource,
+                               struct wl_resource *region)
+{
+    (void)client; (void)resource; (void)region;
+}
+
+/*
+ * Ausstehende Frame-Callbacks und Präsentationsrückmeldungen erfüllen.
+ * Unsichtbare Surfaces bekommen (wie bei echten Compositors) keine
+ * Frame-Callbacks; ihre Rückmeldungen werden verworfen.
+ */
+static void surface_complete(Surface *s, bool presented)
+{
+    MockComp *mc = s->mc;
+    Res *r, *tmp;
+
+    if (presented) {
+        uint32_t ms = now_ms();
+        wl_list_for_each_safe(r, tmp, &s->frame_callbacks, link) {
+            wl_callback_send_done(r->resource, ms);
+            wl_resource_destroy(r->resource);
+        }
+    }
+
+    uint64_t t = now_ns();
+    wl_list_for_each_safe(r, tmp, &s->feedbacks, link) {
+        if (presented) {
+            if (s->layer && s->layer->output >= 0) {
+                Output *o = &mc->outputs[s->layer->output];
+                struct wl_client *c = wl_resource_get_client(r->resource);
+                Res *out;
+                wl_list_for_each(out, &o->resources, link)
+                    if (wl_resource_get_client(out->resource) == c)
+                        wp_presentation_feedback_send_sync_output(
+                            r->resource, out->resource);
+            }
+            uint64_t sec = t / 1000000000ull;
+            uint64_t seq = t / REFRESH_NS;
+            wp_presentation_feedback_send_presented(
+                r->resource, (uint32_t)(sec >> 32), (uint32_t)sec,
+                (uint32_t)(t % 1000000000ull), REFRESH_NS,
+                (uint32_t)(seq >> 32), (uint32_t)seq,
+                WP_PRESENTATION_FEEDBACK_KIND_VSYNC);
+        } else {
+            wp_presentation_feedback_send_discarded(r->resource);
+        }
+        wl_resource_destroy(r->resource);
+    }
+}
+
+/*
+ * Res-Einträge einer Liste lösen, ohne die Ressourcen zu zerstören. Beim
+ * Abbau eines Clients ist die Reihenfolge der Objektzerstörung beliebig;
+ * zurückbleibende Ressourcen dürfen danach nicht mehr auf uns verweisen.
+ */
+static void res_detach_all(struct wl_list *list)
+{
+    Res *r, *tmp;
+    wl_list_for_each_safe(r, tmp, list, link) {
+        wl_resource_set_user_data(r->resource, NULL);
+        wl_list_remove(&r->link);
+        free(r);
+    }
+}
+
+static void surface_commit(struct wl_client *client,
+                           struct wl_resource *resource)
+{
+    (void)client;
+    Surface *s = wl_resource_get_user_data(resource);
+    MockComp *mc = s->mc;
+    mc->stats.commits++;
+
+    bool had_buffer = s->has_buffer;
+    if (s->pending_attach) {
+        s->pending_attach = false;
+        s->has_buffer = s->pending_buffer != NULL;
+        if (s->pending_buffer) {
+            note_buffer(mc, s->pending_buffer);
+            if (mc->pixel_check)
+                mc->stats.last_black = buffer_is_black(s->pending_buffer);
+            /* Inhalt ist "dargestellt"; Puffer sofort zurückgeben */
+            wl_buffer_send_release(s->pending_buffer);
+        }
+        s->pending_buffer = NULL;
+    }
+
+    LayerSurface *ls = s->layer;
+    if (ls) {
+        if (s->has_buffer && !ls->acked) {
+            wl_resource_post_error(ls->resource,
+                                   ZWLR_LAYER_SURFACE_V1_ERROR_INVALID_SURFACE_STATE,
+                                   "buffer committed before ack_configure");
+            return;
+        }
+        if (had_buffer && !s->has_buffer) {
+            /*
+             * Null-Puffer: Layer-Surface ungemappt und wieder im
+             * Ausgangszustand; der nächste leere Commit löst ein neues
+             * configure aus.
+             */
+            ls->acked = false;
+            ls->last_serial = 0;
+        } else if (!ls->acked && !ls->closed && ls->last_serial == 0) {
+            /* Erster Commit ohne Puffer: initiales configure senden */
+            int w = 0, h = 0;
+            if (ls->output >= 0) {
+                w = mc->outputs[ls->output].width;
+                h = mc->outputs[ls->output].height;
+            }
+            ls->last_serial = wl_display_next_serial(mc->display);
+            zwlr_layer_surface_v1_send_configure(ls->resource, ls->last_serial,
+                                                 (uint32_t)w, (uint32_t)h);
+            mc->stats.configures_sent++;
+        }
+        set_mapped(s, s->has_buffer && !ls->closed);
+    }
+
+    surface_complete(s, s->mapped);
+}
+
+static void surface_set_buffer_transform(struct wl_client *client,
+                                         struct wl_resource *resource,
+                                         int32_t transform)
+{
+    (void)client; (void)resource; (void)transform;
+}
+
+static void surface_set_buffer_scale(struct wl_client *client,
+                                     struct wl_resource *resource,
+                                     int32_t scale)
+{
+    (void)client; (void)resource; (void)scale;
+}
+
+static const struct wl_surface_interface surface_impl = {
+    .destroy              = destroy_request,
+    .attach               = surface_attach,
+    .damage               = surface_damage,
+    .frame                = surface_frame,
+    .set_opaque_region    = surface_set_region,
+    .set_input_region     = surface_set_region,
+    .commit               = surface_commit,
+    .set_buffer_transform = surface_set_buffer_transform,
+    .set_buffer_scale     = surface_set_buffer_scale,
+    .damage_buffer        = surface_damage,
+};
+
+static void surface_destroy(struct wl_resource *resource)
+{
+    Surface *s = wl_resource_get_user_data(resource);
+    MockComp *mc = s->mc;
+
+    /* Kein leave an eine Surface schicken, die gerade verschwindet */
+    if (mc->focus == s)
+        mc->focus = NULL;
+    set_mapped(s, false);
+    res_detach_all(&s->frame_callbacks);
+    res_detach_all(&s->feedbacks);
+    if (s->layer)
+        s->layer->surface = NULL;
+    wl_list_remove(&s->link);
+    free(s);
+}
+
+static void region_add(struct wl_client *client, struct wl_resource *resource,
+                       int32_t x, int32_t y, int32_t w, int32_t h)
+{
+    (void)client; (void)resource; (void)x; (void)y; (void)w; (void)h;
+}
+
+static const struct wl_region_interface region_impl = {
+    .destroy  = destroy_request,
+    .add      = region_add,
+    .subtract = region_add,
+};
+
+static void compositor_create_surface(struct wl_client *client,
+                                      struct wl_resource *resource,
+                                      uint32_t id)
+{
+    MockComp *mc = wl_resource_get_user_data(resource);
+    Surface *s = calloc(1, sizeof(*s));
+    struct wl_resource *sr = s ? wl_resource_create(client,
+                                     &wl_surface_interface,
+                                     wl_resource_get_version(resource), id)
+                               : NULL;
+    if (!sr) {
+        free(s);
+        wl_client_post_no_memory(client);
+        return;
+    }
+    track_id(mc, sr);
+    s->mc = mc;
+    s->resource = sr;
+    wl_list_init(&s->frame_callbacks);
+    wl_list_init(&s->feedbacks);
+    wl_list_insert(&mc->surfaces, &s->link);
+    wl_resource_set_implementation(sr, &surface_impl, s, surface_destroy);
+}
+
+static void compositor_create_region(struct wl_client *client,
+                                     struct wl_resource *resource,
+                                     uint32_t id)
+{
+    MockComp *mc = wl_resource_get_user_data(resource);
+    struct wl_resource *rr = wl_resource_create(client, &wl_region_interface,
+                                                1, id);
+    if (!rr) {
+        wl_client_post_no_memory(client);
+        return;
+    }
+    track_id(mc, rr);
+    wl_resource_set_implementation(rr, &region_impl, NULL, NULL);
+}
+
+static const struct wl_compositor_interface compositor_impl = {
+    .create_surface = compositor_create_surface,
+    .create_region  = compositor_create_region,
+};
+
+static void compositor_bind(struct wl_client *client, void *data,
+                            uint32_t version, uint32_t id)
+{
+    MockComp *mc = data;
+    struct wl_resource *r = wl_resource_create(client,
+                                               &wl_compositor_interface,
+                                               (int)version, id);
+    if (!r) {
+        wl_client_post_no_memory(client);
+        return;
+    }
+    track_id(mc, r);
+    wl_resource_set_implementation(r, &compositor_impl, mc, NULL);
+}
+
+/* =========================================================================
+ * wl_seat mit Tastatur und Maus
+ * ========================================================================= */
+
+static void seat_get_pointer(struct wl_client *client,
+                             struct wl_resource *resource, uint32_t id)
+{
+    MockComp *mc = ((Seat *)wl_resource_get_user_data(resource))->mc;
+    struct wl_resource *r = wl_resource_create(client, &wl_pointer_interface,
+                                               wl_resource_get_version(resource),
+                                               id);
+    if (!r) {
+        wl_client_post_no_memory(client);
+        return;
+    }
+    track_id(mc, r);
+    mc->stats.pointers_bound++;
+    wl_resource_set_implementation(r, NULL, res_add(&mc->pointers, r),
+                                   res_destroy);
+}
+
+static void seat_get_keyboard(struct wl_client *client,
+                              struct wl_resource *resource, uint32_t id)
+{
+    MockComp *mc = ((Seat *)wl_resource_get_user_data(resource))->mc;
+    struct wl_resource *r = wl_resource_create(client, &wl_keyboard_interface,
+                                               wl_resource_get_version(resource),
+                                               id);
+    if (!r) {
+        wl_client_post_no_memory(client);
+        return;
+    }
+    track_id(mc, r);
+    mc->stats.keyboards_bound++;
+    wl_resource_set_implementation(r, NULL, res_add(&mc->keyboards, r),
+                                   res_destroy);
+
+    /* Keine Keymap: leere Datei mit Format no_keymap */
+    int fd = memfd_create("mockcomp-keymap", MFD_CLOEXEC);
+    if (fd >= 0) {
+        wl_keyboard_send_keymap(r, WL_KEYBOARD_KEYMAP_FORMAT_NO_KEYMAP, fd, 0);
+        close(fd);
+    }
+    if (wl_resource_get_version(r) >= 4)
+        wl_keyboard_send_repeat_info(r, 0, 0);
+}
+
+static void seat_get_touch(struct wl_client *client,
+                           struct wl_resource *resource, uint32_t id)
+{
+    /* Keine Touch-Fähigkeit angekündigt; trotzdem gültiges Objekt liefern */
+    struct wl_resource *r = wl_resource_create(client, &wl_touch_interface,
+                                               wl_resource_get_version(resource),
+                                               id);
+    if (!r) {
+        wl_client_post_no_memory(client);
+        return;
+    }
+    wl_resource_set_implementation(r, NULL, NULL, NULL);
+}
+
+static const struct wl_seat_interface seat_impl = {
+    .get_pointer  = seat_get_pointer,
+    .get_keyboard = seat_get_keyboard,
+    .get_touch    = seat_get_touch,
+    .release      = destroy_request,
+};
+
+static void seat_destroy(struct wl_resource *resource)
+{
+    wl_list_remove(wl_resource_get_link(resource));
+}
+
+static void seat_bind(struct wl_client *client, void *data,
+                      uint32_t version, uint32_t id)
+{
+    Seat     *seat = data;
+    MockComp *mc   = seat->mc;
+    struct wl_resource *r = wl_resource_create(client, &wl_seat_interface,
+                                               (int)version, id);
+    if (!r) {
+        wl_client_post_no_memory(client);
+        return;
+    }
+    track_id(mc, r);
+    wl_resource_set_implementation(r, &seat_impl, seat, seat_destroy);
+    wl_list_insert(mc->seats.prev, wl_resource_get_link(r));
+    wl_seat_send_capabilities(r, mc->capabilities);
+    if (version >= 2)
+        wl_seat_send_name(r, seat->name);
+}
+
+/* =========================================================================
+ * wl_output
+ * ========================================================================= */
+
+static const struct wl_output_interface output_impl = {
+    .release = destroy_request,
+};
+
+static void output_bind(struct wl_client *client, void *data,
+                        uint32_t version, uint32_t id)
+{
+    Output *o = data;
+    struct wl_resource *r = wl_resource_create(client, &wl_output_interface,
+                                               (int)version, id);
+    if (!r) {
+        wl_client_post_no_memory(client);
+        return;
+    }
+    wl_resource_set_implementation(r, &output_impl, res_add(&o->resources, r),
+                                   res_destroy);
+
+    wl_output_send_geometry(r, 0, 0, 0, 0, WL_OUTPUT_SUBPIXEL_UNKNOWN,
+                            "mockcomp", "virtual", WL_OUTPUT_TRANSFORM_NORMAL);
+    wl_output_send_mode(r, WL_OUTPUT_MODE_CURRENT | WL_OUTPUT_MODE_PREFERRED,
+                        o->width, o->height, REFRESH_MHZ);
+    if (version >= 2) {
+        wl_output_send_scale(r, 1);
+        wl_output_send_done(r);
+    }
+}
+
+static int output_index(MockComp *mc, struct wl_resource *resource)
+{
+    if (!resource)
+        return -1;
+    for (int i = 0; i < MOCK_MAX_OUTPUTS; i++) {
+        Res *r;
+        wl_list_for_each(r, &mc->outputs[i].resources, link)
+            if (r->resource == resource)
+                return i;
+    }
+    return -1;
+}
+
+static int first_output(MockComp *mc)
+{
+    for (int i = 0; i < MOCK_MAX_OUTPUTS; i++)
+        if (mc->outputs[i].present)
+            return i;
+    return -1;
+}
+
+/* =========================================================================
+ * zwlr_layer_shell_v1
+ * ========================================================================= */
+
+static void layer_set_size(struct wl_client *client,
+                           struct wl_resource *resource,
+                           uint32_t width, uint32_t height)
+{
+    (void)client; (void)resource; (void)width; (void)height;
+}
+
+static void layer_set_anchor(struct wl_client *client,
+                             struct wl_resource *resource, uint32_t anchor)
+{
+    (void)client; (void)resource; (void)anchor;
+}
+
+static void layer_set_int(struct wl_client *client,
+                          struct wl_resource *resource, int32_t value)
+{
+    (void)client; (void)resource; (void)value;
+}
+
+static void layer_set_margin(struct wl_client *client,
+                             struct wl_resource *resource,
+                             int32_t top, int32_t right,
+                             int32_t bottom, int32_t left)
+{
+    (void)client; (void)resource;
+    (void)top; (void)right; (void)bottom; (void)left;
+}
+
+static void layer_set_uint(struct wl_client *client,
+                           struct wl_resource *resource, uint32_t value)
+{
+    (void)client; (void)resource; (void)value;
+}
+
+static void layer_get_popup(struct wl_client *client,
+                            struct wl_resource *resource,
+                            struct wl_resource *popup)
+{
+    (void)client; (void)resource; (void)popup;
+}
+
+static void layer_ack_configure(struct wl_client *client,
+                                struct wl_resource *resource, uint32_t serial)
+{
+    (void)client;
+    LayerSurface *ls = wl_resource_get_user_data(resource);
+    if (serial == 0 || serial > ls->last_serial) {
+        wl_resource_post_error(resource,
+                               ZWLR_LAYER_SURFACE_V1_ERROR_INVALID_SURFACE_STATE,
+                               "ack_configure with unknown serial %u", serial);
+        return;
+    }
+    ls->acked = true;
+}
+
+static const struct zwlr_layer_surface_v1_interface layer_surface_impl = {
+    .set_size                   = layer_set_size,
+    .set_anchor                 = layer_set_anchor,
+    .set_exclusive_zone         = layer_set_int,
+    .set_margin                 = layer_set_margin,
+    .set_keyboard_interactivity = layer_set_uint,
+    .get_popup                  = layer_get_popup,
+    .ack_configure              = layer_ack_configure,
+    .destroy                    = destroy_request,
+    .set_layer                  = layer_set_uint,
+};
+
+static void layer_surface_destroy(struct wl_resource *resource)
+{
+    LayerSurface *ls = wl_resource_get_user_data(resource);
+    MockComp *mc = ls->mc;
+
+    if (ls->surface) {
+        set_mapped(ls->surface, false);
+        ls->surface->layer = NULL;
+    }
+    mc->stats.layer_surfaces--;
+    wl_list_remove(&ls->link);
+    free(ls);
+}
+
+static void layer_shell_get_layer_surface(struct wl_client *client,
+                                          struct wl_resource *resource,
+                                          uint32_t id,
+                                          struct wl_resource *surface,
+                                          struct wl_resource *output,
+                                          uint32_t layer,
+                                          const char *namespace)
+{
+    (void)layer; (void)namespace;
+    MockComp *mc = wl_resource_get_user_data(resource);
+    Surface *s = wl_resource_get_user_data(surface);
+
+    if (s->layer || s->has_buffer) {
+        wl_resource_post_error(resource,
+                               ZWLR_LAYER_SHELL_V1_ERROR_ALREADY_CONSTRUCTED,
+                               "surface already has a role or a buffer");
+        return;
+    }
+
+    LayerSurface *ls = calloc(1, sizeof(*ls));
+    struct wl_resource *r = ls ? wl_resource_create(client,
+                                     &zwlr_layer_surface_v1_interface,
+                                     wl_resource_get_version(resource), id)
+                               : NULL;
+    if (!r) {
+        free(ls);
+        wl_client_post_no_memory(client);
+        return;
+    }
+    track_id(mc, r);
+    ls->mc = mc;
+    ls->resource = r;
+    ls->surface = s;
+    ls->output = output ? output_index(mc, output) : first_output(mc);
+    s->layer = ls;
+    wl_list_insert(&mc->layers, &ls->link);
+    mc->stats.layer_surfaces++;
+    wl_resource_set_implementation(r, &layer_surface_impl, ls,
+                                   layer_surface_destroy);
+
+    /* Ohne Ausgabe kann die Surface nie erscheinen */
+    if (ls->output < 0) {
+        ls->closed = true;
+        zwlr_layer_surface_v1_send_closed(r);
+    }
+}
+
+static const struct zwlr_layer_shell_v1_interface layer_shell_impl = {
+    .get_layer_surface = layer_shell_get_layer_surface,
+    .destroy           = destroy_request,
+};
+
+static void layer_shell_bind(struct wl_client *client, void *data,
+                             uint32_t version, uint32_t id)
+{
+    MockComp *mc = data;
+    struct wl_resource *r = wl_resource_create(client,
+                                               &zwlr_layer_shell_v1_interface,
+                                               (int)version, id);
+    if (!r) {
+        wl_client_post_no_memory(client);
+        return;
+    }
+    track_id(mc, r);
+    wl_resource_set_implementation(r, &layer_shell_impl, mc, NULL);
+}
+
+/* =========================================================================
+ * ext_idle_notifier_v1
+ * ========================================================================= */
+
+static const struct ext_idle_notification_v1_interface notification_impl = {
+    .destroy = destroy_request,
+};
+
+static void notification_destroy(struct wl_resource *resource)
+{
+    Notification *n = wl_resource_get_user_data(resource);
+    if (!n)
+        return;
+    wl_list_remove(&n->link);
+    free(n);
+}
+
+static void notifier_get_idle_notification(struct wl_client *client,
+                                           struct wl_resource *resource,
+                                           uint32_t id, uint32_t timeout,
+                                           struct wl_resource *seat)
+{
+    (void)timeout;
+    MockComp *mc = wl_resource_get_user_data(resource);
+    Notification *n = calloc(1, sizeof(*n));
+    struct wl_resource *r = n ? wl_resource_create(client,
+                                    &ext_idle_notification_v1_interface,
+                                    wl_resource_get_version(resource), id)
+                              : NULL;
+    if (!r) {
+        free(n);
+        wl_client_post_no_memory(client);
+        return;
+    }
+    track_id(mc, r);
+    n->resource = r;
+    n->seat     = wl_resource_get_user_data(seat);
+    wl_list_insert(mc->notifications.prev, &n->link);
+    wl_resource_set_implementation(r, &notification_impl, n,
+                                   notification_destroy);
+    if (n->seat->idle)
+        ext_idle_notification_v1_send_idled(r);
+}
+
+static const struct ext_idle_notifier_v1_interface notifier_impl = {
+    .destroy               = destroy_request,
+    .get_idle_notification = notifier_get_idle_notification,
+};
+
+static void notifier_bind(struct wl_client *client, void *data,
+                          uint32_t version, uint32_t id)
+{
+    MockComp *mc = data;
+    struct wl_resource *r = wl_resource_create(client,
+                                               &ext_idle_notifier_v1_interface,
+                                               (int)version, id);
+    if (!r) {
+        wl_client_post_no_memory(client);
+        return;
+    }
+    track_id(mc, r);
+    wl_resource_set_implementation(r, &notifier_impl, mc, NULL);
+}
+
+/* =========================================================================
+ * wp_presentation
+ * ========================================================================= */
+
+static void presentation_feedback(struct wl_client *client,
+                                  struct wl_resource *resource,
+                                  struct wl_resource *surface, uint32_t id)
+{
+    MockComp *mc = wl_resource_get_user_data(resource);
+    Surface *s = wl_resource_get_user_data(surface);
+    struct wl_resource *r = wl_resource_create(client,
+                                               &wp_presentation_feedback_interface,
+                                               1, id);
+    if (!r) {
+        wl_client_post_no_memory(client);
+        return;
+    }
+    track_id(mc, r);
+    wl_resource_set_implementation(r, NULL, res_add(&s->feedbacks, r),
+                                   res_destroy);
+}
+
+static const struct wp_presentation_interface presentation_impl = {
+    .destroy  = destroy_request,
+    .feedback = presentation_feedback,
+};
+
+static void presentation_bind(struct wl_client *client, void *data,
+                              uint32_t version, uint32_t id)
+{
+    MockComp *mc = data;
+    struct wl_resource *r = wl_resource_create(client,
+                                               &wp_presentation_interface,
+                                               (int)version, id);
+    if (!r) {
+        wl_client_post_no_memory(client);
+        return;
+    }
+    track_id(mc, r);
+    wl_resource_set_implementation(r, &presentation_impl, mc, NULL);
+    wp_presentation_send_clock_id(r, CLOCK_MONOTONIC);
+}
+
+/* =========================================================================
+ * wp_viewporter
+ * =========================================================================
+ * Skalierung wird nicht ausgewertet; die Objekte existieren nur, damit
+ * Clients mit kleinem Puffer und Viewport (blkout --strategy small) laufen.
+ */
+
+static void viewport_set_source(struct wl_client *client,
+                                struct wl_resource *resource,
+                                wl_fixed_t x, wl_fixed_t y,
+                                wl_fixed_t width, wl_fixed_t height)
+{
+    (void)client; (void)resource; (void)x; (void)y; (void)width; (void)height;
+}
+
+static void viewport_set_destination(struct wl_client *client,
+                                     struct wl_resource *resource,
+                                     int32_t width, int32_t height)
+{
+    (void)client;
+    if ((width <= 0 || height <= 0) && !(width == -1 && height == -1))
+        wl_resource_post_error(resource, WP_VIEWPORT_ERROR_BAD_VALUE,
+                               "invalid destination %dx%d", width, height);
+}
+
+static const struct wp_viewport_interface viewport_impl = {
+    .destroy         = destroy_request,
+    .set_source      = viewport_set_source,
+    .set_destination = viewport_set_destination,
+};
+
+static void viewporter_get_viewport(struct wl_client *client,
+                                    struct wl_resource *resource,
+                                    uint32_t id, struct wl_resource *surface)
+{
+    (void)surface;
+    MockComp *mc = wl_resource_get_user_data(resource);
+    struct wl_resource *r = wl_resource_create(client, &wp_viewport_interface,
+                                               1, id);
+    if (!r) {
+        wl_client_post_no_memory(client);
+        return;
+    }
+    track_id(mc, r);
+    wl_resource_set_implementation(r, &viewport_impl, NULL, NULL);
+}
+
+static const struct wp_viewporter_interface viewporter_impl = {
+    .destroy      = destroy_request,
+    .get_viewport = viewporter_get_viewport,
+};
+
+static void viewporter_bind(struct wl_client *client, void *data,
+                            uint32_t version, uint32_t id)
+{
+    MockComp *mc = data;
+    struct wl_resource *r = wl_resource_create(client, &wp_viewporter_interface,
+                                               (int)version, id);
+    if (!r) {
+        wl_client_post_no_memory(client);
+        return;
+    }
+    track_id(mc, r);
+    wl_resource_set_implementation(r, &viewporter_impl, mc, NULL);
+}
+
+/* =========================================================================
+ * Clients
+ * ========================================================================= */
+
+typedef struct {
+    MockComp          *mc;
+    struct wl_listener destroy;
+} ClientData;
+
+static void client_destroyed(struct wl_listener *listener, void *data)
+{
+    (void)data;
+    ClientData *cd = wl_container_of(listener, cd, destroy);
+    cd->mc->stats.clients--;
+    wl_list_remove(&cd->destroy.link);
+    free(cd);
+}
+
+static void client_created(struct wl_listener *listener, void *data)
+{
+    MockComp *mc = wl_container_of(listener, mc, client_created);
+    struct wl_client *client = data;
+    ClientData *cd = calloc(1, sizeof(*cd));
+    if (!cd)
+        return;
+    cd->mc = mc;
+    cd->destroy.notify = client_destroyed;
+    wl_client_add_destroy_listener(client, &cd->destroy);
+    wl_client_get_credentials(client, &mc->stats.client_pid, NULL, NULL);
+    mc->stats.clients++;
+}
+
+/* Jeden vom Client empfangenen Request zählen, gleich welcher Art */
+static void log_message(void *data, enum wl_protocol_logger_type type,
+                        const struct wl_protocol_logger_message *message)
+{
+    (void)message;
+    MockComp *mc = data;
+    if (type == WL_PROTOCOL_LOGGER_REQUEST)
+        mc->stats.requests++;
+}
+
+/* Festes Global anlegen und für mock_hide_global() merken */
+static bool add_global(MockComp *mc, const struct wl_interface *interface,
+                       int version, wl_global_bind_func_t bind)
+{
+    if (mc->nglobals >= MOCK_MAX_GLOBALS)
+        return false;
+    struct wl_global *g = wl_global_create(mc->display, interface, version,
+                                           mc, bind);
+    if (!g)
+        return false;
+    mc->globals[mc->nglobals++] = g;
+    return true;
+}
+
+/* =========================================================================
+ * Öffentliche Schnittstelle
+ * ========================================================================= */
+
+MockComp *mock_create(void)
+{
+    MockComp *mc = calloc(1, sizeof(*mc));
+    if (!mc)
+        return NULL;
+
+    const char *tmp = getenv("TMPDIR");
+    snprintf(mc->runtime_dir, sizeof(mc->runtime_dir), "%s/mockcomp-XXXXXX",
+             (tmp && strlen(tmp) < 40) ? tmp : "/tmp");
+    if (!mkdtemp(mc->runtime_dir)) {
+        perror("mkdtemp");
+        free(mc);
+        return NULL;
+    }
+    setenv("XDG_RUNTIME_DIR", mc->runtime_dir, 1);
+
+    mc->pixel_check = true;
+    mc->capabilities = WL_SEAT_CAPABILITY_POINTER | WL_SEAT_CAPABILITY_KEYBOARD;
+    wl_list_init(&mc->surfaces);
+    wl_list_init(&mc->layers);
+    wl_list_init(&mc->keyboards);
+    wl_list_init(&mc->pointers);
+    wl_list_init(&mc->seats);
+    wl_list_init(&mc->notifications);
+    wl_list_init(&mc->buffers);
+    for (int i = 0; i < MOCK_MAX_OUTPUTS; i++)
+        wl_list_init(&mc->outputs[i].resources);
+
+    mc->display = wl_display_create();
+    if (!mc->display)
+        goto fail;
+    mc->loop = wl_display_get_event_loop(mc->display);
+
+    mc->socket = wl_display_add_socket_auto(mc->display);
+    if (!mc->socket) {
+        fprintf(stderr, "mockcomp: Socket konnte nicht angelegt werden\n");
+        goto fail;
+    }
+
+    mc->client_created.notify = client_created;
+    wl_display_add_client_created_listener(mc->display, &mc->client_created);
+    mc->logger = wl_display_add_protocol_logger(mc->display, log_message, mc);
+
+    if (wl_display_init_shm(mc->display) != 0 ||
+        !add_global(mc, &wl_compositor_interface, COMPOSITOR_VERSION,
+                    compositor_bind) ||
+        mock_add_seat(mc, "seat0") < 0 ||
+        !add_global(mc, &zwlr_layer_shell_v1_interface, LAYER_SHELL_VERSION,
+                    layer_shell_bind) ||
+        !add_global(mc, &ext_idle_notifier_v1_interface, IDLE_VERSION,
+                    notifier_bind) ||
+        !add_global(mc, &wp_presentation_interface, PRESENTATION_VERSION,
+                    presentation_bind) ||
+        !add_global(mc, &wp_viewporter_interface, VIEWPORTER_VERSION,
+                    viewporter_bind)) {
+        fprintf(stderr, "mockcomp: Globals konnten nicht angelegt werden\n");
+        goto fail;
+    }
+    return mc;
+
+fail:
+    mock_destroy(mc);
+    return NULL;
+}
+
+void mock_destroy(MockComp *mc)
+{
+    if (!mc)
+        return;
+    if (mc->display) {
+        if (mc->logger)
+            wl_protocol_logger_destroy(mc->logger);
+        wl_display_destroy_clients(mc->display);
+        wl_display_destroy(mc->display);
+    }
+    /* Von wl_display_destroy nicht entfernte Reste (z.B. fremde Dateien) */
+    rmdir(mc->runtime_dir);
+    free(mc);
+}
+
+const char *mock_socket(const MockComp *mc)
+{
+    return mc->socket;
+}
+
+const char *mock_runtime_dir(const MockComp *mc)
+{
+    return mc->runtime_dir;
+}
+
+void mock_set_pixel_check(MockComp *mc, bool enabled)
+{
+    mc->pixel_check = enabled;
+}
+
+int mock_add_output(MockComp *mc, int width, int height)
+{
+    for (int i = 0; i < MOCK_MAX_OUTPUTS; i++) {
+        Output *o = &mc->outputs[i];
+        if (o->present)
+            continue;
+        o->width = width;
+        o->height = height;
+        o->global = wl_global_create(mc->display, &wl_output_interface,
+                                     OUTPUT_VERSION, o, output_bind);
+        if (!o->global)
+            return -1;
+        o->present = true;
+        mc->stats.outputs++;
+        return i;
+    }
+    return -1;
+}
+
+void mock_remove_output(MockComp *mc, int index)
+{
+    if (index < 0 || index >= MOCK_MAX_OUTPUTS || !mc->outputs[index].present)
+        return;
+    Output *o = &mc->outputs[index];
+
+    /* Layer-Surfaces auf dieser Ausgabe schließen */
+    LayerSurface *ls;
+    wl_list_for_each(ls, &mc->layers, link) {
+        if (ls->output != index || ls->closed)
+            continue;
+        ls->closed = true;
+        ls->output = -1;
+        if (ls->surface)
+            set_mapped(ls->surface, false);
+        zwlr_layer_surface_v1_send_closed(ls->resource);
+    }
+
+    /* Bestehende wl_output-Ressourcen bleiben bis zum release des Clients */
+    res_detach_all(&o->resources);
+    wl_global_destroy(o->global);
+    o->global = NULL;
+    o->present = false;
+    mc->stats.outputs--;
+}
+
+void mock_configure(MockComp *mc, int width, int height)
+{
+    LayerSurface *ls;
+    wl_list_for_each(ls, &mc->layers, link) {
+        if (ls->closed || !ls->acked)
+            continue;
+        ls->last_serial = wl_display_next_serial(mc->display);
+        zwlr_layer_surface_v1_send_configure(ls->resource, ls->last_serial,
+                                             (uint32_t)width, (uint32_t)height);
+        mc->stats.configures_sent++;
+    }
+}
+
+int mock_add_seat(MockComp *mc, const char *name)
+{
+    for (int i = 0; i < MOCK_MAX_SEATS; i++) {
+        Seat *seat = &mc->seat_slots[i];
+        if (seat->present)
+            continue;
+        if (mc->nglobals >= MOCK_MAX_GLOBALS)
+            return -1;
+        *seat = (Seat){ .mc = mc };
+        snprintf(seat->name, sizeof(seat->name), "%s", name);
+        struct wl_global *g = wl_global_create(mc->display, &wl_seat_interface,
+                                               SEAT_VERSION, seat, seat_bind);
+        if (!g)
+            return -1;
+        mc->globals[mc->nglobals++] = g;
+        seat->present = true;
+        return i;
+    }
+    return -1;
+}
+
+void mock_set_seat_name(MockComp *mc, int seat, const char *name)
+{
+    if (seat < 0 || seat >= MOCK_MAX_SEATS || !mc->seat_slots[seat].present)
+        return;
+    snprintf(mc->seat_slots[seat].name, sizeof(mc->seat_slots[seat].name),
+             "%s", name);
+}
+
+int mock_find_seat(const MockComp *mc, const char *name)
+{
+    for (int i = 0; i < MOCK_MAX_SEATS; i++)
+        if (mc->seat_slots[i].present &&
+            strcmp(mc->seat_slots[i].name, name) == 0)
+            return i;
+    return -1;
+}
+
+/* idled bzw. resumed an die Notifications eines Seats, falls sich etwas ändert */
+static void seat_set_idle(Seat *seat, bool idle)
+{
+    if (!seat->present || seat->idle == idle)
+        return;
+    seat->idle = idle;
+    Notification *n;
+    wl_list_for_each(n, &seat->mc->notifications, link) {
+        if (n->seat != seat)
+            continue;
+        if (idle)
+            ext_idle_notification_v1_send_idled(n->resource);
+        else
+            ext_idle_notification_v1_send_resumed(n->resource);
+    }
+}
+
+void mock_idle(MockComp *mc)
+{
+    for (int i = 0; i < MOCK_MAX_SEATS; i++)
+        seat_set_idle(&mc->seat_slots[i], true);
+}
+
+void mock_resume(MockComp *mc)
+{
+    for (int i = 0; i < MOCK_MAX_SEATS; i++)
+        seat_set_idle(&mc->seat_slots[i], false);
+}
+
+void mock_idle_seat(MockComp *mc, int seat)
+{
+    if (seat >= 0 && seat < MOCK_MAX_SEATS)
+        seat_set_idle(&mc->seat_slots[seat], true);
+}
+
+void mock_resume_seat(MockComp *mc, int seat)
+{
+    if (seat >= 0 && seat < MOCK_MAX_SEATS)
+        seat_set_idle(&mc->seat_slots[seat], false);
+}
+
+void mock_hide_global(MockComp *mc, const char *interface)
+{
+    for (int i = 0; i < mc->nglobals; i++) {
+        struct wl_global *g = mc->globals[i];
+        if (!g || strcmp(wl_global_get_interface(g)->name, interface) != 0)
+            continue;
+        wl_global_destroy(g);
+        mc->globals[i] = NULL;
+    }
+}
+
+void mock_set_capabilities(MockComp *mc, uint32_t capabilities)
+{
+    mc->capabilities = capabilities;
+    struct wl_resource *r;
+    wl_resource_for_each(r, &mc->seats)
+        wl_seat_send_capabilities(r, capabilities);
+}
+
+void mock_close(MockComp *mc)
+{
+    LayerSurface *ls;
+    wl_list_for_each(ls, &mc->layers, link) {
+        if (ls->closed)
+            continue;
+        ls->closed = true;
+        if (ls->surface)
+            set_mapped(ls->surface, false);
+        zwlr_layer_surface_v1_send_closed(ls->resource);
+    }
+}
+
+void mock_restart(MockComp *mc)
+{
+    wl_display_destroy_clients(mc->display);
+    for (int i = 0; i < MOCK_MAX_SEATS; i++)
+        mc->seat_slots[i].idle = false;
+}
+
+void mock_set_pointer(MockComp *mc, double x, double y)
+{
+    mc->ptr_x = x;
+    mc->ptr_y = y;
+}
+
+/* Client der Surface mit Fokus, NULL = keine */
+static struct wl_client *focus_client(MockComp *mc)
+{
+    return mc->focus ? wl_resource_get_client(mc->focus->resource) : NULL;
+}
+
+void mock_key_event(MockComp *mc, uint32_t key, uint32_t state, uint32_t time)
+{
+    struct wl_client *client = focus_client(mc);
+    if (!client)
+        return;
+    Res *r;
+    wl_list_for_each(r, &mc->keyboards, link)
+        if (wl_resource_get_client(r->resource) == client)
+            wl_keyboard_send_key(r->resource,
+                                 wl_display_next_serial(mc->display),
+                                 time, key, state);
+}
+
+void mock_pointer_motion(MockComp *mc, double x, double y, uint32_t time)
+{
+    struct wl_client *client = focus_client(mc);
+    if (!client)
+        return;
+    Res *r;
+    wl_list_for_each(r, &mc->pointers, link)
+        if (wl_resource_get_client(r->resource) == client)
+            wl_pointer_send_motion(r->resource, time, wl_fixed_from_double(x),
+                                   wl_fixed_from_double(y));
+}
+
+void mock_pointer_button(MockComp *mc, uint32_t button, uint32_t state,
+                         uint32_t time)
+{
+    struct wl_client *client = focus_client(mc);
+    if (!client)
+        return;
+    Res *r;
+    wl_list_for_each(r, &mc->pointers, link)
+        if (wl_resource_get_client(r->resource) == client)
+            wl_pointer_send_button(r->resource,
+                                   wl_display_next_serial(mc->display),
+                                   time, button, state);
+}
+
+void mock_pointer_axis(MockComp *mc, uint32_t axis, double value,
+                       uint32_t time)
+{
+    struct wl_client *client = focus_client(mc);
+    if (!client)
+        return;
+    Res *r;
+    wl_list_for_each(r, &mc->pointers, link)
+        if (wl_resource_get_client(r->resource) == client)
+            wl_pointer_send_axis(r->resource, time, axis,
+                                 wl_fixed_from_double(value));
+}
+
+void mock_pointer_frame(MockComp *mc)
+{
+    struct wl_client *client = focus_client(mc);
+    if (!client)
+        return;
+    Res *r;
+    wl_list_for_each(r, &mc->pointers, link)
+        if (wl_resource_get_client(r->resource) == client &&
+            wl_resource_get_version(r->resource) >= 5)
+            wl_pointer_send_frame(r->resource);
+}
+
+void mock_key(MockComp *mc, uint32_t key)
+{
+    /* Jede Eingabe beendet auch den Leerlauf, wie bei einem echten Compositor */
+    mock_resume(mc);
+    uint32_t t = now_ms();
+    mock_key_event(mc, key, WL_KEYBOARD_KEY_STATE_PRESSED, t);
+    mock_key_event(mc, key, WL_KEYBOARD_KEY_STATE_RELEASED, t);
+}
+
+void mock_motion(MockComp *mc, double x, double y)
+{
+    mock_resume(mc);
+    mock_pointer_motion(mc, x, y, now_ms());
+    mock_pointer_frame(mc);
+}
+
+void mock_button(MockComp *mc, uint32_t button)
+{
+    mock_resume(mc);
+    uint32_t t = now_ms();
+    mock_pointer_button(mc, button, WL_POINTER_BUTTON_STATE_PRESSED, t);
+    mock_pointer_button(mc, button, WL_POINTER_BUTTON_STATE_RELEASED, t);
+    mock_pointer_frame(mc);
+}
+
+void mock_dispatch(MockComp *mc, int timeout_ms)
+{
+    wl_display_flush_clients(mc->display);
+    wl_event_loop_dispatch(mc->loop, timeout_ms);
+    wl_display_flush_clients(mc->display);
+}
+
+bool mock_wait_mapped(MockComp *mc, bool mapped, int timeout_ms)
+{
+    uint64_t deadline = now_ns() + (uint64_t)timeout_ms * 1000000ull;
+    for (;;) {
+        if ((mc->stats.mapped > 0) == mapped)
+            return true;
+        uint64_t now = now_ns();
+        if (now >= deadline)
+            return false;
+        mock_dispatch(mc, (int)((deadline - now + 999999ull) / 1000000ull));
+    }
+}
+
+const MockStats *mock_stats(const MockComp *mc)
+{
+    return &mc->stats;
+}
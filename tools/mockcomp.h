@@ -0,0 +1,151 @@
+/*
+ * mockcomp.h — Minimaler Wayland-Compositor für reproduzierbare Läufe
+ *
+ * Implementiert auf Basis von libwayland-server genau die Protokolle, die
+ * blkout verwendet: wl_compositor, wl_shm, wl_seat (auch mehrere) mit
+ * Tastatur und Maus, wl_output, zwlr_layer_shell_v1, ext_idle_notifier_v1,
+ * wp_presentation und wp_viewporter.
+ * Es wird nichts gezeichnet; der Compositor merkt sich nur, welche
+ * Layer-Surfaces gemappt sind, wann das geschah und ob der zuletzt
+ * eingereichte Puffer schwarz war.
+ *
+ * Der Socket wird in einem frisch angelegten temporären XDG_RUNTIME_DIR
+ * erzeugt, sodass keine laufende Sitzung berührt wird. Configure-Größen,
+ * idled/resumed, Eingaben und das An- und Abstecken von Ausgaben werden
+ * vom Aufrufer gesteuert (siehe mockcomp-run.c für die Skriptsprache).
+ */
+
+#ifndef BLKOUT_MOCKCOMP_H
+#define BLKOUT_MOCKCOMP_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <sys/types.h>
+
+typedef struct MockComp MockComp;
+
+/* Beobachteter Zustand des Clients */
+typedef struct {
+    int      outputs;           /* Aktuell angesteckte Ausgaben */
+    int      layer_surfaces;    /* Existierende Layer-Surfaces */
+    int      mapped;            /* Davon mit Puffer sichtbar */
+    uint64_t maps;              /* Übergänge nach "sichtbar" */
+    uint64_t unmaps;            /* Übergänge nach "nicht sichtbar" */
+    uint64_t last_map_ns;       /* CLOCK_MONOTONIC des letzten Mappens */
+    uint64_t last_unmap_ns;     /* CLOCK_MONOTONIC des letzten Unmappens */
+    uint64_t configures_sent;   /* Gesendete configure-Events */
+    uint64_t commits;           /* wl_surface.commit insgesamt */
+    uint64_t requests;          /* Vom Client empfangene Requests insgesamt */
+    uint64_t buffers;           /* Eingereichte, neue wl_buffer */
+    uint64_t buffer_bytes;      /* Deren Größe (stride * height) */
+    uint32_t max_object_id;     /* Höchste vom Client benutzte Objekt-ID */
+    bool     last_black;        /* Zuletzt eingereichter Puffer ganz schwarz */
+    pid_t    client_pid;        /* PID des (letzten) verbundenen Clients */
+    int      clients;           /* Aktuell verbundene Clients */
+    uint64_t keyboards_bound;   /* wl_seat.get_keyboard insgesamt */
+    uint64_t pointers_bound;    /* wl_seat.get_pointer insgesamt */
+} MockStats;
+
+/*
+ * Compositor anlegen: temporäres XDG_RUNTIME_DIR erzeugen, in der
+ * Prozessumgebung setzen und dort einen Socket öffnen. NULL bei Fehler.
+ */
+MockComp *mock_create(void);
+
+/* Compositor beenden, Socket und temporäres Verzeichnis entfernen */
+void mock_destroy(MockComp *mc);
+
+/* Name des Sockets (für WAYLAND_DISPLAY) und das temporäre Verzeichnis */
+const char *mock_socket(const MockComp *mc);
+const char *mock_runtime_dir(const MockComp *mc);
+
+/* Pixelprüfung auf Schwarz bei jedem Commit ein-/ausschalten (Standard: an) */
+void mock_set_pixel_check(MockComp *mc, bool enabled);
+
+/* Ausgabe anstecken; gibt ihre Nummer zurück (-1 bei Fehler) */
+int mock_add_output(MockComp *mc, int width, int height);
+
+/* Ausgabe abziehen; Layer-Surfaces darauf erhalten "closed" */
+void mock_remove_output(MockComp *mc, int index);
+
+/* Allen Layer-Surfaces ein configure mit dieser Größe schicken */
+void mock_configure(MockComp *mc, int width, int height);
+
+/*
+ * Weiteren wl_seat mit diesem Namen ankündigen; gibt seine Nummer zurück
+ * (-1 bei Fehler). Seat 0 ("seat0") besteht von Anfang an. Der Name lässt
+ * sich ändern, solange noch kein Client den Seat gebunden hat.
+ */
+int mock_add_seat(MockComp *mc, const char *name);
+void mock_set_seat_name(MockComp *mc, int seat, const char *name);
+
+/* Nummer des Seats mit diesem Namen, -1 = unbekannt */
+int mock_find_seat(const MockComp *mc, const char *name);
+
+/*
+ * Idle-Notifications: idled bzw. resumed an alle senden, oder nur an die
+ * für einen Seat angeforderten. Jeder Seat hat seinen eigenen Leerlauf.
+ */
+void mock_idle(MockComp *mc);
+void mock_resume(MockComp *mc);
+void mock_idle_seat(MockComp *mc, int seat);
+void mock_resume_seat(MockComp *mc, int seat);
+
+/*
+ * Festes Global (z.B. "wp_viewporter") zurückziehen, bevor ein Client sich
+ * verbindet — für Läufe, die einen Compositor ohne dieses Protokoll
+ * nachstellen. wl_shm lässt sich nicht zurückziehen.
+ */
+void mock_hide_global(MockComp *mc, const char *interface);
+
+/* Seat-Fähigkeiten ändern (Standard: Zeiger und Tastatur) und ankündigen */
+void mock_set_capabilities(MockComp *mc, uint32_t capabilities);
+
+/* Allen Layer-Surfaces "closed" schicken, ohne eine Ausgabe abzuziehen */
+void mock_close(MockComp *mc);
+
+/*
+ * Neustart des Compositors nachstellen: alle Clients trennen und den
+ * Leerlauf zurücksetzen. Socket, Globals und Ausgaben bleiben, wie bei
+ * einem Compositor, dessen Wrapper den Socket über Neustarts hält.
+ */
+void mock_restart(MockComp *mc);
+
+/*
+ * Eingaben an die gemappte Layer-Surface mit Fokus: Taste bzw. Maustaste
+ * drücken und loslassen, Bewegung, jeweils mit wl_pointer.frame. Jede
+ * Eingabe sendet vorher resumed an alle Seats, wie bei einem echten
+ * Compositor; zugestellt wird über die Tastaturen und Zeiger aller Seats.
+ */
+void mock_key(MockComp *mc, uint32_t key);
+void mock_motion(MockComp *mc, double x, double y);
+void mock_button(MockComp *mc, uint32_t button);
+
+/*
+ * Einzelne Eingabeereignisse mit vorgegebenem Zeitstempel (ms), ohne
+ * resumed und ohne abschließendes frame — zum Nachspielen mitgeschnittener
+ * Sitzungen (tools/replay.c). mock_set_pointer() legt die Position fest,
+ * mit der der Zeiger beim nächsten Fokuswechsel eintritt.
+ */
+void mock_set_pointer(MockComp *mc, double x, double y);
+void mock_key_event(MockComp *mc, uint32_t key, uint32_t state, uint32_t time);
+void mock_pointer_motion(MockComp *mc, double x, double y, uint32_t time);
+void mock_pointer_button(MockComp *mc, uint32_t button, uint32_t state,
+                         uint32_t time);
+void mock_pointer_axis(MockComp *mc, uint32_t axis, double value,
+                       uint32_t time);
+void mock_pointer_frame(MockComp *mc);
+
+/* Ereignisse bis zu timeout_ms Millisekunden verarbeiten (0 = nur Anstehendes) */
+void mock_dispatch(MockComp *mc, int timeout_ms);
+
+/*
+ * Verarbeiten, bis mindestens eine Layer-Surface gemappt (mapped = true)
+ * bzw. keine mehr gemappt ist. Gibt false bei Zeitüberschreitung zurück.
+ */
+bool mock_wait_mapped(MockComp *mc, bool mapped, int timeout_ms);
+
+/* Aktueller Beobachtungsstand */
+const MockStats *mock_stats(const MockComp *mc);
+
+#endif
@@ -0,0 +1,128 @@
+/*
+ * png2blk.c — PNG in das Standbildformat von blkout --image umwandeln
+ *
+ * Aufruf:
+ *   png2blk [--fit BxH] EINGABE.png AUSGABE.blk
+ *
+ * Schreibt die Pixel als XRGB8888 hinter den Kopf aus src/image.h, so wie
+ * blkout sie unverändert an den Compositor weiterreicht. Transparenz wird
+ * gegen Schwarz verrechnet. Mit --fit entsteht ein Bild der angegebenen
+ * Größe (z.B. der Bildschirmauflösung), in dessen Mitte das PNG steht;
+ * überstehende Ränder werden abgeschnitten. Ohne --fit streckt der
+ * Compositor das Bild per wp_viewporter auf die Ausgabe.
+ *
+ * Nur dieses Werkzeug verwendet libpng; blkout selbst dekodiert nichts.
+ */
+
+#define _GNU_SOURCE
+
+#include <png.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../src/image.h"
+
+#define SHM_FORMAT_XRGB8888 1
+
+static void usage(const char *prog)
+{
+    fprintf(stderr, "Aufruf: %s [--fit BxH] EINGABE.png AUSGABE.blk\n", prog);
+}
+
+int main(int argc, char *argv[])
+{
+    const char *in = NULL, *out = NULL;
+    int fit_w = 0, fit_h = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--fit") == 0 && i + 1 < argc) {
+            if (sscanf(argv[++i], "%dx%d", &fit_w, &fit_h) != 2 ||
+                fit_w <= 0 || fit_h <= 0 ||
+                fit_w > IMAGE_MAX_SIDE || fit_h > IMAGE_MAX_SIDE) {
+                fprintf(stderr, "Ungültige Größe für --fit: %s\n", argv[i]);
+                return 2;
+            }
+        } else if (!in && argv[i][0] != '-') {
+            in = argv[i];
+        } else if (!out && argv[i][0] != '-') {
+            out = argv[i];
+        } else {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+    if (!in || !out) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    /* PNG als BGRA lesen: im Speicher dieselbe Byte-Folge wie ARGB8888 */
+    png_image png = { .version = PNG_IMAGE_VERSION };
+    if (!png_image_begin_read_from_file(&png, in)) {
+        fprintf(stderr, "%s: %s\n", in, png.message);
+        return 1;
+    }
+    png.format = PNG_FORMAT_BGRA;
+    if (png.width > IMAGE_MAX_SIDE || png.height > IMAGE_MAX_SIDE) {
+        fprintf(stderr, "%s: %ux%u ist zu groß\n", in, png.width, png.height);
+        png_image_free(&png);
+        return 1;
+    }
+    uint32_t *src = malloc(PNG_IMAGE_SIZE(png));
+    if (!src || !png_image_finish_read(&png, NULL, src, 0, NULL)) {
+        fprintf(stderr, "%s: %s\n", in, src ? png.message : "kein Speicher");
+        free(src);
+        return 1;
+    }
+
+    int w = fit_w ? fit_w : (int)png.width;
+    int h = fit_h ? fit_h : (int)png.height;
+    uint32_t *dst = calloc((size_t)w * (size_t)h, 4);
+    if (!dst) {
+        perror("calloc");
+        free(src);
+        return 1;
+    }
+
+    /* Mittig platzieren, Alpha gegen Schwarz verrechnen */
+    int dx = (w - (int)png.width) / 2;
+    int dy = (h - (int)png.height) / 2;
+    for (int y = 0; y < (int)png.height; y++) {
+        if (y + dy < 0 || y + dy >= h)
+            continue;
+        for (int x = 0; x < (int)png.width; x++) {
+            if (x + dx < 0 || x + dx >= w)
+                continue;
+            uint32_t p = src[(size_t)y * png.width + (size_t)x];
+            uint32_t a = p >> 24;
+            uint32_t r = ((p >> 16) & 0xFF) * a / 255;
+            uint32_t g = ((p >> 8) & 0xFF) * a / 255;
+            uint32_t b = (p & 0xFF) * a / 255;
+            dst[(size_t)(y + dy) * (size_t)w + (size_t)(x + dx)] =
+                (r << 16) | (g << 8) | b;
+        }
+    }
+    free(src);
+
+    ImageHeader hdr = {
+        .width  = (uint32_t)w,
+        .height = (uint32_t)h,
+        .stride = (uint32_t)w * 4,
+        .format = SHM_FORMAT_XRGB8888,
+        .offset = sizeof(ImageHeader),
+    };
+    memcpy(hdr.magic, IMAGE_MAGIC, sizeof(hdr.magic));
+    FILE *f = fopen(out, "wb");
+    if (!f || fwrite(&hdr, sizeof(hdr), 1, f) != 1 ||
+        fwrite(dst, 4, (size_t)w * (size_t)h, f) != (size_t)w * (size_t)h ||
+        fclose(f) != 0) {
+        perror(out);
+        free(dst);
+        return 1;
+    }
+    free(dst);
+    printf("%s: %dx%d XRGB8888, %zu Bytes\n", out, w, h,
+           sizeof(hdr) + (size_t)w * (size_t)h * 4);
+    return 0;
+}
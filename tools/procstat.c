@@ -0,0 +1,137 @@
+/*
+ * procstat.c — Kennzahlen eines fremden Prozesses aus /proc
+ */
+
+#define _GNU_SOURCE
+
+#include <dirent.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "procstat.h"
+
+uint64_t proc_cpu_ns(pid_t pid)
+{
+    char path[64];
+    unsigned long long ns = 0;
+
+    /* schedstat: erste Zahl = Laufzeit in ns (fein aufgelöst) */
+    snprintf(path, sizeof(path), "/proc/%d/schedstat", (int)pid);
+    FILE *f = fopen(path, "r");
+    if (f) {
+        int n = fscanf(f, "%llu", &ns);
+        fclose(f);
+        if (n == 1)
+            return ns;
+    }
+
+    /* Rückfall: utime + stime aus stat, in Clock-Ticks */
+    snprintf(path, sizeof(path), "/proc/%d/stat", (int)pid);
+    f = fopen(path, "r");
+    if (!f)
+        return 0;
+    char buf[1024];
+    size_t len = fread(buf, 1, sizeof(buf) - 1, f);
+    fclose(f);
+    buf[len] = '\0';
+    char *p = strrchr(buf, ')');
+    unsigned long ut = 0, st = 0;
+    if (p && sscanf(p + 2, "%*c %*d %*d %*d %*d %*d %*u %*u %*u %*u %*u %lu %lu",
+                    &ut, &st) == 2)
+        return (uint64_t)(ut + st) * 1000000000ull /
+               (uint64_t)sysconf(_SC_CLK_TCK);
+    return 0;
+}
+
+long proc_status_kb(pid_t pid, const char *field)
+{
+    char path[64], line[256];
+    long kb = -1;
+    snprintf(path, sizeof(path), "/proc/%d/status", (int)pid);
+    FILE *f = fopen(path, "r");
+    if (!f)
+        return -1;
+    size_t flen = strlen(field);
+    while (fgets(line, sizeof(line), f)) {
+        if (strncmp(line, field, flen) == 0) {
+            kb = strtol(line + flen, NULL, 10);
+            break;
+        }
+    }
+    fclose(f);
+    return kb;
+}
+
+/* Beide ctxt_switches-Felder einer status-Datei addieren */
+static long status_ctxt_switches(const char *path)
+{
+    char line[256];
+    long n = 0;
+    FILE *f = fopen(path, "r");
+    if (!f)
+        return -1;
+    while (fgets(line, sizeof(line), f)) {
+        if (strncmp(line, "voluntary_ctxt_switches:", 24) == 0)
+            n += strtol(line + 24, NULL, 10);
+        else if (strncmp(line, "nonvoluntary_ctxt_switches:", 27) == 0)
+            n += strtol(line + 27, NULL, 10);
+    }
+    fclose(f);
+    return n;
+}
+
+long proc_ctxt_switches(pid_t pid)
+{
+    char path[64];
+    snprintf(path, sizeof(path), "/proc/%d/task", (int)pid);
+    DIR *d = opendir(path);
+    if (!d)
+        return -1;
+    long n = 0;
+    struct dirent *de;
+    while ((de = readdir(d))) {
+        if (de->d_name[0] == '.')
+            continue;
+        char status[300];
+        snprintf(status, sizeof(status), "/proc/%d/task/%s/status",
+                 (int)pid, de->d_name);
+        long t = status_ctxt_switches(status);
+        if (t > 0)
+            n += t;
+    }
+    closedir(d);
+    return n;
+}
+
+int proc_count_fds(pid_t pid)
+{
+    char path[64];
+    snprintf(path, sizeof(path), "/proc/%d/fd", (int)pid);
+    DIR *d = opendir(path);
+    if (!d)
+        return -1;
+    int n = 0;
+    struct dirent *de;
+    while ((de = readdir(d)))
+        if (de->d_name[0] != '.')
+            n++;
+    closedir(d);
+    return n;
+}
+
+int proc_count_maps(pid_t pid)
+{
+    char path[64];
+    snprintf(path, sizeof(path), "/proc/%d/maps", (int)pid);
+    FILE *f = fopen(path, "r");
+    if (!f)
+        return -1;
+    int n = 0, c;
+    while ((c = getc(f)) != EOF)
+        if (c == '\n')
+            n++;
+    fclose(f);
+    return n;
+}
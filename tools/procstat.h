@@ -0,0 +1,32 @@
+/*
+ * procstat.h — Kennzahlen eines fremden Prozesses aus /proc
+ *
+ * Gemeinsame Hilfsfunktionen der Werkzeuge unter tools/. Alle Funktionen
+ * geben bei Fehlern (Prozess beendet, /proc nicht lesbar) 0 bzw. -1 zurück.
+ */
+
+#ifndef BLKOUT_PROCSTAT_H
+#define BLKOUT_PROCSTAT_H
+
+#include <stdint.h>
+#include <sys/types.h>
+
+/* Verbrauchte CPU-Zeit in Nanosekunden (schedstat, sonst utime + stime) */
+uint64_t proc_cpu_ns(pid_t pid);
+
+/* Feld aus /proc/<pid>/status in kB, z.B. "VmRSS:" oder "VmHWM:" */
+long proc_status_kb(pid_t pid, const char *field);
+
+/*
+ * Kontextwechsel aller Threads (voluntary + nonvoluntary aus
+ * /proc/<pid>/task/<tid>/status); jedes Aufwachen aus poll() zählt mit
+ */
+long proc_ctxt_switches(pid_t pid);
+
+/* Anzahl offener Dateideskriptoren */
+int proc_count_fds(pid_t pid);
+
+/* Anzahl der Speicherbereiche (Zeilen in /proc/<pid>/maps) */
+int proc_count_maps(pid_t pid);
+
+#endif
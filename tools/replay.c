@@ -0,0 +1,501 @@
+/*
+ * replay.c — Mitschnitt von blkout --record gegen den Mock-Compositor abspielen
+ *
+ * Aufruf:
+ *   replay [--speed F] [--timeout MS] MITSCHNITT -- BLKOUT [ARGUMENTE...]
+ *
+ * Stellt den Compositor aus dem Mitschnitt nach (angekündigte Globals,
+ * Ausgaben, Seats mit ihren Namen, Seat-Fähigkeiten), startet BLKOUT dagegen und schickt die
+ * aufgezeichneten Ereignisse in ihrer ursprünglichen Reihenfolge und mit
+ * ihren Abständen (geteilt durch --speed, Standard 1; 0 = ohne Pausen)
+ * erneut. Sie landen so in denselben Listener-Tabellen von blkout wie im
+ * Feld (registry_listener, layer_surface_listener, keyboard_listener,
+ * pointer_listener, idle_notification_listener); die Zeitstempel der
+ * Eingaben behalten ihre aufgezeichneten Abstände. idled und resumed gehen
+ * nur an den Seat, der sie aufgezeichnet hat; Mitschnitte der Version 1
+ * ohne Seat-Namen schicken sie an alle.
+ *
+ * Stehen hinter BLKOUT keine Argumente, werden die aus dem Mitschnitt
+ * übernommen (Kopfzeile "# args"). Für Profiler lässt sich BLKOUT auch
+ * in einen anderen Befehl einbetten, z.B. "-- perf record ./blkout -s 5".
+ *
+ * Nicht nachgeschickt werden Ereignisse, die der Mock-Compositor selbst
+ * erzeugt: das erste configure nach show_overlay, enter/leave beim
+ * Fokuswechsel und closed nach dem Abziehen einer Ausgabe. An den Marken
+ * show_overlay und hide_overlay wird gewartet (höchstens --timeout ms,
+ * Standard 5000), bis das Overlay gemappt bzw. ungemappt ist. Bleibt das
+ * aus, verhält sich blkout anders als bei der Aufnahme; die Zeile wird
+ * gemeldet und am Ende mit Status 1 beendet.
+ */
+
+#define _GNU_SOURCE
+
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+#include "mockcomp.h"
+
+#define DEFAULT_TIMEOUT_MS 5000
+#define SLICE_MS           10
+#define SETTLE_MS          100
+#define MAX_ARGS           64
+#define DEFAULT_WIDTH      1920
+#define DEFAULT_HEIGHT     1080
+
+/* Eine Zeile des Mitschnitts */
+typedef struct {
+    uint64_t t_us;
+    char     name[48];
+    char     args[128];
+    int      line;
+    bool     setup;     /* Beim Aufbau des Compositors schon berücksichtigt */
+} Entry;
+
+/* Aufgezeichnete Ausgabe: Registry-Name im Feld → Index im Mock */
+typedef struct {
+    uint32_t name;
+    int      index;
+} OutputMap;
+
+static pid_t child = -1;
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static bool child_exited(void)
+{
+    if (child < 0)
+        return true;
+    if (waitpid(child, NULL, WNOHANG) == child) {
+        child = -1;
+        return true;
+    }
+    return false;
+}
+
+/* Ereignisse bis zum Zeitpunkt deadline (CLOCK_MONOTONIC, ns) verarbeiten */
+static void run_until(MockComp *mc, uint64_t deadline)
+{
+    for (;;) {
+        uint64_t now = now_ns();
+        if (now >= deadline)
+            break;
+        uint64_t left_ms = (deadline - now + 999999ull) / 1000000ull;
+        mock_dispatch(mc, left_ms < SLICE_MS ? (int)left_ms : SLICE_MS);
+        child_exited();
+    }
+    mock_dispatch(mc, 0);
+}
+
+/* =========================================================================
+ * Mitschnitt einlesen
+ * ========================================================================= */
+
+static Entry *read_log(const char *path, int *count, char *args, size_t len)
+{
+    FILE *f = fopen(path, "r");
+    if (!f) {
+        perror(path);
+        return NULL;
+    }
+
+    Entry *entries = NULL;
+    int n = 0, cap = 0, lineno = 0;
+    char line[256];
+    while (fgets(line, sizeof(line), f)) {
+        lineno++;
+        line[strcspn(line, "\r\n")] = '\0';
+        if (strncmp(line, "# args", 6) == 0) {
+            snprintf(args, len, "%s", line + 6);
+            continue;
+        }
+        if (line[0] == '#' || line[0] == '\0')
+            continue;
+
+        if (n == cap) {
+            cap = cap ? cap * 2 : 256;
+            Entry *grown = realloc(entries, (size_t)cap * sizeof(Entry));
+            if (!grown) {
+                free(entries);
+                fclose(f);
+                return NULL;
+            }
+            entries = grown;
+        }
+        Entry *e = &entries[n];
+        memset(e, 0, sizeof(*e));
+        unsigned long long t;
+        int off = 0;
+        if (sscanf(line, "%llu %47s %n", &t, e->name, &off) < 2) {
+            fprintf(stderr, "%s:%d: unlesbare Zeile\n", path, lineno);
+            continue;
+        }
+        e->t_us = t;
+        e->line = lineno;
+        snprintf(e->args, sizeof(e->args), "%s", line + off);
+        n++;
+    }
+    fclose(f);
+    *count = n;
+    return entries;
+}
+
+/* =========================================================================
+ * Compositor nachstellen
+ * ========================================================================= */
+
+/* Protokolle, die der Mock anbietet und die im Feld fehlen können */
+static const char *optional_globals[] = {
+    "wl_compositor", "wl_seat", "zwlr_layer_shell_v1",
+    "ext_idle_notifier_v1", "wp_presentation", "wp_viewporter",
+};
+
+/*
+ * Seats aus den idled/resumed-Ereignissen ankündigen: der erste benennt
+ * den immer vorhandenen Seat 0 um, jeder weitere kommt hinzu.
+ */
+static void setup_seats(MockComp *mc, const Entry *entries, int n)
+{
+    bool first = true;
+    for (int i = 0; i < n; i++) {
+        const Entry *e = &entries[i];
+        if ((strcmp(e->name, "ext_idle_notification_v1.idled") != 0 &&
+             strcmp(e->name, "ext_idle_notification_v1.resumed") != 0) ||
+            e->args[0] == '\0')
+            continue;
+        if (first)
+            mock_set_seat_name(mc, 0, e->args);
+        else if (mock_find_seat(mc, e->args) < 0 &&
+                 mock_add_seat(mc, e->args) < 0)
+            fprintf(stderr, "Zu viele Seats, ignoriere %s\n", e->args);
+        first = false;
+    }
+}
+
+/*
+ * Anfangszustand aus dem Mitschnitt übernehmen: die Registry-Ereignisse
+ * und Seat-Fähigkeiten vor dem ersten anderen Ereignis. Ausgaben erhalten
+ * die Größe des ersten configure.
+ */
+static void setup_mock(MockComp *mc, Entry *entries, int n,
+                       OutputMap *outputs, int *noutputs)
+{
+    int width = DEFAULT_WIDTH, height = DEFAULT_HEIGHT;
+    for (int i = 0; i < n; i++)
+        if (strcmp(entries[i].name, "zwlr_layer_surface_v1.configure") == 0 &&
+            sscanf(entries[i].args, "%d %d", &width, &height) == 2 &&
+            width > 0 && height > 0)
+            break;
+
+    bool seen[sizeof(optional_globals) / sizeof(optional_globals[0])] = { 0 };
+    bool caps_set = false;
+    for (int i = 0; i < n; i++) {
+        Entry *e = &entries[i];
+        if (strcmp(e->name, "wl_registry.global") == 0) {
+            unsigned name;
+            char iface[64];
+            if (sscanf(e->args, "%u %63s", &name, iface) != 2)
+                continue;
+            for (size_t g = 0; g < sizeof(seen) / sizeof(seen[0]); g++)
+                if (strcmp(iface, optional_globals[g]) == 0)
+                    seen[g] = true;
+            if (strcmp(iface, "wl_output") == 0 && *noutputs < 8) {
+                outputs[*noutputs].name = name;
+                outputs[*noutputs].index = mock_add_output(mc, width, height);
+                (*noutputs)++;
+            }
+            e->setup = true;
+        } else if (strcmp(e->name, "wl_seat.capabilities") == 0 && !caps_set) {
+            mock_set_capabilities(mc, (uint32_t)strtoul(e->args, NULL, 10));
+            caps_set = true;
+            e->setup = true;
+        } else {
+            break;
+        }
+    }
+
+    for (size_t g = 0; g < sizeof(seen) / sizeof(seen[0]); g++)
+        if (!seen[g])
+            mock_hide_global(mc, optional_globals[g]);
+
+    /* Ohne aufgezeichnete Ausgabe könnte keine Layer-Surface erscheinen */
+    if (*noutputs == 0)
+        mock_add_output(mc, width, height);
+
+    setup_seats(mc, entries, n);
+}
+
+/* Position des nächsten pointer.enter vor dem nächsten hide_overlay */
+static void preset_pointer(MockComp *mc, Entry *entries, int n, int from)
+{
+    for (int i = from; i < n; i++) {
+        if (strcmp(entries[i].name, "hide_overlay") == 0)
+            return;
+        double x, y;
+        if (strcmp(entries[i].name, "wl_pointer.enter") == 0 &&
+            sscanf(entries[i].args, "%lf %lf", &x, &y) == 2) {
+            mock_set_pointer(mc, x, y);
+            return;
+        }
+    }
+}
+
+/* =========================================================================
+ * Abspielen
+ * ========================================================================= */
+
+typedef struct {
+    MockComp  *mc;
+    OutputMap  outputs[8];
+    int        noutputs;
+    bool       initial_configure;  /* Nächstes configure erzeugt der Mock */
+    bool       skip_closed;        /* Nächstes closed erzeugt der Mock */
+    bool       have_time_offset;
+    uint32_t   time_offset;        /* Aufgezeichnete → aktuelle Eingabezeit */
+    int        timeout_ms;
+    int        replayed, skipped, divergences;
+} Replay;
+
+static uint32_t input_time(Replay *r, uint32_t recorded)
+{
+    if (!r->have_time_offset) {
+        r->time_offset = (uint32_t)(now_ns() / 1000000ull) - recorded;
+        r->have_time_offset = true;
+    }
+    return recorded + r->time_offset;
+}
+
+static int output_slot(Replay *r, uint32_t name)
+{
+    for (int i = 0; i < r->noutputs; i++)
+        if (r->outputs[i].name == name)
+            return i;
+    return -1;
+}
+
+/* Ein Ereignis nachschicken. Gibt false zurück, wenn es übersprungen wurde. */
+static bool replay_entry(Replay *r, Entry *entries, int n, int i,
+                         const char *path)
+{
+    Entry *e = &entries[i];
+    MockComp *mc = r->mc;
+    unsigned a, b, c;
+    double x, y;
+
+    if (strcmp(e->name, "show_overlay") == 0 ||
+        strcmp(e->name, "hide_overlay") == 0) {
+        bool show = e->name[0] == 's';
+        if (show) {
+            r->initial_configure = true;
+            preset_pointer(mc, entries, n, i + 1);
+        }
+        if (!mock_wait_mapped(mc, show, r->timeout_ms)) {
+            fprintf(stderr, "%s:%d: %s blieb aus\n", path, e->line, e->name);
+            r->divergences++;
+        }
+        return true;
+    }
+
+    if (strcmp(e->name, "wl_registry.global") == 0) {
+        char iface[64];
+        if (sscanf(e->args, "%u %63s", &a, iface) != 2 ||
+            strcmp(iface, "wl_output") != 0 || r->noutputs >= 8)
+            return false;
+        r->outputs[r->noutputs].name = a;
+        r->outputs[r->noutputs].index = mock_add_output(mc, DEFAULT_WIDTH,
+                                                        DEFAULT_HEIGHT);
+        r->noutputs++;
+    } else if (strcmp(e->name, "wl_registry.global_remove") == 0) {
+        int slot = sscanf(e->args, "%u", &a) == 1 ? output_slot(r, a) : -1;
+        if (slot < 0)
+            return false;
+        mock_remove_output(mc, r->outputs[slot].index);
+        r->outputs[slot] = r->outputs[--r->noutputs];
+        r->skip_closed = true;
+    } else if (strcmp(e->name, "wl_seat.capabilities") == 0) {
+        mock_set_capabilities(mc, (uint32_t)strtoul(e->args, NULL, 10));
+    } else if (strcmp(e->name, "zwlr_layer_surface_v1.configure") == 0) {
+        if (r->initial_configure) {
+            r->initial_configure = false;
+            return false;
+        }
+        if (sscanf(e->args, "%u %u", &a, &b) != 2)
+            return false;
+        mock_configure(mc, (int)a, (int)b);
+    } else if (strcmp(e->name, "zwlr_layer_surface_v1.closed") == 0) {
+        if (r->skip_closed) {
+            r->skip_closed = false;
+            return false;
+        }
+        mock_close(mc);
+    } else if (strcmp(e->name, "wl_keyboard.key") == 0) {
+        if (sscanf(e->args, "%u %u %u", &a, &b, &c) != 3)
+            return false;
+        mock_key_event(mc, a, b, input_time(r, c));
+    } else if (strcmp(e->name, "wl_pointer.motion") == 0) {
+        if (sscanf(e->args, "%lf %lf %u", &x, &y, &c) != 3)
+            return false;
+        mock_pointer_motion(mc, x, y, input_time(r, c));
+    } else if (strcmp(e->name, "wl_pointer.button") == 0) {
+        if (sscanf(e->args, "%u %u %u", &a, &b, &c) != 3)
+            return false;
+        mock_pointer_button(mc, a, b, input_time(r, c));
+    } else if (strcmp(e->name, "wl_pointer.axis") == 0) {
+        if (sscanf(e->args, "%u %lf %u", &a, &x, &c) != 3)
+            return false;
+        mock_pointer_axis(mc, a, x, input_time(r, c));
+    } else if (strcmp(e->name, "wl_pointer.frame") == 0) {
+        mock_pointer_frame(mc);
+    } else if (strcmp(e->name, "ext_idle_notification_v1.idled") == 0 ||
+               strcmp(e->name, "ext_idle_notification_v1.resumed") == 0) {
+        bool idled = strcmp(e->name, "ext_idle_notification_v1.idled") == 0;
+        if (e->args[0] == '\0') {
+            /* Version 1: ohne Seat-Namen an alle */
+            if (idled)
+                mock_idle(mc);
+            else
+                mock_resume(mc);
+        } else {
+            int seat = mock_find_seat(mc, e->args);
+            if (seat < 0)
+                return false;
+            if (idled)
+                mock_idle_seat(mc, seat);
+            else
+                mock_resume_seat(mc, seat);
+        }
+    } else {
+        /* enter/leave und Unbekanntes: erzeugt der Mock selbst oder entfällt */
+        return false;
+    }
+
+    mock_dispatch(mc, 0);
+    return true;
+}
+
+static void usage(const char *prog)
+{
+    fprintf(stderr, "Aufruf: %s [--speed F] [--timeout MS] MITSCHNITT "
+                    "-- BLKOUT [ARGUMENTE...]\n", prog);
+}
+
+/* =========================================================================
+ * Hauptprogramm
+ * ========================================================================= */
+
+int main(int argc, char *argv[])
+{
+    double speed = 1.0;
+    int timeout_ms = DEFAULT_TIMEOUT_MS;
+    const char *path = NULL;
+    int i;
+
+    for (i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--") == 0) {
+            i++;
+            break;
+        } else if (strcmp(argv[i], "--speed") == 0 && i + 1 < argc) {
+            speed = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--timeout") == 0 && i + 1 < argc) {
+            timeout_ms = atoi(argv[++i]);
+        } else if (!path && argv[i][0] != '-') {
+            path = argv[i];
+        } else {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+    if (!path || i >= argc || speed < 0 || timeout_ms <= 0) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    char recorded_args[512] = "";
+    int n = 0;
+    Entry *entries = read_log(path, &n, recorded_args, sizeof(recorded_args));
+    if (!entries)
+        return 2;
+
+    /* Befehlszeile: angegebene Argumente oder die aus dem Mitschnitt */
+    char *cargv[MAX_ARGS + 1];
+    int cargc = 0;
+    for (int k = i; k < argc && cargc < MAX_ARGS; k++)
+        cargv[cargc++] = argv[k];
+    if (cargc == 1)
+        for (char *tok = strtok(recorded_args, " "); tok && cargc < MAX_ARGS;
+             tok = strtok(NULL, " "))
+            cargv[cargc++] = tok;
+    cargv[cargc] = NULL;
+
+    Replay r = { .timeout_ms = timeout_ms };
+    r.mc = mock_create();
+    if (!r.mc) {
+        free(entries);
+        return 2;
+    }
+    mock_set_pixel_check(r.mc, false);
+    setup_mock(r.mc, entries, n, r.outputs, &r.noutputs);
+    setenv("WAYLAND_DISPLAY", mock_socket(r.mc), 1);
+
+    child = fork();
+    if (child < 0) {
+        perror("fork");
+        mock_destroy(r.mc);
+        free(entries);
+        return 2;
+    }
+    if (child == 0) {
+        execvp(cargv[0], cargv);
+        perror(cargv[0]);
+        _exit(127);
+    }
+
+    /* Abstände zwischen den Ereignissen einhalten, geteilt durch speed */
+    uint64_t prev_us = 0, prev_ns = now_ns();
+    for (int k = 0; k < n; k++) {
+        Entry *e = &entries[k];
+        if (e->setup)
+            continue;
+        if (speed > 0 && e->t_us > prev_us)
+            run_until(r.mc, prev_ns +
+                      (uint64_t)((double)(e->t_us - prev_us) * 1000.0 / speed));
+        prev_us = e->t_us;
+        if (replay_entry(&r, entries, n, k, path))
+            r.replayed++;
+        else
+            r.skipped++;
+        prev_ns = now_ns();
+        if (child_exited())
+            break;
+    }
+    run_until(r.mc, now_ns() + SETTLE_MS * 1000000ull);
+
+    /* blkout beenden, falls es noch läuft */
+    if (!child_exited()) {
+        kill(child, SIGTERM);
+        for (int ms = 0; ms < 1000 && !child_exited(); ms += SLICE_MS)
+            mock_dispatch(r.mc, SLICE_MS);
+        if (!child_exited()) {
+            kill(child, SIGKILL);
+            waitpid(child, NULL, 0);
+        }
+    }
+
+    printf("events %d\n", n);
+    printf("replayed %d\n", r.replayed);
+    printf("skipped %d\n", r.skipped);
+    printf("divergences %d\n", r.divergences);
+
+    mock_destroy(r.mc);
+    free(entries);
+    return r.divergences ? 1 : 0;
+}
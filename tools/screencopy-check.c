@@ -0,0 +1,202 @@
+/*
+ * screencopy-check.c — Bildschirminhalt per wlr-screencopy prüfen
+ *
+ * Aufruf:
+ *   screencopy-check [--expect black|not-black] [--min-black N]
+ *                    [--timeout MS] [-- BEFEHL [ARGUMENTE...]]
+ *
+ * Verbindet sich mit dem Compositor aus WAYLAND_DISPLAY, bindet alle
+ * wl_output und kopiert deren Inhalt über zwlr_screencopy_manager_v1 in
+ * eigene SHM-Puffer.
+ *
+ *   --expect black      (Standard) So lange erneut kopieren, bis jede
+ *                       Ausgabe vollständig schwarz ist, höchstens --timeout
+ *                       Millisekunden (Standard 5000). Mit --min-black N
+ *                       genügen N schwarze Ausgaben (blkout deckt bisher
+ *                       nur die vom Compositor gewählte Ausgabe ab).
+ *   --expect not-black  Einmal kopieren; mindestens eine Ausgabe darf nicht
+ *                       vollständig schwarz sein (Vorbedingung, damit die
+ *                       Schwarzprüfung überhaupt etwas aussagt).
+ *
+ * Ist ein BEFEHL angegeben (typischerweise blkout), wird er unmittelbar vor
+ * der ersten Kopie gestartet. Die Zeit bis zum ersten schwarzen Bild wird
+ * aus dem ready-Zeitstempel des Compositors berechnet, also dem Zeitpunkt,
+ * zu dem das kopierte Bild tatsächlich dargestellt wurde. Ausgabe:
+ *
+ *   output <name> <breite>x<höhe> black_ms <ms>
+ *   time_to_black_ms <ms>        (späteste Ausgabe)
+ *
+ * Der Befehl läuft danach weiter und wird beim Beenden mit SIGTERM beendet.
+ */
+
+#define _GNU_SOURCE
+
+#include <signal.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+#include "screencopy.h"
+
+#define DEFAULT_TIMEOUT_MS 5000
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+/* =========================================================================
+ * Registry
+ * ========================================================================= */
+
+static void registry_global(void *data, struct wl_registry *registry,
+                            uint32_t name, const char *interface,
+                            uint32_t version)
+{
+    sc_registry_global(data, registry, name, interface, version);
+}
+
+static void registry_global_remove(void *data, struct wl_registry *registry,
+                                   uint32_t name)
+{
+    (void)data; (void)registry; (void)name;
+}
+
+static const struct wl_registry_listener registry_listener = {
+    .global        = registry_global,
+    .global_remove = registry_global_remove,
+};
+
+/* =========================================================================
+ * Hauptprogramm
+ * ========================================================================= */
+
+int main(int argc, char *argv[])
+{
+    bool expect_black = true;
+    int timeout_ms = DEFAULT_TIMEOUT_MS;
+    int min_black = 0;                  /* 0 = alle Ausgaben */
+    char **cmd = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--") == 0 && i + 1 < argc) {
+            cmd = &argv[i + 1];
+            break;
+        } else if (strcmp(argv[i], "--expect") == 0 && i + 1 < argc) {
+            i++;
+            if (strcmp(argv[i], "black") == 0)
+                expect_black = true;
+            else if (strcmp(argv[i], "not-black") == 0)
+                expect_black = false;
+            else
+                goto usage;
+        } else if (strcmp(argv[i], "--min-black") == 0 && i + 1 < argc) {
+            min_black = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--timeout") == 0 && i + 1 < argc) {
+            timeout_ms = atoi(argv[++i]);
+        } else {
+            goto usage;
+        }
+    }
+
+    ScContext sc = { 0 };
+    uint64_t first_black[SC_MAX_OUTPUTS] = { 0 };   /* 0 = noch nie schwarz */
+    sc.display = wl_display_connect(NULL);
+    if (!sc.display) {
+        fprintf(stderr, "Keine Verbindung zum Wayland-Display möglich\n");
+        return 2;
+    }
+    struct wl_registry *registry = wl_display_get_registry(sc.display);
+    wl_registry_add_listener(registry, &registry_listener, &sc);
+    wl_display_roundtrip(sc.display);
+    wl_display_roundtrip(sc.display);
+
+    if (!sc_ready(&sc)) {
+        fprintf(stderr, "wl_shm, zwlr_screencopy_manager_v1 oder wl_output "
+                        "fehlt\n");
+        return 2;
+    }
+
+    int status = 1;
+    pid_t child = -1;
+    uint64_t t0 = now_ns();
+
+    if (!expect_black) {
+        if (!sc_capture_all(&sc))
+            goto out;
+        for (int i = 0; i < sc.noutputs; i++)
+            if (!sc.outputs[i].failed && !sc.outputs[i].black)
+                status = 0;
+        if (status)
+            fprintf(stderr, "Alle Ausgaben sind bereits schwarz\n");
+        goto out;
+    }
+
+    if (cmd) {
+        child = fork();
+        if (child < 0) {
+            perror("fork");
+            goto out;
+        }
+        if (child == 0) {
+            execvp(cmd[0], cmd);
+            perror(cmd[0]);
+            _exit(127);
+        }
+    }
+
+    uint64_t deadline = t0 + (uint64_t)timeout_ms * 1000000ull;
+    while (now_ns() < deadline) {
+        if (!sc_capture_all(&sc))
+            goto out;
+        for (int i = 0; i < sc.noutputs; i++) {
+            const ScOutput *o = &sc.outputs[i];
+            if (o->black && !first_black[i])
+                first_black[i] = o->ready_ns ? o->ready_ns : now_ns();
+        }
+        if (sc_count_black(&sc) >= (min_black > 0 ? min_black : sc.noutputs)) {
+            status = 0;
+            break;
+        }
+    }
+
+    uint64_t worst = 0;
+    for (int i = 0; i < sc.noutputs; i++) {
+        const ScOutput *o = &sc.outputs[i];
+        double ms = first_black[i] > t0 ?
+                    (double)(first_black[i] - t0) / 1e6 : 0.0;
+        if (first_black[i])
+            printf("output %s %ux%u black_ms %.3f\n",
+                   o->name, o->width, o->height, ms);
+        else
+            printf("output %s %ux%u black_ms -\n", o->name, o->width, o->height);
+        if (first_black[i] > worst)
+            worst = first_black[i];
+    }
+    if (status == 0)
+        printf("time_to_black_ms %.3f\n",
+               worst > t0 ? (double)(worst - t0) / 1e6 : 0.0);
+    else
+        fprintf(stderr, "Nicht genug Ausgaben wurden innerhalb von %d ms "
+                        "schwarz\n", timeout_ms);
+
+out:
+    if (child > 0) {
+        kill(child, SIGTERM);
+        waitpid(child, NULL, 0);
+    }
+    sc_destroy(&sc);
+    wl_display_disconnect(sc.display);
+    return status;
+
+usage:
+    fprintf(stderr, "Aufruf: %s [--expect black|not-black] [--min-black N] "
+                    "[--timeout MS] [-- BEFEHL [ARGUMENTE...]]\n", argv[0]);
+    return 2;
+}
@@ -0,0 +1,319 @@
+/*
+ * screencopy.c — Bildschirminhalt per wlr-screencopy in SHM-Puffer kopieren
+ *
+ * Siehe screencopy.h. Unterstützt werden die 32-Bit-SHM-Formate
+ * (X/A)RGB8888 und (X/A)BGR8888; andere Formate gelten als fehlgeschlagen.
+ */
+
+#define _GNU_SOURCE
+
+#include "screencopy.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+#include "wlr-screencopy-unstable-v1-client-protocol.h"
+
+/* =========================================================================
+ * Ausgaben
+ * ========================================================================= */
+
+static void output_geometry(void *data, struct wl_output *o, int32_t x,
+                            int32_t y, int32_t pw, int32_t ph, int32_t sub,
+                            const char *make, const char *model, int32_t tr)
+{
+    (void)data; (void)o; (void)x; (void)y; (void)pw; (void)ph; (void)sub;
+    (void)make; (void)model; (void)tr;
+}
+
+static void output_mode(void *data, struct wl_output *o, uint32_t flags,
+                        int32_t w, int32_t h, int32_t refresh)
+{
+    (void)data; (void)o; (void)flags; (void)w; (void)h; (void)refresh;
+}
+
+static void output_done(void *data, struct wl_output *o)
+{
+    (void)data; (void)o;
+}
+
+static void output_scale(void *data, struct wl_output *o, int32_t factor)
+{
+    (void)data; (void)o; (void)factor;
+}
+
+static void output_name(void *data, struct wl_output *o, const char *name)
+{
+    (void)o;
+    ScOutput *out = data;
+    snprintf(out->name, sizeof(out->name), "%s", name);
+}
+
+static void output_description(void *data, struct wl_output *o,
+                               const char *desc)
+{
+    (void)data; (void)o; (void)desc;
+}
+
+static const struct wl_output_listener output_listener = {
+    .geometry    = output_geometry,
+    .mode        = output_mode,
+    .done        = output_done,
+    .scale       = output_scale,
+    .name        = output_name,
+    .description = output_description,
+};
+
+/* =========================================================================
+ * Registry
+ * ========================================================================= */
+
+bool sc_registry_global(ScContext *sc, struct wl_registry *registry,
+                        uint32_t name, const char *interface,
+                        uint32_t version)
+{
+    if (strcmp(interface, wl_shm_interface.name) == 0) {
+        sc->shm = wl_registry_bind(registry, name, &wl_shm_interface, 1);
+    } else if (strcmp(interface, zwlr_screencopy_manager_v1_interface.name) == 0) {
+        sc->manager_version = version < 3 ? version : 3;
+        sc->manager = wl_registry_bind(registry, name,
+                                       &zwlr_screencopy_manager_v1_interface,
+                                       sc->manager_version);
+    } else if (strcmp(interface, wl_output_interface.name) == 0 &&
+               sc->noutputs < SC_MAX_OUTPUTS) {
+        ScOutput *out = &sc->outputs[sc->noutputs];
+        out->sc = sc;
+        snprintf(out->name, sizeof(out->name), "output-%d", sc->noutputs);
+        out->output = wl_registry_bind(registry, name, &wl_output_interface,
+                                       version < 4 ? version : 4);
+        wl_output_add_listener(out->output, &output_listener, out);
+        sc->noutputs++;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+bool sc_ready(const ScContext *sc)
+{
+    return sc->shm && sc->manager && sc->noutputs > 0;
+}
+
+/* =========================================================================
+ * Kopieren
+ * ========================================================================= */
+
+static void destroy_target(ScOutput *out)
+{
+    if (out->buffer)
+        wl_buffer_destroy(out->buffer);
+    if (out->data)
+        munmap(out->data, out->size);
+    out->buffer = NULL;
+    out->data = NULL;
+    out->size = 0;
+}
+
+/* Zielpuffer passend zum angekündigten Format anlegen */
+static bool create_target(ScContext *sc, ScOutput *out)
+{
+    size_t size = (size_t)out->stride * out->height;
+    if (out->buffer && out->size == size)
+        return true;
+    destroy_target(out);
+
+    int fd = memfd_create("screencopy", MFD_CLOEXEC);
+    if (fd < 0 || ftruncate(fd, (off_t)size) < 0) {
+        perror("memfd");
+        if (fd >= 0)
+            close(fd);
+        return false;
+    }
+    out->data = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (out->data == MAP_FAILED) {
+        perror("mmap");
+        out->data = NULL;
+        close(fd);
+        return false;
+    }
+    struct wl_shm_pool *pool = wl_shm_create_pool(sc->shm, fd, (int32_t)size);
+    out->buffer = wl_shm_pool_create_buffer(pool, 0, (int32_t)out->width,
+                                            (int32_t)out->height,
+                                            (int32_t)out->stride, out->format);
+    wl_shm_pool_destroy(pool);
+    close(fd);
+    out->size = size;
+    return true;
+}
+
+/* 32-Bit-Formate, bei denen die unteren 24 Bit die Farbe tragen */
+static bool format_supported(uint32_t format)
+{
+    return format == WL_SHM_FORMAT_XRGB8888 ||
+           format == WL_SHM_FORMAT_ARGB8888 ||
+           format == WL_SHM_FORMAT_XBGR8888 ||
+           format == WL_SHM_FORMAT_ABGR8888;
+}
+
+static bool target_is_black(const ScOutput *out)
+{
+    const uint8_t *p = out->data;
+    for (uint32_t y = 0; y < out->height; y++) {
+        const uint32_t *row = (const uint32_t *)(p + (size_t)y * out->stride);
+        for (uint32_t x = 0; x < out->width; x++)
+            if (row[x] & 0x00ffffffu)
+                return false;
+    }
+    return true;
+}
+
+static void start_copy(ScContext *sc, ScOutput *out)
+{
+    if (!out->have_format || !format_supported(out->format) ||
+        !create_target(sc, out)) {
+        out->failed = true;
+        out->done = true;
+        return;
+    }
+    zwlr_screencopy_frame_v1_copy(out->frame, out->buffer);
+}
+
+static void frame_buffer(void *data, struct zwlr_screencopy_frame_v1 *frame,
+                         uint32_t format, uint32_t width, uint32_t height,
+                         uint32_t stride)
+{
+    (void)frame;
+    ScOutput *out = data;
+    /* Erstes unterstütztes SHM-Format verwenden */
+    if (out->have_format && format_supported(out->format))
+        return;
+    out->have_format = true;
+    out->format = format;
+    out->width = width;
+    out->height = height;
+    out->stride = stride;
+}
+
+static void frame_flags(void *data, struct zwlr_screencopy_frame_v1 *frame,
+                        uint32_t flags)
+{
+    /* y_invert spielt für eine reine Schwarzprüfung keine Rolle */
+    (void)data; (void)frame; (void)flags;
+}
+
+static void frame_ready(void *data, struct zwlr_screencopy_frame_v1 *frame,
+                        uint32_t tv_sec_hi, uint32_t tv_sec_lo,
+                        uint32_t tv_nsec)
+{
+    (void)frame;
+    ScOutput *out = data;
+    out->ready_ns = ((((uint64_t)tv_sec_hi << 32) | tv_sec_lo) *
+                     1000000000ull) + tv_nsec;
+    out->black = target_is_black(out);
+    out->done = true;
+}
+
+static void frame_failed(void *data, struct zwlr_screencopy_frame_v1 *frame)
+{
+    (void)frame;
+    ScOutput *out = data;
+    out->failed = true;
+    out->done = true;
+}
+
+static void frame_damage(void *data, struct zwlr_screencopy_frame_v1 *frame,
+                         uint32_t x, uint32_t y, uint32_t w, uint32_t h)
+{
+    (void)data; (void)frame; (void)x; (void)y; (void)w; (void)h;
+}
+
+static void frame_linux_dmabuf(void *data,
+                               struct zwlr_screencopy_frame_v1 *frame,
+                               uint32_t format, uint32_t w, uint32_t h)
+{
+    (void)data; (void)frame; (void)format; (void)w; (void)h;
+}
+
+/* Ab Version 3: alle Puffertypen angekündigt, jetzt kopieren */
+static void frame_buffer_done(void *data,
+                              struct zwlr_screencopy_frame_v1 *frame)
+{
+    (void)frame;
+    ScOutput *out = data;
+    start_copy(out->sc, out);
+}
+
+static const struct zwlr_screencopy_frame_v1_listener frame_listener = {
+    .buffer       = frame_buffer,
+    .flags        = frame_flags,
+    .ready        = frame_ready,
+    .failed       = frame_failed,
+    .damage       = frame_damage,
+    .linux_dmabuf = frame_linux_dmabuf,
+    .buffer_done  = frame_buffer_done,
+};
+
+bool sc_capture_all(ScContext *sc)
+{
+    for (int i = 0; i < sc->noutputs; i++) {
+        ScOutput *out = &sc->outputs[i];
+        out->have_format = false;
+        out->done = false;
+        out->failed = false;
+        out->black = false;
+        out->frame = zwlr_screencopy_manager_v1_capture_output(
+            sc->manager, 0, out->output);
+        zwlr_screencopy_frame_v1_add_listener(out->frame, &frame_listener, out);
+    }
+
+    /* Vor Version 3 gibt es kein buffer_done: nach dem Roundtrip kopieren */
+    if (wl_display_roundtrip(sc->display) < 0)
+        return false;
+    if (sc->manager_version < 3)
+        for (int i = 0; i < sc->noutputs; i++)
+            if (!sc->outputs[i].done)
+                start_copy(sc, &sc->outputs[i]);
+
+    for (;;) {
+        bool pending = false;
+        for (int i = 0; i < sc->noutputs; i++)
+            if (!sc->outputs[i].done)
+                pending = true;
+        if (!pending)
+            break;
+        if (wl_display_dispatch(sc->display) < 0)
+            return false;
+    }
+
+    for (int i = 0; i < sc->noutputs; i++) {
+        zwlr_screencopy_frame_v1_destroy(sc->outputs[i].frame);
+        sc->outputs[i].frame = NULL;
+    }
+    return true;
+}
+
+int sc_count_black(const ScContext *sc)
+{
+    int n = 0;
+    for (int i = 0; i < sc->noutputs; i++)
+        if (sc->outputs[i].black)
+            n++;
+    return n;
+}
+
+void sc_destroy(ScContext *sc)
+{
+    for (int i = 0; i < sc->noutputs; i++) {
+        destroy_target(&sc->outputs[i]);
+        wl_output_destroy(sc->outputs[i].output);
+    }
+    sc->noutputs = 0;
+    if (sc->manager)
+        zwlr_screencopy_manager_v1_destroy(sc->manager);
+    if (sc->shm)
+        wl_shm_destroy(sc->shm);
+    sc->manager = NULL;
+    sc->shm = NULL;
+}
@@ -0,0 +1,74 @@
+/*
+ * screencopy.h — Bildschirminhalt per wlr-screencopy in SHM-Puffer kopieren
+ *
+ * Gemeinsame Hilfsfunktionen von screencopy-check und wake-bench. Die
+ * Werkzeuge richten ihre Registry selbst ein und reichen jedes globale
+ * Objekt an sc_registry_global() weiter; danach kopiert sc_capture_all()
+ * alle Ausgaben und vermerkt pro Ausgabe, ob sie vollständig schwarz ist
+ * und wann der Compositor das Bild dargestellt hat.
+ */
+
+#ifndef BLKOUT_SCREENCOPY_H
+#define BLKOUT_SCREENCOPY_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <wayland-client.h>
+
+#define SC_MAX_OUTPUTS 8
+
+typedef struct ScContext ScContext;
+
+typedef struct {
+    ScContext        *sc;
+    struct wl_output *output;
+    char              name[32];
+
+    /* Laufende Kopie */
+    struct zwlr_screencopy_frame_v1 *frame;
+    bool     have_format;
+    uint32_t format, width, height, stride;
+    bool     done, failed;
+
+    /* Zielpuffer, wiederverwendet solange die Größe gleich bleibt */
+    struct wl_buffer *buffer;
+    void             *data;
+    size_t            size;
+
+    /* Ergebnis der letzten Kopie */
+    bool     black;
+    uint64_t ready_ns;     /* Darstellungszeitpunkt, CLOCK_MONOTONIC */
+} ScOutput;
+
+struct ScContext {
+    struct wl_display                 *display;
+    struct wl_shm                     *shm;
+    struct zwlr_screencopy_manager_v1 *manager;
+    uint32_t                           manager_version;
+    ScOutput                           outputs[SC_MAX_OUTPUTS];
+    int                                noutputs;
+};
+
+/*
+ * Globales Objekt übernehmen, falls es wl_shm, der Screencopy-Manager oder
+ * ein wl_output ist. Gibt true zurück, wenn es gebunden wurde.
+ */
+bool sc_registry_global(ScContext *sc, struct wl_registry *registry,
+                        uint32_t name, const char *interface,
+                        uint32_t version);
+
+/* true, wenn alle benötigten Objekte gebunden sind */
+bool sc_ready(const ScContext *sc);
+
+/* Alle Ausgaben einmal kopieren; false bei Verbindungsfehler */
+bool sc_capture_all(ScContext *sc);
+
+/* Anzahl der Ausgaben, deren letzte Kopie vollständig schwarz war */
+int sc_count_black(const ScContext *sc);
+
+/* Puffer und Objekte freigeben (die Verbindung bleibt bestehen) */
+void sc_destroy(ScContext *sc);
+
+#endif
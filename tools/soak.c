@@ -0,0 +1,246 @@
+/*
+ * soak.c — Dauertest von blkout auf Ressourcenlecks
+ *
+ * Aufruf:
+ *   soak [--cycles N] [--size BxH] [--sample-every N] [--storm-every N]
+ *        [--storm-len N] [--rss-slack KB] -- BLKOUT [ARGUMENTE...]
+ *
+ * Startet blkout (mit zusätzlich "-s 1") gegen den Mock-Compositor und
+ * durchläuft N Zyklen (Standard 100000) aus idled → gemappt → Taste →
+ * ungemappt. Alle --storm-every Zyklen (Standard 100) bekommt das sichtbare
+ * Overlay --storm-len configure-Events (Standard 20) mit wechselnder Größe
+ * hintereinander, wie bei einem Moduswechsel oder Hotplug-Gewitter.
+ *
+ * Alle --sample-every Zyklen (Standard 1000) werden offene Dateideskriptoren,
+ * Speicherbereiche (VMAs), RSS und die höchste vom Client verwendete
+ * Wayland-Objekt-ID erfasst und nach stderr geschrieben. Referenz ist die
+ * erste Stichprobe (nach der Aufwärmphase). Liegt eine spätere Stichprobe
+ * bei fds, VMAs oder Objekt-ID über der Referenz, oder beim RSS um mehr als
+ * --rss-slack kB (Standard 512, wegen malloc-Verschnitt), endet der Test
+ * mit Status 1.
+ */
+
+#define _GNU_SOURCE
+
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+#include "mockcomp.h"
+#include "procstat.h"
+
+#define DEFAULT_CYCLES       100000
+#define DEFAULT_SAMPLE_EVERY 1000
+#define DEFAULT_STORM_EVERY  100
+#define DEFAULT_STORM_LEN    20
+#define DEFAULT_RSS_SLACK_KB 512
+#define WAIT_TIMEOUT_MS      5000
+#define SETTLE_MS            20
+#define KEY_ESC              1
+
+/* Eine Stichprobe der überwachten Größen */
+typedef struct {
+    int      fds;
+    int      vmas;
+    long     rss_kb;
+    uint32_t max_id;
+} Sample;
+
+static Sample take_sample(pid_t pid, const MockComp *mc)
+{
+    Sample s = {
+        .fds    = proc_count_fds(pid),
+        .vmas   = proc_count_maps(pid),
+        .rss_kb = proc_status_kb(pid, "VmRSS:"),
+        .max_id = mock_stats(mc)->max_object_id,
+    };
+    return s;
+}
+
+/* Ereignisse verarbeiten, bis der Client ms Millisekunden Ruhe gibt */
+static void settle(MockComp *mc, int ms)
+{
+    uint64_t commits;
+    do {
+        commits = mock_stats(mc)->commits;
+        mock_dispatch(mc, ms);
+    } while (mock_stats(mc)->commits != commits);
+}
+
+/* Configure-Gewitter auf das sichtbare Overlay */
+static void storm(MockComp *mc, int width, int height, int len)
+{
+    for (int i = 0; i < len; i++) {
+        int d = (i % 5) * 16;
+        mock_configure(mc, width - d, height - d);
+        mock_dispatch(mc, 0);
+    }
+    /* Zum Schluss wieder die volle Größe */
+    mock_configure(mc, width, height);
+    settle(mc, SETTLE_MS);
+}
+
+static void usage(const char *prog)
+{
+    fprintf(stderr, "Aufruf: %s [--cycles N] [--size BxH] [--sample-every N] "
+                    "[--storm-every N] [--storm-len N] [--rss-slack KB] "
+                    "-- BLKOUT [ARGUMENTE...]\n", prog);
+}
+
+int main(int argc, char *argv[])
+{
+    long cycles = DEFAULT_CYCLES;
+    int width = 1920, height = 1080;
+    int sample_every = DEFAULT_SAMPLE_EVERY;
+    int storm_every = DEFAULT_STORM_EVERY;
+    int storm_len = DEFAULT_STORM_LEN;
+    long rss_slack = DEFAULT_RSS_SLACK_KB;
+    int i;
+
+    for (i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--") == 0) {
+            i++;
+            break;
+        } else if (strcmp(argv[i], "--cycles") == 0 && i + 1 < argc) {
+            cycles = atol(argv[++i]);
+        } else if (strcmp(argv[i], "--size") == 0 && i + 1 < argc) {
+            if (sscanf(argv[++i], "%dx%d", &width, &height) != 2) {
+                usage(argv[0]);
+                return 2;
+            }
+        } else if (strcmp(argv[i], "--sample-every") == 0 && i + 1 < argc) {
+            sample_every = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--storm-every") == 0 && i + 1 < argc) {
+            storm_every = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--storm-len") == 0 && i + 1 < argc) {
+            storm_len = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--rss-slack") == 0 && i + 1 < argc) {
+            rss_slack = atol(argv[++i]);
+        } else {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+    if (i >= argc || cycles <= 0 || sample_every <= 0 || width < 100 ||
+        height < 100) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    /* Befehlszeile von blkout um "-s 1" ergänzen */
+    int nbase = argc - i;
+    char **cargv = calloc((size_t)nbase + 3, sizeof(char *));
+    if (!cargv)
+        return 2;
+    for (int k = 0; k < nbase; k++)
+        cargv[k] = argv[i + k];
+    cargv[nbase] = "-s";
+    cargv[nbase + 1] = "1";
+
+    signal(SIGPIPE, SIG_IGN);
+
+    MockComp *mc = mock_create();
+    if (!mc)
+        return 2;
+    mock_set_pixel_check(mc, false);
+    mock_add_output(mc, width, height);
+    setenv("WAYLAND_DISPLAY", mock_socket(mc), 1);
+
+    pid_t pid = fork();
+    if (pid < 0) {
+        perror("fork");
+        mock_destroy(mc);
+        return 2;
+    }
+    if (pid == 0) {
+        execvp(cargv[0], cargv);
+        perror(cargv[0]);
+        _exit(127);
+    }
+
+    Sample ref = { 0 }, worst = { 0 };
+    bool have_ref = false;
+    const char *failure = NULL;
+    long c;
+
+    fprintf(stderr, "%10s %6s %6s %10s %8s\n",
+            "zyklus", "fds", "vmas", "rss_kb", "max_id");
+
+    for (c = 1; c <= cycles && !failure; c++) {
+        mock_idle(mc);
+        if (!mock_wait_mapped(mc, true, WAIT_TIMEOUT_MS)) {
+            failure = "Overlay nicht gemappt";
+            break;
+        }
+        if (storm_every > 0 && c % storm_every == 0)
+            storm(mc, width, height, storm_len);
+
+        mock_key(mc, KEY_ESC);
+        if (!mock_wait_mapped(mc, false, WAIT_TIMEOUT_MS)) {
+            failure = "Overlay nicht ungemappt";
+            break;
+        }
+
+        if (c % sample_every != 0)
+            continue;
+
+        /* Ausstehende delete_id/release zustellen, bevor gemessen wird */
+        settle(mc, 1);
+        Sample s = take_sample(pid, mc);
+        fprintf(stderr, "%10ld %6d %6d %10ld %8u\n",
+                c, s.fds, s.vmas, s.rss_kb, s.max_id);
+        if (s.fds < 0 || s.vmas < 0 || s.rss_kb < 0) {
+            failure = "Client beendet";
+            break;
+        }
+
+        if (!have_ref) {
+            ref = worst = s;
+            have_ref = true;
+            continue;
+        }
+        if (s.fds > worst.fds)       worst.fds = s.fds;
+        if (s.vmas > worst.vmas)     worst.vmas = s.vmas;
+        if (s.rss_kb > worst.rss_kb) worst.rss_kb = s.rss_kb;
+        if (s.max_id > worst.max_id) worst.max_id = s.max_id;
+
+        if (s.fds > ref.fds)
+            failure = "Dateideskriptoren wachsen";
+        else if (s.vmas > ref.vmas)
+            failure = "Speicherbereiche wachsen";
+        else if (s.rss_kb > ref.rss_kb + rss_slack)
+            failure = "RSS wächst";
+        else if (s.max_id > ref.max_id)
+            failure = "Wayland-Objekt-IDs wachsen";
+    }
+
+    kill(pid, SIGTERM);
+    for (int ms = 0; ms < 2000; ms += 10) {
+        if (waitpid(pid, NULL, WNOHANG) == pid) {
+            pid = -1;
+            break;
+        }
+        mock_dispatch(mc, 10);
+    }
+    if (pid > 0) {
+        kill(pid, SIGKILL);
+        waitpid(pid, NULL, 0);
+    }
+    mock_destroy(mc);
+    free(cargv);
+
+    if (have_ref)
+        printf("referenz fds=%d vmas=%d rss_kb=%ld max_id=%u\n"
+               "maximum  fds=%d vmas=%d rss_kb=%ld max_id=%u\n",
+               ref.fds, ref.vmas, ref.rss_kb, ref.max_id,
+               worst.fds, worst.vmas, worst.rss_kb, worst.max_id);
+    if (failure) {
+        fprintf(stderr, "FEHLER nach Zyklus %ld: %s\n", c, failure);
+        return 1;
+    }
+    printf("OK: %ld Zyklen ohne Wachstum\n", cycles);
+    return 0;
+}
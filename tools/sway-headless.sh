@@ -0,0 +1,79 @@
+#!/bin/sh
+#
+# sway-headless.sh — Befehl unter einem kopflosen sway ausführen
+#
+# Aufruf:
+#   tools/sway-headless.sh [--outputs BxH[,BxH...]] BEFEHL [ARGUMENTE...]
+#
+# Startet sway mit WLR_BACKENDS=headless und dem pixman-Renderer (keine GPU
+# nötig) in einem temporären XDG_RUNTIME_DIR, legt die mit --outputs
+# angegebenen Ausgaben an (HEADLESS-1, HEADLESS-2, ...) und führt BEFEHL mit
+# gesetztem WAYLAND_DISPLAY, SWAYSOCK und SWAY_PID aus. Ohne --outputs gibt
+# es keine Ausgabe; BEFEHL kann sie dann per "swaymsg create_output" anlegen.
+# Der Hintergrund ist farbig, damit ein schwarzer Bildschirm etwas bedeutet.
+#
+# Rückgabe: Status von BEFEHL; 2 wenn sway fehlt oder nicht startet.
+
+set -u
+
+OUTPUTS=
+if [ "${1:-}" = "--outputs" ] && [ $# -ge 2 ]; then
+    OUTPUTS=$(echo "$2" | tr ',' ' ')
+    shift 2
+fi
+if [ $# -eq 0 ]; then
+    echo "Aufruf: $0 [--outputs BxH[,BxH...]] BEFEHL [ARGUMENTE...]" >&2
+    exit 2
+fi
+
+if ! command -v sway >/dev/null 2>&1; then
+    echo "sway nicht gefunden" >&2
+    exit 2
+fi
+
+RUNTIME=$(mktemp -d /tmp/blkout-sway.XXXXXX) || exit 2
+chmod 700 "$RUNTIME"
+SWAY_PID=
+cleanup() {
+    [ -n "$SWAY_PID" ] && kill "$SWAY_PID" 2>/dev/null && wait "$SWAY_PID"
+    rm -rf "$RUNTIME"
+}
+trap cleanup EXIT INT TERM
+
+# Ohne swaybg zeichnet sway seinen grauen Standardhintergrund
+cat > "$RUNTIME/config" <<EOF
+output * bg #3465a4 solid_color
+EOF
+
+export XDG_RUNTIME_DIR="$RUNTIME"
+unset WAYLAND_DISPLAY DISPLAY SWAYSOCK
+WLR_BACKENDS=headless WLR_RENDERER=pixman WLR_LIBINPUT_NO_DEVICES=1 \
+WLR_HEADLESS_OUTPUTS=0 \
+    sway -c "$RUNTIME/config" >"$RUNTIME/sway.log" 2>&1 &
+SWAY_PID=$!
+export SWAY_PID
+
+# Auf den IPC-Socket warten
+SWAYSOCK=
+for i in $(seq 50); do
+    SWAYSOCK=$(ls "$RUNTIME"/sway-ipc.*.sock 2>/dev/null | head -n 1)
+    [ -n "$SWAYSOCK" ] && break
+    sleep 0.1
+done
+if [ -z "$SWAYSOCK" ]; then
+    echo "sway ist nicht gestartet, siehe Protokoll:" >&2
+    cat "$RUNTIME/sway.log" >&2
+    exit 2
+fi
+export SWAYSOCK
+export WAYLAND_DISPLAY=$(cd "$RUNTIME" && ls wayland-* | grep -v lock | head -n 1)
+
+n=1
+for mode in $OUTPUTS; do
+    swaymsg -q create_output
+    swaymsg -q output "HEADLESS-$n" enable mode --custom "$mode"
+    n=$((n + 1))
+done
+[ -n "$OUTPUTS" ] && sleep 0.2
+
+"$@"
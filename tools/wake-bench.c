@@ -0,0 +1,650 @@
+/*
+ * wake-bench.c — Weck-Latenz von blkout mit virtueller Tastatur und Maus
+ *
+ * Aufruf:
+ *   wake-bench [--cycles N] [--input key|pointer|both] [--mode e|r|both]
+ *              [--activity SEKUNDEN] [--timeout MS] [--out <datei>]
+ *              -- BLKOUT [ARGUMENTE...]
+ *
+ * Läuft gegen einen echten Compositor mit zwp_virtual_keyboard_manager_v1,
+ * zwlr_virtual_pointer_manager_v1 und zwlr_screencopy_manager_v1, z.B.
+ * kopfloses sway (tools/sway-headless.sh). Pro Zyklus wird blkout mit
+ * zusätzlich "-e --trace <datei>" gestartet, per Screencopy abgewartet, bis
+ * der Bildschirm schwarz ist, und dann eine Eingabe eingespeist: ein
+ * Tastendruck (KEY_ESC) über die virtuelle Tastatur oder eine absolute
+ * Mausbewegung über die virtuelle Maus. Gemessen wird ab dem Absenden:
+ *
+ *   event_ms   bis wl_keyboard.key bzw. wl_pointer.motion in blkout, mit
+ *              -r bis idle-resumed
+ *   hide_ms    bis zum Beginn von hide_overlay in blkout
+ *   screen_ms  bis der Compositor erstmals ein nicht mehr schwarzes Bild
+ *              darstellt (ready-Zeitstempel der Screencopy; Auflösung
+ *              ein Frame)
+ *
+ * --mode wählt, wie blkout geweckt wird: "e" über seine Eingabe-Listener,
+ * "r" nur über idle-resumed (blkout zusätzlich mit -r), "both" (Standard)
+ * misst beides nacheinander.
+ *
+ * Danach läuft je Modus eine Aktivitätsphase von --activity Sekunden
+ * (Standard 60, 0 = keine): blkout mit "-s 1 --trace <datei>" ohne -e,
+ * alle BURST_PERIOD_MS eine Mausbewegung (bzw. Tastendrücke) von
+ * BURST_EVENTS Ereignissen, dazwischen wird schwarz. Aus dem Trace wird
+ * hochgerechnet, wie oft blkout pro Stunde aufwacht (wakeups_per_hour)
+ * und wie viele Eingabe- und Idle-Ereignisse es erhält (events_per_hour).
+ *
+ * Die Zeitpunkte in blkout stammen aus dessen Trace (CLOCK_MONOTONIC, wie
+ * hier). Nach N Zyklen (Standard 2000, plus Aufwärmzyklen) wird je Modus
+ * und Eingabeart eine Zeile mit p50/p99/max in Millisekunden, je Modus
+ * eine Zeile der Aktivitätsphase als JSON-Array nach stdout bzw. --out
+ * geschrieben, im selben Zeilenformat wie bench.
+ */
+
+#define _GNU_SOURCE
+
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+
+#include "screencopy.h"
+#include "virtual-keyboard-unstable-v1-client-protocol.h"
+#include "wlr-virtual-pointer-unstable-v1-client-protocol.h"
+
+#define DEFAULT_CYCLES     2000
+#define DEFAULT_TIMEOUT_MS 5000
+#define WARMUP_CYCLES      5
+#define SETTLE_MS          20
+#define KEY_ESC            1
+#define POINTER_EXTENT     1000
+#define DEFAULT_ACTIVITY_S 60
+#define BURST_PERIOD_MS    3000
+#define BURST_EVENTS       30
+#define BURST_GAP_MS       16
+
+/* Minimale Tastaturbelegung; die Includes liefert xkeyboard-config */
+static const char keymap[] =
+    "xkb_keymap {\n"
+    "xkb_keycodes \"blkout\" { minimum = 8; maximum = 255; <ESC> = 9; };\n"
+    "xkb_types \"blkout\" { include \"complete\" };\n"
+    "xkb_compatibility \"blkout\" { include \"complete\" };\n"
+    "xkb_symbols \"blkout\" { key <ESC> { [ Escape ] }; };\n"
+    "};\n";
+
+typedef enum { INPUT_KEY, INPUT_POINTER } Input;
+
+static const char *const input_names[] = { "key", "pointer" };
+
+/* Weckweg von blkout: Eingabe-Listener (-e) oder nur idle-resumed (-r) */
+typedef enum { MODE_E, MODE_R } Mode;
+
+static const char *const mode_names[] = { "e", "r" };
+
+typedef struct {
+    ScContext                               sc;
+    struct wl_seat                         *seat;
+    struct zwp_virtual_keyboard_manager_v1 *vkbd_manager;
+    struct zwlr_virtual_pointer_manager_v1 *vptr_manager;
+    struct zwp_virtual_keyboard_v1         *vkbd;
+    struct zwlr_virtual_pointer_v1         *vptr;
+} Bench;
+
+/* Messwerte einer Eingabeart */
+typedef struct {
+    double *event, *hide, *screen;
+    int     n;
+    int     failed;
+} Series;
+
+/* Ergebnis einer Aktivitätsphase, hochgerechnet auf eine Stunde */
+typedef struct {
+    bool   ok;
+    int    seconds;
+    double wakeups;
+    double events;
+} Activity;
+
+/* =========================================================================
+ * Hilfsfunktionen
+ * ========================================================================= */
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static int cmp_double(const void *a, const void *b)
+{
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+/* Perzentil (Nearest-Rank) eines sortierten Arrays */
+static double percentile(const double *v, int n, double q)
+{
+    if (n <= 0)
+        return 0.0;
+    int i = (int)(q * (n - 1) + 0.5);
+    return v[i];
+}
+
+/* =========================================================================
+ * Registry
+ * ========================================================================= */
+
+static void registry_global(void *data, struct wl_registry *registry,
+                            uint32_t name, const char *interface,
+                            uint32_t version)
+{
+    Bench *b = data;
+
+    if (sc_registry_global(&b->sc, registry, name, interface, version))
+        return;
+    if (strcmp(interface, wl_seat_interface.name) == 0 && !b->seat) {
+        b->seat = wl_registry_bind(registry, name, &wl_seat_interface, 1);
+    } else if (strcmp(interface,
+                      zwp_virtual_keyboard_manager_v1_interface.name) == 0) {
+        b->vkbd_manager = wl_registry_bind(
+            registry, name, &zwp_virtual_keyboard_manager_v1_interface, 1);
+    } else if (strcmp(interface,
+                      zwlr_virtual_pointer_manager_v1_interface.name) == 0) {
+        b->vptr_manager = wl_registry_bind(
+            registry, name, &zwlr_virtual_pointer_manager_v1_interface, 1);
+    }
+}
+
+static void registry_global_remove(void *data, struct wl_registry *registry,
+                                   uint32_t name)
+{
+    (void)data; (void)registry; (void)name;
+}
+
+static const struct wl_registry_listener registry_listener = {
+    .global        = registry_global,
+    .global_remove = registry_global_remove,
+};
+
+/* Virtuelle Tastatur samt Belegung anlegen */
+static bool create_keyboard(Bench *b)
+{
+    b->vkbd = zwp_virtual_keyboard_manager_v1_create_virtual_keyboard(
+        b->vkbd_manager, b->seat);
+
+    size_t size = sizeof(keymap);
+    int fd = memfd_create("wake-bench-keymap", MFD_CLOEXEC);
+    if (fd < 0 || write(fd, keymap, size) != (ssize_t)size) {
+        perror("memfd");
+        if (fd >= 0)
+            close(fd);
+        return false;
+    }
+    zwp_virtual_keyboard_v1_keymap(b->vkbd, WL_KEYBOARD_KEYMAP_FORMAT_XKB_V1,
+                                   fd, (uint32_t)size);
+    close(fd);
+    return wl_display_roundtrip(b->sc.display) >= 0;
+}
+
+/* =========================================================================
+ * Trace von blkout auswerten
+ * =========================================================================
+ * Jede Zeile der Trace-Datei ist ein Ereignis; gesucht wird das erste
+ * Vorkommen der Eingabe bzw. von hide_overlay ab dem Einspeisezeitpunkt.
+ */
+
+static bool trace_event(const char *line, const char *name, char ph,
+                        double *ts_us)
+{
+    char pattern[80];
+    snprintf(pattern, sizeof(pattern), "\"name\":\"%s\",\"ph\":\"%c\"",
+             name, ph);
+    if (!strstr(line, pattern))
+        return false;
+    const char *ts = strstr(line, "\"ts\":");
+    return ts && sscanf(ts + 5, "%lf", ts_us) == 1;
+}
+
+static bool read_trace(const char *path, Mode mode, Input input,
+                       uint64_t since_ns, double *event_ns, double *hide_ns)
+{
+    FILE *f = fopen(path, "r");
+    if (!f)
+        return false;
+
+    const char *name = mode == MODE_R      ? "resumed"
+                     : input == INPUT_KEY ? "wl_keyboard.key"
+                                          : "wl_pointer.motion";
+    double since_us = (double)since_ns / 1e3;
+    *event_ns = *hide_ns = 0;
+
+    char line[512];
+    double ts;
+    while (fgets(line, sizeof(line), f)) {
+        if (!*event_ns && trace_event(line, name, 'i', &ts) && ts >= since_us)
+            *event_ns = ts * 1e3;
+        else if (!*hide_ns && trace_event(line, "hide_overlay", 'B', &ts) &&
+                 ts >= since_us)
+            *hide_ns = ts * 1e3;
+    }
+    fclose(f);
+    return *event_ns && *hide_ns;
+}
+
+/*
+ * Aufwachvorgänge (Beginn von "wakeup") und erhaltene Eingabe- und
+ * Idle-Ereignisse (Einzelereignisse wl_keyboard.*, wl_pointer.*, idled,
+ * resumed) im Trace zählen.
+ */
+static bool count_trace(const char *path, long *wakeups, long *events)
+{
+    FILE *f = fopen(path, "r");
+    if (!f)
+        return false;
+
+    *wakeups = *events = 0;
+    char line[512];
+    while (fgets(line, sizeof(line), f)) {
+        if (strstr(line, "\"name\":\"wakeup\",\"ph\":\"B\""))
+            (*wakeups)++;
+        else if (strstr(line, "\"ph\":\"i\"") &&
+                 (strstr(line, "\"name\":\"wl_keyboard.") ||
+                  strstr(line, "\"name\":\"wl_pointer.") ||
+                  strstr(line, "\"name\":\"idled\"") ||
+                  strstr(line, "\"name\":\"resumed\"")))
+            (*events)++;
+    }
+    fclose(f);
+    return true;
+}
+
+/* =========================================================================
+ * Ein Zyklus
+ * ========================================================================= */
+
+/* Auf Beendigung warten; false bei Timeout (Kind wird dann beendet) */
+static bool wait_child(pid_t pid, int timeout_ms)
+{
+    int status;
+    for (int ms = 0; ms < timeout_ms; ms++) {
+        if (waitpid(pid, &status, WNOHANG) == pid)
+            return WIFEXITED(status) && WEXITSTATUS(status) == 0;
+        usleep(1000);
+    }
+    kill(pid, SIGKILL);
+    waitpid(pid, NULL, 0);
+    return false;
+}
+
+/* Screencopy wiederholen, bis mindestens bzw. weniger als n Ausgaben
+ * schwarz sind. Gibt den ready-Zeitstempel zurück, 0 bei Timeout. */
+static uint64_t wait_black(ScContext *sc, bool black, int n, int timeout_ms)
+{
+    uint64_t deadline = now_ns() + (uint64_t)timeout_ms * 1000000ull;
+    while (now_ns() < deadline) {
+        if (!sc_capture_all(sc))
+            return 0;
+        int nblack = sc_count_black(sc);
+        if (black ? nblack >= n : nblack < n) {
+            uint64_t ready = 0;
+            for (int i = 0; i < sc->noutputs; i++)
+                if (sc->outputs[i].ready_ns > ready)
+                    ready = sc->outputs[i].ready_ns;
+            return ready ? ready : now_ns();
+        }
+    }
+    return 0;
+}
+
+static void inject(Bench *b, Input input, long cycle)
+{
+    uint32_t time = (uint32_t)(now_ns() / 1000000ull);
+
+    if (input == INPUT_KEY) {
+        zwp_virtual_keyboard_v1_key(b->vkbd, time, KEY_ESC,
+                                    WL_KEYBOARD_KEY_STATE_PRESSED);
+        zwp_virtual_keyboard_v1_key(b->vkbd, time, KEY_ESC,
+                                    WL_KEYBOARD_KEY_STATE_RELEASED);
+    } else {
+        /* Zwischen zwei Punkten in der Bildschirmmitte hin und her */
+        uint32_t x = POINTER_EXTENT / 2 + (uint32_t)(cycle % 2) * 10;
+        zwlr_virtual_pointer_v1_motion_absolute(b->vptr, time, x,
+                                                POINTER_EXTENT / 2,
+                                                POINTER_EXTENT,
+                                                POINTER_EXTENT);
+        zwlr_virtual_pointer_v1_frame(b->vptr);
+    }
+    wl_display_flush(b->sc.display);
+}
+
+/*
+ * blkout starten, schwarz abwarten, Eingabe einspeisen und die drei
+ * Zeitspannen in Millisekunden ermitteln. Gibt false bei Fehlschlag zurück.
+ */
+static bool cycle(Bench *b, char **argv, const char *trace_path, Mode mode,
+                  Input input, long n, int timeout_ms, double out[3])
+{
+    pid_t pid = fork();
+    if (pid < 0) {
+        perror("fork");
+        return false;
+    }
+    if (pid == 0) {
+        execvp(argv[0], argv);
+        perror(argv[0]);
+        _exit(127);
+    }
+
+    if (!wait_black(&b->sc, true, 1, timeout_ms)) {
+        kill(pid, SIGTERM);
+        wait_child(pid, timeout_ms);
+        return false;
+    }
+    /* Fokus und Zeiger-enter nach dem Mappen zustellen lassen */
+    usleep(SETTLE_MS * 1000);
+
+    uint64_t t0 = now_ns();
+    inject(b, input, n);
+    uint64_t screen = wait_black(&b->sc, false, 1, timeout_ms);
+
+    if (!wait_child(pid, timeout_ms) || !screen)
+        return false;
+
+    double event_ns, hide_ns;
+    if (!read_trace(trace_path, mode, input, t0, &event_ns, &hide_ns))
+        return false;
+
+    out[0] = (event_ns - (double)t0) / 1e6;
+    out[1] = (hide_ns - (double)t0) / 1e6;
+    out[2] = screen > t0 ? (double)(screen - t0) / 1e6 : 0.0;
+    return true;
+}
+
+/*
+ * Aktivitätsphase: blkout ohne -e laufen lassen und alle BURST_PERIOD_MS
+ * eine Folge von Eingaben einspeisen; dazwischen schaltet -s 1 schwarz.
+ */
+static void activity(Bench *b, char **argv, const char *trace_path,
+                     Input input, int seconds, int timeout_ms, Activity *a)
+{
+    a->seconds = seconds;
+    pid_t pid = fork();
+    if (pid < 0) {
+        perror("fork");
+        return;
+    }
+    if (pid == 0) {
+        execvp(argv[0], argv);
+        perror(argv[0]);
+        _exit(127);
+    }
+
+    uint64_t end = now_ns() + (uint64_t)seconds * 1000000000ull;
+    for (long burst = 0; now_ns() < end; burst++) {
+        usleep(BURST_PERIOD_MS * 1000);
+        for (int k = 0; k < BURST_EVENTS; k++) {
+            inject(b, input, burst * BURST_EVENTS + k);
+            usleep(BURST_GAP_MS * 1000);
+        }
+    }
+
+    kill(pid, SIGTERM);
+    wait_child(pid, timeout_ms);
+
+    long wakeups, events;
+    if (!count_trace(trace_path, &wakeups, &events))
+        return;
+    a->ok = true;
+    a->wakeups = (double)wakeups * 3600.0 / seconds;
+    a->events = (double)events * 3600.0 / seconds;
+}
+
+/* =========================================================================
+ * Ausgabe
+ * ========================================================================= */
+
+static void print_series(FILE *f, Mode mode, Input input, Series *s,
+                         bool last)
+{
+    qsort(s->event, (size_t)s->n, sizeof(double), cmp_double);
+    qsort(s->hide, (size_t)s->n, sizeof(double), cmp_double);
+    qsort(s->screen, (size_t)s->n, sizeof(double), cmp_double);
+
+    fprintf(f, "{\"name\":\"wake/%s/%s\",\"ok\":%s,\"cycles\":%d,"
+               "\"failed\":%d",
+            mode_names[mode], input_names[input], s->n > 0 ? "true" : "false",
+            s->n, s->failed);
+    const char *keys[] = { "event_ms", "hide_ms", "screen_ms" };
+    double *vals[] = { s->event, s->hide, s->screen };
+    for (int k = 0; k < 3; k++)
+        fprintf(f, ",\"%s_p50\":%.3f,\"%s_p99\":%.3f,\"%s_max\":%.3f",
+                keys[k], percentile(vals[k], s->n, 0.50),
+                keys[k], percentile(vals[k], s->n, 0.99),
+                keys[k], s->n ? vals[k][s->n - 1] : 0.0);
+    fprintf(f, "}%s\n", last ? "" : ",");
+}
+
+static void print_activity(FILE *f, Mode mode, const Activity *a, bool last)
+{
+    fprintf(f, "{\"name\":\"activity/%s\",\"ok\":%s,\"seconds\":%d,"
+               "\"wakeups_per_hour\":%.0f,\"events_per_hour\":%.0f}%s\n",
+            mode_names[mode], a->ok ? "true" : "false", a->seconds,
+            a->wakeups, a->events, last ? "" : ",");
+}
+
+static void usage(const char *prog)
+{
+    fprintf(stderr, "Aufruf: %s [--cycles N] [--input key|pointer|both] "
+                    "[--mode e|r|both] [--activity SEKUNDEN] [--timeout MS] "
+                    "[--out <datei>] -- BLKOUT [ARGUMENTE...]\n", prog);
+}
+
+/* =========================================================================
+ * Hauptprogramm
+ * ========================================================================= */
+
+int main(int argc, char *argv[])
+{
+    long cycles = DEFAULT_CYCLES;
+    int timeout_ms = DEFAULT_TIMEOUT_MS;
+    bool use[2] = { true, true };
+    bool modes[2] = { true, true };
+    int activity_s = DEFAULT_ACTIVITY_S;
+    const char *out_path = NULL;
+    int i;
+
+    for (i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--") == 0) {
+            i++;
+            break;
+        } else if (strcmp(argv[i], "--cycles") == 0 && i + 1 < argc) {
+            cycles = atol(argv[++i]);
+        } else if (strcmp(argv[i], "--input") == 0 && i + 1 < argc) {
+            i++;
+            use[INPUT_KEY] = strcmp(argv[i], "pointer") != 0;
+            use[INPUT_POINTER] = strcmp(argv[i], "key") != 0;
+        } else if (strcmp(argv[i], "--mode") == 0 && i + 1 < argc) {
+            i++;
+            modes[MODE_E] = strcmp(argv[i], "r") != 0;
+            modes[MODE_R] = strcmp(argv[i], "e") != 0;
+        } else if (strcmp(argv[i], "--activity") == 0 && i + 1 < argc) {
+            activity_s = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--timeout") == 0 && i + 1 < argc) {
+            timeout_ms = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--out") == 0 && i + 1 < argc) {
+            out_path = argv[++i];
+        } else {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+    if (i >= argc || cycles <= 0 || timeout_ms <= 0 || activity_s < 0) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    /*
+     * Befehlszeilen von blkout je Modus: für die Zyklen um
+     * "[-r] -e --trace <datei>" ergänzt, für die Aktivitätsphase um
+     * "[-r] -s 1 --trace <datei>"
+     */
+    char trace_path[] = "/tmp/wake-bench-XXXXXX";
+    int tfd = mkstemp(trace_path);
+    if (tfd < 0) {
+        perror("mkstemp");
+        return 2;
+    }
+    close(tfd);
+    int nbase = argc - i;
+    char **cargv[2], **aargv[2];
+    for (int m = 0; m < 2; m++) {
+        cargv[m] = calloc((size_t)nbase + 5, sizeof(char *));
+        aargv[m] = calloc((size_t)nbase + 6, sizeof(char *));
+        if (!cargv[m] || !aargv[m])
+            return 2;
+        int n = 0;
+        for (int k = 0; k < nbase; k++)
+            cargv[m][n++] = argv[i + k];
+        if (m == MODE_R)
+            cargv[m][n++] = "-r";
+        memcpy(aargv[m], cargv[m], (size_t)n * sizeof(char *));
+        cargv[m][n] = "-e";
+        cargv[m][n + 1] = "--trace";
+        cargv[m][n + 2] = trace_path;
+        aargv[m][n] = "-s";
+        aargv[m][n + 1] = "1";
+        aargv[m][n + 2] = "--trace";
+        aargv[m][n + 3] = trace_path;
+    }
+
+    Bench b = { 0 };
+    b.sc.display = wl_display_connect(NULL);
+    if (!b.sc.display) {
+        fprintf(stderr, "Keine Verbindung zum Wayland-Display möglich\n");
+        return 2;
+    }
+    struct wl_registry *registry = wl_display_get_registry(b.sc.display);
+    wl_registry_add_listener(registry, &registry_listener, &b);
+    wl_display_roundtrip(b.sc.display);
+    wl_display_roundtrip(b.sc.display);
+
+    if (!sc_ready(&b.sc) || !b.seat ||
+        (use[INPUT_KEY] && !b.vkbd_manager) ||
+        (use[INPUT_POINTER] && !b.vptr_manager)) {
+        fprintf(stderr, "Compositor bietet Screencopy, virtuelle Tastatur "
+                        "oder virtuelle Maus nicht an\n");
+        return 2;
+    }
+    if (use[INPUT_KEY] && !create_keyboard(&b))
+        return 2;
+    if (use[INPUT_POINTER])
+        b.vptr = zwlr_virtual_pointer_manager_v1_create_virtual_pointer(
+            b.vptr_manager, b.seat);
+
+    Series series[2][2] = { { { 0 } } };
+    Activity act[2] = { { 0 } };
+    for (int m = 0; m < 2; m++) {
+        for (int in = 0; in < 2; in++) {
+            Series *s = &series[m][in];
+            s->event  = calloc((size_t)cycles, sizeof(double));
+            s->hide   = calloc((size_t)cycles, sizeof(double));
+            s->screen = calloc((size_t)cycles, sizeof(double));
+            if (!s->event || !s->hide || !s->screen)
+                return 2;
+        }
+    }
+
+    for (int m = 0; m < 2; m++) {
+        if (!modes[m])
+            continue;
+        for (int in = 0; in < 2; in++) {
+            if (!use[in])
+                continue;
+            Series *s = &series[m][in];
+            for (long c = -WARMUP_CYCLES; c < cycles; c++) {
+                double v[3];
+                if (!cycle(&b, cargv[m], trace_path, (Mode)m, (Input)in, c,
+                           timeout_ms, v)) {
+                    if (c >= 0)
+                        s->failed++;
+                    continue;
+                }
+                if (c < 0)
+                    continue;
+                s->event[s->n]  = v[0];
+                s->hide[s->n]   = v[1];
+                s->screen[s->n] = v[2];
+                s->n++;
+                if ((c + 1) % 100 == 0)
+                    fprintf(stderr, "%s/%s: %ld/%ld\n", mode_names[m],
+                            input_names[in], c + 1, cycles);
+            }
+        }
+        if (activity_s > 0) {
+            fprintf(stderr, "%s: Aktivität %d s\n", mode_names[m], activity_s);
+            activity(&b, aargv[m], trace_path,
+                     use[INPUT_POINTER] ? INPUT_POINTER : INPUT_KEY,
+                     activity_s, timeout_ms, &act[m]);
+        }
+    }
+
+    FILE *out = out_path ? fopen(out_path, "w") : stdout;
+    if (!out) {
+        perror(out_path);
+        return 2;
+    }
+    int nmodes = modes[MODE_E] + modes[MODE_R];
+    int nused = nmodes * (use[INPUT_KEY] + use[INPUT_POINTER] +
+                          (activity_s > 0));
+    int printed = 0;
+    fputs("[\n", out);
+    for (int m = 0; m < 2; m++) {
+        if (!modes[m])
+            continue;
+        for (int in = 0; in < 2; in++)
+            if (use[in])
+                print_series(out, (Mode)m, (Input)in, &series[m][in],
+                             ++printed == nused);
+        if (activity_s > 0)
+            print_activity(out, (Mode)m, &act[m], ++printed == nused);
+    }
+    fputs("]\n", out);
+    if (out != stdout)
+        fclose(out);
+
+    int status = 0;
+    for (int m = 0; m < 2; m++) {
+        for (int in = 0; in < 2; in++) {
+            Series *s = &series[m][in];
+            if (modes[m] && use[in] && s->failed) {
+                fprintf(stderr, "%s/%s: %d Zyklen fehlgeschlagen\n",
+                        mode_names[m], input_names[in], s->failed);
+                status = 1;
+            }
+            free(s->event);
+            free(s->hide);
+            free(s->screen);
+        }
+        if (modes[m] && activity_s > 0 && !act[m].ok) {
+            fprintf(stderr, "%s: Aktivitätsphase fehlgeschlagen\n",
+                    mode_names[m]);
+            status = 1;
+        }
+    }
+
+    if (b.vkbd)
+        zwp_virtual_keyboard_v1_destroy(b.vkbd);
+    if (b.vptr)
+        zwlr_virtual_pointer_v1_destroy(b.vptr);
+    sc_destroy(&b.sc);
+    wl_display_disconnect(b.sc.display);
+    unlink(trace_path);
+    for (int m = 0; m < 2; m++) {
+        free(cargv[m]);
+        free(aargv[m]);
+    }
+    return status;
+}